@@ -0,0 +1,52 @@
+#!/usr/bin/env python3
+
+# xswl-youdidit 微基准结果比较脚本
+# 按 (名称, 表大小, 线程数) 对齐两次 core_bench 的 JSON 输出，打印 ns/op 中位数的变化
+# 用法: python3 benchmarks/compare.py <基线.json> <新结果.json> [--threshold 百分比]
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for r in data.get('results', []):
+        results[(r['name'], r['table_size'], r['threads'])] = r['ns_per_op']['median']
+    return data, results
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Compare two core_bench JSON result files')
+    parser.add_argument('baseline')
+    parser.add_argument('candidate')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='flag changes larger than this percentage (default 10)')
+    args = parser.parse_args()
+
+    base_meta, base = load(args.baseline)
+    cand_meta, cand = load(args.candidate)
+    if base_meta.get('build') != cand_meta.get('build'):
+        print('warning: build configurations differ: %s vs %s' % (base_meta.get('build'), cand_meta.get('build')))
+
+    print('%-30s %9s %7s %12s %12s %9s' % ('benchmark', 'size', 'threads', 'base ns/op', 'new ns/op', 'change'))
+    regressions = 0
+    for key in sorted(set(base) & set(cand)):
+        before, after = base[key], cand[key]
+        change = (after - before) / before * 100.0 if before > 0 else 0.0
+        mark = ''
+        if change > args.threshold:
+            mark = '  slower'
+            regressions += 1
+        elif change < -args.threshold:
+            mark = '  faster'
+        print('%-30s %9d %7d %12.1f %12.1f %+8.1f%%%s' % (key[0], key[1], key[2], before, after, change, mark))
+    for key in sorted(set(base) ^ set(cand)):
+        print('%-30s %9d %7d  only in %s' % (key[0], key[1], key[2], 'baseline' if key in base else 'candidate'))
+    return 1 if regressions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
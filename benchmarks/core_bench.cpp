@@ -0,0 +1,486 @@
+// 核心热路径微基准：TaskBuilder、publish_task、claim_next_task、claim_matching_task、状态转换、
+// get_tasks 过滤、信号发射与 EventLog::add_event，每项按 (表大小, 线程数) 组合运行，结果输出为 JSON 便于跨提交比较。
+//
+// 用法：core_bench [--filter 子串] [--sizes 100,10000] [--threads 1,4] [--ops 每线程操作数]
+//                  [--min-time-ms 毫秒] [--repetitions 次数] [--label 标签] [--out 文件]
+//
+// “表大小”指测量期间平台上已存在的背景任务数（已完成状态，不可申领但会被扫描）；
+// EventLog 一项中为环形缓冲区容量。消耗型操作（发布、申领、状态转换）每线程执行固定的 --ops 次，
+// 其余操作按批运行至 --min-time-ms。申领类基准的平台上另有 线程数 × --ops 个待申领任务，同样会被扫描。
+#include <xswl/youdidit/youdidit.hpp>
+#if YOUDIDIT_BENCH_HAS_WEB
+#include <xswl/youdidit/web/event_log.hpp>
+#endif
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef YOUDIDIT_BENCH_BUILD_TYPE
+#define YOUDIDIT_BENCH_BUILD_TYPE ""
+#endif
+
+using namespace xswl::youdidit;
+
+namespace {
+
+const int kCategoryCount = 8;
+
+struct Options {
+    std::string filter;
+    std::vector<std::size_t> sizes{100, 10000};
+    std::vector<int> threads{1, 4};
+    std::size_t ops = 2000;
+    int min_time_ms = 200;
+    int repetitions = 3;
+    std::string label;
+    std::string out;
+};
+
+// 一次运行所需的全部状态；各基准只使用其中一部分
+struct Fixture {
+    std::shared_ptr<TaskPlatform> platform;
+    std::vector<std::shared_ptr<Claimer>> claimers;          // 每线程一个申领者
+    std::vector<std::vector<std::shared_ptr<Task>>> tasks;   // 每线程预先准备的任务
+    std::vector<std::size_t> cursor;                         // 每线程已消耗的任务数
+#if YOUDIDIT_BENCH_HAS_WEB
+    std::unique_ptr<EventLog> event_log;
+#endif
+    std::atomic<std::uint64_t> sink{0};                      // 防止结果被优化掉
+};
+
+struct Benchmark {
+    const char *name;
+    bool consumable;   // true：每线程固定 --ops 次；false：按时间运行
+    std::function<void(Fixture &, std::size_t table_size, int threads, std::size_t ops)> setup;
+    // 在线程 index 上执行最多 count 次操作，返回实际完成的次数
+    std::function<std::size_t(Fixture &, int index, std::size_t count)> run;
+};
+
+struct Sample {
+    double wall_ns;
+    std::uint64_t ops;
+};
+
+Task::TaskHandler noop_handler() {
+    return [](Task &, const std::string &) { return TaskResult("ok"); };
+}
+
+std::shared_ptr<Task> build_task(TaskPlatform &platform, std::size_t i) {
+    return platform.task_builder()
+        .title("bench-" + std::to_string(i))
+        .category("cat-" + std::to_string(i % kCategoryCount))
+        .priority(static_cast<int>(i % 10))
+        .handler(noop_handler())
+        .build();
+}
+
+// 平台 + table_size 个已完成的背景任务（申领时被扫描但不可申领）
+void make_platform(Fixture &fixture, std::size_t table_size) {
+    fixture.platform = std::make_shared<TaskPlatform>("bench");
+    fixture.platform->set_max_task_queue_size(0);
+    for (std::size_t i = 0; i < table_size; ++i) {
+        auto task = build_task(*fixture.platform, i);
+        task->set_status(TaskStatus::Published);
+        task->set_status(TaskStatus::Claimed);
+        task->set_status(TaskStatus::Processing);
+        task->set_status(TaskStatus::Completed);
+        fixture.platform->publish_task(task);
+    }
+}
+
+void make_claimers(Fixture &fixture, int threads, std::size_t capacity) {
+    for (int t = 0; t < threads; ++t) {
+        auto claimer = std::make_shared<Claimer>("bench-claimer-" + std::to_string(t), "Bench");
+        claimer->set_max_concurrent(static_cast<int>(capacity));
+        claimer->add_category("cat-" + std::to_string(t % kCategoryCount));
+        fixture.platform->register_claimer(claimer);
+        fixture.claimers.push_back(claimer);
+    }
+}
+
+// 每线程 ops 个已构建的任务；publish 为 true 时同时发布
+void make_thread_tasks(Fixture &fixture, int threads, std::size_t ops, bool publish) {
+    fixture.tasks.assign(threads, std::vector<std::shared_ptr<Task>>());
+    fixture.cursor.assign(threads, 0);
+    std::size_t serial = 0;
+    for (int t = 0; t < threads; ++t) {
+        for (std::size_t i = 0; i < ops; ++i) {
+            auto task = build_task(*fixture.platform, serial++);
+            if (publish) {
+                fixture.platform->publish_task(task);
+            }
+            fixture.tasks[t].push_back(task);
+        }
+    }
+}
+
+// 申领直到成功 count 次或没有可申领的任务；与其他线程竞争失败时重试
+template <typename Claim>
+std::size_t claim_loop(Fixture &fixture, int index, std::size_t count, Claim claim) {
+    const auto &claimer = fixture.claimers[index];
+    std::size_t done = 0;
+    while (done < count) {
+        auto result = claim(claimer);
+        if (result.has_value()) {
+            ++done;
+        } else if (result.error().code == ErrorCode::PLATFORM_NO_AVAILABLE_TASK) {
+            break;
+        }
+    }
+    return done;
+}
+
+std::vector<Benchmark> make_benchmarks() {
+    std::vector<Benchmark> benchmarks;
+
+    benchmarks.push_back(Benchmark{
+        "task_builder.build", false,
+        [](Fixture &f, std::size_t size, int, std::size_t) { make_platform(f, size); },
+        [](Fixture &f, int, std::size_t count) {
+            auto builder = f.platform->task_builder();
+            for (std::size_t i = 0; i < count; ++i) {
+                auto task = builder.title("built")
+                                .category("cat-1")
+                                .priority(3)
+                                .add_tag("bench")
+                                .metadata("key", "value")
+                                .handler(noop_handler())
+                                .build();
+                f.sink.fetch_add(task ? 1 : 0, std::memory_order_relaxed);
+                builder.reset();
+            }
+            return count;
+        }});
+
+    benchmarks.push_back(Benchmark{
+        "platform.publish_task", true,
+        [](Fixture &f, std::size_t size, int threads, std::size_t ops) {
+            make_platform(f, size);
+            make_thread_tasks(f, threads, ops, false);
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            std::size_t done = 0;
+            auto &tasks = f.tasks[index];
+            for (; done < count && f.cursor[index] < tasks.size(); ++done) {
+                f.platform->publish_task(tasks[f.cursor[index]++]);
+            }
+            return done;
+        }});
+
+    benchmarks.push_back(Benchmark{
+        "platform.claim_next_task", true,
+        [](Fixture &f, std::size_t size, int threads, std::size_t ops) {
+            make_platform(f, size);
+            make_claimers(f, threads, ops);
+            make_thread_tasks(f, threads, ops, true);
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            return claim_loop(f, index, count, [&f](const std::shared_ptr<Claimer> &claimer) {
+                return f.platform->claim_next_task(claimer);
+            });
+        }});
+
+    benchmarks.push_back(Benchmark{
+        "platform.claim_matching_task", true,
+        [](Fixture &f, std::size_t size, int threads, std::size_t ops) {
+            make_platform(f, size);
+            make_claimers(f, threads, ops);
+            make_thread_tasks(f, threads, ops, true);
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            return claim_loop(f, index, count, [&f](const std::shared_ptr<Claimer> &claimer) {
+                return f.platform->claim_matching_task(claimer);
+            });
+        }});
+
+    // 一次操作 = Claimed -> Processing -> Completed 两次转换
+    benchmarks.push_back(Benchmark{
+        "task.start_complete", true,
+        [](Fixture &f, std::size_t size, int threads, std::size_t ops) {
+            make_platform(f, size);
+            make_claimers(f, threads, ops);
+            make_thread_tasks(f, threads, ops, true);
+            for (int t = 0; t < threads; ++t) {
+                for (const auto &task : f.tasks[t]) {
+                    f.platform->claim_task(f.claimers[t], task->id());
+                }
+            }
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            std::size_t done = 0;
+            auto &tasks = f.tasks[index];
+            const TaskResult result("ok");
+            for (; done < count && f.cursor[index] < tasks.size(); ++done) {
+                const auto &task = tasks[f.cursor[index]++];
+                task->start();
+                task->complete(result);
+            }
+            return done;
+        }});
+
+    benchmarks.push_back(Benchmark{
+        "platform.get_tasks_filtered", false,
+        [](Fixture &f, std::size_t size, int threads, std::size_t) {
+            make_platform(f, size);
+            make_thread_tasks(f, threads, 64, true);
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            TaskPlatform::TaskFilter filter;
+            filter.status = TaskStatus::Published;
+            filter.category = "cat-" + std::to_string(index % kCategoryCount);
+            filter.min_priority = 2;
+            for (std::size_t i = 0; i < count; ++i) {
+                f.sink.fetch_add(f.platform->get_tasks(filter).size(), std::memory_order_relaxed);
+            }
+            return count;
+        }});
+
+    // 一次操作 = 一次 set_progress（进度值变化，向一个已连接的槽发射 sig_progress_updated）
+    benchmarks.push_back(Benchmark{
+        "task.signal_emit", false,
+        [](Fixture &f, std::size_t size, int threads, std::size_t) {
+            make_platform(f, size);
+            make_thread_tasks(f, threads, 1, true);
+            for (int t = 0; t < threads; ++t) {
+                Fixture *fixture = &f;
+                f.tasks[t][0]->sig_progress_updated.connect([fixture](Task &, int progress) {
+                    fixture->sink.fetch_add(static_cast<std::uint64_t>(progress), std::memory_order_relaxed);
+                });
+            }
+        },
+        [](Fixture &f, int index, std::size_t count) {
+            const auto &task = f.tasks[index][0];
+            for (std::size_t i = 0; i < count; ++i) {
+                task->set_progress(static_cast<int>(i & 63));
+            }
+            return count;
+        }});
+
+#if YOUDIDIT_BENCH_HAS_WEB
+    benchmarks.push_back(Benchmark{
+        "event_log.add_event", false,
+        [](Fixture &f, std::size_t size, int, std::size_t) {
+            f.event_log.reset(new EventLog(size));
+        },
+        [](Fixture &f, int, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i) {
+                f.event_log->add_event(EventLog::EventType::Info, "bench", "event message");
+            }
+            return count;
+        }});
+#endif
+
+    return benchmarks;
+}
+
+// 所有线程同时开始；消耗型基准每线程执行 ops 次，其余按 64 次一批运行到 min_time
+Sample run_once(const Benchmark &bench, std::size_t table_size, int threads, const Options &options) {
+    Fixture fixture;
+    bench.setup(fixture, table_size, threads, options.ops);
+
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> total{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            std::uint64_t done = 0;
+            if (bench.consumable) {
+                done = bench.run(fixture, t, options.ops);
+            } else {
+                while (!stop.load(std::memory_order_relaxed)) {
+                    done += bench.run(fixture, t, 64);
+                }
+            }
+            total.fetch_add(done);
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    const auto begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    if (!bench.consumable) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.min_time_ms));
+        stop.store(true);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return Sample{std::chrono::duration<double, std::nano>(end - begin).count(), total.load()};
+}
+
+std::string json_string(const std::string &value) {
+    std::string out = "\"";
+    for (char ch : value) {
+        switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        default:
+            if (static_cast<unsigned char>(ch) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", ch);
+                out += buf;
+            } else {
+                out += ch;
+            }
+        }
+    }
+    return out + "\"";
+}
+
+double median(std::vector<double> values) {
+    std::sort(values.begin(), values.end());
+    const std::size_t n = values.size();
+    return n % 2 ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2.0;
+}
+
+template <typename T>
+std::vector<T> parse_list(const std::string &text) {
+    std::vector<T> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) {
+            values.push_back(static_cast<T>(std::strtoull(item.c_str(), nullptr, 10)));
+        }
+    }
+    return values;
+}
+
+bool parse_options(int argc, char **argv, Options &options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h" || i + 1 >= argc) {
+            return false;
+        }
+        const std::string value = argv[++i];
+        if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--sizes") {
+            options.sizes = parse_list<std::size_t>(value);
+        } else if (arg == "--threads") {
+            options.threads = parse_list<int>(value);
+        } else if (arg == "--ops") {
+            options.ops = std::max<std::size_t>(1, std::strtoull(value.c_str(), nullptr, 10));
+        } else if (arg == "--min-time-ms") {
+            options.min_time_ms = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--repetitions") {
+            options.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--out") {
+            options.out = value;
+        } else {
+            return false;
+        }
+    }
+    return !options.sizes.empty() && !options.threads.empty();
+}
+
+std::string utc_timestamp() {
+    std::time_t now = std::time(nullptr);
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return buf;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    Options options;
+    if (!parse_options(argc, argv, options)) {
+        std::cerr << "usage: " << argv[0]
+                  << " [--filter NAME] [--sizes N,N] [--threads N,N] [--ops N] [--min-time-ms MS]"
+                     " [--repetitions N] [--label TEXT] [--out FILE]" << std::endl;
+        return 2;
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"suite\": \"youdidit-core\",\n"
+         << "  \"label\": " << json_string(options.label) << ",\n"
+         << "  \"timestamp\": " << json_string(utc_timestamp()) << ",\n"
+         << "  \"build\": {\"type\": " << json_string(YOUDIDIT_BENCH_BUILD_TYPE)
+         << ", \"tracing\": " << (tracing_compiled_in() ? "true" : "false")
+         << ", \"lock_profiling\": " << (lock_profiling_compiled_in() ? "true" : "false") << "},\n"
+         << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+         << "  \"options\": {\"ops\": " << options.ops << ", \"min_time_ms\": " << options.min_time_ms
+         << ", \"repetitions\": " << options.repetitions << "},\n"
+         << "  \"results\": [";
+
+    std::fprintf(stderr, "%-30s %9s %7s %12s %12s %14s\n", "benchmark", "size", "threads", "ns/op", "min ns/op",
+                 "ops/s");
+    bool first = true;
+    for (const auto &bench : make_benchmarks()) {
+        if (!options.filter.empty() && std::string(bench.name).find(options.filter) == std::string::npos) {
+            continue;
+        }
+        for (std::size_t size : options.sizes) {
+            for (int threads : options.threads) {
+                // ns/op 为每个线程看到的单次操作耗时（墙钟时间 × 线程数 / 总操作数）
+                std::vector<double> ns_per_op;
+                std::vector<double> ops_per_sec;
+                std::uint64_t ops = 0;
+                for (int rep = 0; rep < options.repetitions; ++rep) {
+                    Sample sample = run_once(bench, size, threads, options);
+                    if (sample.ops == 0) {
+                        continue;
+                    }
+                    ops += sample.ops;
+                    ns_per_op.push_back(sample.wall_ns * threads / static_cast<double>(sample.ops));
+                    ops_per_sec.push_back(static_cast<double>(sample.ops) * 1e9 / sample.wall_ns);
+                }
+                if (ns_per_op.empty()) {
+                    continue;
+                }
+                const double med = median(ns_per_op);
+                const double min = *std::min_element(ns_per_op.begin(), ns_per_op.end());
+                const double max = *std::max_element(ns_per_op.begin(), ns_per_op.end());
+                const double rate = median(ops_per_sec);
+                std::fprintf(stderr, "%-30s %9zu %7d %12.1f %12.1f %14.0f\n", bench.name, size, threads, med, min,
+                             rate);
+
+                char line[512];
+                std::snprintf(line, sizeof(line),
+                              "%s\n    {\"name\": \"%s\", \"table_size\": %zu, \"threads\": %d, \"ops\": %llu, "
+                              "\"ns_per_op\": {\"median\": %.1f, \"min\": %.1f, \"max\": %.1f}, "
+                              "\"ops_per_sec\": {\"median\": %.0f}}",
+                              first ? "" : ",", bench.name, size, threads, static_cast<unsigned long long>(ops),
+                              med, min, max, rate);
+                json << line;
+                first = false;
+            }
+        }
+    }
+    json << "\n  ]\n}\n";
+
+    if (options.out.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(options.out.c_str());
+        if (!(file << json.str())) {
+            std::cerr << "failed to write " << options.out << std::endl;
+            return 1;
+        }
+        std::cerr << "results written to " << options.out << std::endl;
+    }
+    return 0;
+}
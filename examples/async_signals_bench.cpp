@@ -0,0 +1,124 @@
+// 异步信号分发基准：订阅者每次回调耗时 1ms 时，对比同步触发与 SignalDispatcher 下的工作线程吞吐量
+//
+// 用法：example_async_signals_bench [tasks] [workers]
+#include <xswl/youdidit/youdidit.hpp>
+#include <xswl/youdidit/core/signal_dispatcher.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+namespace {
+
+struct BenchResult {
+    double worker_seconds;   // 所有工作线程完成任务的耗时
+    double drain_seconds;    // 直至所有信号投递完成的耗时
+    int delivered;
+    std::uint64_t dropped;
+};
+
+BenchResult run_once(int task_count, int worker_count, const std::shared_ptr<SignalDispatcher> &dispatcher) {
+    auto platform = std::make_shared<TaskPlatform>("bench");
+    platform->set_max_task_queue_size(0);
+    if (dispatcher) {
+        platform->set_signal_dispatcher(dispatcher);
+    }
+
+    std::atomic<int> delivered{0};
+    std::vector<std::shared_ptr<Claimer>> workers;
+    for (int i = 0; i < worker_count; ++i) {
+        auto claimer = std::make_shared<Claimer>("worker-" + std::to_string(i), "Worker");
+        claimer->set_max_concurrent(1);
+        // 慢速订阅者：模拟写日志/推送通知等耗时 1ms 的处理
+        claimer->sig_task_completed.connect([&delivered](Claimer &, std::shared_ptr<Task>, const TaskResult &) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            delivered.fetch_add(1, std::memory_order_relaxed);
+        });
+        platform->register_claimer(claimer);
+        workers.push_back(claimer);
+    }
+
+    for (int i = 0; i < task_count; ++i) {
+        auto task = platform->task_builder()
+                        .title("bench-" + std::to_string(i))
+                        .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                        .build();
+        platform->publish_task(task);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (const auto &claimer : workers) {
+        threads.emplace_back([claimer, platform]() {
+            for (;;) {
+                auto claimed = claimer->claim_next_task();
+                if (!claimed.has_value()) {
+                    // 与其他工作线程竞争失败时重试，直到没有可申领的任务
+                    if (platform->task_count_by_status(TaskStatus::Published) == 0) {
+                        break;
+                    }
+                    continue;
+                }
+                claimer->run_task(claimed.value(), std::string());
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto workers_done = std::chrono::steady_clock::now();
+    if (dispatcher) {
+        dispatcher->flush();
+    }
+    auto drained = std::chrono::steady_clock::now();
+
+    BenchResult result;
+    result.worker_seconds = std::chrono::duration<double>(workers_done - start).count();
+    result.drain_seconds = std::chrono::duration<double>(drained - start).count();
+    result.delivered = delivered.load();
+    result.dropped = dispatcher ? dispatcher->statistics().dropped : 0;
+    return result;
+}
+
+void print_row(const std::string &mode, int task_count, const BenchResult &r) {
+    std::cout << std::left << std::setw(26) << mode << std::right << std::fixed << std::setprecision(0)
+              << std::setw(14) << task_count / r.worker_seconds << std::setprecision(3) << std::setw(12)
+              << r.worker_seconds << std::setw(12) << r.drain_seconds << std::setw(11) << r.delivered
+              << std::setw(9) << r.dropped << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int task_count = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int worker_count = argc > 2 ? std::atoi(argv[2]) : 4;
+
+    std::cout << "tasks=" << task_count << " workers=" << worker_count << " subscriber=1ms" << std::endl;
+    std::cout << std::left << std::setw(26) << "mode" << std::right << std::setw(14) << "tasks/s"
+              << std::setw(12) << "workers(s)" << std::setw(12) << "drained(s)" << std::setw(11)
+              << "delivered" << std::setw(9) << "dropped" << std::endl;
+
+    print_row("sync", task_count, run_once(task_count, worker_count, nullptr));
+
+    SignalDispatcher::Options options;
+    options.queue_capacity = static_cast<std::size_t>(task_count) * 8;
+    options.dispatcher_threads = static_cast<std::size_t>(worker_count);
+    print_row("async block", task_count,
+              run_once(task_count, worker_count, std::make_shared<SignalDispatcher>(options)));
+
+    // 队列远小于事件量：Block 会把订阅者的背压传回工作线程，DropNewest 以丢事件换取吞吐
+    options.queue_capacity = 64;
+    options.overflow_policy = SignalDispatcher::OverflowPolicy::Block;
+    print_row("async block (cap=64)", task_count,
+              run_once(task_count, worker_count, std::make_shared<SignalDispatcher>(options)));
+    options.overflow_policy = SignalDispatcher::OverflowPolicy::DropNewest;
+    print_row("async drop-newest (cap=64)", task_count,
+              run_once(task_count, worker_count, std::make_shared<SignalDispatcher>(options)));
+    return 0;
+}
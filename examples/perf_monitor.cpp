@@ -1,4 +1,5 @@
 #include <xswl/youdidit/youdidit.hpp>
+#include <xswl/youdidit/core/latency_histogram.hpp>
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -10,6 +11,7 @@
 #include <climits>
 #include <limits>
 #include <mutex>
+#include <condition_variable>
 #include <fstream>
 #include <sstream>
 #include <ctime>
@@ -160,6 +162,7 @@ static void print_usage(const char* prog) {
     std::cerr << "Error: duration ranges are required. Usage:\n";
     std::cerr << "  " << prog << " <tasks> <claimers> <duration_ranges> [html_path] [sample_interval_ms] [max_latency_samples] [max_task_details] [max_event_samples] [categories]\n";
     std::cerr << "Example: " << prog << " 200 4 \"0-1,1-1,2-8\" perf_report.html 20 100000 2000 500000 \"A,B,C,D\"\n";
+    std::cerr << "Open-loop mode (fixed arrival rate, rate sweep): " << prog << " --open-loop --help\n";
 }
 
 static bool parse_args(int argc, char** argv, Config &cfg) {
@@ -196,7 +199,397 @@ static void sleep_for_ms(int ms) {
 #endif
 }
 
+// ===================== Open-loop mode =====================
+// A producer thread publishes tasks at a target arrival rate (Poisson or fixed interval) regardless of how
+// fast claimers keep up, and end-to-end latency is measured from the *intended* publish time. A producer
+// that falls behind (or a queue that backs up) therefore shows up in the latency instead of silently
+// lowering the offered load (coordinated omission). A rate sweep runs one step per rate and reports the
+// knee: the highest rate before throughput stops tracking the offered load or p99 latency blows up.
+struct OpenLoopConfig {
+    std::vector<double> rates{100.0};     // tasks per second; several values = sweep
+    bool poisson = true;
+    double step_seconds = 5.0;
+    double drain_seconds = -1.0;          // < 0: same as step_seconds
+    size_t num_claimers = 4;
+    std::string duration_ranges_str = "1-3";
+    std::vector<std::pair<int,int>> duration_ranges;
+    std::string html_path;
+    std::string json_path;
+    unsigned int seed = 0;
+    double knee_p99_factor = 5.0;         // p99 above factor x lowest-rate p99 counts as saturated
+    double knee_throughput_ratio = 0.95;  // throughput below ratio x arrival rate counts as saturated
+};
+
+// One scheduled arrival; `done` makes sure each task is recorded exactly once (completed or censored)
+struct Arrival {
+    std::chrono::steady_clock::time_point intended;
+    std::chrono::steady_clock::time_point published;
+    std::shared_ptr<Task> task;
+    std::atomic<bool> done{false};
+};
+
+struct OpenLoopRecorder {
+    LatencyHistogram corrected;    // completion - intended publish time (us)
+    LatencyHistogram uncorrected;  // completion - actual publish time (us), what a closed-loop view reports
+    LatencyHistogram service;      // handler run time (us)
+    LatencyHistogram publish_lag;  // actual - intended publish time (us)
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> completed_in_window{0};
+    std::chrono::steady_clock::time_point window_end;
+};
+
+struct OpenLoopStep {
+    double target_rate{0.0};
+    double arrival_rate{0.0};      // achieved publish rate
+    double throughput{0.0};        // completions inside the step window per second
+    uint64_t published{0};
+    uint64_t completed{0};
+    uint64_t incomplete{0};        // not completed when draining stopped (recorded as censored latency)
+    LatencyHistogram::Snapshot corrected;
+    LatencyHistogram::Snapshot uncorrected;
+    LatencyHistogram::Snapshot service;
+    LatencyHistogram::Snapshot publish_lag;
+    bool saturated{false};
+};
+
+static uint64_t micros_between(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    if (to <= from) return 0;
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(to - from).count());
+}
+
+static void print_open_loop_usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " --open-loop [--rate R | --sweep R1,R2,...] [--arrival poisson|fixed]\n"
+              << "       [--step-seconds S] [--drain-seconds S] [--claimers N] [--durations \"1-3\"]\n"
+              << "       [--html report.html] [--json report.json] [--seed N]\n"
+              << "Example: " << prog << " --open-loop --sweep 200,400,800,1600 --claimers 4 --durations \"1-3\" --html open_loop.html\n";
+}
+
+static bool parse_open_loop_args(int argc, char** argv, OpenLoopConfig &cfg) {
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string value = argv[++i];
+        try {
+            if (arg == "--rate") {
+                cfg.rates.assign(1, std::stod(value));
+            } else if (arg == "--sweep") {
+                cfg.rates.clear();
+                for (const auto &tok : parse_categories(value)) cfg.rates.push_back(std::stod(tok));
+            } else if (arg == "--arrival") {
+                if (value != "poisson" && value != "fixed") return false;
+                cfg.poisson = value == "poisson";
+            } else if (arg == "--step-seconds") {
+                cfg.step_seconds = std::stod(value);
+            } else if (arg == "--drain-seconds") {
+                cfg.drain_seconds = std::stod(value);
+            } else if (arg == "--claimers") {
+                cfg.num_claimers = std::stoul(value);
+            } else if (arg == "--durations") {
+                cfg.duration_ranges_str = value;
+            } else if (arg == "--html") {
+                cfg.html_path = value;
+            } else if (arg == "--json") {
+                cfg.json_path = value;
+            } else if (arg == "--seed") {
+                cfg.seed = static_cast<unsigned int>(std::stoul(value));
+            } else {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+    }
+    cfg.duration_ranges = parse_duration_ranges(cfg.duration_ranges_str);
+    std::sort(cfg.rates.begin(), cfg.rates.end());
+    cfg.rates.erase(std::remove_if(cfg.rates.begin(), cfg.rates.end(), [](double r) { return !(r > 0.0); }),
+                    cfg.rates.end());
+    if (cfg.drain_seconds < 0) cfg.drain_seconds = cfg.step_seconds;
+    // JSON goes next to the HTML report unless a path is given
+    if (cfg.json_path.empty() && !cfg.html_path.empty()) {
+        std::string base = cfg.html_path;
+        size_t dot = base.find_last_of('.');
+        size_t slash = base.find_last_of("/\\");
+        if (dot != std::string::npos && (slash == std::string::npos || dot > slash)) base.erase(dot);
+        cfg.json_path = base + ".json";
+    }
+    return !cfg.rates.empty() && !cfg.duration_ranges.empty() && cfg.num_claimers > 0 && cfg.step_seconds > 0;
+}
+
+static OpenLoopStep run_open_loop_step(const OpenLoopConfig &cfg, double rate, unsigned int seed) {
+    typedef std::chrono::steady_clock Clock;
+    TaskPlatform platform;
+    platform.set_max_task_queue_size(0);   // the queue must be free to grow under overload
+    auto recorder = std::make_shared<OpenLoopRecorder>();
+
+    std::mutex work_mutex;
+    std::condition_variable work_cv;
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < cfg.num_claimers; ++i) {
+        auto claimer = std::make_shared<Claimer>("claimer-" + std::to_string(i + 1), "claimer-" + std::to_string(i + 1));
+        claimer->set_max_concurrent(1);
+        platform.register_claimer(claimer);
+        workers.emplace_back([&, claimer, i]() {
+            std::mt19937 rng(seed + 7919u * static_cast<unsigned int>(i + 1));
+            std::uniform_int_distribution<size_t> range_idx_dist(0, cfg.duration_ranges.size() - 1);
+            while (!stop.load(std::memory_order_acquire)) {
+                auto claimed = claimer->claim_next_task();
+                if (!claimed.has_value()) {
+                    std::unique_lock<std::mutex> lock(work_mutex);
+                    work_cv.wait_for(lock, std::chrono::milliseconds(1));
+                    continue;
+                }
+                auto pr = cfg.duration_ranges[range_idx_dist(rng)];
+                std::uniform_int_distribution<int> d(pr.first, std::max(pr.first, pr.second));
+                claimer->run_task(claimed.value(), std::to_string(d(rng)));
+            }
+        });
+    }
+
+    std::vector<std::shared_ptr<Arrival>> arrivals;
+    arrivals.reserve(static_cast<size_t>(rate * cfg.step_seconds * 1.2) + 16);
+    const auto start = Clock::now();
+    const auto window = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(cfg.step_seconds));
+    recorder->window_end = start + window;
+
+    // producer: the schedule is fixed up front, so a late publish never shifts later arrivals
+    std::mt19937 rng(seed);
+    std::exponential_distribution<double> poisson_gap(rate);
+    double offset_s = 0.0;
+    TaskBuilder builder = platform.task_builder();
+    for (;;) {
+        offset_s += cfg.poisson ? poisson_gap(rng) : 1.0 / rate;
+        if (offset_s >= cfg.step_seconds) break;
+        auto arrival = std::make_shared<Arrival>();
+        arrival->intended = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(offset_s));
+        std::this_thread::sleep_until(arrival->intended);
+        Arrival *entry = arrival.get();
+        std::weak_ptr<OpenLoopRecorder> weak_recorder = recorder;
+        arrival->task = builder.reset()
+                            .title("open-loop")
+                            .handler([entry, weak_recorder](Task &, const std::string &input) -> TaskResult {
+                                int ms = 0;
+                                try { ms = std::stoi(input); } catch (...) { ms = 0; }
+                                auto begin = Clock::now();
+                                if (ms > 0) sleep_for_ms(ms);
+                                auto end = Clock::now();
+                                auto rec = weak_recorder.lock();
+                                if (rec && !entry->done.exchange(true)) {
+                                    rec->corrected.record(micros_between(entry->intended, end));
+                                    rec->uncorrected.record(micros_between(entry->published, end));
+                                    rec->service.record(micros_between(begin, end));
+                                    rec->completed.fetch_add(1, std::memory_order_relaxed);
+                                    if (end <= rec->window_end) {
+                                        rec->completed_in_window.fetch_add(1, std::memory_order_relaxed);
+                                    }
+                                }
+                                return TaskResult("ok");
+                            })
+                            .build();
+        arrival->published = Clock::now();
+        recorder->publish_lag.record(micros_between(arrival->intended, arrival->published));
+        platform.publish_task(arrival->task);
+        arrivals.push_back(arrival);
+        work_cv.notify_one();
+    }
+    const auto publish_end = Clock::now();
+
+    // drain: wait for the backlog, but never longer than drain_seconds past the window
+    const auto drain_deadline = recorder->window_end +
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(cfg.drain_seconds));
+    while (recorder->completed.load() < arrivals.size() && Clock::now() < drain_deadline) {
+        sleep_for_ms(5);
+    }
+
+    // whatever is still outstanding is recorded with the latency it had accumulated so far (a lower bound)
+    OpenLoopStep step;
+    const auto cutoff = Clock::now();
+    for (const auto &arrival : arrivals) {
+        if (!arrival->done.exchange(true)) {
+            recorder->corrected.record(micros_between(arrival->intended, cutoff));
+            ++step.incomplete;
+        }
+    }
+    stop.store(true, std::memory_order_release);
+    work_cv.notify_all();
+    for (auto &t : workers) t.join();
+
+    step.target_rate = rate;
+    step.published = arrivals.size();
+    step.completed = recorder->completed.load();
+    double publish_seconds = std::chrono::duration<double>(std::max(publish_end, recorder->window_end) - start).count();
+    step.arrival_rate = publish_seconds > 0 ? step.published / publish_seconds : 0.0;
+    step.throughput = recorder->completed_in_window.load() / cfg.step_seconds;
+    step.corrected = recorder->corrected.snapshot();
+    step.uncorrected = recorder->uncorrected.snapshot();
+    step.service = recorder->service.snapshot();
+    step.publish_lag = recorder->publish_lag.snapshot();
+    return step;
+}
+
+static double us_to_ms(uint64_t us) { return us / 1000.0; }
+
+// Mark saturated steps and return the index of the knee (last step before the first saturated one), or -1
+static int find_knee(const OpenLoopConfig &cfg, std::vector<OpenLoopStep> &steps, std::string &reason) {
+    if (steps.empty()) return -1;
+    const double base_p99 = std::max<double>(1.0, static_cast<double>(steps.front().corrected.percentile(0.99)));
+    int first_saturated = -1;
+    for (size_t i = 0; i < steps.size(); ++i) {
+        auto &s = steps[i];
+        // throughput only counts completions inside the arrival window, so at most the tasks in service at the
+        // window edge are missed; that is far below the ratio threshold for any step of a few seconds
+        bool falls_behind = s.throughput < cfg.knee_throughput_ratio * s.arrival_rate || s.incomplete > 0;
+        bool latency_blowup = s.corrected.percentile(0.99) > cfg.knee_p99_factor * base_p99;
+        s.saturated = falls_behind || latency_blowup;
+        if (s.saturated && first_saturated < 0) {
+            first_saturated = static_cast<int>(i);
+            std::ostringstream oss;
+            oss << "at " << s.target_rate << "/s ";
+            if (falls_behind) {
+                oss << "throughput " << std::fixed << std::setprecision(1) << s.throughput << "/s fell behind arrivals "
+                    << s.arrival_rate << "/s";
+                if (s.incomplete > 0) oss << " (" << s.incomplete << " tasks left undrained)";
+            } else {
+                oss << "p99 " << std::fixed << std::setprecision(3) << us_to_ms(s.corrected.percentile(0.99))
+                    << " ms exceeded " << cfg.knee_p99_factor << "x the lowest-rate p99";
+            }
+            reason = oss.str();
+        }
+    }
+    if (first_saturated < 0) {
+        reason = "no saturation within the swept rates";
+        return static_cast<int>(steps.size()) - 1;
+    }
+    return first_saturated - 1;
+}
+
+static void write_histogram_json(std::ostream &os, const char *name, const LatencyHistogram::Snapshot &h) {
+    os << "\"" << name << "\": {\"count\": " << h.count << std::fixed << std::setprecision(3)
+       << ", \"mean_ms\": " << (h.count ? us_to_ms(h.sum) / h.count : 0.0)
+       << ", \"p50_ms\": " << us_to_ms(h.percentile(0.50))
+       << ", \"p90_ms\": " << us_to_ms(h.percentile(0.90))
+       << ", \"p99_ms\": " << us_to_ms(h.percentile(0.99))
+       << ", \"p999_ms\": " << us_to_ms(h.percentile(0.999))
+       << ", \"max_ms\": " << us_to_ms(h.percentile(1.0)) << "}";
+}
+
+static int run_open_loop(int argc, char** argv) {
+    OpenLoopConfig cfg;
+    if (!parse_open_loop_args(argc, argv, cfg)) {
+        print_open_loop_usage(argv[0]);
+        return 1;
+    }
+    if (cfg.seed == 0) cfg.seed = static_cast<unsigned int>(std::chrono::steady_clock::now().time_since_epoch().count());
+
+    std::cout << "Open-loop load generator\n";
+    std::cout << "  arrival=" << (cfg.poisson ? "poisson" : "fixed") << " claimers=" << cfg.num_claimers
+              << " durations=" << cfg.duration_ranges_str << " step_seconds=" << cfg.step_seconds
+              << " drain_seconds=" << cfg.drain_seconds << " seed=" << cfg.seed << "\n";
+    std::cout << std::setw(10) << "rate" << std::setw(11) << "arrival" << std::setw(11) << "thruput"
+              << std::setw(10) << "p50_ms" << std::setw(10) << "p99_ms" << std::setw(11) << "p999_ms"
+              << std::setw(12) << "raw_p99_ms" << std::setw(10) << "lag_max" << std::setw(10) << "undrained" << "\n";
+
+    std::vector<OpenLoopStep> steps;
+    for (size_t i = 0; i < cfg.rates.size(); ++i) {
+        OpenLoopStep s = run_open_loop_step(cfg, cfg.rates[i], cfg.seed + static_cast<unsigned int>(i));
+        std::cout << std::fixed << std::setprecision(1) << std::setw(10) << s.target_rate << std::setw(11) << s.arrival_rate
+                  << std::setw(11) << s.throughput << std::setprecision(3)
+                  << std::setw(10) << us_to_ms(s.corrected.percentile(0.50))
+                  << std::setw(10) << us_to_ms(s.corrected.percentile(0.99))
+                  << std::setw(11) << us_to_ms(s.corrected.percentile(0.999))
+                  << std::setw(12) << us_to_ms(s.uncorrected.percentile(0.99))
+                  << std::setw(10) << us_to_ms(s.publish_lag.percentile(1.0))
+                  << std::setw(10) << s.incomplete << "\n";
+        steps.push_back(std::move(s));
+    }
+
+    std::string knee_reason;
+    int knee = find_knee(cfg, steps, knee_reason);
+    if (knee >= 0) {
+        std::cout << "Knee: " << std::setprecision(1) << steps[knee].target_rate << " tasks/s (" << knee_reason << ")\n";
+    } else {
+        std::cout << "Knee: below the lowest swept rate (" << knee_reason << ")\n";
+    }
+
+    if (!cfg.json_path.empty()) {
+        std::ofstream os(cfg.json_path);
+        if (os) {
+            os << "{\n  \"mode\": \"open_loop\",\n  \"arrival\": \"" << (cfg.poisson ? "poisson" : "fixed") << "\",\n"
+               << "  \"claimers\": " << cfg.num_claimers << ",\n  \"durations\": \"" << cfg.duration_ranges_str << "\",\n"
+               << std::fixed << std::setprecision(3)
+               << "  \"step_seconds\": " << cfg.step_seconds << ",\n  \"drain_seconds\": " << cfg.drain_seconds << ",\n"
+               << "  \"seed\": " << cfg.seed << ",\n  \"steps\": [";
+            for (size_t i = 0; i < steps.size(); ++i) {
+                const auto &s = steps[i];
+                os << (i ? "," : "") << "\n    {\"target_rate\": " << s.target_rate << ", \"arrival_rate\": " << s.arrival_rate
+                   << ", \"throughput\": " << s.throughput << ", \"published\": " << s.published
+                   << ", \"completed\": " << s.completed << ", \"incomplete\": " << s.incomplete
+                   << ", \"saturated\": " << (s.saturated ? "true" : "false") << ",\n     ";
+                write_histogram_json(os, "latency", s.corrected);
+                os << ",\n     ";
+                write_histogram_json(os, "latency_uncorrected", s.uncorrected);
+                os << ",\n     ";
+                write_histogram_json(os, "service", s.service);
+                os << ",\n     ";
+                write_histogram_json(os, "publish_lag", s.publish_lag);
+                os << "}";
+            }
+            os << "\n  ],\n  \"knee\": {\"rate\": ";
+            if (knee >= 0) os << steps[knee].target_rate; else os << "null";
+            os << ", \"reason\": \"" << knee_reason << "\"}\n}\n";
+            std::cout << "Wrote JSON results to " << cfg.json_path << "\n";
+        } else {
+            std::cerr << "Failed to open JSON output file: " << cfg.json_path << "\n";
+        }
+    }
+
+    if (!cfg.html_path.empty()) {
+        std::ofstream ofs(cfg.html_path);
+        if (ofs) {
+            ofs << "<!doctype html>\n<html><head><meta charset=\"utf-8\"><title>开环负载报告</title>\n"
+                << "<style>body{font-family:Arial,Helvetica,sans-serif;margin:12px;font-size:13px;line-height:1.25;color:#222} table{border-collapse:collapse;font-size:0.9em} td,th{border:1px solid #ddd;padding:4px} th{background:#f8f8f8} h1{font-size:1.25em;margin-bottom:6px} h2{font-size:1.05em;margin-top:10px;margin-bottom:6px} .muted{color:#666;font-size:0.85em} tr.saturated td{background:#fff1f0} tr.knee td{background:#f0fff4}</style>\n"
+                << "</head><body>\n";
+            ofs << "<h1>开环负载报告</h1>\n";
+            ofs << "<p class='muted'>生产者按目标到达率（" << (cfg.poisson ? "泊松" : "固定间隔")
+                << "）发布任务，与申领者的处理速度无关；延迟从计划发布时间起算（修正协调遗漏），"
+                << "未修正延迟从实际发布时间起算，仅供对比。排空截止时仍未完成的任务以截止时的累计延迟计入（下界）。</p>\n";
+            ofs << "<h2>测试输入参数</h2>\n<table>\n<tr><th>到达过程</th><th>Claimers</th><th>时长分布</th><th>每档时长 (s)</th><th>排空上限 (s)</th><th>随机种子</th></tr>\n";
+            ofs << "<tr><td>" << (cfg.poisson ? "poisson" : "fixed") << "</td><td>" << cfg.num_claimers << "</td><td>"
+                << cfg.duration_ranges_str << "</td><td>" << cfg.step_seconds << "</td><td>" << cfg.drain_seconds
+                << "</td><td>" << cfg.seed << "</td></tr>\n</table>\n";
+            ofs << "<h2>速率扫描</h2>\n";
+            std::ostringstream knee_text;
+            if (knee >= 0) knee_text << std::fixed << std::setprecision(1) << steps[knee].target_rate << " tasks/s";
+            else knee_text << "低于最低扫描速率";
+            ofs << "<p class='muted'>拐点：" << knee_text.str()
+                << "（" << knee_reason << "）。吞吐低于到达率的 " << cfg.knee_throughput_ratio * 100 << "%、存在未排空任务，或 P99 超过最低速率 P99 的 "
+                << cfg.knee_p99_factor << " 倍，即视为饱和。</p>\n";
+            ofs << "<table>\n<tr><th>目标速率 (/s)</th><th>实际到达 (/s)</th><th>吞吐 (/s)</th><th>P50 (ms)</th><th>P90 (ms)</th><th>P99 (ms)</th><th>P999 (ms)</th><th>最大 (ms)</th><th>未修正 P99 (ms)</th><th>服务 P50 (ms)</th><th>发布滞后最大 (ms)</th><th>未排空</th></tr>\n";
+            for (size_t i = 0; i < steps.size(); ++i) {
+                const auto &s = steps[i];
+                const char *cls = static_cast<int>(i) == knee ? " class='knee'" : (s.saturated ? " class='saturated'" : "");
+                ofs << "<tr" << cls << "><td>" << std::fixed << std::setprecision(1) << s.target_rate << "</td><td>" << s.arrival_rate
+                    << "</td><td>" << s.throughput << std::setprecision(3)
+                    << "</td><td>" << us_to_ms(s.corrected.percentile(0.50)) << "</td><td>" << us_to_ms(s.corrected.percentile(0.90))
+                    << "</td><td>" << us_to_ms(s.corrected.percentile(0.99)) << "</td><td>" << us_to_ms(s.corrected.percentile(0.999))
+                    << "</td><td>" << us_to_ms(s.corrected.percentile(1.0)) << "</td><td>" << us_to_ms(s.uncorrected.percentile(0.99))
+                    << "</td><td>" << us_to_ms(s.service.percentile(0.50)) << "</td><td>" << us_to_ms(s.publish_lag.percentile(1.0))
+                    << "</td><td>" << s.incomplete << "</td></tr>\n";
+            }
+            ofs << "</table>\n</body></html>\n";
+            std::cout << "Wrote HTML summary to " << cfg.html_path << "\n";
+        } else {
+            std::cerr << "Failed to open HTML output file: " << cfg.html_path << "\n";
+        }
+    }
+    return 0;
+}
+
 int main(int argc, char** argv) {
+    // Open-loop mode has its own options: perf_monitor --open-loop [...]
+    if (argc > 1 && std::string(argv[1]) == "--open-loop") return run_open_loop(argc, argv);
+
     // Parse CLI into a small config object (keeps main short and makes parsing logic reusable)
     Config cfg;
     if (!parse_args(argc, argv, cfg)) return 1;
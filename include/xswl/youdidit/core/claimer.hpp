@@ -16,6 +16,33 @@ namespace youdidit {
 // 前向声明
 class TaskPlatform;
 
+/**
+ * @brief 申领者能力快照（角色与分类）
+ *
+ * 不可变对象，由 add_role/remove_role/add_category/remove_category 以写时复制方式整体替换，
+ * 每次替换 version 递增。调度方可在一次扫描中只加载一次，并在 version 不变时复用路由判断。
+ */
+struct ClaimerCapabilities {
+    std::set<std::string> roles;
+    std::set<std::string> categories;
+    std::uint64_t role_mask{0};       ///< 角色名哈希位图（用于快速排除）
+    std::uint64_t category_mask{0};   ///< 分类名哈希位图（用于快速排除）
+    std::uint64_t version{0};
+
+    /**
+     * @brief 计算名称对应的位图位（哈希取模 64，可能冲突，仅用于快速排除）
+     */
+    static std::uint64_t bit_of(const std::string &name) noexcept;
+
+    bool has_role(const std::string &role) const;
+    bool has_category(const std::string &category) const;
+
+    /**
+     * @brief 判断是否接受指定分类的任务（空分类或未限制分类时接受）
+     */
+    bool accepts_category(const std::string &category) const;
+};
+
 /**
  * @brief 任务申领者类
  * 
@@ -43,6 +70,16 @@ public:
     // 角色和分类
     std::set<std::string> roles() const;       // 返回副本
     std::set<std::string> categories() const;  // 返回副本
+
+    /**
+     * @brief 获取当前能力快照（无锁，一次原子读取）
+     */
+    std::shared_ptr<const ClaimerCapabilities> capabilities() const;
+
+    /**
+     * @brief 获取能力快照版本号（角色/分类每次变化时递增）
+     */
+    std::uint64_t capabilities_version() const;
     
     // 已申领的任务
     std::vector<std::shared_ptr<Task>> claimed_tasks() const;
@@ -53,6 +90,13 @@ public:
     std::uint64_t total_completed() const noexcept;
     std::uint64_t total_failed() const noexcept;
     std::uint64_t total_abandoned() const noexcept;
+
+    /**
+     * @brief 获取近似内存占用（O(1)，增量维护）
+     * @return 组件 "claimer" / "capabilities" / "claimed_tasks" / "executing_tasks" 的字节数
+     * @note 已申领任务对象本身由平台统计，这里只计入索引容器的开销
+     */
+    MemoryUsage memory_usage() const;
     
     // ========== 基本属性 Setter (Fluent API) ==========
     Claimer &set_name(const std::string &name);
@@ -147,6 +191,16 @@ public:
      * @param input 任务输入数据
      */
     TaskResult run_task(const TaskId &task_id, const std::string &input);
+
+    /**
+     * @brief 以共享负载作为输入执行任务（输入数据在整个调用链中不被复制）
+     */
+    TaskResult run_task(std::shared_ptr<Task> task, const Payload &input);
+
+    /**
+     * @brief 以共享负载作为输入执行任务
+     */
+    TaskResult run_task(const TaskId &task_id, const Payload &input);
     
     /**
      * @brief 完成任务
@@ -192,12 +246,23 @@ public:
      * @brief 计算与任务的匹配度（0-100）
      */
     int calculate_match_score(const std::shared_ptr<Task> &task) const;
+
+    /**
+     * @brief 以给定的能力快照计算匹配度（扫描路径在扫描开始时加载一次快照，逐个候选任务复用）
+     */
+    int calculate_match_score(const std::shared_ptr<Task> &task, const ClaimerCapabilities &caps) const;
     
     // ========== 平台关联 ==========
     /**
      * @brief 设置关联的平台
      */
     void set_platform(TaskPlatform* platform);
+
+    /**
+     * @brief 设置异步信号分发器（传入 nullptr 恢复同步触发；申领者只弱引用分发器）
+     */
+    Claimer &set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher);
+    std::shared_ptr<SignalDispatcher> signal_dispatcher() const;
     
     /**
      * @brief 获取关联的平台
@@ -0,0 +1,91 @@
+#ifndef XSWL_YOUDIDIT_CORE_LATENCY_HISTOGRAM_HPP
+#define XSWL_YOUDIDIT_CORE_LATENCY_HISTOGRAM_HPP
+
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 对数分桶的延迟直方图（HDR 风格，单位微秒）
+ *
+ * 小于 16us 的值每微秒一个桶；之后每个 2 的幂区间再等分为 16 个子桶，相对误差不超过 1/16。
+ * 分桶覆盖到 2^40us（约 12.7 天），更大的值一律记入最后一个桶，每个分片约 4.7KB。
+ * 记录线程按线程槽位写入各自的分片（首次使用时分配），只做 relaxed 原子加，不加锁、互不争用；
+ * snapshot() 在读取时合并所有分片。分片数越少内存越省，但并发记录时争用同一缓存行的可能越大。
+ */
+class LatencyHistogram {
+public:
+    static const std::size_t kSubBucketBits = 4;
+    static const std::size_t kSubBucketCount = std::size_t(1) << kSubBucketBits;
+    static const std::size_t kMaxValueBits = 40;   ///< 分桶上限 2^40（更大的值记入最后一个桶）
+    static const std::size_t kBucketCount = (kMaxValueBits - kSubBucketBits + 1) * kSubBucketCount;
+    static const std::size_t kMaxShards = 16;
+
+    /**
+     * @brief 某一时刻合并后的计数（去掉了末尾的空桶）
+     */
+    struct Snapshot {
+        std::vector<std::uint64_t> buckets;   ///< buckets[i] 为落入第 i 个桶的样本数
+        std::uint64_t count{0};
+        std::uint64_t sum{0};                 ///< 样本总和（微秒）
+
+        /**
+         * @brief 分位数对应的值（所在桶的上界，不会低估），q ∈ [0, 1]；无样本时返回 0
+         */
+        std::uint64_t percentile(double q) const;
+
+        /**
+         * @brief 小于 limit 的样本数（limit 为桶边界时精确）
+         */
+        std::uint64_t count_below(std::uint64_t limit) const;
+
+        void merge(const Snapshot &other);
+    };
+
+    /**
+     * @param shards 记录分片数（1 ~ kMaxShards，超出范围时取边界值）
+     */
+    explicit LatencyHistogram(std::size_t shards = kMaxShards);
+    ~LatencyHistogram() noexcept;
+
+    LatencyHistogram(const LatencyHistogram &) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+    void record(std::uint64_t micros) noexcept;
+    Snapshot snapshot() const;
+
+    static std::size_t bucket_index(std::uint64_t micros) noexcept;
+    static std::uint64_t bucket_lower_bound(std::size_t index) noexcept;
+    /// 第 index 个桶的上界（不含）；最后一个桶返回 UINT64_MAX
+    static std::uint64_t bucket_upper_bound(std::size_t index) noexcept;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> d;
+};
+
+/**
+ * @brief 平台记录的任务延迟阶段
+ */
+enum class LatencyStage {
+    QueueWait = 0,   ///< 发布 → 申领
+    StartDelay,      ///< 申领 → 开始执行
+    Run,             ///< 开始执行 → 完成
+    EndToEnd,        ///< 发布 → 完成（重新发布的任务从最近一次发布算起）
+};
+
+const std::size_t kLatencyStageCount = 4;
+
+/**
+ * @brief 阶段名（queue_wait / start_delay / run / end_to_end）
+ */
+const char *latency_stage_name(LatencyStage stage) noexcept;
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_CORE_LATENCY_HISTOGRAM_HPP
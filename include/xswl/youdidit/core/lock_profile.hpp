@@ -0,0 +1,122 @@
+#ifndef XSWL_YOUDIDIT_CORE_LOCK_PROFILE_HPP
+#define XSWL_YOUDIDIT_CORE_LOCK_PROFILE_HPP
+
+#include <xswl/youdidit/core/latency_histogram.hpp>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// CMake 选项 XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING=ON 时定义为 1：平台与申领者/任务的内部锁记录争用数据
+#ifndef XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING
+#define XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING 0
+#endif
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 被统计的锁（同一位置的所有实例合并统计，如所有任务的 data_mutex_）
+ */
+enum class LockSite {
+    PlatformTasks,      ///< TaskPlatform 任务表锁 "platform.tasks"
+    PlatformClaimers,   ///< TaskPlatform 申领者表锁 "platform.claimers"
+    ClaimerData,        ///< Claimer 数据锁 "claimer.data"
+    TaskData            ///< Task 数据锁 "task.data"
+};
+
+const char *lock_site_name(LockSite site) noexcept;
+
+/**
+ * @brief 单个锁位置的争用统计（时间单位为纳秒）
+ */
+struct LockStatistics {
+    LockSite site = LockSite::PlatformTasks;
+    std::string name;
+    std::uint64_t acquisitions = 0;      ///< 已释放的加锁次数
+    std::uint64_t contended = 0;         ///< 需要等待的加锁次数
+    LatencyHistogram::Snapshot wait;     ///< 争用时的等待时间（未争用的加锁不记录）
+    LatencyHistogram::Snapshot hold;     ///< 持有时间
+};
+
+/**
+ * @brief 本构建是否启用了锁统计
+ */
+constexpr bool lock_profiling_compiled_in() noexcept {
+    return XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING != 0;
+}
+
+/**
+ * @brief 各锁位置的累计统计；未启用锁统计时返回空列表
+ */
+std::vector<LockStatistics> lock_statistics();
+
+namespace detail {
+void record_lock_wait(LockSite site, std::uint64_t nanos) noexcept;
+void record_lock_hold(LockSite site, std::uint64_t nanos) noexcept;
+}
+
+/**
+ * @brief 可统计争用的互斥量（内部使用）
+ *
+ * 满足 Lockable 要求，可直接用于 std::lock_guard。未启用锁统计时只是 std::mutex 的转发，没有额外开销；
+ * 启用后先 try_lock，失败才计为争用并记录等待时间，解锁时记录持有时间。
+ * 直方图按线程分片，记录不会在统计数据本身上产生新的争用。
+ */
+class ProfiledMutex {
+public:
+#if XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING
+    explicit ProfiledMutex(LockSite site) noexcept : site_(site) {}
+
+    void lock() {
+        if (!mutex_.try_lock()) {
+            const auto begin = std::chrono::steady_clock::now();
+            mutex_.lock();
+            acquired_at_ = std::chrono::steady_clock::now();
+            detail::record_lock_wait(site_, _nanos(acquired_at_ - begin));
+            return;
+        }
+        acquired_at_ = std::chrono::steady_clock::now();
+    }
+
+    bool try_lock() {
+        if (!mutex_.try_lock()) {
+            return false;
+        }
+        acquired_at_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    void unlock() {
+        const auto held = std::chrono::steady_clock::now() - acquired_at_;
+        mutex_.unlock();
+        detail::record_lock_hold(site_, _nanos(held));
+    }
+#else
+    explicit ProfiledMutex(LockSite) noexcept {}
+
+    void lock() { mutex_.lock(); }
+    bool try_lock() { return mutex_.try_lock(); }
+    void unlock() { mutex_.unlock(); }
+#endif
+
+    ProfiledMutex(const ProfiledMutex &) = delete;
+    ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+private:
+    std::mutex mutex_;
+#if XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING
+    static std::uint64_t _nanos(std::chrono::steady_clock::duration d) noexcept {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(d).count());
+    }
+
+    LockSite site_;
+    std::chrono::steady_clock::time_point acquired_at_;   // 只由持有者写入
+#endif
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_CORE_LOCK_PROFILE_HPP
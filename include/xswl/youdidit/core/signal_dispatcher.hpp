@@ -0,0 +1,166 @@
+#ifndef XSWL_YOUDIDIT_CORE_SIGNAL_DISPATCHER_HPP
+#define XSWL_YOUDIDIT_CORE_SIGNAL_DISPATCHER_HPP
+
+#include <memory>
+#include <atomic>
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 异步信号分发器（可选）
+ *
+ * 默认情况下 Task / Claimer / TaskPlatform 的信号在状态转换线程上同步触发。为对象设置分发器后，
+ * 信号发射只会把回调封装后放入有界无锁队列，由分发线程异步调用槽函数，慢速订阅者不再拖慢工作线程。
+ *
+ * 顺序保证：同一发射对象（同一个 Task / Claimer / TaskPlatform）的所有信号按发射顺序投递到同一个
+ * 分发线程，因此同一信号、同一对象上的不同信号之间均保持发射顺序；不同对象之间不保证顺序。
+ *
+ * 生命周期：对象只弱引用分发器，调用方需在使用期间持有分发器；析构时会投递完队列中剩余的事件。
+ * 最后一个引用可以在槽函数内释放：此时析构不等待分发线程，内部状态在分发线程排空队列退出后回收。
+ */
+class SignalDispatcher {
+public:
+    /**
+     * @brief 队列已满时的处理策略
+     */
+    enum class OverflowPolicy {
+        Block,       ///< 发射线程等待队列出现空位（不丢事件）；在分发线程（槽函数）内发射时改为同步调用
+        DropNewest,  ///< 丢弃本次事件并计数
+        CallerRuns   ///< 在发射线程上同步调用槽函数（不丢事件，但该事件可能越过队列中的早先事件）
+    };
+
+    struct Options {
+        std::size_t queue_capacity = 4096;       ///< 每个分发线程的队列容量（向上取整为 2 的幂）
+        std::size_t dispatcher_threads = 1;      ///< 分发线程数（至少 1）
+        OverflowPolicy overflow_policy = OverflowPolicy::Block;
+    };
+
+    struct Statistics {
+        std::uint64_t posted;       ///< 成功入队的事件数
+        std::uint64_t delivered;    ///< 已由分发线程投递的事件数
+        std::uint64_t dropped;      ///< 因队列满被丢弃的事件数
+        std::uint64_t caller_runs;  ///< 因队列满改为同步执行的事件数
+        std::uint64_t slot_errors;  ///< 槽函数抛出异常的次数
+    };
+
+    SignalDispatcher();
+    explicit SignalDispatcher(const Options &options);
+    ~SignalDispatcher() noexcept;
+
+    SignalDispatcher(const SignalDispatcher &) = delete;
+    SignalDispatcher &operator=(const SignalDispatcher &) = delete;
+
+    /**
+     * @brief 投递一个回调
+     * @param key 排序键：相同 key 的回调按投递顺序在同一分发线程上执行
+     * @param fn 回调
+     * @return 已入队或已同步执行返回 true；被丢弃或分发器已停止返回 false
+     */
+    bool post(const void *key, std::function<void()> fn);
+
+    /**
+     * @brief 异步发射信号
+     * @param key 排序键（通常为发射对象地址）
+     * @param keep_alive 在回调执行前保持发射对象存活
+     * @param sig 信号对象（须为 keep_alive 所持有对象的成员）
+     * @param args 信号参数；按值保存，引用参数请使用 std::ref 包装
+     */
+    template <typename Signal, typename... Args>
+    bool emit_signal(const void *key, std::shared_ptr<const void> keep_alive, Signal &sig, Args &&... args) {
+        return post(key, std::function<void()>(std::bind(SignalInvoker<Signal>(), &sig, std::move(keep_alive),
+                                                         std::forward<Args>(args)...)));
+    }
+
+    /**
+     * @brief 等待当前已入队的事件全部投递完成
+     * @note 在分发线程（槽函数）内调用时不等待其他分发线程，只在当前线程上依次执行本线程队列中已入队的事件
+     */
+    void flush();
+
+    /**
+     * @brief 停止接收新事件，投递剩余事件并等待分发线程退出（幂等）
+     * @note 在槽函数内调用时不等待，分发线程排空队列后自行退出
+     */
+    void stop();
+
+    std::size_t pending() const noexcept;
+    Statistics statistics() const noexcept;
+    const Options &options() const noexcept;
+
+private:
+    template <typename Signal>
+    struct SignalInvoker {
+        template <typename... A>
+        void operator()(Signal *sig, const std::shared_ptr<const void> &, A &... args) const {
+            (*sig)(args...);
+        }
+    };
+
+    class Impl;
+    std::shared_ptr<Impl> d;   // 分发线程共同持有，见 Impl
+};
+
+/**
+ * @brief 发射对象持有的分发器弱引用（可在任意线程读取，设置时整体替换）
+ */
+class SignalDispatcherRef {
+public:
+    void reset(const std::shared_ptr<SignalDispatcher> &dispatcher) {
+        std::shared_ptr<const std::weak_ptr<SignalDispatcher>> ref;
+        if (dispatcher) {
+            ref = std::make_shared<const std::weak_ptr<SignalDispatcher>>(dispatcher);
+        }
+        std::atomic_store(&ref_, ref);
+    }
+
+    std::shared_ptr<SignalDispatcher> lock() const {
+        std::shared_ptr<const std::weak_ptr<SignalDispatcher>> ref = std::atomic_load(&ref_);
+        return ref ? ref->lock() : std::shared_ptr<SignalDispatcher>();
+    }
+
+private:
+    std::shared_ptr<const std::weak_ptr<SignalDispatcher>> ref_;
+};
+
+template <typename T>
+inline T &unwrap_signal_arg(std::reference_wrapper<T> ref) noexcept {
+    return ref.get();
+}
+
+template <typename T>
+inline T &&unwrap_signal_arg(T &&value) noexcept {
+    return std::forward<T>(value);
+}
+
+/**
+ * @brief 按发射对象的分发模式触发信号
+ *
+ * 未设置分发器，或 owner 不由 std::shared_ptr 管理（无法保证异步回调时存活）时同步触发；
+ * 否则以 owner 地址为排序键异步投递。引用类型的参数（如 owner 自身）请用 std::ref 传入。
+ */
+template <typename Owner, typename Signal, typename... Args>
+void dispatch_signal(const SignalDispatcherRef &ref, Owner &owner, Signal &sig, Args &&... args) {
+    std::shared_ptr<SignalDispatcher> dispatcher = ref.lock();
+    if (dispatcher) {
+        std::shared_ptr<const void> keep_alive;
+        try {
+            keep_alive = owner.shared_from_this();
+        } catch (const std::bad_weak_ptr &) {
+        }
+        if (keep_alive) {
+            dispatcher->emit_signal(&owner, std::move(keep_alive), sig, std::forward<Args>(args)...);
+            return;
+        }
+    }
+    sig(unwrap_signal_arg(std::forward<Args>(args))...);
+}
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_CORE_SIGNAL_DISPATCHER_HPP
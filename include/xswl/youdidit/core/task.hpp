@@ -2,6 +2,7 @@
 #define XSWL_YOUDIDIT_CORE_TASK_HPP
 
 #include <xswl/youdidit/core/types.hpp>
+#include <xswl/youdidit/core/signal_dispatcher.hpp>
 #include <xswl/signals.hpp>
 #include <memory>
 #include <string>
@@ -10,11 +11,93 @@
 #include <set>
 #include <functional>
 #include <chrono>
+#include <cstdint>
+#include <atomic>
 
 namespace xswl {
 namespace youdidit {
 
-class Task {
+/**
+ * @brief 任务只读快照
+ *
+ * 由 Task::snapshot() 返回的不可变视图，字段在同一时刻一致地读取。
+ * 任务字段发生变化后，下一次调用 snapshot() 才会重新构建（写时复制）。
+ */
+struct TaskView {
+    TaskId id;
+    std::string title;
+    std::string description;
+    int priority{0};
+    TaskStatus status{TaskStatus::Draft};
+    int progress{0};
+    std::string category;
+    std::set<std::string> tags;
+    std::string claimer_id;
+    Timestamp created_at;
+    Timestamp published_at;
+    Timestamp claimed_at;
+    Timestamp started_at;
+    Timestamp completed_at;
+    bool cancel_requested{false};
+    std::uint64_t version{0};   ///< 构建快照时任务的修改版本号
+};
+
+/**
+ * @brief 任务内存记账汇总
+ *
+ * 由平台持有并在多个任务间共享。任务挂接后，其字段变化产生的字节增量会实时累加到这里，
+ * 平台无需遍历任务即可得到总占用（近似值）。
+ */
+struct TaskMemoryAccount {
+    std::atomic<std::int64_t> task_bytes{0};      ///< 任务对象与字符串/集合字段
+    std::atomic<std::int64_t> metadata_bytes{0};  ///< 元数据键值对
+    std::atomic<std::int64_t> handler_bytes{0};   ///< 处理函数对象（不含捕获的堆内存）
+};
+
+/**
+ * @brief 任务生命周期记录（紧凑格式，供批量订阅使用）
+ */
+struct TaskLifecycleRecord {
+    TaskId task_id;
+    TaskStatus old_status{TaskStatus::Draft};
+    TaskStatus new_status{TaskStatus::Draft};
+    Timestamp timestamp;     ///< 状态转换发生的时间
+    std::string claimer_id;  ///< 转换时的申领者（可能为空）
+    bool removed{false};     ///< 任务被从平台删除：old_status 与 new_status 均为删除时的状态
+    std::uint64_t change_sequence{0};  ///< 本次转换（或删除）分配的变更序号，与 TaskPlatform::change_sequence() 同源；0 表示未分配
+};
+
+class Task;
+
+/**
+ * @brief 任务状态转换接收器（内部接口，由平台实现并在发布任务时挂接）
+ */
+class TaskLifecycleSink {
+public:
+    virtual ~TaskLifecycleSink() = default;
+
+    /**
+     * @brief 在状态转换完成后、状态信号触发前于转换线程上调用；实现必须快速且不抛异常
+     * @return 为本次转换分配的变更序号（0 表示未分配），任务据此更新 change_sequence()
+     */
+    virtual std::uint64_t on_status_changed(const Task &task, TaskStatus old_status, TaskStatus new_status) noexcept = 0;
+};
+
+/**
+ * @brief 进度信号合并（节流）配置
+ *
+ * 启用后 set_progress() 仍立即更新进度值（progress() 始终精确），但 sig_progress_updated 仅在
+ * 距上次发射不少于 min_interval 且变化量不少于 min_delta 时触发。进度 100 总是立即发射；
+ * 任务发生状态转换前会补发尚未发射的最新值，保证订阅者最终看到准确进度。
+ */
+struct ProgressCoalescing {
+    std::chrono::milliseconds min_interval{0};  ///< 两次发射的最小间隔（0 表示不限制）
+    int min_delta{0};                           ///< 两次发射的最小进度差（<= 1 表示不限制）
+
+    bool enabled() const noexcept { return min_interval.count() > 0 || min_delta > 1; }
+};
+
+class Task : public std::enable_shared_from_this<Task> {
 public:
     // ========== 类型定义 ==========
     using TaskHandler = std::function<TaskResult(
@@ -55,6 +138,30 @@ public:
     // 白名单和黑名单 (返回副本)
     std::set<std::string> whitelist() const;
     std::set<std::string> blacklist() const;
+
+    /**
+     * @brief 获取任务的不可变快照
+     * @return 共享的只读视图；字段未变化时返回同一个对象，无需加锁
+     * @note 适用于仪表板、过滤和导出等需要一次性读取多个字段的场景
+     */
+    std::shared_ptr<const TaskView> snapshot() const;
+
+    /**
+     * @brief 获取任务的修改版本号（每次快照相关字段变化时递增）
+     */
+    std::uint64_t version() const noexcept;
+
+    /**
+     * @brief 获取平台变更序号（最近一次发布、状态转换或删除时由平台分配；未发布时为 0）
+     * @see TaskPlatform::get_changes_since
+     */
+    std::uint64_t change_sequence() const noexcept;
+
+    /**
+     * @brief 获取任务的近似内存占用（O(1)，由各 setter 增量维护）
+     * @return 组件 "task" / "metadata" / "handler" 的字节数
+     */
+    MemoryUsage memory_usage() const;
     
     // ========== Setter 方法 (Fluent API) ==========
     Task &set_title(const std::string &title);
@@ -69,6 +176,17 @@ public:
     Task &set_status(TaskStatus status);
     
     Task &set_progress(int progress);
+
+    /**
+     * @brief 设置进度信号合并策略（默认关闭：每次进度变化都发射信号）
+     */
+    Task &set_progress_coalescing(const ProgressCoalescing &coalescing);
+    ProgressCoalescing progress_coalescing() const noexcept;
+
+    /**
+     * @brief 立即发射被合并的最新进度（若与上次发射值不同）
+     */
+    void flush_progress();
     Task &set_category(const std::string &category);
     Task &add_tag(const std::string &tag);
     Task &remove_tag(const std::string &tag);
@@ -88,6 +206,25 @@ public:
     Task &set_claimed_at(const Timestamp &timestamp);
     Task &set_started_at(const Timestamp &timestamp);
     Task &set_completed_at(const Timestamp &timestamp);
+    Task &set_change_sequence(std::uint64_t sequence);
+
+    /**
+     * @brief 挂接内存记账汇总（内部使用，传入 nullptr 表示解除挂接）
+     * @note 挂接时会把当前占用计入新的汇总，并从旧汇总中扣除
+     */
+    Task &set_memory_account(std::shared_ptr<TaskMemoryAccount> account);
+
+    /**
+     * @brief 挂接状态转换接收器（内部使用，传入 nullptr 表示解除挂接）
+     */
+    Task &set_lifecycle_sink(std::shared_ptr<TaskLifecycleSink> sink);
+
+    /**
+     * @brief 设置异步信号分发器（传入 nullptr 恢复同步触发）
+     * @note 仅当任务由 std::shared_ptr 管理时异步投递，否则仍同步触发；任务只弱引用分发器
+     */
+    Task &set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher);
+    std::shared_ptr<SignalDispatcher> signal_dispatcher() const;
     
     // ========== 语义化状态转换 API ==========
     /**
@@ -154,6 +291,12 @@ public:
     // 执行任务
     TaskResult execute(const std::string &input);
 
+    /**
+     * @brief 以共享负载作为输入执行任务
+     * @note 处理函数收到的 input 直接引用负载内容，不复制数据
+     */
+    TaskResult execute(const Payload &input);
+
     // ========== 自动清理标志 ==========
     /**
      * @brief 设置是否允许在平台清理操作中自动删除此任务
@@ -210,6 +353,13 @@ private:
     
     // 私有辅助方法
     void _trigger_status_signal(TaskStatus old_status, TaskStatus new_status);
+    void _emit_progress(int progress, bool force);
+
+    // 语义化方法的实现（公开方法在外层包裹追踪 span）
+    TaskResult _execute(const std::string &input);
+    tl::expected<void, Error> _complete(const TaskResult &result);
+    tl::expected<void, Error> _fail(const std::string &reason);
+    tl::expected<void, Error> _abandon(const std::string &reason);
 };
 
 } // namespace youdidit
@@ -4,16 +4,29 @@
 #include <xswl/youdidit/core/task.hpp>
 #include <xswl/youdidit/core/claimer.hpp>
 #include <xswl/youdidit/core/task_builder.hpp>
+#include <xswl/youdidit/core/latency_histogram.hpp>
 #include <xswl/signals.hpp>
 #include <memory>
 #include <string>
 #include <vector>
 #include <map>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 
 namespace xswl {
 namespace youdidit {
 
+/**
+ * @brief 生命周期批量订阅选项
+ */
+struct LifecycleBatchOptions {
+    std::size_t max_batch_size = 256;                    ///< 攒满该数量立即投递（单批最多该数量）
+    std::chrono::milliseconds flush_interval{100};       ///< 未攒满时的最长等待时间
+    std::size_t max_pending = 65536;                     ///< 待投递记录上限，超出时丢弃新记录并计数；0 表示不限
+};
+
 class TaskPlatform : public std::enable_shared_from_this<TaskPlatform> {
 public:
     // ========== 构造与析构 ==========
@@ -34,8 +47,27 @@ public:
     TaskPlatform &set_max_task_queue_size(size_t size);
     size_t max_task_queue_size() const noexcept;
 
+    /**
+     * @brief 设置异步信号分发器（传入 nullptr 恢复同步触发）
+     * @note 同时应用于已有任务/申领者，以及之后发布的任务和注册的申领者；平台只弱引用分发器
+     */
+    TaskPlatform &set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher);
+    std::shared_ptr<SignalDispatcher> signal_dispatcher() const;
+
+    /**
+     * @brief 设置平台级进度信号合并策略
+     * @note 立即应用于已有任务；之后发布的任务在策略启用时继承该策略
+     */
+    TaskPlatform &set_progress_coalescing(const ProgressCoalescing &coalescing);
+    ProgressCoalescing progress_coalescing() const;
+
     // ========== 任务管理 ==========
     tl::expected<TaskId, Error> publish_task(const std::shared_ptr<Task> &task);
+    /**
+     * @brief 批量发布任务：整批只获取一次任务表锁，其余步骤与 publish_task 相同
+     * @return 与 tasks 一一对应的结果；队列上限在批内逐个检查，达到上限后其余任务返回 PLATFORM_QUEUE_FULL
+     */
+    std::vector<tl::expected<TaskId, Error>> publish_tasks(const std::vector<std::shared_ptr<Task>> &tasks);
     tl::expected<TaskId, Error> create_and_publish_task(const std::function<void(TaskBuilder &)> &configurator);
 
     std::shared_ptr<Task> get_task(const TaskId &task_id) const;
@@ -61,6 +93,67 @@ public:
     };
 
     std::vector<std::shared_ptr<Task>> get_tasks(const TaskFilter &filter = {}) const;
+
+    /**
+     * @brief 分页查询的排序字段（相同值再按任务 ID 排序，保证顺序稳定）
+     */
+    enum class TaskSortKey {
+        Id,
+        PublishedAt,
+        Priority
+    };
+
+    struct TaskQuery {
+        TaskFilter filter;
+        TaskSortKey sort_by = TaskSortKey::Id;
+        bool descending = false;
+        size_t limit = 100;     ///< 每页最多返回的任务数（0 视为 1）
+        std::string cursor;     ///< 上一页返回的 next_cursor，空表示第一页
+    };
+
+    struct TaskPage {
+        std::vector<std::shared_ptr<const TaskView>> tasks;
+        std::string next_cursor;  ///< 为空表示没有更多数据
+    };
+
+    /**
+     * @brief 按条件分页查询任务快照
+     *
+     * 游标记录上一页最后一项的 (排序值, 任务 ID)，下一页从其后继续，翻页期间增删任务不会导致重复或遗漏已存在的项。
+     * 按 ID 排序时沿任务表顺序扫描并在凑满一页后停止；按其他字段排序时扫描全部任务但只保留 limit 项。
+     * 扫描分段进行，每段只短暂持有任务表锁，不复制完整任务列表。
+     * @return 游标无法解析或与排序方式不一致时返回 PLATFORM_INVALID_CURSOR
+     */
+    tl::expected<TaskPage, Error> query_tasks(const TaskQuery &query) const;
+
+    // ========== 增量同步 ==========
+    /**
+     * @brief 自某个变更序号以来的增量
+     */
+    struct ChangeSet {
+        std::uint64_t sequence = 0;                   ///< 下一次调用使用的 since
+        bool has_more = false;                        ///< 超过 limit，需以 sequence 继续获取
+        bool reset = false;                           ///< since 早于已丢弃的墓碑，删除信息不完整，需全量同步
+        std::vector<std::shared_ptr<Task>> tasks;     ///< 新增或修改的任务（每个任务只出现一次）
+        std::vector<TaskId> removed_task_ids;         ///< 已删除任务的墓碑
+        std::vector<std::string> changed_claimer_ids; ///< 注册或负载变化的申领者
+        std::vector<std::string> removed_claimer_ids; ///< 已注销的申领者
+    };
+
+    /**
+     * @brief 当前变更序号
+     *
+     * 平台维护单调递增的变更序号，在发布、状态转换、删除任务以及注册/注销申领者时递增；
+     * 每个任务记录最近一次修改的序号（Task::change_sequence()）。序号是一个原子计数器；
+     * 状态转换只在按线程分片的缓冲区中登记，不经过全局锁，索引在读取变更或删除条目时批量更新。
+     */
+    std::uint64_t change_sequence() const;
+
+    /**
+     * @brief 获取序号大于 since 的变更（按序号升序，至多 limit 项）
+     * @note 代价与变更数量成正比，与任务总数无关；同一对象多次修改只返回最新一次
+     */
+    ChangeSet get_changes_since(std::uint64_t since, size_t limit = 1000) const;
     std::vector<std::shared_ptr<Task>> get_published_tasks() const;
     std::vector<std::shared_ptr<Task>> get_tasks_by_status(TaskStatus status) const;
     std::vector<std::shared_ptr<Task>> get_tasks_by_category(const std::string &category) const;
@@ -118,6 +211,74 @@ public:
 
     PlatformStatistics get_statistics() const;
 
+    /**
+     * @brief 获取平台近似内存占用（O(1)，增量维护，不遍历任务）
+     * @return 组件 "tasks" / "task_metadata" / "task_handlers" / "task_index" / "claimer_index" 的字节数
+     * @note 申领者自身的占用请使用 Claimer::memory_usage()
+     */
+    MemoryUsage memory_usage() const;
+
+    /**
+     * @brief 一组 (分类, 申领者) 的各阶段延迟分布
+     */
+    struct LatencySeries {
+        std::string category;
+        std::string claimer_id;
+        LatencyHistogram::Snapshot stages[kLatencyStageCount];   ///< 以 LatencyStage 为下标
+
+        const LatencyHistogram::Snapshot &stage(LatencyStage s) const {
+            return stages[static_cast<std::size_t>(s)];
+        }
+    };
+
+    /**
+     * @brief 合并各线程分片后的延迟直方图
+     *
+     * 已发布任务每次进入 Claimed（发布→申领）、从 Claimed 进入 Processing（申领→开始）以及
+     * 进入 Completed（开始→完成、发布→完成）时，在转换线程上按 (分类, 申领者) 记录一次样本，
+     * 记录路径无锁。分组内计数单调递增；申领者注销时删除其分组。分组总数上限见 set_max_latency_series()，
+     * 达到上限后新的 (分类, 申领者) 组合一律记入 category、claimer_id 均为 "*" 的溢出分组。
+     * 每个分组的四个阶段各用 2 个记录分片，单个分组最多约 38KB。
+     */
+    std::vector<LatencySeries> latency_histograms() const;
+
+    /**
+     * @brief 设置延迟分组数上限（含溢出分组，默认 256，最小 1）
+     * @note 调低上限不删除已有分组，只让之后出现的新组合进入溢出分组
+     */
+    TaskPlatform &set_max_latency_series(size_t count);
+    size_t max_latency_series() const noexcept;
+
+    // ========== 生命周期批量订阅 ==========
+    using LifecycleBatchHandler = std::function<void(const std::vector<TaskLifecycleRecord> &)>;
+
+    /**
+     * @brief 订阅已发布任务的状态转换批次
+     * @param handler 在订阅专属的后台线程上调用，每次收到按发生顺序排列的一批记录；
+     *                任务被删除时另有一条 removed 为 true 的记录
+     * @param options 批大小与刷新间隔
+     * @return 订阅 ID（用于取消订阅）
+     * @note 批次在攒满 max_batch_size 或距上次投递超过 flush_interval 时投递
+     */
+    std::uint64_t subscribe_lifecycle_batches(LifecycleBatchHandler handler,
+                                              const LifecycleBatchOptions &options = LifecycleBatchOptions());
+
+    /**
+     * @brief 取消订阅（投递剩余记录并停止后台线程）
+     */
+    bool unsubscribe_lifecycle_batches(std::uint64_t subscription_id);
+
+    /**
+     * @brief 立即在调用线程上投递所有订阅中待发送的记录
+     * @note 在处理函数内调用时跳过该处理函数所属的订阅（其剩余记录在本次投递之后送达）
+     */
+    void flush_lifecycle_batches();
+
+    /**
+     * @brief 订阅因待投递记录达到 max_pending 而丢弃的记录数（订阅不存在时返回 0）
+     */
+    std::uint64_t lifecycle_batch_dropped(std::uint64_t subscription_id) const;
+
     // ========== 信号 ==========
     xswl::signal_t<const std::shared_ptr<Task>&> sig_task_published;
     xswl::signal_t<const std::shared_ptr<Task>&> sig_task_claimed;
@@ -144,6 +305,12 @@ private:
 
     // 私有删除辅助方法（供内部统一调用）
     bool _delete_task_internal(const TaskId &task_id, bool force = false);
+    // 入表之后的发布步骤（挂接分发器、转为 Published、登记变更、发出 sig_task_published）
+    tl::expected<TaskId, Error> _finish_publish(const std::shared_ptr<Task> &task);
+    // 申领的实现（公开方法在外层包裹追踪 span）
+    tl::expected<std::shared_ptr<Task>, Error> _claim_task(const std::shared_ptr<Claimer> &claimer, const TaskId &task_id);
+    tl::expected<std::shared_ptr<Task>, Error> _claim_next_task(const std::shared_ptr<Claimer> &claimer);
+    tl::expected<std::shared_ptr<Task>, Error> _claim_matching_task(const std::shared_ptr<Claimer> &claimer);
 };
 
 } // namespace youdidit
@@ -0,0 +1,204 @@
+#ifndef XSWL_YOUDIDIT_CORE_TRACING_HPP
+#define XSWL_YOUDIDIT_CORE_TRACING_HPP
+
+#include <xswl/youdidit/core/types.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// CMake 选项 XSWL_YOUDIDIT_ENABLE_TRACING=OFF 时定义为 0：所有埋点编译为空操作
+#ifndef XSWL_YOUDIDIT_ENABLE_TRACING
+#define XSWL_YOUDIDIT_ENABLE_TRACING 1
+#endif
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 追踪器接口（OpenTelemetry 风格的 span 开始/结束钩子）
+ *
+ * 埋点位置：TaskPlatform::publish_task / publish_tasks、claim_task / claim_next_task / claim_matching_task /
+ * claim_tasks_to_capacity，Task::execute、complete / fail / abandon。
+ * 同一线程上嵌套的 span 通过 parent_id 关联（如 claim_next_task 内的 claim_task、execute 内的 complete）。
+ *
+ * 钩子在业务线程上同步调用，实现必须线程安全、快速且不抛异常；接入 OpenTelemetry 等系统时，
+ * 由适配器在 begin_span 中创建对应的 span 并在 end_span 中结束。
+ */
+class Tracer {
+public:
+    virtual ~Tracer() = default;
+
+    /**
+     * @param name span 名称（静态字符串，如 "task.execute"）
+     * @param parent_id 同一线程上外层 span 的 ID，没有时为 0
+     * @param task_id 相关任务，开始时尚不确定（如 claim_next_task）时为空
+     * @param claimer_id 相关申领者，可能为空
+     * @return span ID，原样传给 end_span；返回 0 表示不追踪该 span
+     */
+    virtual std::uint64_t begin_span(const char *name, std::uint64_t parent_id, const std::string &task_id,
+                                     const std::string &claimer_id) noexcept = 0;
+
+    /**
+     * @param task_id 结束时才确定的任务（如申领到的任务），否则为空
+     * @param error 失败原因，成功时为空
+     */
+    virtual void end_span(std::uint64_t span_id, const std::string &task_id, const std::string &error) noexcept = 0;
+};
+
+/**
+ * @brief 设置全局追踪器（nullptr 关闭追踪）
+ * @note 未设置时每个埋点只有一次原子读取；编译时关闭追踪后设置不产生任何 span
+ */
+void set_tracer(std::shared_ptr<Tracer> tracer);
+std::shared_ptr<Tracer> get_tracer();
+
+/**
+ * @brief 本构建是否编译了追踪埋点
+ */
+constexpr bool tracing_compiled_in() noexcept {
+    return XSWL_YOUDIDIT_ENABLE_TRACING != 0;
+}
+
+namespace detail {
+extern std::atomic<bool> g_tracer_installed;
+}
+
+/**
+ * @brief 作用域 span：构造时开始、析构时结束
+ *
+ * 未设置追踪器时只做一次原子读取，不分配内存；编译时关闭追踪后是空对象。
+ * 也可用于在处理函数内标注自己的子阶段。
+ */
+class ScopedSpan {
+public:
+#if XSWL_YOUDIDIT_ENABLE_TRACING
+    explicit ScopedSpan(const char *name) {
+        if (detail::g_tracer_installed.load(std::memory_order_relaxed)) {
+            _begin(name, nullptr, nullptr);
+        }
+    }
+
+    ScopedSpan(const char *name, const std::string &task_id) {
+        if (detail::g_tracer_installed.load(std::memory_order_relaxed)) {
+            _begin(name, &task_id, nullptr);
+        }
+    }
+
+    ScopedSpan(const char *name, const std::string &task_id, const std::string &claimer_id) {
+        if (detail::g_tracer_installed.load(std::memory_order_relaxed)) {
+            _begin(name, &task_id, &claimer_id);
+        }
+    }
+
+    ~ScopedSpan() noexcept {
+        if (state_) {
+            _end();
+        }
+    }
+
+    void set_task_id(const std::string &task_id);
+    void set_error(const std::string &error);
+#else
+    explicit ScopedSpan(const char *) noexcept {}
+    ScopedSpan(const char *, const std::string &) noexcept {}
+    ScopedSpan(const char *, const std::string &, const std::string &) noexcept {}
+
+    void set_task_id(const std::string &) noexcept {}
+    void set_error(const std::string &) noexcept {}
+#endif
+
+    ScopedSpan(const ScopedSpan &) = delete;
+    ScopedSpan &operator=(const ScopedSpan &) = delete;
+
+    /**
+     * @brief 失败的结果把错误信息记入 span，原样返回结果
+     */
+    template <typename T>
+    tl::expected<T, Error> record(tl::expected<T, Error> result) {
+        if (!result.has_value()) {
+            set_error(result.error().message);
+        }
+        return result;
+    }
+
+    TaskResult record(TaskResult result) {
+        if (!result.ok()) {
+            set_error(result.error.message);
+        }
+        return result;
+    }
+
+private:
+#if XSWL_YOUDIDIT_ENABLE_TRACING
+    struct State;
+
+    void _begin(const char *name, const std::string *task_id, const std::string *claimer_id);
+    void _end() noexcept;
+
+    State *state_ = nullptr;   // 只在追踪器开始了该 span 时分配，由 _end() 释放
+#endif
+};
+
+/**
+ * @brief 一个已结束的 span
+ */
+struct SpanRecord {
+    std::uint64_t span_id = 0;
+    std::uint64_t parent_id = 0;
+    std::string name;
+    std::string task_id;      ///< 开始时的任务 ID，结束时给出的任务 ID 优先
+    std::string claimer_id;
+    std::string error;        ///< 为空表示成功
+    Timestamp start_time;
+    std::chrono::nanoseconds duration{0};
+
+    bool ok() const noexcept { return error.empty(); }
+};
+
+/**
+ * @brief 内置的内存导出器（用于测试与调试）
+ *
+ * 按结束顺序保存最近 capacity 个 span，超出时丢弃最早的并计数。
+ */
+class InMemoryTracer : public Tracer {
+public:
+    explicit InMemoryTracer(std::size_t capacity = 65536);
+    ~InMemoryTracer() noexcept override;
+
+    InMemoryTracer(const InMemoryTracer &) = delete;
+    InMemoryTracer &operator=(const InMemoryTracer &) = delete;
+
+    std::uint64_t begin_span(const char *name, std::uint64_t parent_id, const std::string &task_id,
+                             const std::string &claimer_id) noexcept override;
+    void end_span(std::uint64_t span_id, const std::string &task_id, const std::string &error) noexcept override;
+
+    /**
+     * @brief 已结束的 span（按结束顺序）
+     */
+    std::vector<SpanRecord> spans() const;
+
+    /**
+     * @brief 已开始但尚未结束的 span 数
+     */
+    std::size_t open_span_count() const;
+
+    /**
+     * @brief 因超出容量被丢弃的 span 数
+     */
+    std::uint64_t dropped() const;
+
+    void clear();
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> d;
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_CORE_TRACING_HPP
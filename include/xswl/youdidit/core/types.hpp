@@ -13,6 +13,8 @@
 #include <string>
 #include <map>
 #include <chrono>
+#include <cstddef>
+#include <memory>
 
 namespace xswl {
 namespace youdidit {
@@ -151,7 +153,14 @@ enum class ErrorCode {
     
     // 平台相关错误 (3001-3999)
     PLATFORM_QUEUE_FULL = 3001,       ///< 平台任务队列已满
-    PLATFORM_NO_AVAILABLE_TASK = 3002 ///< 没有可申领的任务
+    PLATFORM_NO_AVAILABLE_TASK = 3002, ///< 没有可申领的任务
+    PLATFORM_INVALID_CURSOR = 3003,   ///< 分页游标无效或与查询不匹配
+
+    // 存储相关错误 (4001-4999)
+    STORAGE_IO_FAILED = 4001,         ///< 持久化文件读写失败
+
+    // 网络相关错误 (5001-5999)
+    NETWORK_BIND_FAILED = 5001        ///< 无法绑定监听地址或端口
 };
 
 /**
@@ -189,6 +198,47 @@ struct Error {
     int code_value() const noexcept { return to_int(code); }
 };
 
+/**
+ * @brief 共享只读负载缓冲区
+ *
+ * 以引用计数方式共享一段不可变数据，复制 Payload 只增加引用计数而不复制内容，
+ * 用于在 run_task / execute / complete 与信号之间传递大块输入输出数据。
+ */
+class Payload {
+public:
+    /**
+     * @brief 构造空负载
+     */
+    Payload() noexcept = default;
+
+    /**
+     * @brief 接管字符串内容（传入右值时不复制）
+     */
+    explicit Payload(std::string data);
+
+    /**
+     * @brief 从原始内存复制一次构造
+     */
+    Payload(const char *data, std::size_t size);
+
+    /**
+     * @brief 以 std::string 形式访问内容（空负载返回空串）
+     */
+    const std::string &str() const noexcept;
+
+    const char *data() const noexcept { return str().data(); }
+    std::size_t size() const noexcept { return data_ ? data_->size() : 0; }
+    bool empty() const noexcept { return size() == 0; }
+
+    /**
+     * @brief 当前共享该缓冲区的 Payload 数量（空负载为 0）
+     */
+    long use_count() const noexcept { return data_.use_count(); }
+
+private:
+    std::shared_ptr<const std::string> data_;
+};
+
 /**
  * @brief 任务执行结果
  *
@@ -197,6 +247,7 @@ struct Error {
 struct TaskResult {
     std::string summary;                             ///< 结果摘要
     std::string output;                              ///< 输出数据（自由文本，推荐序列化为 JSON 或类似格式）
+    Payload payload;                                 ///< 大块输出数据（共享只读，复制 TaskResult 时不复制内容）
     Error error{ "", ErrorCode::SUCCESS };           ///< 失败时的错误信息（ErrorCode::SUCCESS 表示成功）
 
     /**
@@ -222,6 +273,37 @@ struct TaskResult {
      * @brief 检查是否成功
      */
     bool ok() const noexcept { return error.code == ErrorCode::SUCCESS; }
+
+    /**
+     * @brief 获取输出数据：设置了 payload 时返回其内容，否则返回 output
+     */
+    const std::string &output_data() const noexcept { return payload.empty() ? output : payload.str(); }
+};
+
+/**
+ * @brief 内存占用明细（近似字节数）
+ *
+ * 由 TaskPlatform / Claimer / EventLog 的 memory_usage() 返回。各组件的字节数均为增量维护的
+ * 估算值（对象本身 + 字符串堆内存 + 容器节点开销），不包含分配器内部开销，也无法计入
+ * std::function 捕获的堆内存，仅用于容量规划与队列上限估算。
+ */
+struct MemoryUsage {
+    std::map<std::string, std::size_t> components;  ///< 组件名 -> 近似字节数
+
+    /**
+     * @brief 所有组件字节数之和
+     */
+    std::size_t total_bytes() const noexcept;
+
+    /**
+     * @brief 估算字符串的堆内存字节数（短字符串优化范围内视为 0）
+     */
+    static std::size_t string_bytes(const std::string &str) noexcept;
+
+    /**
+     * @brief 估算 std::map / std::set 单个节点的字节数（红黑树节点头 + 负载）
+     */
+    static std::size_t tree_node_bytes(std::size_t payload) noexcept;
 };
 
 } // namespace youdidit
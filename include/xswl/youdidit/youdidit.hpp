@@ -16,6 +16,8 @@
 #include <xswl/youdidit/core/task_builder.hpp>
 #include <xswl/youdidit/core/claimer.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/tracing.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
 
 /**
  * @namespace xswl
@@ -1,9 +1,11 @@
 #include <xswl/youdidit/core/claimer.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
 #include <algorithm>
 #include <mutex>
 #include <atomic>
 #include <cstdint>
+#include <functional>
 
 namespace xswl {
 namespace youdidit {
@@ -16,6 +18,32 @@ namespace {
     }
 }
 
+// ========== ClaimerCapabilities ==========
+std::uint64_t ClaimerCapabilities::bit_of(const std::string &name) noexcept {
+    return std::uint64_t(1) << (std::hash<std::string>()(name) % 64);
+}
+
+bool ClaimerCapabilities::has_role(const std::string &role) const {
+    if ((role_mask & bit_of(role)) == 0) {
+        return false;
+    }
+    return roles.find(role) != roles.end();
+}
+
+bool ClaimerCapabilities::has_category(const std::string &category) const {
+    if ((category_mask & bit_of(category)) == 0) {
+        return false;
+    }
+    return categories.find(category) != categories.end();
+}
+
+bool ClaimerCapabilities::accepts_category(const std::string &category) const {
+    if (category.empty() || categories.empty()) {
+        return true;
+    }
+    return has_category(category);
+}
+
 // ========== 内部实现类 ==========
 class Claimer::Impl {
 public:
@@ -27,9 +55,8 @@ public:
     std::atomic<int> max_concurrent_tasks_;
     std::atomic<int> claimed_task_count_;
     
-    // 角色和分类
-    std::set<std::string> roles_;
-    std::set<std::string> categories_;
+    // 角色和分类（不可变快照，仅通过 std::atomic_load/atomic_store 访问；写入方持有 data_mutex_）
+    std::shared_ptr<const ClaimerCapabilities> capabilities_;
     
     // 已申领的任务
     std::map<TaskId, std::shared_ptr<Task>> claimed_tasks_;
@@ -45,9 +72,18 @@ public:
     
     // 平台关联
     TaskPlatform* platform_;
+
+    // 可选的异步信号分发器
+    SignalDispatcherRef signal_dispatcher_;
+
+    // 内存记账（近似字节数，写入方持有 data_mutex_）
+    std::atomic<std::size_t> base_bytes_;
+    std::atomic<std::size_t> capabilities_bytes_;
+    std::atomic<std::size_t> claimed_index_bytes_;
+    std::atomic<std::size_t> executing_index_bytes_;
     
     // 线程同步
-    mutable std::mutex data_mutex_;
+    mutable ProfiledMutex data_mutex_{LockSite::ClaimerData};
     
     explicit Impl(const std::string &id, const std::string &name)
         : id_(id),
@@ -56,11 +92,73 @@ public:
           offline_(false),
           max_concurrent_tasks_(5),
           claimed_task_count_(0),
+          capabilities_(std::make_shared<ClaimerCapabilities>()),
           total_claimed_(0u),
           total_completed_(0u),
           total_failed_(0u),
           total_abandoned_(0u),
-          platform_(nullptr) {}
+          platform_(nullptr),
+          base_bytes_(sizeof(Claimer) + sizeof(Impl) +
+                      MemoryUsage::string_bytes(id_) + MemoryUsage::string_bytes(name_)),
+          capabilities_bytes_(sizeof(ClaimerCapabilities)),
+          claimed_index_bytes_(0),
+          executing_index_bytes_(0) {}
+
+    static std::size_t claimed_node_bytes(const TaskId &task_id) {
+        return MemoryUsage::tree_node_bytes(sizeof(std::pair<const TaskId, std::shared_ptr<Task>>)) +
+               MemoryUsage::string_bytes(task_id);
+    }
+
+    static std::size_t executing_node_bytes(const TaskId &task_id) {
+        return MemoryUsage::tree_node_bytes(sizeof(TaskId)) + MemoryUsage::string_bytes(task_id);
+    }
+
+    static std::size_t capabilities_bytes(const ClaimerCapabilities &caps) {
+        std::size_t bytes = sizeof(ClaimerCapabilities);
+        for (const auto &role : caps.roles) {
+            bytes += MemoryUsage::tree_node_bytes(sizeof(std::string)) + MemoryUsage::string_bytes(role);
+        }
+        for (const auto &category : caps.categories) {
+            bytes += MemoryUsage::tree_node_bytes(sizeof(std::string)) + MemoryUsage::string_bytes(category);
+        }
+        return bytes;
+    }
+
+    // 从已申领列表移除任务（调用方需持有 data_mutex_），返回是否确实移除
+    bool erase_claimed(const TaskId &task_id) {
+        auto it = claimed_tasks_.find(task_id);
+        if (it == claimed_tasks_.end()) {
+            return false;
+        }
+        claimed_index_bytes_.fetch_sub(claimed_node_bytes(it->first), std::memory_order_relaxed);
+        claimed_tasks_.erase(it);
+        claimed_task_count_.fetch_sub(1, std::memory_order_acq_rel);
+        return true;
+    }
+
+    std::shared_ptr<const ClaimerCapabilities> load_capabilities() const {
+        return std::atomic_load(&capabilities_);
+    }
+
+    // 复制当前快照、应用修改并原子替换（调用方需持有 data_mutex_ 以串行化写入）
+    template<typename Mutator>
+    void update_capabilities(Mutator mutate) {
+        auto next = std::make_shared<ClaimerCapabilities>(*load_capabilities());
+        if (!mutate(*next)) {
+            return;
+        }
+        next->role_mask = 0;
+        for (const auto &role : next->roles) {
+            next->role_mask |= ClaimerCapabilities::bit_of(role);
+        }
+        next->category_mask = 0;
+        for (const auto &category : next->categories) {
+            next->category_mask |= ClaimerCapabilities::bit_of(category);
+        }
+        next->version += 1;
+        capabilities_bytes_.store(capabilities_bytes(*next), std::memory_order_relaxed);
+        std::atomic_store(&capabilities_, std::shared_ptr<const ClaimerCapabilities>(std::move(next)));
+    }
     
     // 计算当前状态（返回描述性结构）
     ClaimerState calculate_state() const noexcept {
@@ -89,7 +187,7 @@ const std::string &Claimer::id() const noexcept {
 }
 
 std::string Claimer::name() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->name_;  // 返回副本，线程安全
 }
 
@@ -106,17 +204,23 @@ int Claimer::claimed_task_count() const noexcept {
 }
 
 std::set<std::string> Claimer::roles() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    return d->roles_;
+    return d->load_capabilities()->roles;
 }
 
 std::set<std::string> Claimer::categories() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    return d->categories_;
+    return d->load_capabilities()->categories;
+}
+
+std::shared_ptr<const ClaimerCapabilities> Claimer::capabilities() const {
+    return d->load_capabilities();
+}
+
+std::uint64_t Claimer::capabilities_version() const {
+    return d->load_capabilities()->version;
 }
 
 std::vector<std::shared_ptr<Task>> Claimer::claimed_tasks() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     std::vector<std::shared_ptr<Task>> tasks;
     for (const auto &pair : d->claimed_tasks_) {
         tasks.push_back(pair.second);
@@ -125,7 +229,7 @@ std::vector<std::shared_ptr<Task>> Claimer::claimed_tasks() const {
 }
 
 std::vector<std::shared_ptr<Task>> Claimer::active_tasks() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     std::vector<std::shared_ptr<Task>> tasks;
     for (const auto &pair : d->claimed_tasks_) {
         TaskStatus status = pair.second->status();
@@ -154,10 +258,21 @@ std::uint64_t Claimer::total_abandoned() const noexcept {
     return d->total_abandoned_.load(std::memory_order_acquire);
 }
 
+MemoryUsage Claimer::memory_usage() const {
+    MemoryUsage usage;
+    usage.components["claimer"] = d->base_bytes_.load(std::memory_order_relaxed);
+    usage.components["capabilities"] = d->capabilities_bytes_.load(std::memory_order_relaxed);
+    usage.components["claimed_tasks"] = d->claimed_index_bytes_.load(std::memory_order_relaxed);
+    usage.components["executing_tasks"] = d->executing_index_bytes_.load(std::memory_order_relaxed);
+    return usage;
+}
+
 // ========== 基本属性 Setter ==========
 Claimer &Claimer::set_name(const std::string &name) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->base_bytes_.fetch_sub(MemoryUsage::string_bytes(d->name_), std::memory_order_relaxed);
     d->name_ = name;
+    d->base_bytes_.fetch_add(MemoryUsage::string_bytes(d->name_), std::memory_order_relaxed);
     return *this;
 }
 
@@ -169,7 +284,7 @@ Claimer &Claimer::set_paused(bool paused) {
     }
     ClaimerState new_state = status();
     if (!(old_state == new_state)) {
-        emit sig_status_changed(*this, old_state, new_state);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_status_changed, std::ref(*this), old_state, new_state);
     }
     return *this;
 }
@@ -182,7 +297,7 @@ Claimer &Claimer::set_offline(bool offline) {
     }
     ClaimerState new_state = status();
     if (!(old_state == new_state)) {
-        emit sig_status_changed(*this, old_state, new_state);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_status_changed, std::ref(*this), old_state, new_state);
     }
     return *this;
 }
@@ -193,32 +308,40 @@ Claimer &Claimer::set_max_concurrent(int max_concurrent) {
     ClaimerState new_state = status();
     // 修改并发数可能会改变 Idle/Busy 状态
     if (!(old_state == new_state)) {
-        emit sig_status_changed(*this, old_state, new_state);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_status_changed, std::ref(*this), old_state, new_state);
     }
     return *this;
 }
 
 Claimer &Claimer::add_role(const std::string &role) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->roles_.insert(role);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->update_capabilities([&](ClaimerCapabilities &caps) {
+        return caps.roles.insert(role).second;
+    });
     return *this;
 }
 
 Claimer &Claimer::remove_role(const std::string &role) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->roles_.erase(role);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->update_capabilities([&](ClaimerCapabilities &caps) {
+        return caps.roles.erase(role) > 0;
+    });
     return *this;
 }
 
 Claimer &Claimer::add_category(const std::string &category) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->categories_.insert(category);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->update_capabilities([&](ClaimerCapabilities &caps) {
+        return caps.categories.insert(category).second;
+    });
     return *this;
 }
 
 Claimer &Claimer::remove_category(const std::string &category) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->categories_.erase(category);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->update_capabilities([&](ClaimerCapabilities &caps) {
+        return caps.categories.erase(category) > 0;
+    });
     return *this;
 }
 
@@ -261,14 +384,20 @@ tl::expected<void, Error> Claimer::claim_task(std::shared_ptr<Task> task) {
     }
 
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        d->claimed_tasks_[task->id()] = task;
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        auto inserted = d->claimed_tasks_.insert(std::make_pair(task->id(), task));
+        if (inserted.second) {
+            d->claimed_index_bytes_.fetch_add(Impl::claimed_node_bytes(inserted.first->first),
+                                              std::memory_order_relaxed);
+        } else {
+            inserted.first->second = task;
+        }
         d->claimed_task_count_.fetch_add(1, std::memory_order_acq_rel);
         d->total_claimed_.fetch_add(1u, std::memory_order_acq_rel);
     }
     
     // 触发信号
-    emit sig_task_claimed(*this, task);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_task_claimed, std::ref(*this), task);
     
     return {};  // 返回 void，不是 task
 }
@@ -325,6 +454,14 @@ TaskResult Claimer::run_task(const TaskId &task_id, const std::string &input) {
     return run_task(task_opt.value(), input);
 }
 
+TaskResult Claimer::run_task(const TaskId &task_id, const Payload &input) {
+    return run_task(task_id, input.str());
+}
+
+TaskResult Claimer::run_task(std::shared_ptr<Task> task, const Payload &input) {
+    return run_task(std::move(task), input.str());
+}
+
 TaskResult Claimer::run_task(std::shared_ptr<Task> task, const std::string &input) {
     if (!task) {
         return Error("Task is null", ErrorCode::TASK_NOT_FOUND);
@@ -340,7 +477,7 @@ TaskResult Claimer::run_task(std::shared_ptr<Task> task, const std::string &inpu
     
     // ========== 并发保护：确保同一任务不会被多个线程同时执行 ==========
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
         // 检查任务是否已经在执行中
         if (d->executing_tasks_.find(task_id) != d->executing_tasks_.end()) {
             return Error("Task is already being executed by another thread", 
@@ -348,6 +485,7 @@ TaskResult Claimer::run_task(std::shared_ptr<Task> task, const std::string &inpu
         }
         // 标记任务为执行中
         d->executing_tasks_.insert(task_id);
+        d->executing_index_bytes_.fetch_add(Impl::executing_node_bytes(task_id), std::memory_order_relaxed);
     }
     
     // RAII 守卫：确保函数退出时自动清理执行标记
@@ -355,14 +493,17 @@ TaskResult Claimer::run_task(std::shared_ptr<Task> task, const std::string &inpu
         Claimer::Impl* impl;
         TaskId task_id;
         ~ExecutionGuard() {
-            std::lock_guard<std::mutex> lock(impl->data_mutex_);
-            impl->executing_tasks_.erase(task_id);
+            std::lock_guard<ProfiledMutex> lock(impl->data_mutex_);
+            if (impl->executing_tasks_.erase(task_id) > 0) {
+                impl->executing_index_bytes_.fetch_sub(Impl::executing_node_bytes(task_id),
+                                                       std::memory_order_relaxed);
+            }
         }
     };
     ExecutionGuard guard{d.get(), task_id};
     
     // 触发开始信号
-    emit sig_task_started(*this, task);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_task_started, std::ref(*this), task);
     
     // 执行任务
     TaskResult result = task->execute(input);
@@ -409,18 +550,13 @@ tl::expected<void, Error> Claimer::complete_task(const TaskId &task_id, const Ta
     // 从已申领任务列表中移除已完成的任务，并减少已申领任务计数（幂等）
     bool removed = false;
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        auto it = d->claimed_tasks_.find(task_id);
-        if (it != d->claimed_tasks_.end()) {
-            d->claimed_tasks_.erase(it);
-            d->claimed_task_count_.fetch_sub(1, std::memory_order_acq_rel);
-            removed = true;
-        }
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        removed = d->erase_claimed(task_id);
     }
 
     // 只有第一个成功移除任务的调用者负责触发 Claimer 层信号与统计更新
     if (removed && completed) {
-        emit sig_task_completed(*this, task, result);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_task_completed, std::ref(*this), task, result);
         _update_statistics(old_status, TaskStatus::Completed);
     }
 
@@ -442,18 +578,13 @@ tl::expected<void, Error> Claimer::abandon_task(const TaskId &task_id, const std
     // 尝试从已申领任务列表中移除，并减少已申领任务计数（幂等）
     bool removed = false;
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        auto it = d->claimed_tasks_.find(task_id);
-        if (it != d->claimed_tasks_.end()) {
-            d->claimed_tasks_.erase(it);
-            d->claimed_task_count_.fetch_sub(1, std::memory_order_acq_rel);
-            removed = true;
-        }
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        removed = d->erase_claimed(task_id);
     }
 
     // 只有第一个成功移除任务的调用者负责触发 Claimer 层信号与统计更新
     if (removed) {
-        emit sig_task_abandoned(*this, task, reason);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_task_abandoned, std::ref(*this), task, reason);
         _update_statistics(old_status, TaskStatus::Abandoned);
     }
 
@@ -507,12 +638,12 @@ bool Claimer::can_claim_more() const noexcept {
 }
 
 bool Claimer::has_task(const TaskId &task_id) const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->claimed_tasks_.find(task_id) != d->claimed_tasks_.end();
 }
 
 tl::optional<std::shared_ptr<Task>> Claimer::get_task(const TaskId &task_id) const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     auto it = d->claimed_tasks_.find(task_id);
     if (it != d->claimed_tasks_.end()) {
         return it->second;
@@ -524,53 +655,65 @@ int Claimer::calculate_match_score(const std::shared_ptr<Task> &task) const {
     if (!task) {
         return 0;
     }
+    return calculate_match_score(task, *d->load_capabilities());
+}
+
+int Claimer::calculate_match_score(const std::shared_ptr<Task> &task, const ClaimerCapabilities &caps) const {
+    if (!task) {
+        return 0;
+    }
     
     int score = 0;
     
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    
+    auto view = task->snapshot();
     
     // 分类匹配（50分）
-    if (!task->category().empty()) {
-        if (d->categories_.find(task->category()) != d->categories_.end()) {
+    if (!view->category.empty()) {
+        if (caps.has_category(view->category)) {
             score += 50;
         }
     }
     
     // 标签匹配（30分）
-    auto task_tags = task->tags();
     int matching_tags = 0;
-    for (const auto &tag : task_tags) {
+    for (const auto &tag : view->tags) {
         // 这里简化处理，假设标签和分类可以匹配
-        if (d->categories_.find(tag) != d->categories_.end()) {
+        if (caps.has_category(tag)) {
             matching_tags++;
         }
     }
-    if (!task_tags.empty()) {
-        score += (matching_tags * 30) / static_cast<int>(task_tags.size());
+    if (!view->tags.empty()) {
+        score += (matching_tags * 30) / static_cast<int>(view->tags.size());
     }
     
     // 优先级加成（20分）
     // 优先级越高，加成越多
-    score += (task->priority() * 20) / 100;
+    score += (view->priority * 20) / 100;
     
     return std::min(100, score);
 }
 
 // ========== 平台关联 ==========
 void Claimer::set_platform(TaskPlatform* platform) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     d->platform_ = platform;
 }
 
+Claimer &Claimer::set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher) {
+    d->signal_dispatcher_.reset(dispatcher);
+    return *this;
+}
+
+std::shared_ptr<SignalDispatcher> Claimer::signal_dispatcher() const {
+    return d->signal_dispatcher_.lock();
+}
+
 TaskPlatform* Claimer::platform() const noexcept {
     return d->platform_;
 }
 
 // ========== 私有辅助方法 ==========
 tl::expected<void, Error> Claimer::_check_claim_permission(const std::shared_ptr<Task> &task) const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    
     // 检查任务是否允许当前申领者
     if (!task->is_claimer_allowed(d->id_)) {
         return tl::make_unexpected(Error("Claimer is not allowed to claim this task", 
@@ -578,13 +721,9 @@ tl::expected<void, Error> Claimer::_check_claim_permission(const std::shared_ptr
     }
     
     // 检查分类匹配（如果任务有分类要求）
-    if (!task->category().empty()) {
-        if (!d->categories_.empty()) {
-            if (d->categories_.find(task->category()) == d->categories_.end()) {
-                return tl::make_unexpected(Error("Task category does not match claimer categories", 
-                                                 ErrorCode::TASK_CATEGORY_MISMATCH));
-            }
-        }
+    if (!d->load_capabilities()->accepts_category(task->category())) {
+        return tl::make_unexpected(Error("Task category does not match claimer categories", 
+                                         ErrorCode::TASK_CATEGORY_MISMATCH));
     }
     
     return {};
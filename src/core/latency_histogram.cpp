@@ -0,0 +1,203 @@
+#include <xswl/youdidit/core/latency_histogram.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <new>
+
+namespace xswl {
+namespace youdidit {
+
+const std::size_t LatencyHistogram::kSubBucketBits;
+const std::size_t LatencyHistogram::kSubBucketCount;
+const std::size_t LatencyHistogram::kMaxValueBits;
+const std::size_t LatencyHistogram::kBucketCount;
+const std::size_t LatencyHistogram::kMaxShards;
+
+namespace {
+
+// 最高有效位的位置（value > 0）
+inline unsigned highest_bit(std::uint64_t value) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63u - static_cast<unsigned>(__builtin_clzll(value));
+#else
+    unsigned bit = 0;
+    while (value >>= 1) {
+        ++bit;
+    }
+    return bit;
+#endif
+}
+
+// 每个线程固定使用一个分片槽位，槽位按线程首次记录的顺序轮流分配
+std::size_t thread_shard_slot() noexcept {
+    static std::atomic<std::size_t> next_slot{0};
+    thread_local std::size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % LatencyHistogram::kMaxShards;
+    return slot;
+}
+}
+
+// ========== Impl ==========
+class LatencyHistogram::Impl {
+public:
+    struct Shard {
+        std::atomic<std::uint64_t> buckets[LatencyHistogram::kBucketCount];
+        std::atomic<std::uint64_t> count;
+        std::atomic<std::uint64_t> sum;
+    };
+
+    explicit Impl(std::size_t shard_count) : shard_count_(shard_count) {
+        for (auto &shard : shards_) {
+            shard.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~Impl() {
+        for (auto &shard : shards_) {
+            delete shard.load(std::memory_order_relaxed);
+        }
+    }
+
+    Shard *shard_for_current_thread() noexcept {
+        std::atomic<Shard *> &slot = shards_[thread_shard_slot() % shard_count_];
+        Shard *shard = slot.load(std::memory_order_acquire);
+        if (shard) {
+            return shard;
+        }
+        // 值初始化使所有计数为 0
+        Shard *created = new (std::nothrow) Shard();
+        if (!created) {
+            return nullptr;
+        }
+        if (slot.compare_exchange_strong(shard, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return created;
+        }
+        delete created;  // 同一槽位的另一个线程已抢先分配
+        return shard;
+    }
+
+    const std::size_t shard_count_;
+    std::atomic<Shard *> shards_[LatencyHistogram::kMaxShards];   // 只使用前 shard_count_ 个
+};
+
+// ========== Snapshot ==========
+std::uint64_t LatencyHistogram::Snapshot::percentile(double q) const {
+    if (count == 0) {
+        return 0;
+    }
+    q = std::min(1.0, std::max(0.0, q));
+    std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * static_cast<double>(count)));
+    rank = std::max<std::uint64_t>(rank, 1);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return bucket_upper_bound(i) == std::numeric_limits<std::uint64_t>::max() ? bucket_lower_bound(i)
+                                                                                      : bucket_upper_bound(i) - 1;
+        }
+    }
+    return buckets.empty() ? 0 : bucket_lower_bound(buckets.size() - 1);
+}
+
+std::uint64_t LatencyHistogram::Snapshot::count_below(std::uint64_t limit) const {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < buckets.size() && bucket_lower_bound(i) < limit; ++i) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+void LatencyHistogram::Snapshot::merge(const Snapshot &other) {
+    if (other.buckets.size() > buckets.size()) {
+        buckets.resize(other.buckets.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum += other.sum;
+}
+
+// ========== LatencyHistogram ==========
+LatencyHistogram::LatencyHistogram(std::size_t shards)
+    : d(new Impl(std::min(kMaxShards, std::max<std::size_t>(1, shards)))) {}
+
+LatencyHistogram::~LatencyHistogram() noexcept = default;
+
+void LatencyHistogram::record(std::uint64_t micros) noexcept {
+    Impl::Shard *shard = d->shard_for_current_thread();
+    if (!shard) {
+        return;  // 内存不足时丢弃样本
+    }
+    shard->buckets[bucket_index(micros)].fetch_add(1, std::memory_order_relaxed);
+    shard->sum.fetch_add(micros, std::memory_order_relaxed);
+    shard->count.fetch_add(1, std::memory_order_relaxed);
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    Snapshot result;
+    std::vector<std::uint64_t> merged(kBucketCount, 0);
+    std::size_t used = 0;
+    for (const auto &slot : d->shards_) {
+        const Impl::Shard *shard = slot.load(std::memory_order_acquire);
+        if (!shard) {
+            continue;
+        }
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            std::uint64_t n = shard->buckets[i].load(std::memory_order_relaxed);
+            if (n != 0) {
+                merged[i] += n;
+                used = std::max(used, i + 1);
+            }
+        }
+        result.sum += shard->sum.load(std::memory_order_relaxed);
+    }
+    merged.resize(used);
+    // count 取自桶计数之和，与并发记录时各字段间的微小偏差无关
+    for (std::uint64_t n : merged) {
+        result.count += n;
+    }
+    result.buckets.swap(merged);
+    return result;
+}
+
+std::size_t LatencyHistogram::bucket_index(std::uint64_t micros) noexcept {
+    if (micros < kSubBucketCount) {
+        return static_cast<std::size_t>(micros);
+    }
+    if (micros >> kMaxValueBits) {
+        return kBucketCount - 1;
+    }
+    unsigned exponent = highest_bit(micros);
+    std::size_t mantissa = static_cast<std::size_t>(micros >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1);
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + mantissa;
+}
+
+std::uint64_t LatencyHistogram::bucket_lower_bound(std::size_t index) noexcept {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    std::size_t exponent = index / kSubBucketCount + kSubBucketBits - 1;
+    std::uint64_t mantissa = index % kSubBucketCount;
+    return (kSubBucketCount + mantissa) << (exponent - kSubBucketBits);
+}
+
+std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) noexcept {
+    if (index + 1 >= kBucketCount) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return bucket_lower_bound(index + 1);
+}
+
+const char *latency_stage_name(LatencyStage stage) noexcept {
+    switch (stage) {
+        case LatencyStage::QueueWait: return "queue_wait";
+        case LatencyStage::StartDelay: return "start_delay";
+        case LatencyStage::Run: return "run";
+        case LatencyStage::EndToEnd: return "end_to_end";
+    }
+    return "unknown";
+}
+
+} // namespace youdidit
+} // namespace xswl
@@ -0,0 +1,63 @@
+#include <xswl/youdidit/core/lock_profile.hpp>
+
+namespace xswl {
+namespace youdidit {
+
+namespace {
+const LockSite kLockSites[] = {LockSite::PlatformTasks, LockSite::PlatformClaimers, LockSite::ClaimerData,
+                               LockSite::TaskData};
+const std::size_t kLockSiteCount = sizeof(kLockSites) / sizeof(kLockSites[0]);
+
+struct LockProfile {
+    LatencyHistogram wait;
+    LatencyHistogram hold;
+};
+
+// 函数内静态对象：在静态初始化期间创建的任务也能安全记录
+LockProfile &profile(LockSite site) {
+    static LockProfile profiles[kLockSiteCount];
+    return profiles[static_cast<std::size_t>(site)];
+}
+}
+
+const char *lock_site_name(LockSite site) noexcept {
+    switch (site) {
+        case LockSite::PlatformTasks: return "platform.tasks";
+        case LockSite::PlatformClaimers: return "platform.claimers";
+        case LockSite::ClaimerData: return "claimer.data";
+        case LockSite::TaskData: return "task.data";
+    }
+    return "unknown";
+}
+
+std::vector<LockStatistics> lock_statistics() {
+    std::vector<LockStatistics> result;
+    if (!lock_profiling_compiled_in()) {
+        return result;
+    }
+    result.reserve(kLockSiteCount);
+    for (LockSite site : kLockSites) {
+        LockStatistics stats;
+        stats.site = site;
+        stats.name = lock_site_name(site);
+        stats.wait = profile(site).wait.snapshot();
+        stats.hold = profile(site).hold.snapshot();
+        stats.contended = stats.wait.count;
+        stats.acquisitions = stats.hold.count;
+        result.push_back(std::move(stats));
+    }
+    return result;
+}
+
+namespace detail {
+void record_lock_wait(LockSite site, std::uint64_t nanos) noexcept {
+    profile(site).wait.record(nanos);
+}
+
+void record_lock_hold(LockSite site, std::uint64_t nanos) noexcept {
+    profile(site).hold.record(nanos);
+}
+}
+
+} // namespace youdidit
+} // namespace xswl
@@ -0,0 +1,411 @@
+#include <xswl/youdidit/core/signal_dispatcher.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+// C++11 兼容的 make_unique 实现
+namespace {
+    template<typename T, typename... Args>
+    std::unique_ptr<T> make_unique_impl(Args&&... args) {
+        return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+    }
+
+    std::size_t round_up_pow2(std::size_t value) {
+        std::size_t result = 2;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    // 有界多生产者单消费者队列（每个槽位带序号，生产者通过 CAS 竞争写入位置，无锁）
+    class MpscRing {
+    public:
+        explicit MpscRing(std::size_t capacity)
+            : cells_(round_up_pow2(capacity)), mask_(cells_.size() - 1), enqueue_pos_(0), dequeue_pos_(0) {
+            for (std::size_t i = 0; i < cells_.size(); ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        bool try_push(std::function<void()> &fn) {
+            std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            Cell *cell;
+            for (;;) {
+                cell = &cells_[pos & mask_];
+                const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+                const std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;  // 队列已满
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->fn = std::move(fn);
+            cell->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        // 仅由唯一的消费者线程调用
+        bool try_pop(std::function<void()> &out) {
+            const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            Cell &cell = cells_[pos & mask_];
+            if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+                return false;
+            }
+            out = std::move(cell.fn);
+            cell.fn = nullptr;
+            cell.sequence.store(pos + mask_ + 1, std::memory_order_release);
+            dequeue_pos_.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        // 已分配的写入位置数（含尚未写完的槽位）
+        std::size_t pushed() const noexcept {
+            return enqueue_pos_.load(std::memory_order_acquire);
+        }
+
+        std::size_t capacity() const noexcept {
+            return mask_ + 1;
+        }
+
+        // 已出队的位置数（仅由消费者线程调用）
+        std::size_t popped() const noexcept {
+            return dequeue_pos_.load(std::memory_order_relaxed);
+        }
+
+        std::size_t size() const noexcept {
+            const std::size_t head = dequeue_pos_.load(std::memory_order_relaxed);
+            const std::size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+            return tail > head ? tail - head : 0;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence;
+            std::function<void()> fn;
+            Cell() : sequence(0) {}
+        };
+
+        std::vector<Cell> cells_;
+        const std::size_t mask_;
+        std::atomic<std::size_t> enqueue_pos_;
+        std::atomic<std::size_t> dequeue_pos_;
+    };
+}
+
+// ========== 内部实现类 ==========
+// 分发线程各持有一份 Impl 的 shared_ptr：最后一个引用在分发线程（槽函数）内释放时，
+// Impl 延后到最后一个分发线程退出时析构，不会销毁仍在运行的分片
+class SignalDispatcher::Impl : public std::enable_shared_from_this<SignalDispatcher::Impl> {
+public:
+    struct Shard {
+        MpscRing ring;
+        std::thread thread;
+        std::atomic<bool> sleeping;
+        std::atomic<std::uint64_t> enqueued;    // 成功入队数（统计用）
+        std::atomic<std::uint64_t> completed;   // 已出队并执行完的数量，与 ring 的写入位置对应
+        std::atomic<std::uint32_t> posting;     // 正在入队的生产者数：非 0 时分发线程不得退出
+        std::atomic<std::uint32_t> waiting;     // 因队列满（Block）而等待空位的生产者数
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+        std::mutex space_mutex;
+        std::condition_variable space_cv;
+
+        explicit Shard(std::size_t capacity)
+            : ring(capacity), sleeping(false), enqueued(0), completed(0), posting(0), waiting(0) {}
+    };
+
+    Options options_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<bool> stopping_;
+    std::mutex stop_mutex_;
+
+    std::atomic<std::uint64_t> dropped_;
+    std::atomic<std::uint64_t> caller_runs_;
+    std::atomic<std::uint64_t> slot_errors_;
+
+    // 当前线程所属的分发分片（非分发线程为 nullptr），用于避免槽函数内再次发射时自我阻塞
+    static thread_local Shard *current_shard_;
+
+    explicit Impl(const Options &options)
+        : options_(options), stopping_(false), dropped_(0), caller_runs_(0), slot_errors_(0) {
+        if (options_.dispatcher_threads == 0) {
+            options_.dispatcher_threads = 1;
+        }
+        if (options_.queue_capacity < 2) {
+            options_.queue_capacity = 2;
+        }
+        for (std::size_t i = 0; i < options_.dispatcher_threads; ++i) {
+            shards_.push_back(make_unique_impl<Shard>(options_.queue_capacity));
+        }
+    }
+
+    ~Impl() {
+        // 只可能在所有分发线程都已释放引用后执行；在分发线程上析构时分离自身
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            std::thread &thread = shards_[i]->thread;
+            if (!thread.joinable()) {
+                continue;
+            }
+            if (thread.get_id() == std::this_thread::get_id()) {
+                thread.detach();
+            } else {
+                thread.join();
+            }
+        }
+    }
+
+    void start() {
+        std::shared_ptr<Impl> self = shared_from_this();
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            Shard *shard = shards_[i].get();
+            shard->thread = std::thread([self, shard]() { self->run(*shard); });
+        }
+    }
+
+    // 当前线程是否为本分发器的分发线程
+    bool on_dispatcher_thread() const noexcept {
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            if (current_shard_ == shards_[i].get()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 在分发线程上执行本分片中位置早于 target 的事件（槽函数内调用 flush 时使用）；
+    // 以出队位置判断，正在执行的槽函数本身尚未计入 completed
+    void drain_inline(Shard &shard, std::size_t target) {
+        std::function<void()> fn;
+        while (shard.ring.popped() < target) {
+            if (!shard.ring.try_pop(fn)) {
+                std::this_thread::yield();  // 生产者已分配位置但尚未写完
+                continue;
+            }
+            invoke(fn);
+            fn = nullptr;
+            complete_one(shard);
+        }
+    }
+
+    Shard &shard_for(const void *key) {
+        // 地址低位因对齐几乎恒定，先做一次 64 位混合再取模
+        std::uint64_t h = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        return *shards_[static_cast<std::size_t>(h % shards_.size())];
+    }
+
+    void invoke(std::function<void()> &fn) {
+        try {
+            fn();
+        } catch (...) {
+            slot_errors_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void wake(Shard &shard) {
+        // 与 run() 中的栅栏配对：要么消费者看到新元素，要么生产者看到 sleeping 并唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(shard.wake_mutex);
+            shard.wake_cv.notify_one();
+        }
+    }
+
+    // 出队的事件执行完毕：计数并唤醒等待空位的生产者
+    void complete_one(Shard &shard) {
+        shard.completed.fetch_add(1, std::memory_order_release);
+        // 与 wait_for_space() 中的栅栏配对：要么生产者看到空位，要么这里看到 waiting 并唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.waiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(shard.space_mutex);
+            shard.space_cv.notify_all();
+        }
+    }
+
+    // Block 策略下队列满时等待分发线程腾出空位（或分发器停止），不占用 CPU 自旋
+    void wait_for_space(Shard &shard) {
+        shard.waiting.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        wake(shard);
+        {
+            std::unique_lock<std::mutex> lock(shard.space_mutex);
+            if (shard.ring.size() >= shard.ring.capacity() && !stopping_.load(std::memory_order_acquire)) {
+                shard.space_cv.wait_for(lock, std::chrono::milliseconds(10));
+            }
+        }
+        shard.waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void run(Shard &shard) {
+        current_shard_ = &shard;
+        std::function<void()> fn;
+        int idle_spins = 0;
+        for (;;) {
+            if (shard.ring.try_pop(fn)) {
+                idle_spins = 0;
+                invoke(fn);
+                fn = nullptr;
+                complete_one(shard);
+                continue;
+            }
+            // 与 post() 中 posting / stopping_ 的顺序一致性访问配对：读到 posting == 0 时，
+            // 所有看到 stopping_ == false 的生产者均已写完，队列为空即可退出
+            if (stopping_.load(std::memory_order_seq_cst) && shard.posting.load(std::memory_order_seq_cst) == 0 &&
+                shard.ring.size() == 0) {
+                break;
+            }
+            if (++idle_spins < 64) {
+                std::this_thread::yield();
+                continue;
+            }
+            // 进入睡眠前先声明 sleeping，再复查队列，避免与生产者的唤醒交错丢失
+            std::unique_lock<std::mutex> lock(shard.wake_mutex);
+            shard.sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (shard.ring.size() == 0 && !stopping_.load(std::memory_order_acquire)) {
+                shard.wake_cv.wait_for(lock, std::chrono::milliseconds(10));
+            }
+            shard.sleeping.store(false, std::memory_order_relaxed);
+            idle_spins = 0;
+        }
+        current_shard_ = nullptr;
+    }
+
+    void stop() {
+        stopping_.store(true, std::memory_order_seq_cst);
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            {
+                std::lock_guard<std::mutex> lock(shards_[i]->wake_mutex);
+                shards_[i]->wake_cv.notify_one();
+            }
+            std::lock_guard<std::mutex> lock(shards_[i]->space_mutex);
+            shards_[i]->space_cv.notify_all();
+        }
+        if (on_dispatcher_thread()) {
+            // 槽函数内停止：不能等待自身，分发线程排空队列后自行退出，由 ~Impl 回收
+            return;
+        }
+        std::lock_guard<std::mutex> guard(stop_mutex_);
+        for (std::size_t i = 0; i < shards_.size(); ++i) {
+            if (shards_[i]->thread.joinable()) {
+                shards_[i]->thread.join();
+            }
+        }
+    }
+};
+
+thread_local SignalDispatcher::Impl::Shard *SignalDispatcher::Impl::current_shard_ = nullptr;
+
+// ========== SignalDispatcher ==========
+SignalDispatcher::SignalDispatcher() : d(std::make_shared<Impl>(Options())) {
+    d->start();
+}
+
+SignalDispatcher::SignalDispatcher(const Options &options) : d(std::make_shared<Impl>(options)) {
+    d->start();
+}
+
+SignalDispatcher::~SignalDispatcher() noexcept {
+    d->stop();
+}
+
+bool SignalDispatcher::post(const void *key, std::function<void()> fn) {
+    if (!fn) {
+        return false;
+    }
+
+    Impl::Shard &shard = d->shard_for(key);
+    // 先登记为正在入队再检查 stopping_：分发线程在 posting 归零前不会退出，
+    // 因此检查通过后写入的事件一定会被投递
+    shard.posting.fetch_add(1, std::memory_order_seq_cst);
+    if (d->stopping_.load(std::memory_order_seq_cst)) {
+        shard.posting.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+    while (!shard.ring.try_push(fn)) {
+        if (d->options_.overflow_policy == OverflowPolicy::DropNewest ||
+            d->stopping_.load(std::memory_order_acquire)) {
+            shard.posting.fetch_sub(1, std::memory_order_release);
+            d->dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        // 分发线程不能等待任何分片腾出空位：自身分片会自锁，两个分发线程互相向对方的满队列发射会互锁
+        if (d->options_.overflow_policy == OverflowPolicy::CallerRuns || d->on_dispatcher_thread()) {
+            shard.posting.fetch_sub(1, std::memory_order_release);
+            d->caller_runs_.fetch_add(1, std::memory_order_relaxed);
+            d->invoke(fn);
+            return true;
+        }
+        d->wait_for_space(shard);
+    }
+    // 只统计成功入队的事件；flush() 以队列写入位置为准，不依赖该计数
+    shard.enqueued.fetch_add(1, std::memory_order_relaxed);
+    shard.posting.fetch_sub(1, std::memory_order_release);
+    d->wake(shard);
+    return true;
+}
+
+void SignalDispatcher::flush() {
+    if (d->on_dispatcher_thread()) {
+        // 槽函数内调用：等待其他分发线程可能与其互相等待，只就地执行本线程队列中已入队的事件
+        Impl::Shard &own = *Impl::current_shard_;
+        d->drain_inline(own, own.ring.pushed());
+        return;
+    }
+    for (std::size_t i = 0; i < d->shards_.size(); ++i) {
+        Impl::Shard &shard = *d->shards_[i];
+        // 写入位置与出队顺序一致：completed 达到 target 即表示此前分配的位置均已执行
+        const std::uint64_t target = shard.ring.pushed();
+        while (shard.completed.load(std::memory_order_acquire) < target) {
+            d->wake(shard);
+            std::this_thread::yield();
+        }
+    }
+}
+
+void SignalDispatcher::stop() {
+    d->stop();
+}
+
+std::size_t SignalDispatcher::pending() const noexcept {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < d->shards_.size(); ++i) {
+        total += d->shards_[i]->ring.size();
+    }
+    return total;
+}
+
+SignalDispatcher::Statistics SignalDispatcher::statistics() const noexcept {
+    Statistics stats{};
+    for (std::size_t i = 0; i < d->shards_.size(); ++i) {
+        stats.posted += d->shards_[i]->enqueued.load(std::memory_order_relaxed);
+        stats.delivered += d->shards_[i]->completed.load(std::memory_order_relaxed);
+    }
+    stats.dropped = d->dropped_.load(std::memory_order_relaxed);
+    stats.caller_runs = d->caller_runs_.load(std::memory_order_relaxed);
+    stats.slot_errors = d->slot_errors_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+const SignalDispatcher::Options &SignalDispatcher::options() const noexcept {
+    return d->options_;
+}
+
+} // namespace youdidit
+} // namespace xswl
@@ -1,7 +1,10 @@
 #include <xswl/youdidit/core/task.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
+#include <xswl/youdidit/core/tracing.hpp>
 #include <atomic>
 #include <mutex>
 #include <algorithm>
+#include <cstdlib>
 #include <sstream>
 
 // C++11 兼容的 make_unique 实现
@@ -53,8 +56,33 @@ public:
     // 自动清理标志（是否允许平台基于策略删除此任务）
     std::atomic<bool> auto_cleanup_{false};
 
+    // 内存记账（近似字节数；修改时需持有 data_mutex_）
+    std::atomic<std::int64_t> task_bytes_{0};
+    std::atomic<std::int64_t> metadata_bytes_{0};
+    std::atomic<std::int64_t> handler_bytes_{0};
+    std::shared_ptr<TaskMemoryAccount> memory_account_;
+
+    // 只读快照（写时复制）：字段变化时递增 version_，snapshot() 按需重建 view_
+    std::atomic<std::uint64_t> version_{0};
+    std::shared_ptr<const TaskView> view_;  // 仅通过 std::atomic_load/atomic_store 访问
+
+    // 平台分配的变更序号（发布、状态转换、删除）
+    std::atomic<std::uint64_t> change_sequence_{0};
+
+    // 可选的异步信号分发器
+    SignalDispatcherRef signal_dispatcher_;
+
+    // 状态转换接收器（仅通过 std::atomic_load/atomic_store 访问）
+    std::shared_ptr<TaskLifecycleSink> lifecycle_sink_;
+
+    // 进度信号合并：配置与最近一次发射的值/时间（steady_clock 纳秒）
+    std::atomic<std::int64_t> progress_min_interval_ms_{0};
+    std::atomic<int> progress_min_delta_{0};
+    std::atomic<int> last_emitted_progress_{0};
+    std::atomic<std::int64_t> last_progress_emit_ns_{0};
+
     // 线程同步
-    mutable std::mutex data_mutex_;
+    mutable ProfiledMutex data_mutex_{LockSite::TaskData};
     mutable std::mutex handler_mutex_;
     
     explicit Impl(const TaskId &id)
@@ -68,9 +96,20 @@ public:
           started_at_(0),
           completed_at_(0),
           cancel_requested_(false),
-          auto_cleanup_(false) {}
+          auto_cleanup_(false) {
+        task_bytes_.store(static_cast<std::int64_t>(sizeof(Task) + sizeof(Impl) +
+                                                    MemoryUsage::string_bytes(id_)),
+                          std::memory_order_relaxed);
+    }
     
     Impl() : Impl(generate_task_id()) {}
+
+    ~Impl() {
+        // 任务销毁时从仍挂接的记账汇总中扣除自身占用
+        if (memory_account_) {
+            account_all(*memory_account_, -1);
+        }
+    }
     
     static TaskId generate_task_id() {
         static std::atomic<int> counter{0};
@@ -90,6 +129,68 @@ public:
     std::chrono::system_clock::time_point::rep from_timestamp(const Timestamp &ts) const {
         return ts.time_since_epoch().count();
     }
+
+    // ---------- 内存记账辅助（调用方需持有 data_mutex_） ----------
+    static std::int64_t set_node_bytes(const std::string &value) {
+        return static_cast<std::int64_t>(MemoryUsage::tree_node_bytes(sizeof(std::string)) +
+                                         MemoryUsage::string_bytes(value));
+    }
+
+    static std::int64_t metadata_node_bytes(const std::string &key, const std::string &value) {
+        return static_cast<std::int64_t>(
+            MemoryUsage::tree_node_bytes(sizeof(std::pair<const std::string, std::string>)) +
+            MemoryUsage::string_bytes(key) + MemoryUsage::string_bytes(value));
+    }
+
+    void add_bytes(std::atomic<std::int64_t> TaskMemoryAccount::*account_field,
+                   std::atomic<std::int64_t> &local, std::int64_t delta) {
+        if (delta == 0) {
+            return;
+        }
+        local.fetch_add(delta, std::memory_order_relaxed);
+        if (memory_account_) {
+            ((*memory_account_).*account_field).fetch_add(delta, std::memory_order_relaxed);
+        }
+    }
+
+    void add_task_bytes(std::int64_t delta) {
+        add_bytes(&TaskMemoryAccount::task_bytes, task_bytes_, delta);
+    }
+
+    void assign_string(std::string &field, const std::string &value) {
+        std::int64_t before = static_cast<std::int64_t>(MemoryUsage::string_bytes(field));
+        field = value;
+        add_task_bytes(static_cast<std::int64_t>(MemoryUsage::string_bytes(field)) - before);
+    }
+
+    void insert_into(std::set<std::string> &set, const std::string &value) {
+        auto inserted = set.insert(value);
+        if (inserted.second) {
+            add_task_bytes(set_node_bytes(*inserted.first));
+        }
+    }
+
+    void erase_from(std::set<std::string> &set, const std::string &value) {
+        auto it = set.find(value);
+        if (it != set.end()) {
+            add_task_bytes(-set_node_bytes(*it));
+            set.erase(it);
+        }
+    }
+
+    void account_all(TaskMemoryAccount &account, std::int64_t sign) {
+        account.task_bytes.fetch_add(sign * task_bytes_.load(std::memory_order_relaxed),
+                                     std::memory_order_relaxed);
+        account.metadata_bytes.fetch_add(sign * metadata_bytes_.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+        account.handler_bytes.fetch_add(sign * handler_bytes_.load(std::memory_order_relaxed),
+                                        std::memory_order_relaxed);
+    }
+
+    // 标记快照相关字段已变化（必须在字段写入之后调用）
+    void touch() noexcept {
+        version_.fetch_add(1, std::memory_order_acq_rel);
+    }
 };
 
 // ========== 构造与析构 ==========
@@ -109,17 +210,17 @@ const TaskId &Task::id() const noexcept {
 }
 
 std::string Task::title() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->title_;  // 返回副本，锁释放后仍安全
 }
 
 std::string Task::description() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->description_;  // 返回副本，锁释放后仍安全
 }
 
 int Task::priority() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->priority_;
 }
 
@@ -132,12 +233,12 @@ int Task::progress() const noexcept {
 }
 
 std::string Task::category() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->category_;  // 返回副本，锁释放后仍安全
 }
 
 std::set<std::string> Task::tags() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->tags_;  // 返回副本，锁释放后仍安全
 }
 
@@ -162,43 +263,99 @@ Timestamp Task::completed_at() const noexcept {
 }
 
 std::string Task::claimer_id() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->claimer_id_;  // 返回副本，线程安全
 }
 
 std::map<std::string, std::string> Task::metadata() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->metadata_;
 }
 
 std::set<std::string> Task::whitelist() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->whitelist_;
 }
 
 std::set<std::string> Task::blacklist() const {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     return d->blacklist_;
 }
 
+std::shared_ptr<const TaskView> Task::snapshot() const {
+    std::shared_ptr<const TaskView> cached = std::atomic_load(&d->view_);
+    if (cached && cached->version == d->version_.load(std::memory_order_acquire)) {
+        return cached;
+    }
+
+    // 先读取版本号再读取字段：构建期间若有并发修改，版本号必然大于快照记录的值，
+    // 下一次调用会重新构建，不会把旧字段当作最新结果返回
+    std::shared_ptr<TaskView> view = std::make_shared<TaskView>();
+    view->version = d->version_.load(std::memory_order_acquire);
+    view->id = d->id_;
+    view->created_at = d->created_at_;
+    {
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        view->title = d->title_;
+        view->description = d->description_;
+        view->priority = d->priority_;
+        view->category = d->category_;
+        view->tags = d->tags_;
+        view->claimer_id = d->claimer_id_;
+    }
+    view->status = status();
+    view->progress = progress();
+    view->published_at = published_at();
+    view->claimed_at = claimed_at();
+    view->started_at = started_at();
+    view->completed_at = completed_at();
+    view->cancel_requested = is_cancel_requested();
+
+    std::shared_ptr<const TaskView> result = view;
+    std::atomic_store(&d->view_, result);
+    return result;
+}
+
+std::uint64_t Task::version() const noexcept {
+    return d->version_.load(std::memory_order_acquire);
+}
+
+std::uint64_t Task::change_sequence() const noexcept {
+    return d->change_sequence_.load(std::memory_order_acquire);
+}
+
+MemoryUsage Task::memory_usage() const {
+    MemoryUsage usage;
+    usage.components["task"] = static_cast<std::size_t>(
+        std::max<std::int64_t>(0, d->task_bytes_.load(std::memory_order_relaxed)));
+    usage.components["metadata"] = static_cast<std::size_t>(
+        std::max<std::int64_t>(0, d->metadata_bytes_.load(std::memory_order_relaxed)));
+    usage.components["handler"] = static_cast<std::size_t>(
+        std::max<std::int64_t>(0, d->handler_bytes_.load(std::memory_order_relaxed)));
+    return usage;
+}
+
 // ========== Setter 方法 ==========
 Task &Task::set_title(const std::string &title) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->title_ = title;
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->assign_string(d->title_, title);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_description(const std::string &description) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->description_ = description;
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->assign_string(d->description_, description);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_priority(int priority) {
     // 约束优先级范围为 [Priority::MIN, Priority::MAX]
     int clamped_priority = std::max(Priority::MIN, std::min(Priority::MAX, priority));
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     d->priority_ = clamped_priority;
+    d->touch();
     return *this;
 }
 
@@ -263,20 +420,74 @@ Task &Task::set_progress(int progress) {
     int old_progress = d->progress_.exchange(clamped_progress, std::memory_order_acq_rel);
     
     if (old_progress != clamped_progress) {
-        emit sig_progress_updated(*this, clamped_progress);
+        d->touch();
+        _emit_progress(clamped_progress, clamped_progress == 100);
     }
     
     return *this;
 }
 
+Task &Task::set_progress_coalescing(const ProgressCoalescing &coalescing) {
+    d->progress_min_interval_ms_.store(coalescing.min_interval.count(), std::memory_order_relaxed);
+    d->progress_min_delta_.store(coalescing.min_delta, std::memory_order_relaxed);
+    return *this;
+}
+
+ProgressCoalescing Task::progress_coalescing() const noexcept {
+    ProgressCoalescing coalescing;
+    coalescing.min_interval = std::chrono::milliseconds(d->progress_min_interval_ms_.load(std::memory_order_relaxed));
+    coalescing.min_delta = d->progress_min_delta_.load(std::memory_order_relaxed);
+    return coalescing;
+}
+
+void Task::flush_progress() {
+    _emit_progress(d->progress_.load(std::memory_order_acquire), true);
+}
+
+void Task::_emit_progress(int progress, bool force) {
+    const std::int64_t min_interval_ms = d->progress_min_interval_ms_.load(std::memory_order_relaxed);
+    const int min_delta = d->progress_min_delta_.load(std::memory_order_relaxed);
+    if (!force && min_interval_ms <= 0 && min_delta <= 1) {
+        // 未启用合并：每次变化都发射
+        d->last_emitted_progress_.store(progress, std::memory_order_release);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_progress_updated, std::ref(*this), progress);
+        return;
+    }
+
+    int last = d->last_emitted_progress_.load(std::memory_order_acquire);
+    if (progress == last) {
+        return;
+    }
+
+    const std::int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    if (!force) {
+        if (min_delta > 1 && std::abs(progress - last) < min_delta) {
+            return;
+        }
+        if (min_interval_ms > 0 &&
+            now_ns - d->last_progress_emit_ns_.load(std::memory_order_relaxed) < min_interval_ms * 1000000) {
+            return;
+        }
+    }
+
+    // 并发更新时只有一个线程赢得本次发射，其余线程的值会由后续更新或 flush 补发
+    if (!d->last_emitted_progress_.compare_exchange_strong(last, progress, std::memory_order_acq_rel)) {
+        return;
+    }
+    d->last_progress_emit_ns_.store(now_ns, std::memory_order_relaxed);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_progress_updated, std::ref(*this), progress);
+}
+
 // 协作式取消请求
 tl::expected<void, Error> Task::request_cancel(const std::string &reason) {
     // 任何状态均可请求取消（发布者/平台/申领者请求），只是设置标志并通知
     d->cancel_requested_.store(true, std::memory_order_release);
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        d->cancel_reason_ = reason;
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        d->assign_string(d->cancel_reason_, reason);
     }
+    d->touch();
 
     // 记录到 metadata 以便审计（ISO 8601 UTC 时间）
     auto now = std::chrono::system_clock::now();
@@ -293,7 +504,7 @@ tl::expected<void, Error> Task::request_cancel(const std::string &reason) {
     set_metadata("cancel.reason", reason);
     set_metadata("cancel.requested_at", std::string(timebuf));
 
-    emit sig_cancel_requested(*this, reason);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_cancel_requested, std::ref(*this), reason);
     return {};
 }
 
@@ -311,94 +522,167 @@ bool Task::auto_cleanup() const noexcept {
 }
 
 Task &Task::set_category(const std::string &category) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->category_ = category;
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->assign_string(d->category_, category);
+    d->touch();
     return *this;
 }
 
 Task &Task::add_tag(const std::string &tag) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->tags_.insert(tag);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->insert_into(d->tags_, tag);
+    d->touch();
     return *this;
 }
 
 Task &Task::remove_tag(const std::string &tag) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->tags_.erase(tag);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->erase_from(d->tags_, tag);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_claimer_id(const std::string &claimer_id) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->claimer_id_ = claimer_id;
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->assign_string(d->claimer_id_, claimer_id);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_metadata(const std::string &key, const std::string &value) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->metadata_[key] = value;
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    auto it = d->metadata_.find(key);
+    std::int64_t before = 0;
+    if (it == d->metadata_.end()) {
+        it = d->metadata_.emplace(key, value).first;
+    } else {
+        before = Impl::metadata_node_bytes(it->first, it->second);
+        it->second = value;
+    }
+    d->add_bytes(&TaskMemoryAccount::metadata_bytes, d->metadata_bytes_,
+                 Impl::metadata_node_bytes(it->first, it->second) - before);
     return *this;
 }
 
 Task &Task::remove_metadata(const std::string &key) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->metadata_.erase(key);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    auto it = d->metadata_.find(key);
+    if (it != d->metadata_.end()) {
+        d->add_bytes(&TaskMemoryAccount::metadata_bytes, d->metadata_bytes_,
+                     -Impl::metadata_node_bytes(it->first, it->second));
+        d->metadata_.erase(it);
+    }
     return *this;
 }
 
 Task &Task::add_to_whitelist(const std::string &claimer_id) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->whitelist_.insert(claimer_id);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->insert_into(d->whitelist_, claimer_id);
     return *this;
 }
 
 Task &Task::remove_from_whitelist(const std::string &claimer_id) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->whitelist_.erase(claimer_id);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->erase_from(d->whitelist_, claimer_id);
     return *this;
 }
 
 Task &Task::add_to_blacklist(const std::string &claimer_id) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->blacklist_.insert(claimer_id);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->insert_into(d->blacklist_, claimer_id);
     return *this;
 }
 
 Task &Task::remove_from_blacklist(const std::string &claimer_id) {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
-    d->blacklist_.erase(claimer_id);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    d->erase_from(d->blacklist_, claimer_id);
     return *this;
 }
 
 // ========== 时间戳设置 ==========
 Task &Task::set_published_at(const Timestamp &timestamp) {
     d->published_at_.store(d->from_timestamp(timestamp), std::memory_order_release);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_claimed_at(const Timestamp &timestamp) {
     d->claimed_at_.store(d->from_timestamp(timestamp), std::memory_order_release);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_started_at(const Timestamp &timestamp) {
     d->started_at_.store(d->from_timestamp(timestamp), std::memory_order_release);
+    d->touch();
     return *this;
 }
 
 Task &Task::set_completed_at(const Timestamp &timestamp) {
     d->completed_at_.store(d->from_timestamp(timestamp), std::memory_order_release);
+    d->touch();
+    return *this;
+}
+
+Task &Task::set_change_sequence(std::uint64_t sequence) {
+    // 并发转换可能乱序到达，只保留较大的序号
+    std::uint64_t current = d->change_sequence_.load(std::memory_order_acquire);
+    while (sequence > current &&
+           !d->change_sequence_.compare_exchange_weak(current, sequence, std::memory_order_acq_rel)) {
+    }
     return *this;
 }
 
+Task &Task::set_memory_account(std::shared_ptr<TaskMemoryAccount> account) {
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+    if (d->memory_account_ == account) {
+        return *this;
+    }
+    if (d->memory_account_) {
+        d->account_all(*d->memory_account_, -1);
+    }
+    d->memory_account_ = std::move(account);
+    if (d->memory_account_) {
+        d->account_all(*d->memory_account_, 1);
+    }
+    return *this;
+}
+
+Task &Task::set_lifecycle_sink(std::shared_ptr<TaskLifecycleSink> sink) {
+    std::atomic_store(&d->lifecycle_sink_, std::move(sink));
+    return *this;
+}
+
+Task &Task::set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher) {
+    d->signal_dispatcher_.reset(dispatcher);
+    return *this;
+}
+
+std::shared_ptr<SignalDispatcher> Task::signal_dispatcher() const {
+    return d->signal_dispatcher_.lock();
+}
+
 // ========== 业务逻辑方法 ==========
 Task &Task::set_handler(TaskHandler handler) {
     std::lock_guard<std::mutex> lock(d->handler_mutex_);
+    bool had_handler = static_cast<bool>(d->handler_);
     d->handler_ = std::move(handler);
+    bool has_handler = static_cast<bool>(d->handler_);
+    if (had_handler != has_handler) {
+        // 仅能计入处理函数对象本身，捕获列表占用的堆内存无法从 std::function 获取
+        std::lock_guard<ProfiledMutex> data_lock(d->data_mutex_);
+        std::int64_t bytes = static_cast<std::int64_t>(sizeof(TaskHandler));
+        d->add_bytes(&TaskMemoryAccount::handler_bytes, d->handler_bytes_, has_handler ? bytes : -bytes);
+    }
     return *this;
 }
 
 TaskResult Task::execute(const std::string &input) {
+    ScopedSpan span("task.execute", d->id_);
+    return span.record(_execute(input));
+}
+
+TaskResult Task::_execute(const std::string &input) {
     std::lock_guard<std::mutex> lock(d->handler_mutex_);
 
     if (!d->handler_) {
@@ -424,13 +708,12 @@ TaskResult Task::execute(const std::string &input) {
     TaskResult result = d->handler_(*this, input);
 
     if (result.ok()) {
-        // 成功
-        TaskResult task_result = result;
-        auto complete_result = complete(task_result);
+        // 成功（直接转交结果，避免复制 output）
+        auto complete_result = complete(result);
         if (!complete_result.has_value() && status() != TaskStatus::Completed) {
             return complete_result.error();
         }
-        return task_result;
+        return result;
     } else {
         // 失败
         auto fail_result = fail(result.error.message);
@@ -441,6 +724,9 @@ TaskResult Task::execute(const std::string &input) {
     }
 }
 
+TaskResult Task::execute(const Payload &input) {
+    return execute(input.str());
+}
 
 bool Task::can_transition_to(TaskStatus new_status) const noexcept {
     TaskStatus current_status = status();
@@ -488,7 +774,7 @@ bool Task::can_transition_to(TaskStatus new_status) const noexcept {
 }
 
 bool Task::is_claimer_allowed(const std::string &claimer_id) const noexcept {
-    std::lock_guard<std::mutex> lock(d->data_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
     
     // 1. 检查黑名单（优先级最高）
     if (d->blacklist_.find(claimer_id) != d->blacklist_.end()) {
@@ -516,8 +802,8 @@ tl::expected<void, Error> Task::try_claim(const std::string &claimer_id) {
 
     auto now = std::chrono::system_clock::now();
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        d->claimer_id_ = claimer_id;
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        d->assign_string(d->claimer_id_, claimer_id);
     }
     d->claimed_at_.store(d->from_timestamp(now), std::memory_order_release);
 
@@ -563,7 +849,7 @@ tl::expected<void, Error> Task::start() {
     
     set_started_at(std::chrono::system_clock::now());
     _trigger_status_signal(TaskStatus::Claimed, TaskStatus::Processing);
-    emit sig_started(*this);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_started, std::ref(*this));
     return {};
 }
 
@@ -625,6 +911,11 @@ tl::expected<void, Error> Task::cancel() {
 }
 
 tl::expected<void, Error> Task::complete(const TaskResult &result) {
+    ScopedSpan span("task.complete", d->id_);
+    return span.record(_complete(result));
+}
+
+tl::expected<void, Error> Task::_complete(const TaskResult &result) {
     TaskStatus current = status();
     if (current != TaskStatus::Processing) {
         return tl::make_unexpected(Error("Task must be in Processing state to complete",
@@ -642,11 +933,16 @@ tl::expected<void, Error> Task::complete(const TaskResult &result) {
     set_progress(100);
     set_completed_at(std::chrono::system_clock::now());
     _trigger_status_signal(TaskStatus::Processing, TaskStatus::Completed);
-    emit sig_completed(*this, result);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_completed, std::ref(*this), result);
     return {};
 }
 
 tl::expected<void, Error> Task::fail(const std::string &reason) {
+    ScopedSpan span("task.fail", d->id_);
+    return span.record(_fail(reason));
+}
+
+tl::expected<void, Error> Task::_fail(const std::string &reason) {
     TaskStatus current = status();
     if (current != TaskStatus::Processing) {
         return tl::make_unexpected(Error("Task must be in Processing state to fail",
@@ -662,11 +958,16 @@ tl::expected<void, Error> Task::fail(const std::string &reason) {
     }
     
     _trigger_status_signal(TaskStatus::Processing, TaskStatus::Failed);
-    emit sig_failed(*this, Error(reason, ErrorCode::TASK_EXECUTION_FAILED));
+    dispatch_signal(d->signal_dispatcher_, *this, sig_failed, std::ref(*this), Error(reason, ErrorCode::TASK_EXECUTION_FAILED));
     return {};
 }
 
 tl::expected<void, Error> Task::abandon(const std::string &reason) {
+    ScopedSpan span("task.abandon", d->id_);
+    return span.record(_abandon(reason));
+}
+
+tl::expected<void, Error> Task::_abandon(const std::string &reason) {
     TaskStatus current = status();
     if (current != TaskStatus::Claimed && 
         current != TaskStatus::Processing && 
@@ -706,8 +1007,8 @@ tl::expected<void, Error> Task::republish() {
 
     // 清除申领者信息
     {
-        std::lock_guard<std::mutex> lock(d->data_mutex_);
-        d->claimer_id_.clear();
+        std::lock_guard<ProfiledMutex> lock(d->data_mutex_);
+        d->assign_string(d->claimer_id_, std::string());
     }
 
     set_published_at(std::chrono::system_clock::now());
@@ -717,18 +1018,26 @@ tl::expected<void, Error> Task::republish() {
 
 // ========== 私有辅助方法 ==========
 void Task::_trigger_status_signal(TaskStatus old_status, TaskStatus new_status) {
-    emit sig_status_changed(*this, old_status, new_status);
+    d->touch();
+    // 状态转换前补发被合并的最新进度，保证订阅者看到转换前的最终值
+    flush_progress();
+
+    std::shared_ptr<TaskLifecycleSink> sink = std::atomic_load(&d->lifecycle_sink_);
+    if (sink) {
+        set_change_sequence(sink->on_status_changed(*this, old_status, new_status));
+    }
+    dispatch_signal(d->signal_dispatcher_, *this, sig_status_changed, std::ref(*this), old_status, new_status);
     
     // 触发特定状态的信号
     switch (new_status) {
         case TaskStatus::Claimed:
-            emit sig_claimed(*this, claimer_id());
+            dispatch_signal(d->signal_dispatcher_, *this, sig_claimed, std::ref(*this), claimer_id());
             break;
         case TaskStatus::Abandoned:
-            emit sig_abandoned(*this, claimer_id());
+            dispatch_signal(d->signal_dispatcher_, *this, sig_abandoned, std::ref(*this), claimer_id());
             break;
         case TaskStatus::Cancelled:
-            emit sig_cancelled(*this);
+            dispatch_signal(d->signal_dispatcher_, *this, sig_cancelled, std::ref(*this));
             break;
         default:
             break;
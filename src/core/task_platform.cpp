@@ -1,7 +1,13 @@
 #include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
+#include <xswl/youdidit/core/tracing.hpp>
 #include <algorithm>
 #include <sstream>
 #include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <unordered_map>
 
 namespace xswl {
 namespace youdidit {
@@ -21,6 +27,757 @@ namespace {
         oss << "platform_" << timestamp << "_" << counter.fetch_add(1);
         return oss.str();
     }
+
+    // 开始时尚不知道任务的 span（如 claim_next_task）
+    const TaskId kNoTaskId;
+
+    // 把申领结果记入 span：成功时给出申领到的任务，失败时给出错误
+    tl::expected<std::shared_ptr<Task>, Error> traced_claim(ScopedSpan &span,
+                                                            tl::expected<std::shared_ptr<Task>, Error> result) {
+        if (result.has_value()) {
+            span.set_task_id(result.value()->id());
+        } else {
+            span.set_error(result.error().message);
+        }
+        return result;
+    }
+    // 单个批量订阅：记录线程只负责追加，后台线程按批大小/刷新间隔投递。
+    // 缓冲区至多 max_pending 条，超出时丢弃新记录并计数
+    class LifecycleBatcher : public std::enable_shared_from_this<LifecycleBatcher> {
+    public:
+        LifecycleBatcher(TaskPlatform::LifecycleBatchHandler handler, const LifecycleBatchOptions &options)
+            : handler_(std::move(handler)), options_(options), stopping_(false), dropped_(0) {
+            if (options_.max_batch_size == 0) {
+                options_.max_batch_size = 1;
+            }
+            if (options_.flush_interval.count() <= 0) {
+                options_.flush_interval = std::chrono::milliseconds(1);
+            }
+            buffer_.reserve(options_.max_batch_size);
+            thread_ = std::thread([this]() { run(); });
+        }
+
+        ~LifecycleBatcher() {
+            stop();
+        }
+
+        void append(const TaskLifecycleRecord &record) {
+            bool full;
+            {
+                std::lock_guard<std::mutex> lock(buffer_mutex_);
+                if (options_.max_pending > 0 && buffer_.size() >= options_.max_pending) {
+                    dropped_.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                buffer_.push_back(record);
+                full = buffer_.size() >= options_.max_batch_size;
+            }
+            if (full) {
+                cv_.notify_one();
+            }
+        }
+
+        void deliver_pending() {
+            if (tl_delivering == this) {
+                return;  // 处理函数内再次 flush：剩余记录由正在进行的投递之后的周期送达
+            }
+            std::lock_guard<std::mutex> delivery_lock(delivery_mutex_);
+            std::vector<TaskLifecycleRecord> pending;
+            {
+                std::lock_guard<std::mutex> lock(buffer_mutex_);
+                pending.swap(buffer_);
+                buffer_.reserve(options_.max_batch_size);
+            }
+            if (pending.empty()) {
+                return;
+            }
+            if (pending.size() <= options_.max_batch_size) {
+                invoke(pending);
+                return;
+            }
+            // 后台线程忙于上一批时可能积压，按 max_batch_size 拆分投递
+            std::vector<TaskLifecycleRecord> chunk;
+            for (std::size_t i = 0; i < pending.size(); i += options_.max_batch_size) {
+                std::size_t end = std::min(pending.size(), i + options_.max_batch_size);
+                chunk.assign(std::make_move_iterator(pending.begin() + i), std::make_move_iterator(pending.begin() + end));
+                invoke(chunk);
+            }
+        }
+
+        void stop() {
+            {
+                std::lock_guard<std::mutex> lock(buffer_mutex_);
+                if (stopping_) {
+                    return;
+                }
+                stopping_ = true;
+                if (std::this_thread::get_id() == thread_.get_id()) {
+                    // 处理函数在后台线程上取消了自己的订阅：无法 join 自身，改为分离线程，
+                    // 并让线程持有自身直到退出，剩余记录由 run() 退出前投递
+                    self_ = shared_from_this();
+                    thread_.detach();
+                    return;
+                }
+            }
+            cv_.notify_one();
+            if (thread_.joinable()) {
+                thread_.join();
+            }
+            deliver_pending();
+        }
+
+        std::uint64_t dropped() const {
+            return dropped_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        void invoke(const std::vector<TaskLifecycleRecord> &batch) {
+            const LifecycleBatcher *previous = tl_delivering;
+            tl_delivering = this;
+            try {
+                handler_(batch);
+            } catch (...) {
+                // 订阅者异常不影响后续批次
+            }
+            tl_delivering = previous;
+        }
+
+        void run() {
+            for (;;) {
+                {
+                    std::unique_lock<std::mutex> lock(buffer_mutex_);
+                    cv_.wait_for(lock, options_.flush_interval, [this]() {
+                        return stopping_ || buffer_.size() >= options_.max_batch_size;
+                    });
+                    if (stopping_) {
+                        break;
+                    }
+                }
+                deliver_pending();
+            }
+            std::shared_ptr<LifecycleBatcher> self;
+            {
+                std::lock_guard<std::mutex> lock(buffer_mutex_);
+                self.swap(self_);
+            }
+            if (self) {
+                deliver_pending();
+            }
+            // self 在此析构：若是最后一个引用，对象在本线程上销毁（线程已分离）
+        }
+
+        // 当前线程正在其处理函数中的订阅（用于识别处理函数内的重入调用）
+        static thread_local const LifecycleBatcher *tl_delivering;
+
+        TaskPlatform::LifecycleBatchHandler handler_;
+        LifecycleBatchOptions options_;
+        std::mutex buffer_mutex_;
+        std::mutex delivery_mutex_;
+        std::condition_variable cv_;
+        std::vector<TaskLifecycleRecord> buffer_;
+        bool stopping_;
+        std::atomic<std::uint64_t> dropped_;
+        std::shared_ptr<LifecycleBatcher> self_;   // 仅在后台线程上自我取消时设置
+        std::thread thread_;
+    };
+
+    thread_local const LifecycleBatcher *LifecycleBatcher::tl_delivering = nullptr;
+
+    // 变更日志：按变更序号索引每个任务/申领者最近一次的修改，已删除的条目保留为墓碑。
+    // 登记修改（状态转换的热路径）只在按线程分片的缓冲区里分配序号并追加一条记录；索引更新推迟到
+    // 读取、删除条目或缓冲区攒满时，在全局锁下按序号批量应用
+    class ChangeLog {
+    public:
+        enum Kind { TaskEntry, ClaimerEntry };
+
+        struct Entry {
+            Kind kind;
+            std::string id;
+            bool removed;
+        };
+
+        // 保留的墓碑上限；更早的墓碑被丢弃后，since 早于它们的调用方需要全量同步
+        static const size_t kMaxTombstones = 65536;
+        // 单个分片缓冲的记录数达到该值时，由追加的线程顺带应用所有分片
+        static const size_t kApplyThreshold = 4096;
+
+        ChangeLog() : sequence_(0), compacted_through_(0) {
+            for (auto &shard : shards_) {
+                shard.reset(new Shard());
+            }
+        }
+
+        std::uint64_t sequence() const {
+            return sequence_.load(std::memory_order_acquire);
+        }
+
+        // 登记一次状态转换：任务条目与（非空时）申领者条目。已删除的条目（删除后仍在途的转换）在应用时忽略
+        std::uint64_t touch_transition(const std::string &task_id, const std::string &claimer_id) {
+            return append(TaskEntry, task_id, false, claimer_id.empty() ? nullptr : &claimer_id);
+        }
+
+        // 发布任务 / 注册申领者：已删除的条目同样复活
+        std::uint64_t touch(Kind kind, const std::string &id) {
+            return append(kind, id, true, nullptr);
+        }
+
+        std::uint64_t remove(Kind kind, const std::string &id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::uint64_t seq = apply_pending_locked(true);
+            erase_current_locked(kind, id);
+            entries_.insert(std::make_pair(seq, Entry{kind, id, true}));
+            index_for(kind)[id] = seq;
+            tombstones_.push_back(seq);
+            while (tombstones_.size() > kMaxTombstones) {
+                std::uint64_t oldest = tombstones_.front();
+                tombstones_.pop_front();
+                auto entry = entries_.find(oldest);
+                if (entry != entries_.end() && entry->second.removed) {
+                    index_for(entry->second.kind).erase(entry->second.id);
+                    entries_.erase(entry);
+                    compacted_through_ = oldest;
+                }
+            }
+            return seq;
+        }
+
+        // 取出序号大于 since 的至多 limit 条；代价与条数成正比
+        void collect(std::uint64_t since, size_t limit, TaskPlatform::ChangeSet &changes,
+                     std::vector<std::pair<std::uint64_t, TaskId>> &changed_tasks) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const std::uint64_t watermark = apply_pending_locked();
+            changes.reset = since < compacted_through_;
+            changes.sequence = watermark;
+            size_t taken = 0;
+            for (auto it = entries_.upper_bound(since); it != entries_.end(); ++it) {
+                if (taken == limit) {
+                    changes.has_more = true;
+                    break;
+                }
+                ++taken;
+                changes.sequence = it->first;
+                const Entry &entry = it->second;
+                if (entry.kind == TaskEntry) {
+                    if (entry.removed) {
+                        changes.removed_task_ids.push_back(entry.id);
+                    } else {
+                        changed_tasks.push_back(std::make_pair(it->first, entry.id));
+                    }
+                } else if (entry.removed) {
+                    changes.removed_claimer_ids.push_back(entry.id);
+                } else {
+                    changes.changed_claimer_ids.push_back(entry.id);
+                }
+            }
+            if (!changes.has_more) {
+                changes.sequence = watermark;
+            }
+        }
+
+    private:
+        struct Pending {
+            std::uint64_t seq;
+            Kind kind;
+            std::string id;
+            bool revive;
+        };
+
+        struct Shard {
+            std::mutex mutex;
+            std::vector<Pending> pending;
+        };
+
+        static const size_t kShards = 16;
+
+        static size_t change_shard_slot() noexcept {
+            static std::atomic<size_t> next_slot{0};
+            thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % kShards;
+            return slot;
+        }
+
+        std::unordered_map<std::string, std::uint64_t> &index_for(Kind kind) {
+            return kind == TaskEntry ? task_index_ : claimer_index_;
+        }
+
+        std::uint64_t append(Kind kind, const std::string &id, bool revive, const std::string *claimer_id) {
+            Shard &shard = *shards_[change_shard_slot()];
+            std::uint64_t seq;
+            bool full;
+            {
+                // 在分片锁内分配序号：应用时同时持有全部分片锁，即可保证不大于水位的序号都已入缓冲
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                seq = sequence_.fetch_add(1, std::memory_order_acq_rel) + 1;
+                shard.pending.push_back(Pending{seq, kind, id, revive});
+                if (claimer_id) {
+                    shard.pending.push_back(Pending{sequence_.fetch_add(1, std::memory_order_acq_rel) + 1,
+                                                    ClaimerEntry, *claimer_id, false});
+                }
+                full = shard.pending.size() >= kApplyThreshold;
+            }
+            if (full) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                apply_pending_locked();
+            }
+            return seq;
+        }
+
+        void erase_current_locked(Kind kind, const std::string &id) {
+            auto &index = index_for(kind);
+            auto it = index.find(id);
+            if (it != index.end()) {
+                entries_.erase(it->second);
+            }
+        }
+
+        // 调用方持有 mutex_。同时锁住全部分片取走缓冲并读取水位，此刻不大于水位的序号都已在取走的缓冲中；
+        // allocate 为 true 时顺带分配一个新序号（大于所有已取走的记录）并返回，否则返回水位
+        std::uint64_t apply_pending_locked(bool allocate = false) {
+            std::vector<Pending> drained;
+            std::uint64_t result;
+            {
+                std::unique_lock<std::mutex> locks[kShards];
+                for (size_t i = 0; i < kShards; ++i) {
+                    locks[i] = std::unique_lock<std::mutex>(shards_[i]->mutex);
+                }
+                for (auto &shard : shards_) {
+                    if (drained.empty()) {
+                        drained.swap(shard->pending);
+                    } else {
+                        drained.insert(drained.end(), std::make_move_iterator(shard->pending.begin()),
+                                       std::make_move_iterator(shard->pending.end()));
+                        shard->pending.clear();
+                    }
+                }
+                result = allocate ? sequence_.fetch_add(1, std::memory_order_acq_rel) + 1
+                                  : sequence_.load(std::memory_order_acquire);
+            }
+            // 不同分片的记录交错，按序号应用，同一条目以最后一次修改为准
+            std::sort(drained.begin(), drained.end(),
+                      [](const Pending &a, const Pending &b) { return a.seq < b.seq; });
+            for (auto &item : drained) {
+                auto &index = index_for(item.kind);
+                auto it = index.find(item.id);
+                if (it != index.end()) {
+                    auto entry = entries_.find(it->second);
+                    if (entry->second.removed && !item.revive) {
+                        continue;
+                    }
+                    entries_.erase(entry);
+                    it->second = item.seq;
+                } else {
+                    index.insert(std::make_pair(item.id, item.seq));
+                }
+                entries_.insert(std::make_pair(item.seq, Entry{item.kind, std::move(item.id), false}));
+            }
+            return result;
+        }
+
+        std::mutex mutex_;
+        std::atomic<std::uint64_t> sequence_;
+        std::uint64_t compacted_through_;
+        std::map<std::uint64_t, Entry> entries_;
+        std::unordered_map<std::string, std::uint64_t> task_index_;
+        std::unordered_map<std::string, std::uint64_t> claimer_index_;
+        std::deque<std::uint64_t> tombstones_;
+        std::unique_ptr<Shard> shards_[kShards];
+    };
+
+    const size_t ChangeLog::kMaxTombstones;
+    const size_t ChangeLog::kApplyThreshold;
+    const size_t ChangeLog::kShards;
+
+    // 任务延迟直方图：按 (分类, 申领者) 分组，每组记录四个阶段。分组表写时复制，
+    // 记录路径只做一次原子加载与查找，新分组出现时才加锁。申领者注销时删除其分组；
+    // 分组数达到 max_series 后，新的组合一律记入 ("*", "*") 溢出分组
+    class LatencyRecorder {
+    public:
+        static const size_t kDefaultMaxSeries = 256;
+        static const size_t kSeriesShards = 2;   // 每个阶段直方图的记录分片数（分组多时控制内存）
+
+        struct Series {
+            std::string category;
+            std::string claimer_id;
+            std::unique_ptr<LatencyHistogram> stages[kLatencyStageCount];
+
+            Series() {
+                for (auto &stage : stages) {
+                    stage.reset(new LatencyHistogram(kSeriesShards));
+                }
+            }
+        };
+        using SeriesMap = std::map<std::pair<std::string, std::string>, std::shared_ptr<Series>>;
+
+        LatencyRecorder() : max_series_(kDefaultMaxSeries), series_(std::make_shared<const SeriesMap>()) {}
+
+        void set_max_series(size_t count) noexcept {
+            max_series_.store(std::max<size_t>(1, count), std::memory_order_relaxed);
+        }
+
+        size_t max_series() const noexcept {
+            return max_series_.load(std::memory_order_relaxed);
+        }
+
+        void on_transition(const Task &task, TaskStatus old_status, TaskStatus new_status,
+                           const std::string &claimer_id) {
+            if (new_status != TaskStatus::Claimed && new_status != TaskStatus::Completed &&
+                !(new_status == TaskStatus::Processing && old_status == TaskStatus::Claimed)) {
+                return;  // 暂停后恢复等转换不属于任何阶段
+            }
+            Timestamp now = std::chrono::system_clock::now();
+            std::shared_ptr<Series> holder = lookup(task.category(), claimer_id);
+            Series &series = *holder;
+            switch (new_status) {
+                case TaskStatus::Claimed:
+                    record(series, LatencyStage::QueueWait, task.published_at(), now);
+                    break;
+                case TaskStatus::Processing:
+                    record(series, LatencyStage::StartDelay, task.claimed_at(), now);
+                    break;
+                case TaskStatus::Completed:
+                    record(series, LatencyStage::Run, task.started_at(), now);
+                    record(series, LatencyStage::EndToEnd, task.published_at(), now);
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        // 删除申领者的全部分组；之后仍在途的样本会重新建组
+        void remove_claimer(const std::string &claimer_id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::shared_ptr<const SeriesMap> current = std::atomic_load(&series_);
+            auto updated = std::make_shared<SeriesMap>();
+            for (const auto &pair : *current) {
+                if (pair.first.second != claimer_id) {
+                    updated->insert(updated->end(), pair);
+                }
+            }
+            if (updated->size() != current->size()) {
+                std::atomic_store(&series_, std::shared_ptr<const SeriesMap>(updated));
+            }
+        }
+
+        std::vector<TaskPlatform::LatencySeries> snapshot() const {
+            std::shared_ptr<const SeriesMap> series = std::atomic_load(&series_);
+            std::vector<TaskPlatform::LatencySeries> result;
+            result.reserve(series->size());
+            for (const auto &pair : *series) {
+                TaskPlatform::LatencySeries item;
+                item.category = pair.second->category;
+                item.claimer_id = pair.second->claimer_id;
+                for (std::size_t i = 0; i < kLatencyStageCount; ++i) {
+                    item.stages[i] = pair.second->stages[i]->snapshot();
+                }
+                result.push_back(std::move(item));
+            }
+            return result;
+        }
+
+    private:
+        static void record(Series &series, LatencyStage stage, const Timestamp &from, const Timestamp &to) {
+            // 通过 set_status 直接跳转的任务可能没有起点时间戳
+            if (from.time_since_epoch().count() == 0 || to < from) {
+                return;
+            }
+            auto micros = std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+            series.stages[static_cast<std::size_t>(stage)]->record(static_cast<std::uint64_t>(micros));
+        }
+
+        // 返回共享指针：分组可能在记录期间被 remove_claimer 删除
+        std::shared_ptr<Series> lookup(const std::string &category, const std::string &claimer_id) {
+            auto key = std::make_pair(category, claimer_id);
+            std::shared_ptr<const SeriesMap> current = std::atomic_load(&series_);
+            auto it = current->find(key);
+            const size_t max_series = max_series_.load(std::memory_order_relaxed);
+            if (it == current->end() && current->size() >= max_series) {
+                it = current->find(overflow_key());   // 已满时溢出分组必然存在，无需加锁
+            }
+            if (it != current->end()) {
+                return it->second;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            current = std::atomic_load(&series_);
+            if (current->find(key) == current->end() && current->size() + 1 >= max_series) {
+                key = overflow_key();   // 最后一个名额留给溢出分组
+            }
+            it = current->find(key);
+            if (it != current->end()) {
+                return it->second;
+            }
+            auto created = std::make_shared<Series>();
+            created->category = key.first;
+            created->claimer_id = key.second;
+            auto updated = std::make_shared<SeriesMap>(*current);
+            (*updated)[key] = created;
+            std::atomic_store(&series_, std::shared_ptr<const SeriesMap>(updated));
+            return created;
+        }
+
+        static std::pair<std::string, std::string> overflow_key() {
+            return std::make_pair(std::string("*"), std::string("*"));
+        }
+
+        std::mutex mutex_;
+        std::atomic<size_t> max_series_;
+        std::shared_ptr<const SeriesMap> series_;  // 仅通过 std::atomic_load/atomic_store 访问
+    };
+
+    const size_t LatencyRecorder::kDefaultMaxSeries;
+    const size_t LatencyRecorder::kSeriesShards;
+
+    // 挂接到平台所有任务上的接收器：登记变更序号，并把状态转换分发给各个批量订阅
+    class LifecycleHub : public TaskLifecycleSink {
+    public:
+        using BatcherList = std::vector<std::shared_ptr<LifecycleBatcher>>;
+
+        LifecycleHub(std::shared_ptr<ChangeLog> changes, std::shared_ptr<LatencyRecorder> latency)
+            : changes_(std::move(changes)), latency_(std::move(latency)), active_(false), next_id_(1),
+              batchers_(std::make_shared<const BatcherList>()) {}
+
+        std::uint64_t on_status_changed(const Task &task, TaskStatus old_status, TaskStatus new_status) noexcept override {
+            std::uint64_t sequence = 0;
+            std::string claimer_id;
+            try {
+                claimer_id = task.claimer_id();
+                sequence = changes_->touch_transition(task.id(), claimer_id);
+            } catch (...) {
+                // 内存不足时不登记本次变更
+            }
+            try {
+                latency_->on_transition(task, old_status, new_status, claimer_id);
+            } catch (...) {
+                // 内存不足时丢弃本次延迟样本
+            }
+            if (!active_.load(std::memory_order_acquire)) {
+                return sequence;
+            }
+            std::shared_ptr<const BatcherList> batchers = std::atomic_load(&batchers_);
+            try {
+                TaskLifecycleRecord record;
+                record.task_id = task.id();
+                record.old_status = old_status;
+                record.new_status = new_status;
+                record.timestamp = std::chrono::system_clock::now();
+                record.claimer_id = claimer_id;
+                record.change_sequence = sequence;
+                for (const auto &batcher : *batchers) {
+                    batcher->append(record);
+                }
+            } catch (...) {
+                // 内存不足等异常时丢弃本条记录，不影响状态转换
+            }
+            return sequence;
+        }
+
+        // 任务被删除：与状态转换走同一条记录流，订阅者据此按顺序撤销该任务（调用方持有 tasks_mutex_）
+        void on_task_removed(const Task &task, std::uint64_t sequence) noexcept {
+            if (!active_.load(std::memory_order_acquire)) {
+                return;
+            }
+            std::shared_ptr<const BatcherList> batchers = std::atomic_load(&batchers_);
+            try {
+                TaskLifecycleRecord record;
+                record.task_id = task.id();
+                record.old_status = task.status();
+                record.new_status = record.old_status;
+                record.timestamp = std::chrono::system_clock::now();
+                record.claimer_id = task.claimer_id();
+                record.removed = true;
+                record.change_sequence = sequence;
+                for (const auto &batcher : *batchers) {
+                    batcher->append(record);
+                }
+            } catch (...) {
+                // 内存不足时丢弃本条记录
+            }
+        }
+
+        std::uint64_t add(TaskPlatform::LifecycleBatchHandler handler, const LifecycleBatchOptions &options) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::uint64_t id = next_id_++;
+            entries_[id] = std::make_shared<LifecycleBatcher>(std::move(handler), options);
+            publish_locked();
+            return id;
+        }
+
+        bool remove(std::uint64_t id) {
+            std::shared_ptr<LifecycleBatcher> removed;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = entries_.find(id);
+                if (it == entries_.end()) {
+                    return false;
+                }
+                removed = it->second;
+                entries_.erase(it);
+                publish_locked();
+            }
+            removed->stop();
+            return true;
+        }
+
+        void flush() {
+            std::shared_ptr<const BatcherList> batchers = std::atomic_load(&batchers_);
+            for (const auto &batcher : *batchers) {
+                batcher->deliver_pending();
+            }
+        }
+
+        std::uint64_t dropped(std::uint64_t id) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto it = entries_.find(id);
+            return it == entries_.end() ? 0 : it->second->dropped();
+        }
+
+        void clear() {
+            std::map<std::uint64_t, std::shared_ptr<LifecycleBatcher>> entries;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                entries.swap(entries_);
+                publish_locked();
+            }
+            for (const auto &pair : entries) {
+                pair.second->stop();
+            }
+        }
+
+    private:
+        void publish_locked() {
+            auto list = std::make_shared<BatcherList>();
+            for (const auto &pair : entries_) {
+                list->push_back(pair.second);
+            }
+            active_.store(!list->empty(), std::memory_order_release);
+            std::atomic_store(&batchers_, std::shared_ptr<const BatcherList>(list));
+        }
+
+        std::shared_ptr<ChangeLog> changes_;
+        std::shared_ptr<LatencyRecorder> latency_;
+        std::atomic<bool> active_;
+        std::mutex mutex_;
+        std::uint64_t next_id_;
+        std::map<std::uint64_t, std::shared_ptr<LifecycleBatcher>> entries_;
+        std::shared_ptr<const BatcherList> batchers_;  // 仅通过 std::atomic_load/atomic_store 访问
+    };
+
+    // 检查快照是否满足除状态外的过滤条件
+    bool view_matches(const TaskPlatform::TaskFilter &filter, const TaskView &view) {
+        if (filter.category.has_value() && view.category != filter.category.value()) {
+            return false;
+        }
+        if (filter.min_priority.has_value() && view.priority < filter.min_priority.value()) {
+            return false;
+        }
+        if (filter.max_priority.has_value() && view.priority > filter.max_priority.value()) {
+            return false;
+        }
+        for (const auto &tag : filter.tags) {
+            if (view.tags.find(tag) == view.tags.end()) {
+                return false;
+            }
+        }
+        if (filter.claimer_id.has_value() && view.claimer_id != filter.claimer_id.value()) {
+            return false;
+        }
+        return true;
+    }
+
+    // 分页位置：排序值 + 任务 ID
+    struct PageKey {
+        std::int64_t value;
+        TaskId id;
+    };
+
+    std::int64_t page_value(TaskPlatform::TaskSortKey sort_by, const TaskView &view) {
+        switch (sort_by) {
+        case TaskPlatform::TaskSortKey::PublishedAt:
+            return static_cast<std::int64_t>(view.published_at.time_since_epoch().count());
+        case TaskPlatform::TaskSortKey::Priority:
+            return view.priority;
+        case TaskPlatform::TaskSortKey::Id:
+        default:
+            return 0;
+        }
+    }
+
+    // 按查询顺序比较（降序为升序的完全反转，包括 ID）
+    struct PageKeyLess {
+        bool descending;
+        bool operator()(const PageKey &a, const PageKey &b) const {
+            if (a.value != b.value) {
+                return descending ? a.value > b.value : a.value < b.value;
+            }
+            return descending ? a.id > b.id : a.id < b.id;
+        }
+    };
+
+    char cursor_tag(TaskPlatform::TaskSortKey sort_by) {
+        switch (sort_by) {
+        case TaskPlatform::TaskSortKey::PublishedAt: return 't';
+        case TaskPlatform::TaskSortKey::Priority: return 'p';
+        case TaskPlatform::TaskSortKey::Id:
+        default: return 'i';
+        }
+    }
+
+    // 游标内容为 "<排序字段><方向>:<排序值>:<任务ID>" 的十六进制编码，可直接放入 URL
+    std::string encode_cursor(TaskPlatform::TaskSortKey sort_by, bool descending, const PageKey &key) {
+        static const char digits[] = "0123456789abcdef";
+        std::string raw;
+        raw += cursor_tag(sort_by);
+        raw += descending ? 'd' : 'a';
+        raw += ':' + std::to_string(key.value) + ':' + key.id;
+        std::string out;
+        out.reserve(raw.size() * 2);
+        for (unsigned char ch : raw) {
+            out += digits[ch >> 4];
+            out += digits[ch & 0x0F];
+        }
+        return out;
+    }
+
+    bool decode_cursor(const std::string &cursor, TaskPlatform::TaskSortKey sort_by, bool descending, PageKey &key) {
+        if (cursor.size() % 2 != 0) {
+            return false;
+        }
+        auto nibble = [](char ch) -> int {
+            if (ch >= '0' && ch <= '9') return ch - '0';
+            if (ch >= 'a' && ch <= 'f') return ch - 'a' + 10;
+            if (ch >= 'A' && ch <= 'F') return ch - 'A' + 10;
+            return -1;
+        };
+        std::string raw;
+        raw.reserve(cursor.size() / 2);
+        for (size_t i = 0; i < cursor.size(); i += 2) {
+            int hi = nibble(cursor[i]);
+            int lo = nibble(cursor[i + 1]);
+            if (hi < 0 || lo < 0) {
+                return false;
+            }
+            raw += static_cast<char>((hi << 4) | lo);
+        }
+        if (raw.size() < 4 || raw[0] != cursor_tag(sort_by) || raw[1] != (descending ? 'd' : 'a') || raw[2] != ':') {
+            return false;
+        }
+        size_t sep = raw.find(':', 3);
+        if (sep == std::string::npos || sep == 3) {
+            return false;
+        }
+        try {
+            size_t used = 0;
+            key.value = static_cast<std::int64_t>(std::stoll(raw.substr(3, sep - 3), &used));
+            if (used != sep - 3) {
+                return false;
+            }
+        } catch (...) {
+            return false;
+        }
+        key.id = raw.substr(sep + 1);
+        return true;
+    }
+
+    // 分段扫描时每次持锁最多取出的任务数
+    const size_t kQueryScanChunk = 512;
 }
 
 // ========== 内部实现类 ==========
@@ -33,21 +790,100 @@ public:
     std::atomic<size_t> total_completed_;
     std::atomic<size_t> total_failed_;
 
-    mutable std::mutex tasks_mutex_;
+    mutable ProfiledMutex tasks_mutex_{LockSite::PlatformTasks};
     std::map<TaskId, std::shared_ptr<Task>> tasks_;
 
-    mutable std::mutex claimers_mutex_;
+    mutable ProfiledMutex claimers_mutex_{LockSite::PlatformClaimers};
     std::map<std::string, std::shared_ptr<Claimer>> claimers_;
 
+    // 内存记账：任务字段占用由各任务增量上报到 task_memory_，容器节点开销在增删时维护
+    std::shared_ptr<TaskMemoryAccount> task_memory_;
+    std::atomic<std::size_t> task_index_bytes_;
+    std::atomic<std::size_t> claimer_index_bytes_;
+
+    // 可选的异步信号分发器（同时下发给已发布的任务与已注册的申领者）
+    SignalDispatcherRef signal_dispatcher_;
+
+    // 平台级进度信号合并策略（受 tasks_mutex_ 保护，发布时下发给任务）
+    ProgressCoalescing progress_coalescing_;
+
+    // 变更序号与增量同步日志
+    std::shared_ptr<ChangeLog> change_log_;
+
+    // 各阶段延迟直方图
+    std::shared_ptr<LatencyRecorder> latency_;
+
+    // 生命周期批量订阅（发布时挂接到任务）
+    std::shared_ptr<LifecycleHub> lifecycle_hub_;
+
     explicit Impl(const std::string &id)
         : platform_id_(id),
           max_queue_size_(10000),
           start_time_(std::chrono::system_clock::now()),
           total_completed_(0),
-          total_failed_(0) {}
+          total_failed_(0),
+          task_memory_(std::make_shared<TaskMemoryAccount>()),
+          task_index_bytes_(0),
+          claimer_index_bytes_(0),
+          change_log_(std::make_shared<ChangeLog>()),
+          latency_(std::make_shared<LatencyRecorder>()),
+          lifecycle_hub_(std::make_shared<LifecycleHub>(change_log_, latency_)) {}
+
+    ~Impl() {
+        lifecycle_hub_->clear();
+    }
+
+    // 加入任务表并挂接内存账户与生命周期汇（调用方需持有 tasks_mutex_ 并已检查队列上限）
+    void insert_task(const std::shared_ptr<Task> &task) {
+        auto inserted = tasks_.insert(std::make_pair(task->id(), task));
+        if (inserted.second) {
+            task_index_bytes_.fetch_add(task_node_bytes(inserted.first->first), std::memory_order_relaxed);
+        } else if (inserted.first->second != task) {
+            inserted.first->second->set_memory_account(nullptr);
+            inserted.first->second->set_lifecycle_sink(nullptr);
+            inserted.first->second = task;
+        }
+        task->set_memory_account(task_memory_);
+        task->set_lifecycle_sink(lifecycle_hub_);
+        if (progress_coalescing_.enabled()) {
+            task->set_progress_coalescing(progress_coalescing_);
+        }
+    }
+
+    static std::size_t task_node_bytes(const TaskId &task_id) {
+        return MemoryUsage::tree_node_bytes(sizeof(std::pair<const TaskId, std::shared_ptr<Task>>)) +
+               MemoryUsage::string_bytes(task_id);
+    }
+
+    static std::size_t claimer_node_bytes(const std::string &claimer_id) {
+        return MemoryUsage::tree_node_bytes(sizeof(std::pair<const std::string, std::shared_ptr<Claimer>>)) +
+               MemoryUsage::string_bytes(claimer_id);
+    }
+
+    // 从任务表中移除（调用方需持有 tasks_mutex_），返回下一个迭代器
+    std::map<TaskId, std::shared_ptr<Task>>::iterator
+    erase_task(std::map<TaskId, std::shared_ptr<Task>>::iterator it) {
+        task_index_bytes_.fetch_sub(task_node_bytes(it->first), std::memory_order_relaxed);
+        it->second->set_memory_account(nullptr);
+        it->second->set_lifecycle_sink(nullptr);
+        const std::uint64_t sequence = change_log_->remove(ChangeLog::TaskEntry, it->first);
+        it->second->set_change_sequence(sequence);
+        lifecycle_hub_->on_task_removed(*it->second, sequence);
+        return tasks_.erase(it);
+    }
 
     bool is_task_allowed_for_claimer(const std::shared_ptr<Task> &task,
                                      const std::shared_ptr<Claimer> &claimer) const {
+        if (!claimer) {
+            return false;
+        }
+        return is_task_allowed_for_claimer(task, claimer, *claimer->capabilities());
+    }
+
+    // 扫描路径使用：调用方在扫描开始时加载一次能力快照，避免每个候选任务复制分类集合
+    bool is_task_allowed_for_claimer(const std::shared_ptr<Task> &task,
+                                     const std::shared_ptr<Claimer> &claimer,
+                                     const ClaimerCapabilities &caps) const {
         if (!task || !claimer) {
             return false;
         }
@@ -58,11 +894,8 @@ public:
         }
 
         // 分类匹配（如果任务有分类要求）
-        if (!task->category().empty()) {
-            auto categories = claimer->categories();
-            if (!categories.empty() && categories.find(task->category()) == categories.end()) {
-                return false;
-            }
+        if (!caps.categories.empty() && !caps.accepts_category(task->category())) {
+            return false;
         }
 
         return true;
@@ -101,18 +934,100 @@ size_t TaskPlatform::max_task_queue_size() const noexcept {
     return d->max_queue_size_;
 }
 
+TaskPlatform &TaskPlatform::set_max_latency_series(size_t count) {
+    d->latency_->set_max_series(count);
+    return *this;
+}
+
+size_t TaskPlatform::max_latency_series() const noexcept {
+    return d->latency_->max_series();
+}
+
+TaskPlatform &TaskPlatform::set_signal_dispatcher(const std::shared_ptr<SignalDispatcher> &dispatcher) {
+    d->signal_dispatcher_.reset(dispatcher);
+    for (const auto &task : get_tasks()) {
+        task->set_signal_dispatcher(dispatcher);
+    }
+    for (const auto &claimer : get_claimers()) {
+        claimer->set_signal_dispatcher(dispatcher);
+    }
+    return *this;
+}
+
+std::shared_ptr<SignalDispatcher> TaskPlatform::signal_dispatcher() const {
+    return d->signal_dispatcher_.lock();
+}
+
+TaskPlatform &TaskPlatform::set_progress_coalescing(const ProgressCoalescing &coalescing) {
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
+    d->progress_coalescing_ = coalescing;
+    for (const auto &pair : d->tasks_) {
+        pair.second->set_progress_coalescing(coalescing);
+    }
+    return *this;
+}
+
+ProgressCoalescing TaskPlatform::progress_coalescing() const {
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
+    return d->progress_coalescing_;
+}
+
 // ========== 任务管理 ==========
 tl::expected<TaskId, Error> TaskPlatform::publish_task(const std::shared_ptr<Task> &task) {
     if (!task) {
         return tl::make_unexpected(Error("Task is null", ErrorCode::TASK_NOT_FOUND));
     }
 
+    ScopedSpan span("platform.publish_task", task->id());
     {
-        std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
         if (d->max_queue_size_ > 0 && d->tasks_.size() >= d->max_queue_size_) {
+            span.set_error("Platform task queue is full");
             return tl::make_unexpected(Error("Platform task queue is full", ErrorCode::PLATFORM_QUEUE_FULL));
         }
-        d->tasks_[task->id()] = task;
+        d->insert_task(task);
+    }
+
+    return span.record(_finish_publish(task));
+}
+
+std::vector<tl::expected<TaskId, Error>> TaskPlatform::publish_tasks(const std::vector<std::shared_ptr<Task>> &tasks) {
+    ScopedSpan span("platform.publish_tasks");
+    std::vector<tl::expected<TaskId, Error>> results;
+    results.reserve(tasks.size());
+    std::vector<bool> inserted(tasks.size(), false);
+
+    {
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (!tasks[i]) {
+                continue;
+            }
+            if (d->max_queue_size_ > 0 && d->tasks_.size() >= d->max_queue_size_) {
+                break;  // 队列已满，其余任务均失败
+            }
+            d->insert_task(tasks[i]);
+            inserted[i] = true;
+        }
+    }
+
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (!tasks[i]) {
+            results.push_back(tl::make_unexpected(Error("Task is null", ErrorCode::TASK_NOT_FOUND)));
+        } else if (!inserted[i]) {
+            results.push_back(tl::make_unexpected(Error("Platform task queue is full", ErrorCode::PLATFORM_QUEUE_FULL)));
+        } else {
+            results.push_back(_finish_publish(tasks[i]));
+        }
+    }
+    return results;
+}
+
+tl::expected<TaskId, Error> TaskPlatform::_finish_publish(const std::shared_ptr<Task> &task) {
+    // 在发布前挂接分发器，使发布产生的状态信号也走异步路径
+    auto dispatcher = d->signal_dispatcher_.lock();
+    if (dispatcher) {
+        task->set_signal_dispatcher(dispatcher);
     }
 
     // 确保状态为 Published
@@ -123,7 +1038,10 @@ tl::expected<TaskId, Error> TaskPlatform::publish_task(const std::shared_ptr<Tas
         }
     }
 
-    emit sig_task_published(task);
+    // 草稿任务的发布转换已登记过；这里再登记一次以覆盖重新发布同 ID 任务（复活墓碑）的情况
+    task->set_change_sequence(d->change_log_->touch(ChangeLog::TaskEntry, task->id()));
+
+    dispatch_signal(d->signal_dispatcher_, *this, sig_task_published, task);
     return task->id();
 }
 
@@ -138,7 +1056,7 @@ tl::expected<TaskId, Error> TaskPlatform::create_and_publish_task(const std::fun
 }
 
 std::shared_ptr<Task> TaskPlatform::get_task(const TaskId &task_id) const {
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     auto it = d->tasks_.find(task_id);
     if (it != d->tasks_.end()) {
         return it->second;
@@ -147,7 +1065,7 @@ std::shared_ptr<Task> TaskPlatform::get_task(const TaskId &task_id) const {
 }
 
 bool TaskPlatform::has_task(const TaskId &task_id) const {
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     return d->tasks_.find(task_id) != d->tasks_.end();
 }
 
@@ -156,7 +1074,7 @@ bool TaskPlatform::_delete_task_internal(const TaskId &task_id, bool force) {
     std::string claimer_id;
     bool has_active_claimer = false;
     {
-        std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
         auto it = d->tasks_.find(task_id);
         if (it == d->tasks_.end()) return false;
         task = it->second;
@@ -170,14 +1088,14 @@ bool TaskPlatform::_delete_task_internal(const TaskId &task_id, bool force) {
             // 不允许删除仍处于活动态的已申领任务
             return false;
         }
-        d->tasks_.erase(it);
+        d->erase_task(it);
     }
 
     // 如果是强制删除且任务之前被某个 Claimer 申领，尝试通知 Claimer 进行清理
     if (force && has_active_claimer) {
         std::shared_ptr<Claimer> claimer;
         {
-            std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+            std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
             auto itc = d->claimers_.find(claimer_id);
             if (itc != d->claimers_.end()) {
                 claimer = itc->second;
@@ -190,7 +1108,7 @@ bool TaskPlatform::_delete_task_internal(const TaskId &task_id, bool force) {
     }
 
     // 在释放平台锁后触发删除信号
-    emit sig_task_deleted(task);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_task_deleted, task);
     return true;
 }
 
@@ -211,14 +1129,14 @@ bool TaskPlatform::cancel_task(const TaskId &task_id) {
         if (!cancel_result.has_value()) {
             return false;
         }
-        emit sig_task_cancelled(task);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_task_cancelled, task);
         return true;
     }
 
     // 已被申领或正在处理：发出协作式取消请求，通知申领者
     std::string reason = "Cancelled by publisher";
     task->request_cancel(reason);
-    emit sig_task_cancel_requested(task, reason);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_task_cancel_requested, task, reason);
     return true;
 }
 
@@ -229,7 +1147,7 @@ void TaskPlatform::clear_tasks_by_status(TaskStatus status, bool only_auto_clean
 
     std::vector<std::shared_ptr<Task>> deleted;
     {
-        std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
         for (auto it = d->tasks_.begin(); it != d->tasks_.end();) {
             const auto &task = it->second;
             if (task->status() == status) {
@@ -238,7 +1156,7 @@ void TaskPlatform::clear_tasks_by_status(TaskStatus status, bool only_auto_clean
                     continue;
                 }
                 deleted.push_back(task);
-                it = d->tasks_.erase(it);
+                it = d->erase_task(it);
             } else {
                 ++it;
             }
@@ -247,7 +1165,7 @@ void TaskPlatform::clear_tasks_by_status(TaskStatus status, bool only_auto_clean
 
     // 在释放平台锁后触发删除信号
     for (const auto &t : deleted) {
-        emit sig_task_deleted(t);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_task_deleted, t);
     }
 }
 
@@ -257,41 +1175,144 @@ void TaskPlatform::clear_completed_tasks(bool only_auto_clean) {
 
 // ========== 任务查询 ==========
 std::vector<std::shared_ptr<Task>> TaskPlatform::get_tasks(const TaskFilter &filter) const {
+    // 除状态外的条件需要读取多个受锁保护的字段，此时改用任务快照一次性读取
+    const bool needs_view = filter.category.has_value() ||
+                            filter.min_priority.has_value() ||
+                            filter.max_priority.has_value() ||
+                            !filter.tags.empty() ||
+                            filter.claimer_id.has_value();
+
     std::vector<std::shared_ptr<Task>> result;
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     for (const auto &pair : d->tasks_) {
         const auto &task = pair.second;
-        bool match = true;
 
         if (filter.status.has_value() && task->status() != filter.status.value()) {
-            match = false;
+            continue;
         }
-        if (match && filter.category.has_value() && task->category() != filter.category.value()) {
-            match = false;
+        if (needs_view && !view_matches(filter, *task->snapshot())) {
+            continue;
         }
-        if (match && filter.min_priority.has_value() && task->priority() < filter.min_priority.value()) {
-            match = false;
+
+        result.push_back(task);
+    }
+    return result;
+}
+
+tl::expected<TaskPlatform::TaskPage, Error> TaskPlatform::query_tasks(const TaskQuery &query) const {
+    PageKey after = PageKey();
+    const bool has_after = !query.cursor.empty();
+    if (has_after && !decode_cursor(query.cursor, query.sort_by, query.descending, after)) {
+        return tl::make_unexpected(Error("Invalid task page cursor", ErrorCode::PLATFORM_INVALID_CURSOR));
+    }
+
+    const size_t limit = std::max<size_t>(query.limit, 1);
+    const bool by_id = query.sort_by == TaskSortKey::Id;
+    const PageKeyLess less{query.descending};
+    typedef std::pair<PageKey, std::shared_ptr<const TaskView>> Entry;
+    auto entry_less = [&less](const Entry &a, const Entry &b) { return less(a.first, b.first); };
+
+    // 最多保留 limit + 1 项（多出的一项用于判断是否还有下一页）；非 ID 排序时为按顺序最靠前项的大顶堆
+    std::vector<Entry> best;
+    best.reserve(limit + 1);
+
+    std::vector<std::shared_ptr<Task>> chunk;
+    chunk.reserve(kQueryScanChunk);
+    TaskId resume;
+    bool resumed = false;
+    bool exhausted = false;
+    while (!exhausted) {
+        chunk.clear();
+        {
+            // 按 ID 分段取出任务：每段只持锁复制 kQueryScanChunk 个指针，快照与过滤在锁外进行
+            std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
+            const bool seek = resumed || (by_id && has_after);
+            const TaskId &from = resumed ? resume : after.id;
+            if (!query.descending) {
+                auto it = seek ? d->tasks_.upper_bound(from) : d->tasks_.begin();
+                for (; it != d->tasks_.end() && chunk.size() < kQueryScanChunk; ++it) {
+                    chunk.push_back(it->second);
+                }
+                exhausted = it == d->tasks_.end();
+            } else {
+                auto it = seek ? std::map<TaskId, std::shared_ptr<Task>>::const_reverse_iterator(d->tasks_.lower_bound(from))
+                               : d->tasks_.crbegin();
+                for (; it != d->tasks_.crend() && chunk.size() < kQueryScanChunk; ++it) {
+                    chunk.push_back(it->second);
+                }
+                exhausted = it == d->tasks_.crend();
+            }
         }
-        if (match && filter.max_priority.has_value() && task->priority() > filter.max_priority.value()) {
-            match = false;
+        if (!chunk.empty()) {
+            resume = chunk.back()->id();
+            resumed = true;
         }
-        if (match && !filter.tags.empty()) {
-            for (const auto &tag : filter.tags) {
-                if (task->tags().find(tag) == task->tags().end()) {
-                    match = false;
-                    break;
-                }
+
+        for (const auto &task : chunk) {
+            if (query.filter.status.has_value() && task->status() != query.filter.status.value()) {
+                continue;
+            }
+            auto view = task->snapshot();
+            if (query.filter.status.has_value() && view->status != query.filter.status.value()) {
+                continue;
+            }
+            if (!view_matches(query.filter, *view)) {
+                continue;
+            }
+            Entry entry(PageKey{page_value(query.sort_by, *view), view->id}, view);
+            if (has_after && !less(after, entry.first)) {
+                continue;
+            }
+            if (by_id) {
+                best.push_back(std::move(entry));  // 扫描顺序即结果顺序
+            } else if (best.size() <= limit) {
+                best.push_back(std::move(entry));
+                std::push_heap(best.begin(), best.end(), entry_less);
+            } else if (entry_less(entry, best.front())) {
+                std::pop_heap(best.begin(), best.end(), entry_less);
+                best.back() = std::move(entry);
+                std::push_heap(best.begin(), best.end(), entry_less);
             }
         }
-        if (match && filter.claimer_id.has_value() && task->claimer_id() != filter.claimer_id.value()) {
-            match = false;
+        if (by_id && best.size() > limit) {
+            break;
         }
+    }
+
+    if (!by_id) {
+        std::sort_heap(best.begin(), best.end(), entry_less);
+    }
+    TaskPage page;
+    if (best.size() > limit) {
+        best.resize(limit);
+        page.next_cursor = encode_cursor(query.sort_by, query.descending, best.back().first);
+    }
+    page.tasks.reserve(best.size());
+    for (auto &entry : best) {
+        page.tasks.push_back(std::move(entry.second));
+    }
+    return page;
+}
+
+std::uint64_t TaskPlatform::change_sequence() const {
+    return d->change_log_->sequence();
+}
 
-        if (match) {
-            result.push_back(task);
+TaskPlatform::ChangeSet TaskPlatform::get_changes_since(std::uint64_t since, size_t limit) const {
+    ChangeSet changes;
+    std::vector<std::pair<std::uint64_t, TaskId>> changed;
+    d->change_log_->collect(since, std::max<size_t>(limit, 1), changes, changed);
+
+    changes.tasks.reserve(changed.size());
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
+    for (const auto &entry : changed) {
+        // 收集后被删除的任务会以更大的序号出现在墓碑中，这里直接跳过
+        auto it = d->tasks_.find(entry.second);
+        if (it != d->tasks_.end()) {
+            changes.tasks.push_back(it->second);
         }
     }
-    return result;
+    return changes;
 }
 
 std::vector<std::shared_ptr<Task>> TaskPlatform::get_published_tasks() const {
@@ -318,7 +1339,7 @@ std::vector<std::shared_ptr<Task>> TaskPlatform::get_tasks_by_priority(int min_p
 }
 
 tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::try_get_next_task() const {
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     std::shared_ptr<Task> best = nullptr;
     int best_priority = -1;
     for (const auto &pair : d->tasks_) {
@@ -339,13 +1360,13 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::try_get_next_task() con
 }
 
 size_t TaskPlatform::task_count() const {
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     return d->tasks_.size();
 }
 
 size_t TaskPlatform::task_count_by_status(TaskStatus status) const {
     size_t count = 0;
-    std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
     for (const auto &pair : d->tasks_) {
         if (pair.second->status() == status) {
             count++;
@@ -360,30 +1381,44 @@ void TaskPlatform::register_claimer(const std::shared_ptr<Claimer> &claimer) {
         return;
     }
     claimer->set_platform(this);
+    auto dispatcher = d->signal_dispatcher_.lock();
+    if (dispatcher) {
+        claimer->set_signal_dispatcher(dispatcher);
+    }
     {
-        std::lock_guard<std::mutex> lock(d->claimers_mutex_);
-        d->claimers_[claimer->id()] = claimer;
+        std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
+        auto inserted = d->claimers_.insert(std::make_pair(claimer->id(), claimer));
+        if (inserted.second) {
+            d->claimer_index_bytes_.fetch_add(Impl::claimer_node_bytes(inserted.first->first),
+                                              std::memory_order_relaxed);
+        } else {
+            inserted.first->second = claimer;
+        }
     }
-    emit sig_claimer_registered(claimer);
+    d->change_log_->touch(ChangeLog::ClaimerEntry, claimer->id());
+    dispatch_signal(d->signal_dispatcher_, *this, sig_claimer_registered, claimer);
 }
 
 bool TaskPlatform::unregister_claimer(const std::string &claimer_id) {
     std::shared_ptr<Claimer> removed;
     {
-        std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
         auto it = d->claimers_.find(claimer_id);
         if (it == d->claimers_.end()) {
             return false;
         }
         removed = it->second;
+        d->claimer_index_bytes_.fetch_sub(Impl::claimer_node_bytes(it->first), std::memory_order_relaxed);
         d->claimers_.erase(it);
     }
-    emit sig_claimer_unregistered(claimer_id);
+    d->change_log_->remove(ChangeLog::ClaimerEntry, claimer_id);
+    d->latency_->remove_claimer(claimer_id);
+    dispatch_signal(d->signal_dispatcher_, *this, sig_claimer_unregistered, claimer_id);
     return true;
 }
 
 std::shared_ptr<Claimer> TaskPlatform::get_claimer(const std::string &claimer_id) const {
-    std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
     auto it = d->claimers_.find(claimer_id);
     if (it != d->claimers_.end()) {
         return it->second;
@@ -392,13 +1427,13 @@ std::shared_ptr<Claimer> TaskPlatform::get_claimer(const std::string &claimer_id
 }
 
 bool TaskPlatform::has_claimer(const std::string &claimer_id) const {
-    std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
     return d->claimers_.find(claimer_id) != d->claimers_.end();
 }
 
 std::vector<std::shared_ptr<Claimer>> TaskPlatform::get_claimers() const {
     std::vector<std::shared_ptr<Claimer>> result;
-    std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
     for (const auto &pair : d->claimers_) {
         result.push_back(pair.second);
     }
@@ -406,12 +1441,20 @@ std::vector<std::shared_ptr<Claimer>> TaskPlatform::get_claimers() const {
 }
 
 size_t TaskPlatform::claimer_count() const {
-    std::lock_guard<std::mutex> lock(d->claimers_mutex_);
+    std::lock_guard<ProfiledMutex> lock(d->claimers_mutex_);
     return d->claimers_.size();
 }
 
 // ========== 任务申领 ==========
 tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_task(const std::shared_ptr<Claimer> &claimer, const TaskId &task_id) {
+    if (!claimer) {
+        return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
+    }
+    ScopedSpan span("platform.claim_task", task_id, claimer->id());
+    return span.record(_claim_task(claimer, task_id));
+}
+
+tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::_claim_task(const std::shared_ptr<Claimer> &claimer, const TaskId &task_id) {
     if (!claimer) {
         return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
     }
@@ -435,13 +1478,21 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_task(const std::s
     // 调用 Claimer 自身的申领逻辑
     auto result = claimer->claim_task(task);
     if (result.has_value()) {
-        emit sig_task_claimed(task);
+        dispatch_signal(d->signal_dispatcher_, *this, sig_task_claimed, task);
         return task;  // 返回 task 对象
     }
     return tl::make_unexpected(result.error());
 }
 
 tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_next_task(const std::shared_ptr<Claimer> &claimer) {
+    if (!claimer) {
+        return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
+    }
+    ScopedSpan span("platform.claim_next_task", kNoTaskId, claimer->id());
+    return traced_claim(span, _claim_next_task(claimer));
+}
+
+tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::_claim_next_task(const std::shared_ptr<Claimer> &claimer) {
     if (!claimer) {
         return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
     }
@@ -451,14 +1502,15 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_next_task(const s
 
     std::shared_ptr<Task> best = nullptr;
     int best_priority = -1;
+    auto caps = claimer->capabilities();
     {
-        std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
         for (const auto &pair : d->tasks_) {
             const auto &task = pair.second;
             if (task->status() != TaskStatus::Published) {
                 continue;
             }
-            if (!d->is_task_allowed_for_claimer(task, claimer)) {
+            if (!d->is_task_allowed_for_claimer(task, claimer, *caps)) {
                 continue;
             }
             if (task->priority() > best_priority) {
@@ -476,6 +1528,14 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_next_task(const s
 }
 
 tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_matching_task(const std::shared_ptr<Claimer> &claimer) {
+    if (!claimer) {
+        return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
+    }
+    ScopedSpan span("platform.claim_matching_task", kNoTaskId, claimer->id());
+    return traced_claim(span, _claim_matching_task(claimer));
+}
+
+tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::_claim_matching_task(const std::shared_ptr<Claimer> &claimer) {
     if (!claimer) {
         return tl::make_unexpected(Error("Claimer is null", ErrorCode::CLAIMER_NOT_FOUND));
     }
@@ -486,17 +1546,18 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_matching_task(con
     std::shared_ptr<Task> best = nullptr;
     int best_score = -1;
     int best_priority = -1;
+    auto caps = claimer->capabilities();
     {
-        std::lock_guard<std::mutex> lock(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock(d->tasks_mutex_);
         for (const auto &pair : d->tasks_) {
             const auto &task = pair.second;
             if (task->status() != TaskStatus::Published) {
                 continue;
             }
-            if (!d->is_task_allowed_for_claimer(task, claimer)) {
+            if (!d->is_task_allowed_for_claimer(task, claimer, *caps)) {
                 continue;
             }
-            int score = claimer->calculate_match_score(task);
+            int score = claimer->calculate_match_score(task, *caps);
             if (score > best_score || (score == best_score && task->priority() > best_priority)) {
                 best_score = score;
                 best_priority = task->priority();
@@ -514,6 +1575,10 @@ tl::expected<std::shared_ptr<Task>, Error> TaskPlatform::claim_matching_task(con
 
 std::vector<std::shared_ptr<Task>> TaskPlatform::claim_tasks_to_capacity(const std::shared_ptr<Claimer> &claimer) {
     std::vector<std::shared_ptr<Task>> claimed;
+    if (!claimer) {
+        return claimed;
+    }
+    ScopedSpan span("platform.claim_tasks_to_capacity", kNoTaskId, claimer->id());
     while (claimer && claimer->can_claim_more()) {
         auto result = claim_matching_task(claimer);
         if (!result.has_value()) {
@@ -529,6 +1594,27 @@ TaskBuilder TaskPlatform::task_builder() {
     return TaskBuilder(this);
 }
 
+// ========== 生命周期批量订阅 ==========
+std::uint64_t TaskPlatform::subscribe_lifecycle_batches(LifecycleBatchHandler handler,
+                                                        const LifecycleBatchOptions &options) {
+    if (!handler) {
+        return 0;
+    }
+    return d->lifecycle_hub_->add(std::move(handler), options);
+}
+
+bool TaskPlatform::unsubscribe_lifecycle_batches(std::uint64_t subscription_id) {
+    return d->lifecycle_hub_->remove(subscription_id);
+}
+
+void TaskPlatform::flush_lifecycle_batches() {
+    d->lifecycle_hub_->flush();
+}
+
+std::uint64_t TaskPlatform::lifecycle_batch_dropped(std::uint64_t subscription_id) const {
+    return d->lifecycle_hub_->dropped(subscription_id);
+}
+
 // ========== 统计 ==========
 TaskPlatform::PlatformStatistics TaskPlatform::get_statistics() const {
     PlatformStatistics stats{};
@@ -543,7 +1629,7 @@ TaskPlatform::PlatformStatistics TaskPlatform::get_statistics() const {
     stats.abandoned_tasks = 0;
 
     {
-        std::lock_guard<std::mutex> lock_tasks(d->tasks_mutex_);
+        std::lock_guard<ProfiledMutex> lock_tasks(d->tasks_mutex_);
         stats.total_tasks = d->tasks_.size();
 
         for (const auto &pair : d->tasks_) {
@@ -561,12 +1647,29 @@ TaskPlatform::PlatformStatistics TaskPlatform::get_statistics() const {
     }
 
     {
-        std::lock_guard<std::mutex> lock_claimers(d->claimers_mutex_);
+        std::lock_guard<ProfiledMutex> lock_claimers(d->claimers_mutex_);
         stats.total_claimers = d->claimers_.size();
     }
 
     return stats;
 }
 
+std::vector<TaskPlatform::LatencySeries> TaskPlatform::latency_histograms() const {
+    return d->latency_->snapshot();
+}
+
+MemoryUsage TaskPlatform::memory_usage() const {
+    auto clamp = [](std::int64_t bytes) {
+        return static_cast<std::size_t>(std::max<std::int64_t>(0, bytes));
+    };
+    MemoryUsage usage;
+    usage.components["tasks"] = clamp(d->task_memory_->task_bytes.load(std::memory_order_relaxed));
+    usage.components["task_metadata"] = clamp(d->task_memory_->metadata_bytes.load(std::memory_order_relaxed));
+    usage.components["task_handlers"] = clamp(d->task_memory_->handler_bytes.load(std::memory_order_relaxed));
+    usage.components["task_index"] = d->task_index_bytes_.load(std::memory_order_relaxed);
+    usage.components["claimer_index"] = d->claimer_index_bytes_.load(std::memory_order_relaxed);
+    return usage;
+}
+
 } // namespace youdidit
 } // namespace xswl
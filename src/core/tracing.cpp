@@ -0,0 +1,169 @@
+#include <xswl/youdidit/core/tracing.hpp>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace xswl {
+namespace youdidit {
+
+namespace detail {
+std::atomic<bool> g_tracer_installed{false};
+}
+
+namespace {
+std::mutex g_tracer_mutex;
+std::shared_ptr<Tracer> g_tracer;   // 只通过 std::atomic_load/atomic_store 访问
+
+#if XSWL_YOUDIDIT_ENABLE_TRACING
+// 当前线程最内层 span 的 ID，作为新 span 的 parent_id
+thread_local std::uint64_t t_current_span = 0;
+#endif
+}
+
+void set_tracer(std::shared_ptr<Tracer> tracer) {
+    std::lock_guard<std::mutex> lock(g_tracer_mutex);
+    const bool installed = static_cast<bool>(tracer);
+    std::atomic_store(&g_tracer, std::move(tracer));
+    detail::g_tracer_installed.store(installed, std::memory_order_release);
+}
+
+std::shared_ptr<Tracer> get_tracer() {
+    return std::atomic_load(&g_tracer);
+}
+
+// ========== ScopedSpan ==========
+#if XSWL_YOUDIDIT_ENABLE_TRACING
+struct ScopedSpan::State {
+    std::shared_ptr<Tracer> tracer;   // 持有开始时的追踪器，中途替换也在同一个追踪器上结束
+    std::uint64_t span_id;
+    std::uint64_t parent_id;
+    std::string task_id;
+    std::string error;
+};
+
+void ScopedSpan::_begin(const char *name, const std::string *task_id, const std::string *claimer_id) {
+    auto tracer = std::atomic_load(&g_tracer);
+    if (!tracer) {
+        return;
+    }
+    static const std::string kEmpty;
+    const std::uint64_t parent = t_current_span;
+    const std::uint64_t id = tracer->begin_span(name, parent, task_id ? *task_id : kEmpty,
+                                                claimer_id ? *claimer_id : kEmpty);
+    if (id == 0) {
+        return;
+    }
+    state_ = new State{std::move(tracer), id, parent, std::string(), std::string()};
+    t_current_span = id;
+}
+
+void ScopedSpan::_end() noexcept {
+    t_current_span = state_->parent_id;
+    state_->tracer->end_span(state_->span_id, state_->task_id, state_->error);
+    delete state_;
+    state_ = nullptr;
+}
+
+void ScopedSpan::set_task_id(const std::string &task_id) {
+    if (state_) {
+        state_->task_id = task_id;
+    }
+}
+
+void ScopedSpan::set_error(const std::string &error) {
+    if (state_) {
+        state_->error = error;
+    }
+}
+#endif
+
+// ========== InMemoryTracer ==========
+class InMemoryTracer::Impl {
+public:
+    struct OpenSpan {
+        SpanRecord record;
+        std::chrono::steady_clock::time_point started;
+    };
+
+    explicit Impl(std::size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+    const std::size_t capacity_;
+    std::atomic<std::uint64_t> next_id_{1};
+    mutable std::mutex mutex_;
+    std::unordered_map<std::uint64_t, OpenSpan> open_;
+    std::deque<SpanRecord> finished_;
+    std::uint64_t dropped_{0};
+};
+
+InMemoryTracer::InMemoryTracer(std::size_t capacity) : d(new Impl(capacity)) {}
+
+InMemoryTracer::~InMemoryTracer() noexcept = default;
+
+std::uint64_t InMemoryTracer::begin_span(const char *name, std::uint64_t parent_id, const std::string &task_id,
+                                         const std::string &claimer_id) noexcept {
+    try {
+        Impl::OpenSpan span;
+        span.record.span_id = d->next_id_.fetch_add(1, std::memory_order_relaxed);
+        span.record.parent_id = parent_id;
+        span.record.name = name;
+        span.record.task_id = task_id;
+        span.record.claimer_id = claimer_id;
+        span.record.start_time = std::chrono::system_clock::now();
+        span.started = std::chrono::steady_clock::now();
+        const std::uint64_t id = span.record.span_id;
+        std::lock_guard<std::mutex> lock(d->mutex_);
+        d->open_.emplace(id, std::move(span));
+        return id;
+    } catch (...) {
+        return 0;  // 内存不足时不追踪该 span
+    }
+}
+
+void InMemoryTracer::end_span(std::uint64_t span_id, const std::string &task_id, const std::string &error) noexcept {
+    const auto now = std::chrono::steady_clock::now();
+    try {
+        std::lock_guard<std::mutex> lock(d->mutex_);
+        auto it = d->open_.find(span_id);
+        if (it == d->open_.end()) {
+            return;  // clear() 之后结束的 span
+        }
+        SpanRecord record = std::move(it->second.record);
+        record.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(now - it->second.started);
+        d->open_.erase(it);
+        if (!task_id.empty()) {
+            record.task_id = task_id;
+        }
+        record.error = error;
+        if (d->finished_.size() >= d->capacity_) {
+            d->finished_.pop_front();
+            ++d->dropped_;
+        }
+        d->finished_.push_back(std::move(record));
+    } catch (...) {
+    }
+}
+
+std::vector<SpanRecord> InMemoryTracer::spans() const {
+    std::lock_guard<std::mutex> lock(d->mutex_);
+    return std::vector<SpanRecord>(d->finished_.begin(), d->finished_.end());
+}
+
+std::size_t InMemoryTracer::open_span_count() const {
+    std::lock_guard<std::mutex> lock(d->mutex_);
+    return d->open_.size();
+}
+
+std::uint64_t InMemoryTracer::dropped() const {
+    std::lock_guard<std::mutex> lock(d->mutex_);
+    return d->dropped_;
+}
+
+void InMemoryTracer::clear() {
+    std::lock_guard<std::mutex> lock(d->mutex_);
+    d->open_.clear();
+    d->finished_.clear();
+    d->dropped_ = 0;
+}
+
+} // namespace youdidit
+} // namespace xswl
@@ -77,6 +77,21 @@ tl::optional<ClaimerState> claimer_state_from_string(const std::string &str) {
     return tl::nullopt;
 }
 
+// ========== Payload 实现 ==========
+
+Payload::Payload(std::string data)
+    : data_(std::make_shared<const std::string>(std::move(data))) {
+}
+
+Payload::Payload(const char *data, std::size_t size)
+    : data_(std::make_shared<const std::string>(data, size)) {
+}
+
+const std::string &Payload::str() const noexcept {
+    static const std::string empty;
+    return data_ ? *data_ : empty;
+}
+
 // ========== TaskResult 实现 ==========
 
 TaskResult::TaskResult()
@@ -97,5 +112,27 @@ Error::Error(const std::string &msg, ErrorCode error_code)
     : message(msg), code(error_code) {
 }
 
+// ========== MemoryUsage 实现 ==========
+
+std::size_t MemoryUsage::total_bytes() const noexcept {
+    std::size_t total = 0;
+    for (const auto &pair : components) {
+        total += pair.second;
+    }
+    return total;
+}
+
+std::size_t MemoryUsage::string_bytes(const std::string &str) noexcept {
+    // 超出内联缓冲区后才会在堆上分配（capacity + 结尾的 '\0'）；
+    // 内联容量取空字符串的 capacity()（libstdc++ 为 15，libc++ 为 22，没有短字符串优化时为 0）
+    static const std::size_t inline_capacity = std::string().capacity();
+    return str.capacity() > inline_capacity ? str.capacity() + 1 : 0;
+}
+
+std::size_t MemoryUsage::tree_node_bytes(std::size_t payload) noexcept {
+    // 红黑树节点：颜色 + 父/左/右指针
+    return 4 * sizeof(void *) + payload;
+}
+
 } // namespace youdidit
 } // namespace xswl
@@ -517,6 +517,13 @@ void test_match_score_calculation() {
     // 空任务
     int score3 = claimer.calculate_match_score(nullptr);
     assert_equal(score3, 0, "Score for null task should be 0");
+
+    // 显式传入的能力快照：结果与默认重载一致，且不受之后修改的影响
+    auto caps = claimer.capabilities();
+    assert_equal(claimer.calculate_match_score(task1, *caps), score1, "Snapshot overload should match the default");
+    claimer.add_category("frontend");
+    assert_equal(claimer.calculate_match_score(task2, *caps), score2, "Held snapshot should ignore later changes");
+    assert_true(claimer.calculate_match_score(task2) > score2, "Default overload should load the latest snapshot");
     
     std::cout << "PASSED" << std::endl;
 }
@@ -538,6 +545,34 @@ void test_move_semantics() {
     std::cout << "PASSED" << std::endl;
 }
 
+// 测试18: 能力快照（写时复制 + 版本号）
+void test_capabilities_snapshot() {
+    std::cout << "Test 18: Capabilities snapshot... ";
+    
+    Claimer claimer("claimer-018", "Sam");
+    auto caps0 = claimer.capabilities();
+    assert_equal(caps0->version, 0u, "Initial capabilities version should be 0");
+    assert_true(caps0->accepts_category("anything"), "Empty categories should accept any category");
+    
+    claimer.add_category("backend").add_role("developer");
+    auto caps1 = claimer.capabilities();
+    assert_equal(caps1->version, 2u, "Each capability change should bump version");
+    assert_true(caps1->has_category("backend"), "Snapshot should contain backend");
+    assert_true(caps1->has_role("developer"), "Snapshot should contain developer role");
+    assert_true(!caps1->accepts_category("frontend"), "Restricted categories should reject others");
+    assert_true(caps1->accepts_category(""), "Uncategorized task should always be accepted");
+    assert_true(caps0->categories.empty(), "Old snapshot must stay immutable");
+    
+    claimer.add_category("backend");  // 重复添加不产生新版本
+    assert_true(claimer.capabilities().get() == caps1.get(), "No-op change should keep snapshot");
+    
+    claimer.remove_category("backend");
+    assert_equal(claimer.capabilities_version(), 3u, "Removal should bump version");
+    assert_true(!claimer.capabilities()->has_category("backend"), "Removed category should be gone");
+    
+    std::cout << "PASSED" << std::endl;
+}
+
 // ========== 主函数 ==========
 int main() {
     std::cout << "Running Claimer unit tests..." << std::endl;
@@ -560,6 +595,7 @@ int main() {
     test_task_query_methods();
     test_match_score_calculation();
     test_move_semantics();
+    test_capabilities_snapshot();
     
     std::cout << "================================" << std::endl;
     std::cout << "All tests passed!" << std::endl;
@@ -0,0 +1,188 @@
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/latency_histogram.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+// 简单断言工具
+void assert_true(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "Assertion failed: " << message << std::endl;
+        std::exit(1);
+    }
+}
+
+void assert_equal(std::uint64_t lhs, std::uint64_t rhs, const char* message) {
+    if (lhs != rhs) {
+        std::cerr << "Assertion failed: " << message
+                  << " (expected " << rhs << ", got " << lhs << ")" << std::endl;
+        std::exit(1);
+    }
+}
+
+// ========== 测试用例 ==========
+void test_bucket_layout() {
+    std::cout << "Test 1: Log-bucket boundaries... ";
+    // 小值每微秒一个桶
+    for (std::uint64_t v = 0; v < LatencyHistogram::kSubBucketCount; ++v) {
+        assert_equal(LatencyHistogram::bucket_index(v), v, "Small values should map to their own bucket");
+    }
+    // 桶边界连续，且每个值都落在所在桶的 [下界, 上界) 内，相对宽度不超过 1/16
+    for (std::size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        std::uint64_t lower = LatencyHistogram::bucket_lower_bound(i);
+        std::uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+        assert_true(upper > lower, "Buckets should be non-empty");
+        assert_equal(LatencyHistogram::bucket_index(lower), i, "Lower bound should map back to its bucket");
+        assert_equal(LatencyHistogram::bucket_index(upper - 1), i, "Upper bound - 1 should stay in the bucket");
+        if (lower >= LatencyHistogram::kSubBucketCount) {
+            assert_true((upper - lower) * 16 <= lower, "Relative bucket width should be at most 1/16");
+        }
+    }
+    assert_equal(LatencyHistogram::bucket_index(UINT64_MAX), LatencyHistogram::kBucketCount - 1,
+                 "Maximum value should map to the last bucket");
+    // 超过 2^40us 的值全部记入最后一个桶，桶数组保持小巧
+    const std::uint64_t top = std::uint64_t(1) << LatencyHistogram::kMaxValueBits;
+    assert_equal(LatencyHistogram::bucket_index(top - 1), LatencyHistogram::kBucketCount - 1,
+                 "The largest in-range value should use the last bucket");
+    assert_equal(LatencyHistogram::bucket_index(top * 3), LatencyHistogram::kBucketCount - 1,
+                 "Out-of-range values should clamp to the last bucket");
+    assert_true(LatencyHistogram::kBucketCount * sizeof(std::uint64_t) < 5000, "A shard should stay under 5KB");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_percentiles_and_merge() {
+    std::cout << "Test 2: Percentiles across thread shards... ";
+    LatencyHistogram histogram;
+    const int kThreads = 4;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        // 每个线程记录 1..1000us 各一次
+        threads.emplace_back([&histogram]() {
+            for (std::uint64_t v = 1; v <= 1000; ++v) {
+                histogram.record(v);
+            }
+        });
+    }
+    for (auto &t : threads) {
+        t.join();
+    }
+    auto snap = histogram.snapshot();
+    assert_equal(snap.count, 4000, "All samples should be merged");
+    assert_equal(snap.sum, 4 * 500500ULL, "Sum should be exact");
+
+    std::uint64_t p50 = snap.percentile(0.5);
+    std::uint64_t p99 = snap.percentile(0.99);
+    std::uint64_t p999 = snap.percentile(0.999);
+    assert_true(p50 >= 500 && p50 <= 500 + 500 / 16, "p50 should be within one bucket above 500us");
+    assert_true(p99 >= 990 && p99 <= 990 + 990 / 16, "p99 should be within one bucket above 990us");
+    assert_true(p999 >= 999 && p999 <= 1023, "p999 should be within one bucket above 999us");
+    assert_equal(snap.count_below(64), 4 * 63, "Counts below a bucket edge should be exact");
+
+    LatencyHistogram::Snapshot merged;
+    merged.merge(snap);
+    merged.merge(snap);
+    assert_equal(merged.count, 8000, "Merged snapshot should add counts");
+    assert_equal(LatencyHistogram::Snapshot().percentile(0.99), 0, "Empty histogram should report 0");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_platform_records_stages() {
+    std::cout << "Test 3: Platform records lifecycle stages... ";
+    auto platform = std::make_shared<TaskPlatform>("latency-platform");
+    auto claimer = std::make_shared<Claimer>("worker-1", "Worker");
+    platform->register_claimer(claimer);
+
+    const int kTasks = 5;
+    for (int i = 0; i < kTasks; ++i) {
+        auto task = platform->task_builder()
+                        .title("t" + std::to_string(i))
+                        .category("ingest")
+                        .handler([](Task &, const std::string &) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                            return TaskResult("ok");
+                        })
+                        .build();
+        platform->publish_task(task);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    for (int i = 0; i < kTasks; ++i) {
+        auto claimed = claimer->claim_next_task();
+        assert_true(claimed.has_value(), "Task should be claimable");
+        assert_true(claimer->run_task(claimed.value(), std::string()).ok(), "Task should complete");
+    }
+
+    auto series = platform->latency_histograms();
+    assert_equal(series.size(), 1, "One (category, claimer) series should exist");
+    assert_true(series[0].category == "ingest" && series[0].claimer_id == "worker-1", "Series should be labelled");
+    for (std::size_t i = 0; i < kLatencyStageCount; ++i) {
+        assert_equal(series[0].stages[i].count, kTasks, "Every stage should have one sample per task");
+    }
+    assert_true(series[0].stage(LatencyStage::QueueWait).percentile(0.5) >= 5000,
+                "Queue wait should include the time spent published");
+    assert_true(series[0].stage(LatencyStage::Run).percentile(0.5) >= 2000, "Run time should include the handler");
+    assert_true(series[0].stage(LatencyStage::EndToEnd).sum >= series[0].stage(LatencyStage::Run).sum,
+                "End-to-end time should cover the run time");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_platform_bounds_series() {
+    std::cout << "Test 4: Latency series are bounded... ";
+    auto platform = std::make_shared<TaskPlatform>("latency-bounded");
+    platform->set_max_task_queue_size(0);
+    assert_equal(platform->max_latency_series(), 256, "Default series cap");
+    platform->set_max_latency_series(512);
+    auto claimer = std::make_shared<Claimer>("worker-1", "Worker");
+    claimer->set_max_concurrent(1);
+    platform->register_claimer(claimer);
+
+    // 分类数超过上限：多出的组合记入 ("*", "*") 溢出分组
+    const int kCategories = 1100;
+    for (int i = 0; i < kCategories; ++i) {
+        auto task = platform->task_builder()
+                        .title("t")
+                        .category("c" + std::to_string(i))
+                        .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                        .build();
+        platform->publish_task(task);
+        auto claimed = claimer->claim_next_task();
+        assert_true(claimed.has_value(), "Task should be claimable");
+        assert_true(claimer->run_task(claimed.value(), std::string()).ok(), "Task should complete");
+    }
+    auto series = platform->latency_histograms();
+    assert_equal(series.size(), 512, "Series count should stop at the cap");
+    std::uint64_t total = 0;
+    std::uint64_t overflow = 0;
+    for (const auto &item : series) {
+        total += item.stage(LatencyStage::EndToEnd).count;
+        if (item.category == "*" && item.claimer_id == "*") {
+            overflow = item.stage(LatencyStage::EndToEnd).count;
+        }
+    }
+    assert_equal(total, kCategories, "No sample should be lost at the cap");
+    assert_equal(overflow, kCategories - 511, "Combinations beyond the cap should land in the overflow series");
+
+    // 注销申领者时删除其分组
+    assert_true(platform->unregister_claimer("worker-1"), "Claimer should unregister");
+    series = platform->latency_histograms();
+    assert_equal(series.size(), 1, "Only the overflow series should remain");
+    assert_true(series[0].category == "*", "Remaining series should be the overflow bucket");
+    std::cout << "PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "Running LatencyHistogram unit tests..." << std::endl;
+    std::cout << "================================" << std::endl;
+
+    test_bucket_layout();
+    test_percentiles_and_merge();
+    test_platform_records_stages();
+    test_platform_bounds_series();
+
+    std::cout << "================================" << std::endl;
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
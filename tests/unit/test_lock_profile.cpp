@@ -0,0 +1,147 @@
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+// 简单断言工具
+void assert_true(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "Assertion failed: " << message << std::endl;
+        std::exit(1);
+    }
+}
+
+LockStatistics find_lock(LockSite site) {
+    for (const auto &stats : lock_statistics()) {
+        if (stats.site == site) {
+            return stats;
+        }
+    }
+    return LockStatistics();
+}
+
+// ========== 测试用例 ==========
+void test_profiled_mutex_basics() {
+    std::cout << "Test 1: ProfiledMutex behaves like std::mutex... ";
+    ProfiledMutex mutex(LockSite::TaskData);
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex);
+        assert_true(!mutex.try_lock(), "try_lock should fail while the mutex is held");
+    }
+    assert_true(mutex.try_lock(), "try_lock should succeed once released");
+    mutex.unlock();
+    assert_true(std::string(lock_site_name(LockSite::PlatformTasks)) == "platform.tasks", "Site names");
+    assert_true(std::string(lock_site_name(LockSite::ClaimerData)) == "claimer.data", "Site names");
+    if (!lock_profiling_compiled_in()) {
+        assert_true(lock_statistics().empty(), "No statistics when lock profiling is compiled out");
+        assert_true(sizeof(ProfiledMutex) == sizeof(std::mutex), "Compiled-out wrapper should add no state");
+    } else {
+        assert_true(lock_statistics().size() == 4, "One entry per lock site");
+    }
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_wait_and_hold_times() {
+    std::cout << "Test 2: Contended acquisition records wait and hold times... ";
+    if (!lock_profiling_compiled_in()) {
+        std::cout << "SKIPPED (lock profiling compiled out)" << std::endl;
+        return;
+    }
+    const LockStatistics before = find_lock(LockSite::ClaimerData);
+    ProfiledMutex mutex(LockSite::ClaimerData);
+    std::atomic<bool> held(false);
+    std::thread holder([&]() {
+        std::lock_guard<ProfiledMutex> lock(mutex);
+        held.store(true);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    while (!held.load()) {
+        std::this_thread::yield();
+    }
+    {
+        std::lock_guard<ProfiledMutex> lock(mutex);   // 必须等待 holder 释放
+    }
+    holder.join();
+
+    const LockStatistics after = find_lock(LockSite::ClaimerData);
+    assert_true(after.name == "claimer.data", "Statistics should carry the site name");
+    assert_true(after.acquisitions == before.acquisitions + 2, "Both acquisitions should be counted");
+    assert_true(after.contended == before.contended + 1, "Only the blocked acquisition is contended");
+    assert_true(after.wait.sum - before.wait.sum >= 10000000ULL, "Wait time should cover most of the 20ms hold");
+    assert_true(after.hold.sum - before.hold.sum >= 20000000ULL, "Hold time should include the 20ms sleep");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_platform_contention() {
+    std::cout << "Test 3: Platform locks report contention under concurrent claims... ";
+    if (!lock_profiling_compiled_in()) {
+        std::cout << "SKIPPED (lock profiling compiled out)" << std::endl;
+        return;
+    }
+    const LockStatistics tasks_before = find_lock(LockSite::PlatformTasks);
+    const LockStatistics task_data_before = find_lock(LockSite::TaskData);
+
+    auto platform = std::make_shared<TaskPlatform>();
+    platform->set_max_task_queue_size(0);
+    const int kThreads = 4;
+    const int kTasks = 4000;
+    for (int i = 0; i < kTasks; ++i) {
+        auto task = platform->task_builder()
+                        .title("Contended")
+                        .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                        .build();
+        assert_true(platform->publish_task(task).has_value(), "Publish should succeed");
+    }
+    std::vector<std::thread> workers;
+    std::atomic<int> claimed(0);
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            auto claimer = std::make_shared<Claimer>("lock-claimer-" + std::to_string(t), "Claimer");
+            claimer->set_max_concurrent(kTasks);
+            platform->register_claimer(claimer);
+            for (;;) {
+                auto result = platform->claim_next_task(claimer);
+                if (result.has_value()) {
+                    claimed.fetch_add(1);
+                } else if (result.error().code == ErrorCode::PLATFORM_NO_AVAILABLE_TASK) {
+                    break;   // 选中的任务被其他线程抢先申领时重试
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    assert_true(claimed.load() == kTasks, "Every task should be claimed once");
+
+    const LockStatistics tasks_after = find_lock(LockSite::PlatformTasks);
+    const LockStatistics task_data_after = find_lock(LockSite::TaskData);
+    assert_true(tasks_after.acquisitions - tasks_before.acquisitions >= std::uint64_t(2 * kTasks),
+                "Publishing and claiming should lock the task table");
+    assert_true(task_data_after.acquisitions > task_data_before.acquisitions, "Task locks should be counted");
+    assert_true(tasks_after.hold.count == tasks_after.acquisitions, "Every acquisition has a hold sample");
+    assert_true(tasks_after.wait.count == tasks_after.contended, "Every contended acquisition has a wait sample");
+    std::cout << "(" << tasks_after.contended - tasks_before.contended << " contended of "
+              << tasks_after.acquisitions - tasks_before.acquisitions << ") PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "Running lock profile unit tests..." << std::endl;
+    std::cout << "================================" << std::endl;
+
+    test_profiled_mutex_basics();
+    test_wait_and_hold_times();
+    test_platform_contention();
+
+    std::cout << "================================" << std::endl;
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
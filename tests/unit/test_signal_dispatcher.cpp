@@ -0,0 +1,330 @@
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/signal_dispatcher.hpp>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+// 简单断言工具
+void assert_true(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "Assertion failed: " << message << std::endl;
+        std::exit(1);
+    }
+}
+
+void assert_equal(int lhs, int rhs, const char* message) {
+    if (lhs != rhs) {
+        std::cerr << "Assertion failed: " << message
+                  << " (expected " << rhs << ", got " << lhs << ")" << std::endl;
+        std::exit(1);
+    }
+}
+
+// ========== 测试用例 ==========
+void test_post_preserves_per_key_order() {
+    std::cout << "Test 1: Per-key FIFO across producers... ";
+    SignalDispatcher::Options options;
+    options.queue_capacity = 64;
+    options.dispatcher_threads = 3;
+    SignalDispatcher dispatcher(options);
+
+    const int kProducers = 4;
+    const int kPerProducer = 2000;
+    std::vector<std::vector<int>> seen(kProducers);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                // 每个生产者使用独立的 key，回调只由该 key 对应的分发线程执行
+                dispatcher.post(&seen[p], [&seen, p, i]() { seen[p].push_back(i); });
+            }
+        });
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    dispatcher.flush();
+
+    for (int p = 0; p < kProducers; ++p) {
+        assert_equal(static_cast<int>(seen[p].size()), kPerProducer, "All events should be delivered");
+        for (int i = 0; i < kPerProducer; ++i) {
+            if (seen[p][i] != i) {
+                assert_true(false, "Events with the same key must stay in order");
+            }
+        }
+    }
+    auto stats = dispatcher.statistics();
+    assert_true(stats.delivered == stats.posted, "Delivered should match posted after flush");
+    assert_true(stats.dropped == 0, "Block policy should not drop");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_overflow_policies() {
+    std::cout << "Test 2: Overflow policies... ";
+    SignalDispatcher::Options options;
+    options.queue_capacity = 4;
+    options.overflow_policy = SignalDispatcher::OverflowPolicy::DropNewest;
+    SignalDispatcher dropping(options);
+
+    std::atomic<bool> release{false};
+    std::atomic<bool> started{false};
+    std::atomic<int> delivered{0};
+    // 第一个回调阻塞分发线程，使后续事件堆积在队列中；等它真正开始执行（已出队）再继续
+    dropping.post(nullptr, [&]() {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    int accepted = 0;
+    for (int i = 0; i < 20; ++i) {
+        if (dropping.post(nullptr, [&]() { delivered.fetch_add(1); })) {
+            ++accepted;
+        }
+    }
+    release.store(true);
+    dropping.flush();
+    assert_equal(accepted, 4, "Only queue_capacity events fit while the consumer is blocked");
+    assert_equal(delivered.load(), accepted, "Accepted events should be delivered");
+    assert_true(dropping.statistics().dropped == 16, "Rejected events should be counted as dropped");
+
+    options.overflow_policy = SignalDispatcher::OverflowPolicy::CallerRuns;
+    SignalDispatcher inline_runner(options);
+    release.store(false);
+    started.store(false);
+    std::atomic<int> inline_count{0};
+    const std::thread::id caller = std::this_thread::get_id();
+    inline_runner.post(nullptr, [&]() {
+        started.store(true);
+        while (!release.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 10; ++i) {
+        inline_runner.post(nullptr, [&]() {
+            if (std::this_thread::get_id() == caller) {
+                inline_count.fetch_add(1);
+            }
+        });
+    }
+    release.store(true);
+    inline_runner.flush();
+    assert_equal(inline_count.load(), 6, "Overflowing events should run on the caller thread");
+    assert_true(inline_runner.statistics().caller_runs == 6, "Caller runs should be counted");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_task_signals_delivered_async() {
+    std::cout << "Test 3: Task signals through dispatcher... ";
+    auto dispatcher = std::make_shared<SignalDispatcher>();
+    auto platform = std::make_shared<TaskPlatform>("dispatch-platform");
+    platform->set_signal_dispatcher(dispatcher);
+
+    auto claimer = std::make_shared<Claimer>("c1", "C");
+    platform->register_claimer(claimer);
+    assert_true(claimer->signal_dispatcher() == dispatcher, "Registered claimer should inherit dispatcher");
+
+    auto task = platform->task_builder()
+                    .title("async")
+                    .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                    .build();
+    std::mutex mutex;
+    std::vector<TaskStatus> transitions;
+    std::thread::id slot_thread;
+    task->sig_status_changed.connect([&](Task &, TaskStatus, TaskStatus new_status) {
+        std::lock_guard<std::mutex> lock(mutex);
+        transitions.push_back(new_status);
+        slot_thread = std::this_thread::get_id();
+    });
+    std::atomic<int> completed{0};
+    claimer->sig_task_completed.connect([&](Claimer &, std::shared_ptr<Task>, const TaskResult &result) {
+        if (result.summary == "ok") {
+            completed.fetch_add(1);
+        }
+    });
+
+    assert_true(platform->publish_task(task).has_value(), "Publish should succeed");
+    assert_true(task->signal_dispatcher() == dispatcher, "Published task should inherit dispatcher");
+    assert_true(platform->claim_task(claimer, task->id()).has_value(), "Claim should succeed");
+    assert_true(claimer->run_task(task, std::string("in")).ok(), "Run should succeed");
+    dispatcher->flush();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    assert_equal(static_cast<int>(transitions.size()), 4, "Publish/claim/start/complete should be delivered");
+    assert_true(transitions[0] == TaskStatus::Published && transitions[1] == TaskStatus::Claimed &&
+                    transitions[2] == TaskStatus::Processing && transitions[3] == TaskStatus::Completed,
+                "Status signals should keep emission order");
+    assert_true(slot_thread != std::this_thread::get_id(), "Slots should run on a dispatcher thread");
+    assert_equal(completed.load(), 1, "Claimer completion signal should carry a copy of the result");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_sync_fallback() {
+    std::cout << "Test 4: Synchronous fallback... ";
+    auto dispatcher = std::make_shared<SignalDispatcher>();
+
+    // 未由 shared_ptr 管理的任务无法保证异步回调时存活，应同步触发
+    Task stack_task("stack");
+    stack_task.set_signal_dispatcher(dispatcher);
+    std::thread::id slot_thread;
+    stack_task.sig_progress_updated.connect([&](Task &, int) { slot_thread = std::this_thread::get_id(); });
+    stack_task.set_progress(10);
+    assert_true(slot_thread == std::this_thread::get_id(), "Stack task should emit synchronously");
+
+    // 分发器释放后对象自动回退为同步触发
+    auto task = std::make_shared<Task>("heap");
+    task->set_signal_dispatcher(dispatcher);
+    dispatcher.reset();
+    int progress = 0;
+    task->sig_progress_updated.connect([&](Task &, int value) { progress = value; });
+    task->set_progress(42);
+    assert_equal(progress, 42, "Expired dispatcher should fall back to synchronous emission");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_flush_and_stop_from_slots() {
+    std::cout << "Test 5: flush/stop inside slots and posting during stop... ";
+    {
+        SignalDispatcher dispatcher;
+        std::atomic<int> after(0);
+        std::atomic<bool> flushed(false);
+        int key = 0;
+        dispatcher.post(&key, [&]() {
+            dispatcher.flush();  // 不等待自身，只就地执行本线程队列中已有的事件
+            flushed.store(true);
+        });
+        dispatcher.post(&key, [&]() {
+            dispatcher.post(&key, [&]() { after.fetch_add(1); });
+            dispatcher.flush();  // 就地执行刚入队的事件
+            assert_equal(after.load(), 1, "Flush inside a slot should run queued events inline");
+        });
+        dispatcher.flush();
+        assert_true(flushed.load(), "Flush inside a slot should not wait for itself");
+        assert_equal(after.load(), 1, "Inline events should run exactly once");
+    }
+
+    // 两个分发线程在槽函数内互相向对方的满队列发射（Block）：改为同步执行，不能互锁
+    {
+        SignalDispatcher::Options options;
+        options.dispatcher_threads = 2;
+        options.queue_capacity = 2;
+        SignalDispatcher dispatcher(options);
+        int keys[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        std::atomic<int> nested(0);
+        for (int k = 0; k < 8; ++k) {
+            dispatcher.post(&keys[k], [&, k]() {
+                for (int i = 0; i < 50; ++i) {
+                    dispatcher.post(&keys[(k + 1 + i) % 8], [&]() { nested.fetch_add(1); });
+                }
+            });
+        }
+        dispatcher.flush();
+        dispatcher.stop();
+        assert_equal(nested.load(), 8 * 50, "Cross-shard emission from slots should not deadlock");
+    }
+
+    // 停止与投递并发：每个被接受的事件都必须投递，flush 不能挂起
+    for (int round = 0; round < 50; ++round) {
+        SignalDispatcher::Options options;
+        options.dispatcher_threads = 2;
+        options.queue_capacity = 8;
+        SignalDispatcher dispatcher(options);
+        std::atomic<int> accepted(0);
+        std::atomic<int> delivered(0);
+        int keys[3] = {0, 0, 0};
+        std::vector<std::thread> producers;
+        for (int p = 0; p < 3; ++p) {
+            producers.emplace_back([&, p]() {
+                for (int i = 0; i < 200; ++i) {
+                    if (dispatcher.post(&keys[p], [&]() { delivered.fetch_add(1); })) {
+                        accepted.fetch_add(1);
+                    }
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50 * (round % 5)));
+        dispatcher.stop();
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        dispatcher.flush();
+        assert_equal(delivered.load(), accepted.load(), "Accepted events should be delivered after stop");
+        auto stats = dispatcher.statistics();
+        assert_true(stats.posted == stats.delivered, "Posted and delivered counts should match after stop");
+    }
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_last_reference_dropped_in_slot() {
+    std::cout << "Test 6: Slot drops the last dispatcher reference... ";
+    for (int round = 0; round < 20; ++round) {
+        SignalDispatcher::Options options;
+        options.dispatcher_threads = 2;
+        auto dispatcher = std::make_shared<SignalDispatcher>(options);
+        auto task = std::make_shared<Task>("owner");
+        task->set_signal_dispatcher(dispatcher);
+
+        std::mutex mutex;
+        std::shared_ptr<SignalDispatcher> holder = dispatcher;
+        dispatcher.reset();
+        std::atomic<int> seen(0);
+        std::thread::id drop_thread;
+        task->sig_progress_updated.connect([&](Task &, int value) {
+            seen.fetch_add(1);
+            if (value == 1) {
+                std::shared_ptr<SignalDispatcher> last;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    last.swap(holder);
+                    drop_thread = std::this_thread::get_id();
+                }
+                // 在分发线程上析构分发器：不能等待自身，也不能销毁仍在运行的分片
+            }
+        });
+        for (int i = 1; i <= 10; ++i) {
+            task->set_progress(i);
+        }
+        // 释放后剩余事件仍由分发线程投递，之后的发射回退为同步
+        for (int spin = 0; spin < 2000 && seen.load() < 10; ++spin) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert_equal(seen.load(), 10, "Events queued before the drop should still be delivered");
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            assert_true(!holder && drop_thread != std::this_thread::get_id(),
+                        "The last reference should be dropped on a dispatcher thread");
+        }
+        assert_true(!task->signal_dispatcher(), "The task should no longer see the dispatcher");
+        task->set_progress(50);
+        assert_equal(seen.load(), 11, "Emission should fall back to synchronous after the drop");
+    }
+    std::cout << "PASSED" << std::endl;
+}
+
+// ========== 主函数 ==========
+int main() {
+    std::cout << "Running SignalDispatcher unit tests..." << std::endl;
+    std::cout << "================================" << std::endl;
+
+    test_post_preserves_per_key_order();
+    test_overflow_policies();
+    test_task_signals_delivered_async();
+    test_sync_fallback();
+    test_flush_and_stop_from_slots();
+    test_last_reference_dropped_in_slot();
+
+    std::cout << "================================" << std::endl;
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
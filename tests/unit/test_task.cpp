@@ -3,6 +3,7 @@
 #include <cassert>
 #include <thread>
 #include <chrono>
+#include <vector>
 
 using namespace xswl::youdidit;
 
@@ -462,6 +463,106 @@ bool test_move_semantics() {
     return true;
 }
 
+// 测试 20: 只读快照（写时复制）
+bool test_snapshot_copy_on_write() {
+    Task task("snap_task");
+    task.set_title("Snapshot").set_category("cat").set_priority(40).add_tag("a");
+
+    auto v1 = task.snapshot();
+    TEST_ASSERT(v1->id == "snap_task", "Snapshot id should match");
+    TEST_ASSERT(v1->title == "Snapshot", "Snapshot title should match");
+    TEST_ASSERT(v1->category == "cat", "Snapshot category should match");
+    TEST_ASSERT(v1->priority == 40, "Snapshot priority should match");
+    TEST_ASSERT(v1->tags.count("a") == 1, "Snapshot tags should match");
+    TEST_ASSERT(v1->status == TaskStatus::Draft, "Snapshot status should be Draft");
+
+    auto v2 = task.snapshot();
+    TEST_ASSERT(v1.get() == v2.get(), "Unchanged task should reuse the same snapshot");
+
+    task.set_title("Changed");
+    auto v3 = task.snapshot();
+    TEST_ASSERT(v3.get() != v1.get(), "Changed task should rebuild the snapshot");
+    TEST_ASSERT(v3->title == "Changed", "Rebuilt snapshot should see new title");
+    TEST_ASSERT(v1->title == "Snapshot", "Old snapshot must stay immutable");
+
+    task.publish();
+    auto v4 = task.snapshot();
+    TEST_ASSERT(v4->status == TaskStatus::Published, "Snapshot should follow status changes");
+    TEST_ASSERT(v4->published_at != Timestamp(), "Snapshot should carry published_at");
+
+    task.set_progress(0);  // 值未变化，不应使快照失效
+    TEST_ASSERT(task.snapshot().get() == v4.get(), "No-op progress update should keep snapshot");
+
+    return true;
+}
+
+// 测试 21: 共享负载在执行与信号中不被复制
+bool test_payload_zero_copy_execution() {
+    Task task;
+    const char *input_seen = nullptr;
+    const char *signal_output = nullptr;
+
+    task.set_handler([&](Task &, const std::string &input) -> TaskResult {
+        input_seen = input.data();
+        TaskResult r("done");
+        r.payload = Payload(std::string(1 << 16, 'o'));
+        return r;
+    });
+    task.sig_completed.connect([&](Task &, const TaskResult &result) {
+        signal_output = result.payload.data();
+    });
+
+    Payload input(std::string(1 << 16, 'i'));
+    task.set_status(TaskStatus::Published);
+    task.set_status(TaskStatus::Claimed);
+    TaskResult result = task.execute(input);
+
+    TEST_ASSERT(result.ok(), "Execution should succeed");
+    TEST_ASSERT(input_seen == input.data(), "Handler should see the shared input buffer");
+    TEST_ASSERT(signal_output == result.payload.data(), "Signal and caller should share the output buffer");
+    TEST_ASSERT(result.output_data().size() == (1u << 16), "Output payload should be intact");
+
+    return true;
+}
+
+bool test_progress_coalescing() {
+    Task task;
+    std::vector<int> emitted;
+    task.sig_progress_updated.connect([&](Task &, int progress) { emitted.push_back(progress); });
+
+    ProgressCoalescing coalescing;
+    coalescing.min_delta = 10;
+    task.set_progress_coalescing(coalescing);
+    task.set_status(TaskStatus::Published);
+    task.set_status(TaskStatus::Claimed);
+    task.start();
+
+    for (int i = 1; i <= 99; ++i) {
+        task.set_progress(i);
+        TEST_ASSERT(task.progress() == i, "Progress value must update immediately");
+    }
+    TEST_ASSERT(emitted.size() == 9, "Only changes of at least min_delta should be emitted");
+    TEST_ASSERT(emitted.front() == 10 && emitted.back() == 90, "Emitted values should follow min_delta steps");
+
+    // 状态转换前补发最终值
+    task.fail("stop");
+    TEST_ASSERT(emitted.size() == 10 && emitted.back() == 99, "Pending progress should be flushed on transition");
+
+    Task timed;
+    std::vector<int> timed_emitted;
+    timed.sig_progress_updated.connect([&](Task &, int progress) { timed_emitted.push_back(progress); });
+    coalescing.min_delta = 0;
+    coalescing.min_interval = std::chrono::milliseconds(60000);
+    timed.set_progress_coalescing(coalescing);
+    for (int i = 1; i <= 100; ++i) {
+        timed.set_progress(i);
+    }
+    TEST_ASSERT(timed_emitted.size() == 2, "Interval should suppress intermediate updates");
+    TEST_ASSERT(timed_emitted[0] == 1 && timed_emitted[1] == 100, "Completion value is always delivered");
+
+    return true;
+}
+
 // ========== 主函数 ==========
 int main() {
     std::cout << "========================================" << std::endl;
@@ -490,6 +591,9 @@ int main() {
     RUN_TEST(test_cancel_published_task_direct);
     RUN_TEST(test_cancel_on_claimed_or_processing_should_fail);
     RUN_TEST(test_move_semantics);
+    RUN_TEST(test_snapshot_copy_on_write);
+    RUN_TEST(test_payload_zero_copy_execution);
+    RUN_TEST(test_progress_coalescing);
     
     std::cout << std::endl;
     std::cout << "========================================" << std::endl;
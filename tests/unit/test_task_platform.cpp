@@ -1,7 +1,12 @@
 #include <xswl/youdidit/core/task_platform.hpp>
+#include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <iostream>
 #include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 using namespace xswl::youdidit;
 
@@ -378,7 +383,411 @@ void test_clear_completed_task_with_retained_claimer_id() {
     std::cout << "PASSED" << std::endl;
 }
 
+void test_memory_usage_accounting() {
+    std::cout << "Test 14: Memory usage accounting... ";
+    TaskPlatform platform;
+    auto empty_total = platform.memory_usage().total_bytes();
+    assert_true(empty_total == 0, "Empty platform should account zero bytes");
+
+    auto task = platform.task_builder()
+                    .title("Memory Task")
+                    .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                    .build();
+    assert_true(platform.publish_task(task).has_value(), "Publish should succeed");
+
+    auto after_publish = platform.memory_usage();
+    assert_true(after_publish.components["tasks"] > 0, "Published task should be accounted");
+    assert_true(after_publish.components["task_handlers"] > 0, "Handler should be accounted");
+    assert_true(after_publish.components["task_index"] > 0, "Task index node should be accounted");
+
+    // 发布后修改元数据，平台统计应同步增长（无需遍历任务）
+    task->set_metadata("payload", std::string(4096, 'x'));
+    auto after_metadata = platform.memory_usage();
+    assert_true(after_metadata.components["task_metadata"] >= 4096, "Metadata growth should be accounted");
+
+    task->remove_metadata("payload");
+    assert_true(platform.memory_usage().components["task_metadata"] == 0,
+                "Metadata removal should be accounted");
+
+    assert_true(platform.remove_task(task->id()), "Remove should succeed");
+    assert_true(platform.memory_usage().total_bytes() == 0, "Removed task should no longer be accounted");
+
+    auto claimer = std::make_shared<Claimer>("claimer-mem", "Mem");
+    platform.register_claimer(claimer);
+    assert_true(platform.memory_usage().components["claimer_index"] > 0, "Claimer index should be accounted");
+    assert_true(claimer->memory_usage().components["claimer"] > 0, "Claimer should account itself");
+    platform.unregister_claimer("claimer-mem");
+    assert_true(platform.memory_usage().components["claimer_index"] == 0, "Unregistered claimer should be released");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_platform_progress_coalescing() {
+    std::cout << "Test 15: Platform progress coalescing... ";
+    TaskPlatform platform;
+    auto existing = platform.task_builder().title("existing")
+                        .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                        .build();
+    platform.publish_task(existing);
+
+    ProgressCoalescing coalescing;
+    coalescing.min_delta = 25;
+    platform.set_progress_coalescing(coalescing);
+    assert_equal(existing->progress_coalescing().min_delta, 25, "Existing tasks should adopt platform policy");
+
+    auto task = platform.task_builder().title("coalesced")
+                    .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                    .build();
+    platform.publish_task(task);
+    assert_equal(task->progress_coalescing().min_delta, 25, "New tasks should inherit platform policy");
+
+    int emitted = 0;
+    task->sig_progress_updated.connect([&](Task &, int) { ++emitted; });
+    for (int i = 1; i <= 100; ++i) {
+        task->set_progress(i);
+    }
+    assert_equal(task->progress(), 100, "Progress should stay exact");
+    assert_equal(emitted, 4, "Only 25/50/75/100 should be emitted");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_lifecycle_batch_subscription() {
+    std::cout << "Test 16: Lifecycle batch subscription... ";
+    TaskPlatform platform;
+    auto claimer = std::make_shared<Claimer>("batch-claimer", "Batch");
+    platform.register_claimer(claimer);
+
+    std::mutex mutex;
+    std::vector<std::vector<TaskLifecycleRecord>> batches;
+    LifecycleBatchOptions options;
+    options.max_batch_size = 4;
+    options.flush_interval = std::chrono::milliseconds(20);
+    auto id = platform.subscribe_lifecycle_batches([&](const std::vector<TaskLifecycleRecord> &batch) {
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(batch);
+    }, options);
+    assert_true(id != 0, "Subscription id should be valid");
+
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (int i = 0; i < 3; ++i) {
+        auto task = platform.task_builder()
+                        .title("batch")
+                        .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                        .build();
+        platform.publish_task(task);
+        tasks.push_back(task);
+    }
+    auto claimed = platform.claim_task(claimer, tasks[0]->id());
+    assert_true(claimed.has_value(), "Claim should succeed");
+    claimer->run_task(tasks[0], std::string("in"));
+
+    // 未手动 flush：后台线程应在刷新间隔内投递
+    for (int i = 0; i < 100; ++i) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::size_t total = 0;
+            for (const auto &b : batches) total += b.size();
+            if (total == 6) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    std::vector<TaskLifecycleRecord> all;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (const auto &b : batches) {
+            assert_true(b.size() <= 4, "Batches should not exceed max_batch_size");
+            all.insert(all.end(), b.begin(), b.end());
+        }
+    }
+    // 3 次发布 + 申领 + 开始 + 完成
+    assert_equal(static_cast<int>(all.size()), 6, "All transitions should be delivered");
+    assert_equal(all[0].task_id, tasks[0]->id(), "Records should be in order");
+    assert_true(all[0].new_status == TaskStatus::Published, "First record is publish");
+    assert_true(all[3].new_status == TaskStatus::Claimed && all[3].claimer_id == "batch-claimer",
+                "Claim record should carry claimer id");
+    assert_true(all[5].old_status == TaskStatus::Processing && all[5].new_status == TaskStatus::Completed,
+                "Completion record should carry old and new status");
+
+    assert_true(platform.unsubscribe_lifecycle_batches(id), "Unsubscribe should succeed");
+    assert_true(!platform.unsubscribe_lifecycle_batches(id), "Second unsubscribe should fail");
+    std::cout << "PASSED" << std::endl;
+}
+
 // ========== 主函数 ==========
+void test_query_tasks_pagination() {
+    std::cout << "Test 17: Paged task queries... ";
+    TaskPlatform platform;
+    for (int i = 0; i < 25; ++i) {
+        auto builder = platform.task_builder();
+        builder.title("Q" + std::to_string(i))
+               .category(i % 2 == 0 ? "even" : "odd")
+               .priority(i % 5)
+               .handler([](Task&, const std::string&) { return TaskResult("q"); });
+        if (i % 3 == 0) {
+            builder.add_tag("third");
+        }
+        platform.publish_task(builder.build());
+    }
+
+    // 按 ID 翻页：所有页拼起来等于完整有序列表，且不重复
+    TaskPlatform::TaskQuery query;
+    query.limit = 7;
+    std::vector<std::string> ids;
+    int pages = 0;
+    do {
+        auto page = platform.query_tasks(query);
+        assert_true(page.has_value(), "Query should succeed");
+        for (const auto &view : page.value().tasks) {
+            ids.push_back(view->id);
+        }
+        query.cursor = page.value().next_cursor;
+        ++pages;
+    } while (!query.cursor.empty());
+    assert_equal(pages, 4, "25 tasks in pages of 7 should take 4 pages");
+    assert_equal(static_cast<int>(ids.size()), 25, "Paging should visit every task once");
+    assert_true(std::is_sorted(ids.begin(), ids.end()) &&
+                std::adjacent_find(ids.begin(), ids.end()) == ids.end(), "Ids should be strictly ascending");
+
+    // 按优先级降序 + 过滤
+    TaskPlatform::TaskQuery by_priority;
+    by_priority.filter.category = std::string("even");
+    by_priority.sort_by = TaskPlatform::TaskSortKey::Priority;
+    by_priority.descending = true;
+    by_priority.limit = 5;
+    std::vector<int> priorities;
+    do {
+        auto page = platform.query_tasks(by_priority);
+        assert_true(page.has_value(), "Priority query should succeed");
+        for (const auto &view : page.value().tasks) {
+            assert_equal(view->category, std::string("even"), "Filter should apply");
+            priorities.push_back(view->priority);
+        }
+        by_priority.cursor = page.value().next_cursor;
+    } while (!by_priority.cursor.empty());
+    assert_equal(static_cast<int>(priorities.size()), 13, "13 even tasks expected");
+    assert_true(std::is_sorted(priorities.rbegin(), priorities.rend()), "Priorities should be descending");
+
+    TaskPlatform::TaskQuery tagged;
+    tagged.filter.tags.push_back("third");
+    tagged.filter.min_priority = 1;
+    auto tagged_page = platform.query_tasks(tagged);
+    assert_true(tagged_page.has_value() && tagged_page.value().next_cursor.empty(), "Single page expected");
+    assert_equal(static_cast<int>(tagged_page.value().tasks.size()), 7, "Tag and priority filters should combine");
+
+    // 游标与排序方式不一致时报错
+    TaskPlatform::TaskQuery first;
+    first.limit = 1;
+    auto first_page = platform.query_tasks(first);
+    TaskPlatform::TaskQuery mismatched;
+    mismatched.sort_by = TaskPlatform::TaskSortKey::PublishedAt;
+    mismatched.cursor = first_page.value().next_cursor;
+    auto bad = platform.query_tasks(mismatched);
+    assert_true(!bad.has_value() && bad.error().code == ErrorCode::PLATFORM_INVALID_CURSOR,
+                "Cursor from another sort should be rejected");
+    mismatched.cursor = "zz";
+    assert_true(!platform.query_tasks(mismatched).has_value(), "Garbage cursor should be rejected");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_change_sequence_delta_sync() {
+    std::cout << "Test 18: Change sequence delta sync... ";
+    TaskPlatform platform;
+    auto claimer = std::make_shared<Claimer>("delta-claimer", "Delta");
+    platform.register_claimer(claimer);
+
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (int i = 0; i < 4; ++i) {
+        auto task = platform.task_builder()
+                        .title("D" + std::to_string(i))
+                        .handler([](Task&, const std::string&) { return TaskResult("d"); })
+                        .build();
+        platform.publish_task(task);
+        tasks.push_back(task);
+    }
+    const std::uint64_t base = platform.change_sequence();
+    assert_true(base > 0, "Publishing should bump the sequence");
+    assert_true(tasks[3]->change_sequence() > tasks[0]->change_sequence(), "Tasks record their last change");
+
+    auto initial = platform.get_changes_since(0);
+    assert_equal(static_cast<int>(initial.tasks.size()), 4, "Every task should appear once from 0");
+    assert_true(initial.sequence == base && !initial.has_more && !initial.reset, "Full delta should end at head");
+
+    auto none = platform.get_changes_since(base);
+    assert_true(none.tasks.empty() && none.removed_task_ids.empty(), "No changes after head");
+
+    assert_true(platform.claim_task(claimer, tasks[1]->id()).has_value(), "Claim should succeed");
+    assert_true(platform.remove_task(tasks[2]->id()), "Remove should succeed");
+    auto delta = platform.get_changes_since(base);
+    assert_equal(static_cast<int>(delta.tasks.size()), 1, "Only the claimed task changed");
+    assert_equal(delta.tasks[0]->id(), tasks[1]->id(), "Claimed task should be returned");
+    assert_true(delta.tasks[0]->change_sequence() > base, "Task sequence should advance");
+    assert_equal(static_cast<int>(delta.removed_task_ids.size()), 1, "Removed task should leave a tombstone");
+    assert_equal(delta.removed_task_ids[0], tasks[2]->id(), "Tombstone should carry the id");
+    assert_true(delta.changed_claimer_ids.size() == 1 && delta.changed_claimer_ids[0] == "delta-claimer",
+                "Claim should mark the claimer as changed");
+
+    // 分批获取：以返回的 sequence 继续
+    auto first = platform.get_changes_since(0, 2);
+    assert_true(first.has_more && first.tasks.size() + first.changed_claimer_ids.size() == 2, "Limit should apply");
+    auto rest = platform.get_changes_since(first.sequence, 100);
+    assert_true(!rest.has_more && rest.sequence == platform.change_sequence(), "Continuation should reach head");
+
+    assert_true(platform.unregister_claimer("delta-claimer"), "Unregister should succeed");
+    auto gone = platform.get_changes_since(delta.sequence);
+    assert_true(gone.removed_claimer_ids.size() == 1, "Unregistered claimer should leave a tombstone");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_publish_tasks_batch() {
+    std::cout << "Test 19: Batch publish... ";
+    TaskPlatform platform;
+    platform.set_max_task_queue_size(3);
+    int published = 0;
+    platform.sig_task_published.connect([&](const std::shared_ptr<Task> &) { ++published; });
+
+    std::vector<std::shared_ptr<Task>> batch;
+    for (int i = 0; i < 3; ++i) {
+        batch.push_back(platform.task_builder()
+                            .title("B" + std::to_string(i))
+                            .handler([](Task&, const std::string&) { return TaskResult("b"); })
+                            .build());
+    }
+    batch.insert(batch.begin() + 1, std::shared_ptr<Task>());
+    batch.push_back(std::make_shared<Task>());
+
+    auto results = platform.publish_tasks(batch);
+    assert_equal(static_cast<int>(results.size()), 5, "One result per input task");
+    assert_true(results[0].has_value() && results[0].value() == batch[0]->id(), "First task should be published");
+    assert_true(!results[1].has_value() && results[1].error().code == ErrorCode::TASK_NOT_FOUND,
+                "Null task should be rejected");
+    assert_true(results[2].has_value() && results[3].has_value(), "Tasks within the limit should be published");
+    assert_true(!results[4].has_value() && results[4].error().code == ErrorCode::PLATFORM_QUEUE_FULL,
+                "Tasks beyond the queue limit should be rejected");
+    assert_equal(published, 3, "Each published task should emit sig_task_published");
+    assert_true(batch[2]->status() == TaskStatus::Published, "Draft tasks should become Published");
+    assert_true(!platform.has_task(batch[4]->id()), "Rejected task should not be stored");
+    assert_true(platform.get_changes_since(0).tasks.size() == 3, "Batch should be recorded in the change log");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_change_log_concurrent_transitions() {
+    std::cout << "Test 20: Change log under concurrent transitions... ";
+    TaskPlatform platform;
+    platform.set_max_task_queue_size(0);
+    const int kThreads = 4;
+    const int kTasksPerThread = 1500;   // 转换总数超过分片缓冲的批量应用阈值
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (int i = 0; i < kThreads * kTasksPerThread; ++i) {
+        auto task = platform.task_builder()
+                        .title("C" + std::to_string(i))
+                        .handler([](Task&, const std::string&) { return TaskResult("c"); })
+                        .build();
+        platform.publish_task(task);
+        tasks.push_back(task);
+    }
+    const std::uint64_t base = platform.change_sequence();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < kThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            auto claimer = std::make_shared<Claimer>("change-claimer-" + std::to_string(t), "Change");
+            claimer->set_max_concurrent(kTasksPerThread);
+            platform.register_claimer(claimer);
+            for (int i = t * kTasksPerThread; i < (t + 1) * kTasksPerThread; ++i) {
+                assert_true(platform.claim_task(claimer, tasks[i]->id()).has_value(), "Claim should succeed");
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    auto delta = platform.get_changes_since(base, tasks.size() + kThreads);
+    assert_equal(static_cast<int>(delta.tasks.size()), kThreads * kTasksPerThread, "Every claimed task should appear once");
+    assert_equal(static_cast<int>(delta.changed_claimer_ids.size()), kThreads, "Every claimer should appear once");
+    assert_true(!delta.has_more && delta.sequence == platform.change_sequence(), "Delta should reach head");
+    for (const auto &task : delta.tasks) {
+        assert_true(task->status() == TaskStatus::Claimed && task->change_sequence() > base,
+                    "Returned tasks should carry their latest change");
+    }
+    assert_true(platform.get_changes_since(delta.sequence).tasks.empty(), "Nothing should remain after head");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_lifecycle_batch_limits_and_reentrancy() {
+    std::cout << "Test 21: Lifecycle batch limits and reentrant calls... ";
+    auto make_task = [](TaskPlatform &platform) {
+        auto task = platform.task_builder()
+                        .title("bounded")
+                        .handler([](Task&, const std::string&) { return TaskResult("ok"); })
+                        .build();
+        platform.publish_task(task);
+    };
+
+    // 待投递记录达到 max_pending 后丢弃新记录并计数
+    {
+        TaskPlatform platform;
+        std::atomic<int> delivered(0);
+        LifecycleBatchOptions options;
+        options.max_batch_size = 1000;
+        options.flush_interval = std::chrono::milliseconds(10000);
+        options.max_pending = 5;
+        auto id = platform.subscribe_lifecycle_batches([&](const std::vector<TaskLifecycleRecord> &batch) {
+            delivered.fetch_add(static_cast<int>(batch.size()));
+        }, options);
+        for (int i = 0; i < 8; ++i) {
+            make_task(platform);
+        }
+        assert_true(platform.lifecycle_batch_dropped(id) == 3, "Records beyond max_pending should be dropped");
+        platform.flush_lifecycle_batches();
+        assert_equal(delivered.load(), 5, "Buffered records should still be delivered");
+        assert_true(platform.lifecycle_batch_dropped(id + 1) == 0, "Unknown subscription reports no drops");
+    }
+
+    // 处理函数在调用线程上 flush：跳过自身，不死锁
+    {
+        TaskPlatform platform;
+        std::atomic<int> calls(0);
+        LifecycleBatchOptions options;
+        options.flush_interval = std::chrono::milliseconds(10000);
+        platform.subscribe_lifecycle_batches([&](const std::vector<TaskLifecycleRecord> &) {
+            calls.fetch_add(1);
+            platform.flush_lifecycle_batches();
+        }, options);
+        make_task(platform);
+        platform.flush_lifecycle_batches();
+        assert_equal(calls.load(), 1, "Reentrant flush should not deliver again");
+    }
+
+    // 处理函数在后台线程上 flush 并取消自己的订阅：不 join 自身，之后平台可正常销毁
+    {
+        auto platform = std::make_shared<TaskPlatform>();
+        std::atomic<std::uint64_t> id(0);
+        std::atomic<int> state(0);   // 1: 已取消订阅 2: 取消失败
+        LifecycleBatchOptions options;
+        options.flush_interval = std::chrono::milliseconds(5);
+        TaskPlatform *raw = platform.get();
+        id = platform->subscribe_lifecycle_batches([&, raw](const std::vector<TaskLifecycleRecord> &) {
+            while (id.load() == 0) {
+                std::this_thread::yield();
+            }
+            raw->flush_lifecycle_batches();
+            if (state.load() == 0) {
+                state.store(raw->unsubscribe_lifecycle_batches(id.load()) ? 1 : 2);
+            }
+        }, options);
+        make_task(*platform);
+        for (int i = 0; i < 200 && state.load() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert_equal(state.load(), 1, "Handler should be able to unsubscribe itself");
+        assert_true(!platform->unsubscribe_lifecycle_batches(id.load()), "Subscription should be gone");
+        make_task(*platform);
+        platform.reset();
+    }
+    std::cout << "PASSED" << std::endl;
+}
+
 int main() {
     std::cout << "Running TaskPlatform unit tests..." << std::endl;
     std::cout << "================================" << std::endl;
@@ -396,6 +805,14 @@ int main() {
     test_clear_completed_tasks_behaviour();
     test_publish_task_error_paths();
     test_clear_completed_task_with_retained_claimer_id();
+    test_memory_usage_accounting();
+    test_platform_progress_coalescing();
+    test_lifecycle_batch_subscription();
+    test_query_tasks_pagination();
+    test_change_sequence_delta_sync();
+    test_publish_tasks_batch();
+    test_change_log_concurrent_transitions();
+    test_lifecycle_batch_limits_and_reentrancy();
 
     std::cout << "================================" << std::endl;
     std::cout << "All tests passed!" << std::endl;
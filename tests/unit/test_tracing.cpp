@@ -0,0 +1,197 @@
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/tracing.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+// 简单断言工具
+void assert_true(bool condition, const char* message) {
+    if (!condition) {
+        std::cerr << "Assertion failed: " << message << std::endl;
+        std::exit(1);
+    }
+}
+
+const SpanRecord *find_span(const std::vector<SpanRecord> &spans, const std::string &name) {
+    for (const auto &span : spans) {
+        if (span.name == name) {
+            return &span;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Task> make_task(TaskPlatform &platform, bool succeed) {
+    return platform.task_builder()
+        .title("Traced")
+        .handler([succeed](Task&, const std::string&) {
+            return succeed ? TaskResult("ok") : TaskResult(Error("boom", ErrorCode::TASK_EXECUTION_FAILED));
+        })
+        .build();
+}
+
+// ========== 测试用例 ==========
+void test_lifecycle_spans() {
+    std::cout << "Test 1: Lifecycle spans and nesting... ";
+    if (!tracing_compiled_in()) {
+        std::cout << "SKIPPED (tracing compiled out)" << std::endl;
+        return;
+    }
+    auto tracer = std::make_shared<InMemoryTracer>();
+    set_tracer(tracer);
+
+    auto platform = std::make_shared<TaskPlatform>();
+    auto claimer = std::make_shared<Claimer>("tracer-claimer", "Tracer");
+    platform->register_claimer(claimer);
+    auto task = make_task(*platform, true);
+    assert_true(platform->publish_task(task).has_value(), "Publish should succeed");
+    auto claimed = platform->claim_next_task(claimer);
+    assert_true(claimed.has_value(), "Claim should succeed");
+    assert_true(claimed.value()->execute("in").ok(), "Execution should succeed");
+    set_tracer(nullptr);
+
+    auto spans = tracer->spans();
+    assert_true(tracer->open_span_count() == 0, "Every span should be closed");
+    const SpanRecord *publish = find_span(spans, "platform.publish_task");
+    const SpanRecord *claim_next = find_span(spans, "platform.claim_next_task");
+    const SpanRecord *claim = find_span(spans, "platform.claim_task");
+    const SpanRecord *execute = find_span(spans, "task.execute");
+    const SpanRecord *complete = find_span(spans, "task.complete");
+    assert_true(publish && claim_next && claim && execute && complete, "Each hook should produce a span");
+    assert_true(publish->task_id == task->id() && publish->parent_id == 0, "Publish span should carry the task");
+    assert_true(claim_next->task_id == task->id(), "claim_next_task should report the task it claimed");
+    assert_true(claim_next->claimer_id == "tracer-claimer", "Claim spans should carry the claimer");
+    assert_true(claim->parent_id == claim_next->span_id, "Inner claim_task should be a child span");
+    assert_true(complete->parent_id == execute->span_id, "complete() inside execute() should be a child span");
+    assert_true(execute->duration >= complete->duration, "Parent span should enclose its child");
+    for (const auto &span : spans) {
+        assert_true(span.ok(), "Successful operations should not record errors");
+    }
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_error_spans() {
+    std::cout << "Test 2: Failed operations record errors... ";
+    if (!tracing_compiled_in()) {
+        std::cout << "SKIPPED (tracing compiled out)" << std::endl;
+        return;
+    }
+    auto tracer = std::make_shared<InMemoryTracer>();
+    set_tracer(tracer);
+
+    auto platform = std::make_shared<TaskPlatform>();
+    auto claimer = std::make_shared<Claimer>("error-claimer", "Errors");
+    platform->register_claimer(claimer);
+    auto empty = platform->claim_next_task(claimer);
+    assert_true(!empty.has_value(), "Nothing to claim yet");
+
+    auto task = make_task(*platform, false);
+    platform->publish_task(task);
+    assert_true(platform->claim_task(claimer, task->id()).has_value(), "Claim should succeed");
+    assert_true(!task->execute("in").ok(), "Handler should fail");
+    assert_true(!task->abandon("late").has_value(), "Failed task cannot be abandoned");
+    set_tracer(nullptr);
+
+    auto spans = tracer->spans();
+    const SpanRecord *claim_next = find_span(spans, "platform.claim_next_task");
+    assert_true(claim_next && claim_next->error == "No available task", "Empty claim should record its error");
+    const SpanRecord *execute = find_span(spans, "task.execute");
+    assert_true(execute && execute->error == "boom", "Handler failure should mark the execute span");
+    const SpanRecord *fail = find_span(spans, "task.fail");
+    assert_true(fail && fail->ok() && fail->parent_id == execute->span_id, "Fail transition itself succeeded");
+    const SpanRecord *abandon = find_span(spans, "task.abandon");
+    assert_true(abandon && !abandon->ok(), "Rejected abandon should record its error");
+    std::cout << "PASSED" << std::endl;
+}
+
+void test_tracer_removal_and_capacity() {
+    std::cout << "Test 3: Removing the tracer and bounded export... ";
+    auto tracer = std::make_shared<InMemoryTracer>(2);
+    set_tracer(tracer);
+    for (int i = 0; i < 5; ++i) {
+        ScopedSpan span("custom.stage");
+    }
+    set_tracer(nullptr);
+    {
+        ScopedSpan span("custom.untraced");
+    }
+    auto spans = tracer->spans();
+    if (tracing_compiled_in()) {
+        assert_true(spans.size() == 2 && tracer->dropped() == 3, "Exporter should keep the newest spans");
+        assert_true(spans[0].span_id < spans[1].span_id, "Spans should be kept in end order");
+    } else {
+        assert_true(spans.empty(), "Compiled-out hooks should not produce spans");
+    }
+    assert_true(find_span(spans, "custom.untraced") == nullptr, "No spans after the tracer is removed");
+    assert_true(get_tracer() == nullptr, "Tracer should be cleared");
+    tracer->clear();
+    assert_true(tracer->spans().empty() && tracer->dropped() == 0, "clear() should reset the exporter");
+    std::cout << "PASSED" << std::endl;
+}
+
+// 未设置追踪器时埋点的开销：单个 ScopedSpan 的代价 × 每个生命周期的 span 数，与生命周期本身的耗时相比
+void test_disabled_overhead() {
+    std::cout << "Test 4: Disabled tracing overhead < 1%... ";
+    set_tracer(nullptr);
+    const int kSpanIterations = 2000000;
+    const int kCycles = 20000;
+    const int kSpansPerCycle = 4;   // publish_task, claim_task, execute, complete
+    const TaskId id("overhead-task");
+
+    double best_span_ns = 1e18;
+    double best_cycle_ns = 1e18;
+    for (int round = 0; round < 3; ++round) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int i = 0; i < kSpanIterations; ++i) {
+            ScopedSpan span("bench.span", id);
+        }
+        auto end = std::chrono::steady_clock::now();
+        best_span_ns = std::min(best_span_ns,
+                                std::chrono::duration<double, std::nano>(end - begin).count() / kSpanIterations);
+
+        auto platform = std::make_shared<TaskPlatform>();
+        platform->set_max_task_queue_size(0);
+        auto claimer = std::make_shared<Claimer>("overhead-claimer", "Overhead");
+        claimer->set_max_concurrent(kCycles);
+        platform->register_claimer(claimer);
+        std::vector<std::shared_ptr<Task>> tasks;
+        for (int i = 0; i < kCycles; ++i) {
+            tasks.push_back(make_task(*platform, true));
+        }
+        begin = std::chrono::steady_clock::now();
+        for (const auto &task : tasks) {
+            platform->publish_task(task);
+            platform->claim_task(claimer, task->id());
+            task->execute("in");
+        }
+        end = std::chrono::steady_clock::now();
+        best_cycle_ns = std::min(best_cycle_ns,
+                                 std::chrono::duration<double, std::nano>(end - begin).count() / kCycles);
+    }
+
+    const double overhead = kSpansPerCycle * best_span_ns / best_cycle_ns;
+    std::cout << "(" << best_span_ns << " ns/span, " << best_cycle_ns << " ns/cycle, "
+              << overhead * 100.0 << "%) ";
+    assert_true(overhead < 0.01, "Disabled tracing should cost less than 1% of a task lifecycle");
+    std::cout << "PASSED" << std::endl;
+}
+
+int main() {
+    std::cout << "Running tracing unit tests..." << std::endl;
+    std::cout << "================================" << std::endl;
+
+    test_lifecycle_spans();
+    test_error_spans();
+    test_tracer_removal_and_capacity();
+    test_disabled_overhead();
+
+    std::cout << "================================" << std::endl;
+    std::cout << "All tests passed!" << std::endl;
+    return 0;
+}
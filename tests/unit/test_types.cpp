@@ -124,10 +124,54 @@ void test_error_codes() {
     assert(to_int(ErrorCode::CLAIMER_NOT_ALLOWED) == 2005);
     assert(to_int(ErrorCode::PLATFORM_QUEUE_FULL) == 3001);
     assert(to_int(ErrorCode::PLATFORM_NO_AVAILABLE_TASK) == 3002);
+    assert(to_int(ErrorCode::PLATFORM_INVALID_CURSOR) == 3003);
+    assert(to_int(ErrorCode::STORAGE_IO_FAILED) == 4001);
+    assert(to_int(ErrorCode::NETWORK_BIND_FAILED) == 5001);
     
     std::cout << "✓ test_error_codes passed" << std::endl;
 }
 
+void test_payload() {
+    Payload empty;
+    assert(empty.empty());
+    assert(empty.str().empty());
+    assert(empty.use_count() == 0);
+
+    std::string big(1 << 20, 'p');
+    const char *original = big.data();
+    Payload payload(std::move(big));
+    assert(payload.size() == (1u << 20));
+    assert(payload.data() == original);  // 接管右值字符串，不复制
+    (void)original;
+
+    Payload shared = payload;
+    assert(shared.data() == payload.data());
+    assert(payload.use_count() == 2);
+
+    TaskResult result("ok");
+    result.payload = payload;
+    TaskResult copied = result;
+    assert(copied.payload.data() == original);
+    assert(copied.output_data().size() == (1u << 20));
+
+    TaskResult plain("ok");
+    plain.output = "text";
+    assert(plain.output_data() == "text");
+
+    std::cout << "✓ test_payload passed" << std::endl;
+}
+
+void test_memory_usage_string_bytes() {
+    const std::size_t inline_capacity = std::string().capacity();
+    std::string short_str(inline_capacity, 's');
+    assert(MemoryUsage::string_bytes(short_str) == 0);  // 仍在内联缓冲区内
+
+    std::string heap_str(inline_capacity + 1, 'h');     // 刚超出内联缓冲区即计入堆内存
+    assert(MemoryUsage::string_bytes(heap_str) == heap_str.capacity() + 1);
+
+    std::cout << "✓ test_memory_usage_string_bytes passed" << std::endl;
+}
+
 int main() {
     std::cout << "Running types unit tests..." << std::endl;
     std::cout << "===========================================" << std::endl;
@@ -139,6 +183,8 @@ int main() {
     test_task_result();
     test_error();
     test_error_codes();
+    test_payload();
+    test_memory_usage_string_bytes();
     
     std::cout << "===========================================" << std::endl;
     std::cout << "All tests passed! ✓" << std::endl;
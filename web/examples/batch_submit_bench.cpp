@@ -0,0 +1,96 @@
+// 批量提交基准：通过回环地址向 POST /api/tasks/batch 发送 NDJSON，统计端到端发布吞吐
+//
+// 用法：example_batch_submit_bench [tasks] [lines_per_request] [clients]
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/web/web_dashboard.hpp>
+#include <xswl/youdidit/web/web_server.hpp>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+namespace {
+
+std::string make_body(int first, int count) {
+    std::string body;
+    body.reserve(static_cast<size_t>(count) * 110);
+    for (int i = first; i < first + count; ++i) {
+        body += "{\"title\":\"Process batch #" + std::to_string(i) + "\",\"handler\":\"noop\",\"priority\":" +
+                std::to_string(i % 100) + ",\"category\":\"" + (i % 2 == 0 ? "ingest" : "report") +
+                "\",\"tags\":[\"bulk\"]}\n";
+    }
+    return body;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int total = argc > 1 ? std::max(1, std::atoi(argv[1])) : 200000;
+    const int per_request = argc > 2 ? std::max(1, std::atoi(argv[2])) : 10000;
+    const int clients = argc > 3 ? std::max(1, std::atoi(argv[3])) : 2;
+
+    TaskPlatform platform;
+    platform.set_max_task_queue_size(0);
+    WebDashboard dashboard(&platform);
+    WebServer::Options options;
+    options.max_batch_lines = static_cast<size_t>(per_request);   // 允许超过默认上限的请求规模
+    WebServer server(&dashboard, 0, options);
+    server.set_host("127.0.0.1");
+    server.register_task_handler("noop", [](Task &, const std::string &) { return TaskResult("ok"); });
+    auto started = server.start();
+    if (!started) {
+        std::cerr << "start failed: " << started.error().message << std::endl;
+        return 1;
+    }
+
+    // 请求体预先生成，计时只包含发送、解析与发布
+    const int requests = (total + per_request - 1) / per_request;
+    std::vector<std::string> bodies;
+    for (int r = 0; r < requests; ++r) {
+        bodies.push_back(make_body(r * per_request, std::min(per_request, total - r * per_request)));
+    }
+
+    std::atomic<int> next{0};
+    std::atomic<long long> accepted{0};
+    std::atomic<bool> failed{false};
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; ++c) {
+        threads.emplace_back([&]() {
+            httplib::Client client("127.0.0.1", server.get_port());
+            client.set_read_timeout(std::chrono::seconds(60));
+            for (int r = next++; r < requests; r = next++) {
+                auto res = client.Post("/api/tasks/batch", bodies[static_cast<size_t>(r)], "application/x-ndjson");
+                if (!res || res->status != 200) {
+                    failed = true;
+                    return;
+                }
+                accepted += nlohmann::json::parse(res->body)["accepted"].get<long long>();
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    server.stop();
+
+    if (failed) {
+        std::cerr << "request failed" << std::endl;
+        return 1;
+    }
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "tasks=" << total << " lines/request=" << per_request << " clients=" << clients << std::endl;
+    std::cout << "accepted=" << accepted.load() << " platform=" << platform.task_count() << std::endl;
+    std::cout << "elapsed=" << seconds * 1000.0 << " ms  throughput=" << accepted.load() / seconds << " tasks/s"
+              << std::endl;
+    return accepted.load() == total ? 0 : 1;
+}
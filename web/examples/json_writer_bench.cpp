@@ -0,0 +1,131 @@
+// JSON 序列化基准：以 /api/tasks 的任务列表为负载，对比原先的 std::ostringstream 拼接、
+// JsonWriter 与 nlohmann::json 的耗时与输出有效性（标题中包含引号与控制字符）
+//
+// 用法：example_json_writer_bench [tasks] [rounds]
+#include <xswl/youdidit/core/task.hpp>
+#include <xswl/youdidit/web/json_writer.hpp>
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace xswl::youdidit;
+
+namespace {
+
+long long epoch_ms(const Timestamp &ts) {
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count());
+}
+
+std::vector<TaskView> make_tasks(int count) {
+    std::vector<TaskView> tasks(static_cast<size_t>(count));
+    auto now = std::chrono::system_clock::now();
+    for (int i = 0; i < count; ++i) {
+        TaskView &view = tasks[static_cast<size_t>(i)];
+        view.id = "task-" + std::to_string(i);
+        // 每 10 个任务有一个标题带引号、反斜杠与换行，原实现会输出非法 JSON
+        view.title = i % 10 == 0 ? "Fix \"quoted\" path C:\\tmp\n(line 2)" : "Process batch #" + std::to_string(i);
+        view.category = i % 2 == 0 ? "ingest" : "report";
+        view.priority = i % 100;
+        view.status = i % 3 == 0 ? TaskStatus::Completed : TaskStatus::Published;
+        view.published_at = now - std::chrono::seconds(i);
+        view.claimer_id = i % 3 == 0 ? "worker-" + std::to_string(i % 8) : std::string();
+    }
+    return tasks;
+}
+
+// 与改造前 /api/tasks 相同的拼接方式（不转义）
+std::string serialize_ostream(const std::vector<TaskView> &tasks) {
+    std::ostringstream oss;
+    oss << "{\"tasks\":[";
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        if (i > 0) oss << ",";
+        oss << "{";
+        oss << "\"id\":\"" << tasks[i].id << "\",";
+        oss << "\"title\":\"" << tasks[i].title << "\",";
+        oss << "\"category\":\"" << tasks[i].category << "\",";
+        oss << "\"priority\":" << tasks[i].priority << ",";
+        oss << "\"status\":\"" << to_string(tasks[i].status) << "\",";
+        oss << "\"published_at\":" << epoch_ms(tasks[i].published_at) << ",";
+        oss << "\"claimer_id\":\"" << tasks[i].claimer_id << "\"";
+        oss << "}";
+    }
+    oss << "],\"count\":" << tasks.size() << "}";
+    return oss.str();
+}
+
+std::string serialize_writer(const std::vector<TaskView> &tasks) {
+    JsonWriter w;
+    w.begin_object().key("tasks").begin_array();
+    for (const auto &view : tasks) {
+        w.begin_object()
+            .field("id", view.id)
+            .field("title", view.title)
+            .field("category", view.category)
+            .field("priority", view.priority)
+            .field("status", to_string(view.status))
+            .field("published_at", epoch_ms(view.published_at))
+            .field("claimer_id", view.claimer_id)
+            .end_object();
+    }
+    w.end_array().field("count", tasks.size()).end_object();
+    return w.str();
+}
+
+std::string serialize_nlohmann(const std::vector<TaskView> &tasks) {
+    nlohmann::json array = nlohmann::json::array();
+    for (const auto &view : tasks) {
+        nlohmann::json item;
+        item["id"] = view.id;
+        item["title"] = view.title;
+        item["category"] = view.category;
+        item["priority"] = view.priority;
+        item["status"] = to_string(view.status);
+        item["published_at"] = epoch_ms(view.published_at);
+        item["claimer_id"] = view.claimer_id;
+        array.push_back(std::move(item));
+    }
+    nlohmann::json doc;
+    doc["tasks"] = std::move(array);
+    doc["count"] = tasks.size();
+    return doc.dump();
+}
+
+void run(const std::string &name, const std::vector<TaskView> &tasks, int rounds,
+         const std::function<std::string(const std::vector<TaskView> &)> &serialize) {
+    std::string out;
+    size_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        out = serialize(tasks);
+        bytes += out.size();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    bool valid = nlohmann::json::accept(out);
+
+    std::cout << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << seconds * 1000.0 / rounds << std::setprecision(1) << std::setw(12)
+              << bytes / seconds / (1024.0 * 1024.0) << std::setw(12) << out.size() / 1024.0 << std::setw(8)
+              << (valid ? "yes" : "NO") << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const int task_count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    const int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+    auto tasks = make_tasks(task_count);
+
+    std::cout << "tasks=" << task_count << " rounds=" << rounds << std::endl;
+    std::cout << std::left << std::setw(14) << "serializer" << std::right << std::setw(12) << "ms/doc"
+              << std::setw(12) << "MB/s" << std::setw(12) << "doc(KB)" << std::setw(8) << "valid" << std::endl;
+    run("ostringstream", tasks, rounds, serialize_ostream);
+    run("JsonWriter", tasks, rounds, serialize_writer);
+    run("nlohmann", tasks, rounds, serialize_nlohmann);
+    return 0;
+}
@@ -69,15 +69,15 @@ int main(int argc, char** argv) {
 #endif
     
     std::cout << "启动Web服务器...\n";
-    web_server.start();
+    auto started = web_server.start();
     
-    if (!web_server.is_running()) {
-        std::cerr << "✗ 无法启动Web服务器\n";
+    if (!started) {
+        std::cerr << "✗ 无法启动Web服务器: " << started.error().message << "\n";
         return 1;
     }
     
     std::cout << "✓ Web服务器已启动\n";
-    std::cout << "\n📊 访问地址: http://localhost:" << port << "\n\n";
+    std::cout << "\n📊 访问地址: http://localhost:" << web_server.get_port() << "\n\n";
     
     // 控制线程运行
     std::atomic<bool> keep_running{true};
@@ -7,10 +7,28 @@
 #include <vector>
 #include <map>
 #include <mutex>
+#include <functional>
+#include <memory>
+#include <cstdint>
 
 namespace xswl {
 namespace youdidit {
 
+class EventStore;
+
+/**
+ * @brief 事件日志
+ *
+ * 默认容量不限；设置容量后以环形缓冲区存储（构造或 set_capacity() 时一次性预留全部槽位）：
+ * 按时间顺序追加为 O(1)、不移动已有事件，满时覆盖最旧的事件并计入 dropped_count()。
+ * 不限容量时底层数组按需增长，扩容时移动已有事件（均摊 O(1)）。
+ *
+ * 事件始终按 (timestamp, sequence) 有序保存：迟到的事件向前逐个交换到正确位置，
+ * 代价为 O(k)，k 为比它新的已有事件数（最坏 O(n)）。
+ * 时间范围查询通过二分查找定位边界，游标分页一页的代价为 O(log n + limit)。
+ *
+ * 挂接 EventStore 后，每个事件在写入内存的同时交给存储的写线程持久化；内存中仍只保留最近的事件。
+ */
 class EventLog {
 public:
     enum class EventType {
@@ -26,6 +44,7 @@ public:
         std::string source;
         std::string message;
         std::map<std::string, std::string> metadata;
+        std::uint64_t sequence;  ///< 写入序号（由 EventLog 分配，单调递增）
     };
 
     struct Filter {
@@ -37,11 +56,21 @@ public:
 
     EventLog();
 
+    /**
+     * @brief 创建固定容量的事件日志
+     * @param capacity 最多保留的事件数（0 表示不限）；非 0 时立即预留 capacity 个槽位
+     */
+    explicit EventLog(size_t capacity);
+
     void add_event(EventType type,
                    const std::string &source,
                    const std::string &message,
                    const std::map<std::string, std::string> &metadata = {});
 
+    /**
+     * @brief 以指定时间戳追加事件
+     * @note 时间戳早于已有事件（迟到）时需向前移动到正确位置，代价与比它新的事件数成正比
+     */
     void add_event_at(const Timestamp &ts,
                       EventType type,
                       const std::string &source,
@@ -50,12 +79,83 @@ public:
 
     std::vector<Event> get_events(const Filter &filter = {}) const;
 
+    /**
+     * @brief 按时间顺序遍历匹配的事件（不复制）
+     * @param visitor 返回 false 时停止遍历；调用期间持有日志锁，不得在其中写入本日志
+     * @return 传给 visitor 的事件数
+     */
+    size_t for_each_event(const Filter &filter, const std::function<bool(const Event &)> &visitor) const;
+
+    /**
+     * @brief 统计匹配的事件数（仅含时间范围条件时为 O(log n)）
+     */
+    size_t count_events(const Filter &filter = {}) const;
+
+    struct Page {
+        std::vector<Event> events;
+        std::string next_cursor;  ///< 为空表示没有更多事件
+    };
+
+    /**
+     * @brief 游标分页查询（按时间升序）
+     * @param cursor 上一页返回的 next_cursor，空字符串表示从头开始；无法解析的游标视为从头开始
+     * @param limit 每页最多返回的事件数
+     */
+    Page get_events_page(const Filter &filter, size_t limit, const std::string &cursor = std::string()) const;
+
     void cleanup_events_before(const Timestamp &before_time);
 
     size_t size() const;
 
+    /**
+     * @brief 设置容量（0 表示不限）；缩小时丢弃最旧的事件并计入 dropped_count()
+     */
+    void set_capacity(size_t capacity);
+    size_t capacity() const;
+
+    /**
+     * @brief 因容量限制被覆盖/丢弃的事件总数
+     */
+    std::uint64_t dropped_count() const;
+
+    /**
+     * @brief 挂接持久化存储（传入空指针表示取消挂接）
+     *
+     * 此后追加的事件同时写入存储，序号从存储中已有的最大序号之后继续；
+     * 日志为空且容量有限时，从存储预加载最近的至多 capacity() 条事件。
+     */
+    void attach_store(std::shared_ptr<EventStore> store);
+    std::shared_ptr<EventStore> store() const;
+
+    /**
+     * @brief 获取近似内存占用（O(1)，增量维护）
+     * @return 组件 "events"（事件及其字符串/元数据）与 "reserved"（vector 预留但未使用的容量）
+     */
+    MemoryUsage memory_usage() const;
+
 private:
-    std::vector<Event> events_;
+    static size_t _event_bytes(const Event &event);
+    void _insert(Event &&event, size_t bytes);   // 要求调用方持有 mutex_
+
+    // 以下辅助函数要求调用方持有 mutex_
+    const Event &_at(size_t index) const;   // 按时间先后的第 index 个事件
+    Event &_at(size_t index);
+    size_t _lower_bound(const Timestamp &ts) const;   // 第一个 timestamp >= ts 的位置
+    size_t _upper_bound(const Timestamp &ts) const;   // 第一个 timestamp > ts 的位置
+    void _range(const Filter &filter, size_t &begin, size_t &end) const;
+    static bool _matches(const Event &event, const Filter &filter);
+    void _linearize();                      // 将环形存储整理为从下标 0 开始的连续顺序
+    void _pop_oldest();
+    void _drop_oldest();                    // 因容量限制丢弃最旧事件（计入 dropped_）
+
+    std::vector<Event> events_;   // 环形存储（events_.size() 为已分配槽位数）
+    size_t head_{0};              // 最旧事件所在槽位
+    size_t count_{0};             // 有效事件数
+    size_t capacity_{0};          // 0 表示不限
+    std::uint64_t dropped_{0};
+    std::uint64_t next_sequence_{1};
+    size_t events_bytes_{0};
+    std::shared_ptr<EventStore> store_;
     mutable std::mutex mutex_;
 };
 
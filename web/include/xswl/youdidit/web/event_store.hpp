@@ -0,0 +1,134 @@
+#ifndef XSWL_YOUDIDIT_WEB_EVENT_STORE_HPP
+#define XSWL_YOUDIDIT_WEB_EVENT_STORE_HPP
+
+#include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/core/types.hpp>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 事件日志的持久化后端（只追加的二进制分段文件）
+ *
+ * 事件编码为带长度与 CRC32 的紧凑二进制记录，由后台写线程批量写入当前段文件，
+ * 每批只做一次 fsync（组提交）；段文件超过 segment_bytes 后封存并滚动到下一个段。
+ *
+ * 每个段维护稀疏时间索引（每 index_interval_bytes 字节一项），封存时写入同名 .idx 文件。
+ * 历史查询先按段的时间范围筛选，再通过 mmap 映射段文件并借助索引跳到起始位置，
+ * 只有被访问的页才会读入内存。
+ *
+ * 打开时执行崩溃恢复扫描：索引缺失或与段文件不一致的段会被重新扫描，
+ * 末尾不完整或 CRC 校验失败的记录会被截断。
+ *
+ * 待写缓冲区以 max_pending_bytes 为上限：磁盘或 fsync 停滞时，超出上限的事件被丢弃并计入
+ * dropped_events，append() 从不阻塞调用方（通常是 EventLog::add_event 的调用线程）。
+ */
+class EventStore {
+public:
+    struct Options {
+        std::string base_path;                             ///< 段文件为 <base_path>.<序号>.seg，索引为 .idx
+        std::size_t segment_bytes = 16 * 1024 * 1024;      ///< 单个段文件的滚动阈值
+        std::size_t index_interval_bytes = 64 * 1024;      ///< 稀疏索引间隔
+        std::size_t retention_bytes = 0;                   ///< 所有段的总大小上限（0 表示不限）
+        std::chrono::hours retention_age{0};               ///< 段内最新事件的最长保留时间（0 表示不限）
+        std::chrono::milliseconds flush_interval{20};      ///< 组提交的最长等待时间
+        bool sync_on_flush = true;                         ///< 每批写入后是否 fsync
+        std::size_t max_pending_bytes = 64 * 1024 * 1024;  ///< 待写缓冲区上限，超出时丢弃新事件（0 表示不限）
+    };
+
+    struct Statistics {
+        std::size_t segments;               ///< 当前段文件数
+        std::uint64_t total_bytes;          ///< 所有段文件的有效字节数
+        std::uint64_t appended;             ///< 已提交给写线程的记录数
+        std::uint64_t persisted;            ///< 已写入段文件的记录数
+        std::uint64_t syncs;                ///< fsync 次数（每批一次）
+        std::uint64_t recovered_records;    ///< 打开时恢复扫描得到的记录数
+        std::uint64_t truncated_bytes;      ///< 恢复扫描截断的损坏/不完整字节数
+        std::uint64_t removed_segments;     ///< 因保留策略删除的段数
+        std::uint64_t write_errors;         ///< 写入失败次数
+        std::uint64_t dropped_events;       ///< 因待写缓冲区超出上限而丢弃的事件数（不计入 appended）
+        std::uint64_t discarded_records;    ///< 已进入缓冲区但因写入失败而丢弃的记录数
+    };
+
+    /**
+     * @brief 打开（或创建）事件存储并执行恢复扫描
+     * @return 段文件无法创建或打开时返回 STORAGE_IO_FAILED
+     */
+    static tl::expected<std::shared_ptr<EventStore>, Error> open(const Options &options);
+
+    /**
+     * @brief 析构时写完缓冲区中的记录并停止写线程
+     */
+    ~EventStore() noexcept;
+
+    EventStore(const EventStore &) = delete;
+    EventStore &operator=(const EventStore &) = delete;
+
+    /**
+     * @brief 追加一条事件（只编码并放入缓冲区，不等待落盘）
+     * @note 缓冲区已超过 max_pending_bytes 时事件被丢弃并计入 dropped_events
+     */
+    void append(const EventLog::Event &event);
+
+    void append(const Timestamp &ts,
+                EventLog::EventType type,
+                const std::string &source,
+                const std::string &message,
+                const std::map<std::string, std::string> &metadata,
+                std::uint64_t sequence);
+
+    /**
+     * @brief 等待此前追加的记录全部由写线程处理（并按配置 fsync）
+     * @return 自上一次 flush() 以来没有事件被丢弃（缓冲区超限或写入失败）时返回 true；
+     *         丢失只报告一次，具体数目见 statistics() 的 dropped_events、discarded_records 与 write_errors
+     */
+    bool flush();
+
+    /**
+     * @brief 按段顺序遍历已写入的匹配事件
+     * @param visitor 返回 false 时停止遍历
+     * @return 传给 visitor 的事件数
+     * @note 同一段内的事件按追加顺序返回，时间戳可能有少量乱序
+     */
+    size_t for_each_event(const EventLog::Filter &filter,
+                          const std::function<bool(const EventLog::Event &)> &visitor) const;
+
+    std::vector<EventLog::Event> get_events(const EventLog::Filter &filter = {}) const;
+
+    /**
+     * @brief 最近写入的至多 limit 条事件（按追加顺序）
+     */
+    std::vector<EventLog::Event> recent_events(size_t limit) const;
+
+    /**
+     * @brief 已写入记录中的最大序号（空存储为 0）
+     */
+    std::uint64_t last_sequence() const;
+
+    /**
+     * @brief 立即按保留策略删除过期的已封存段（写线程在每次滚动后也会执行）
+     */
+    void apply_retention();
+
+    Statistics statistics() const;
+    const Options &options() const noexcept;
+
+private:
+    explicit EventStore(const Options &options);
+
+    class Impl;
+    std::unique_ptr<Impl> d;
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_WEB_EVENT_STORE_HPP
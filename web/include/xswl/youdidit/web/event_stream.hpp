@@ -0,0 +1,124 @@
+#ifndef XSWL_YOUDIDIT_WEB_EVENT_STREAM_HPP
+#define XSWL_YOUDIDIT_WEB_EVENT_STREAM_HPP
+
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief Server-Sent Events 推送中心
+ *
+ * 通过平台的批量生命周期订阅接收状态转换（工作线程只做一次缓冲追加），在订阅线程上把每条转换
+ * 格式化为一条 SSE 消息（只格式化一次，所有客户端共享），再投递到每个客户端的有界队列。
+ * 每个客户端的代价与变化量成正比，与任务总数无关。
+ *
+ * 客户端队列满时丢弃最旧的消息，并在下一次读取时先发送 resync 事件，客户端据此重新拉取全量数据；
+ * 平台订阅的待投递记录超过 batch.max_pending 而丢弃记录时，向所有客户端广播 resync。
+ * 投递从不阻塞，慢客户端不会拖慢订阅线程或任务工作线程。
+ */
+class EventStreamHub {
+public:
+    struct Options {
+        size_t client_queue_capacity = 1024;               ///< 每个客户端最多缓存的消息数
+        size_t max_clients = 0;                            ///< 同时连接的客户端上限，0 表示不限
+        std::chrono::milliseconds heartbeat_interval{15000}; ///< 空闲时发送心跳注释的间隔
+        LifecycleBatchOptions batch;                       ///< 生命周期批量订阅参数
+    };
+
+    /**
+     * @brief 单个 SSE 连接的有界消息队列
+     */
+    class Client {
+    public:
+        explicit Client(size_t capacity);
+
+        /**
+         * @brief 等待并取出所有待发送的消息（拼接为一段 SSE 文本）
+         * @param out 超时且无消息时为空
+         * @return 客户端已关闭时返回 false
+         */
+        bool pop_all(std::string &out, std::chrono::milliseconds timeout);
+
+        /**
+         * @brief 非阻塞投递一批消息；队列满时丢弃最旧消息并标记需要 resync
+         */
+        void push(const std::vector<std::shared_ptr<const std::string>> &messages);
+        void close();
+
+        bool closed() const;
+        std::uint64_t dropped() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        std::deque<std::shared_ptr<const std::string>> queue_;
+        size_t capacity_;
+        bool overflowed_{false};
+        bool closed_{false};
+        std::uint64_t dropped_{0};
+    };
+
+    explicit EventStreamHub(TaskPlatform *platform);
+    EventStreamHub(TaskPlatform *platform, const Options &options);
+    ~EventStreamHub();
+
+    EventStreamHub(const EventStreamHub &) = delete;
+    EventStreamHub &operator=(const EventStreamHub &) = delete;
+
+    /**
+     * @brief 接入一个客户端
+     * @return 已达到 max_clients 时返回空指针；推送中心已关闭时返回已关闭的客户端
+     */
+    std::shared_ptr<Client> connect();
+    void disconnect(const std::shared_ptr<Client> &client);
+
+    /**
+     * @brief 向所有客户端广播一条自定义事件
+     * @param data 单行 JSON（不得包含换行）
+     */
+    void broadcast(const std::string &event, const std::string &data);
+
+    /**
+     * @brief 取消平台订阅并关闭所有客户端（幂等）
+     */
+    void close();
+
+    /**
+     * @brief 立即投递平台中尚未发送的状态转换
+     */
+    void sync();
+
+    size_t client_count() const;
+    const Options &options() const noexcept;
+
+private:
+    void _on_batch(const std::vector<TaskLifecycleRecord> &records);
+    std::shared_ptr<const std::string> _format(const std::string &event, const std::string &data);
+    void _fan_out(const std::vector<std::shared_ptr<const std::string>> &messages);
+
+    TaskPlatform *platform_;
+    Options options_;
+    std::uint64_t subscription_id_{0};
+
+    mutable std::mutex clients_mutex_;
+    std::vector<std::shared_ptr<Client>> clients_;
+    bool closed_{false};
+
+    std::mutex format_mutex_;
+    std::uint64_t next_event_id_{1};
+    std::uint64_t reported_dropped_{0};   // 已通知过 resync 的订阅丢弃数，仅在订阅线程上访问
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_WEB_EVENT_STREAM_HPP
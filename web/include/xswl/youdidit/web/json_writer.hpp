@@ -0,0 +1,103 @@
+#ifndef XSWL_YOUDIDIT_WEB_JSON_WRITER_HPP
+#define XSWL_YOUDIDIT_WEB_JSON_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 流式 JSON 写入器
+ *
+ * 直接追加到内部字符串缓冲区：不经过 std::ostream（不受 locale 影响、无格式化状态开销），
+ * 字符串按 RFC 8259 转义，逗号与冒号由写入器根据嵌套状态自动插入。
+ *
+ * 构造时提供 sink 则在缓冲区超过 flush_threshold 字节时把已生成的内容交给 sink 并清空，
+ * 输出任意大的文档只占用约一个阈值大小的内存；也可在分块输出时手动 clear() 缓冲区，嵌套状态保持不变。
+ *
+ * @code
+ * JsonWriter w;
+ * w.begin_object().field("id", task.id).key("tags").begin_array().value("a").end_array().end_object();
+ * @endcode
+ */
+class JsonWriter {
+public:
+    using Sink = std::function<bool(const char *data, size_t size)>;
+
+    JsonWriter();
+    explicit JsonWriter(Sink sink, size_t flush_threshold = 16384);
+
+    JsonWriter &begin_object();
+    JsonWriter &end_object();
+    JsonWriter &begin_array();
+    JsonWriter &end_array();
+
+    JsonWriter &key(const char *name);
+    JsonWriter &key(const std::string &name);
+
+    JsonWriter &value(const char *text);
+    JsonWriter &value(const std::string &text);
+    JsonWriter &value(bool flag);
+    JsonWriter &value(int number);
+    JsonWriter &value(unsigned number);
+    JsonWriter &value(long number);
+    JsonWriter &value(unsigned long number);
+    JsonWriter &value(long long number);
+    JsonWriter &value(unsigned long long number);
+    JsonWriter &value(double number);   ///< NaN/无穷输出为 null
+    JsonWriter &null();
+
+    /**
+     * @brief 写入一段已经序列化好的 JSON 值（不做检查）
+     */
+    JsonWriter &raw_value(const char *json, size_t size);
+
+    template <typename T>
+    JsonWriter &field(const char *name, const T &v) {
+        return key(name).value(v);
+    }
+
+    const std::string &str() const noexcept;
+    size_t size() const noexcept;
+
+    /**
+     * @brief 清空缓冲区（保留嵌套状态，用于分块输出）
+     */
+    void clear();
+
+    /**
+     * @brief 把缓冲区交给 sink 并清空；没有 sink 时不做任何事
+     * @return sink 曾经返回过 false 时返回 false
+     */
+    bool flush();
+    bool ok() const noexcept;
+
+    /**
+     * @brief 把 text 转义后（不含两侧引号）追加到 out
+     */
+    static void escape(std::string &out, const char *text, size_t size);
+    static void escape(std::string &out, const std::string &text);
+
+private:
+    void _separate();
+    void _write_string(const char *text, size_t size);
+    void _write_signed(long long number);
+    void _write_unsigned(unsigned long long number);
+    void _maybe_flush();
+
+    std::string buffer_;
+    std::vector<bool> first_;   // 每层容器是否尚未写入元素
+    bool after_key_;
+    Sink sink_;
+    size_t flush_threshold_;
+    bool ok_;
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_WEB_JSON_WRITER_HPP
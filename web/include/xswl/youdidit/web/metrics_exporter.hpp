@@ -2,22 +2,35 @@
 #define XSWL_YOUDIDIT_WEB_METRICS_EXPORTER_HPP
 
 #include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/web/metrics_snapshot.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
+#include <memory>
 #include <string>
+#include <ostream>
 
 namespace xswl {
 namespace youdidit {
 
 class MetricsExporter {
 public:
+    // 每次导出时直接从平台与事件日志采集
     MetricsExporter(TaskPlatform *platform, EventLog *event_log);
 
+    // 从后台快照导出：不访问平台锁，数据最多落后一个刷新间隔
+    explicit MetricsExporter(std::shared_ptr<MetricsSnapshotter> snapshotter);
+
     std::string export_json() const;
     std::string export_prometheus() const;
 
 private:
+    std::shared_ptr<const MetricsSnapshot> _snapshot() const;
+    void _write_latency(std::ostream &oss, const MetricsSnapshot &snapshot) const;
+    void _write_locks(std::ostream &oss, const MetricsSnapshot &snapshot) const;
+    void _write_memory_usage(std::ostream &oss, const MetricsSnapshot &snapshot) const;
+
     TaskPlatform *platform_;
     EventLog *event_log_;
+    std::shared_ptr<MetricsSnapshotter> snapshotter_;
 };
 
 } // namespace youdidit
@@ -0,0 +1,121 @@
+#ifndef XSWL_YOUDIDIT_WEB_METRICS_SNAPSHOT_HPP
+#define XSWL_YOUDIDIT_WEB_METRICS_SNAPSHOT_HPP
+
+#include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <xswl/youdidit/core/lock_profile.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 某一时刻的指标快照（发布后不可修改）
+ */
+struct MetricsSnapshot {
+    TaskPlatform::PlatformStatistics stats;
+    std::uint64_t change_sequence;   ///< 采集 stats 前平台的变更序号：stats 已包含序号不大于它的所有变更（无平台时为 0）
+    bool has_platform;
+    bool has_event_log;
+    size_t event_count;
+    std::uint64_t events_dropped;
+    MemoryUsage platform_memory;
+    std::vector<std::pair<std::string, MemoryUsage>> claimer_memory;   ///< (申领者 ID, 内存占用)
+    MemoryUsage event_log_memory;
+    std::vector<TaskPlatform::LatencySeries> latency;   ///< 各 (分类, 申领者) 的阶段延迟直方图
+    std::vector<LockStatistics> locks;   ///< 进程内各锁位置的争用统计，未启用锁统计时为空
+    Timestamp taken_at;
+    std::uint64_t generation;   ///< 发布序号，从 1 开始
+
+    /// 没有本地平台时的统计来源（如多平台聚合），返回值写入 stats
+    using StatisticsSource = std::function<TaskPlatform::PlatformStatistics()>;
+
+    /**
+     * @brief 立即从平台与事件日志采集一份快照（两者均可为空）
+     * @param statistics platform 为空时用它提供 stats（此时 has_platform 为 true）
+     */
+    static std::shared_ptr<const MetricsSnapshot> capture(TaskPlatform *platform, EventLog *event_log,
+                                                          std::uint64_t generation = 0,
+                                                          const StatisticsSource &statistics = StatisticsSource());
+};
+
+/**
+ * @brief 后台指标快照线程
+ *
+ * 每个刷新间隔在后台线程上调用一次 get_statistics()、latency_histograms() 等接口（只有这一处与申领者竞争平台锁），
+ * 生成新的不可变快照并通过 shared_ptr 原子交换发布。current() 只做一次原子加载，
+ * 任意数量的并发抓取者都不会触碰平台锁，代价与任务数无关；读到的数据最多落后一个刷新间隔。
+ *
+ * 刷新间隔 <= 0 时不启动后台线程，current() 每次直接采集（与改造前的行为相同）。
+ */
+class MetricsSnapshotter {
+public:
+    MetricsSnapshotter(TaskPlatform *platform, EventLog *event_log, std::chrono::milliseconds interval);
+    ~MetricsSnapshotter();
+
+    MetricsSnapshotter(const MetricsSnapshotter &) = delete;
+    MetricsSnapshotter &operator=(const MetricsSnapshotter &) = delete;
+
+    /**
+     * @brief 最近发布的快照（一次原子加载，不触碰平台锁，永不为空；刷新间隔 <= 0 且未停止时改为直接采集）
+     */
+    std::shared_ptr<const MetricsSnapshot> current();
+
+    /**
+     * @brief 立即采集并发布一份新快照
+     */
+    std::shared_ptr<const MetricsSnapshot> refresh();
+
+    /**
+     * @brief 修改刷新间隔；<= 0 停止后台线程，> 0 按需启动线程并从现在起按新间隔刷新
+     */
+    void set_interval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds interval() const;
+
+    /**
+     * @brief 设置没有本地平台时的统计来源，并立即刷新一次
+     */
+    void set_statistics_source(MetricsSnapshot::StatisticsSource statistics);
+
+    /**
+     * @brief 停止后台线程（幂等）；之后 current() 返回最后一份快照
+     */
+    void stop();
+
+private:
+    void _run();
+    void _stop_thread(std::unique_lock<std::mutex> &lock);
+    void _update_live();
+
+    TaskPlatform *platform_;
+    EventLog *event_log_;
+
+    std::shared_ptr<const MetricsSnapshot> snapshot_;   // 只通过 std::atomic_load/atomic_store 访问
+    std::mutex refresh_mutex_;                          // 串行化采集与发布，保证 generation 单调
+    std::uint64_t next_generation_{1};
+    MetricsSnapshot::StatisticsSource statistics_;      // 受 refresh_mutex_ 保护
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::chrono::milliseconds interval_;
+    bool stopping_{false};
+    bool interval_changed_{false};
+    bool stopped_{false};
+    std::atomic<bool> live_{false};   // interval_ <= 0 且未停止：current() 直接采集
+    std::thread thread_;
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_WEB_METRICS_SNAPSHOT_HPP
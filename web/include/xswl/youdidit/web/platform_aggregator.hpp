@@ -0,0 +1,120 @@
+#ifndef XSWL_YOUDIDIT_WEB_PLATFORM_AGGREGATOR_HPP
+#define XSWL_YOUDIDIT_WEB_PLATFORM_AGGREGATOR_HPP
+
+#include <xswl/youdidit/core/task.hpp>
+#include <xswl/youdidit/core/task_platform.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace xswl {
+namespace youdidit {
+
+/**
+ * @brief 单个远程平台端点的最近抓取结果（发布后不可修改）
+ *
+ * 抓取失败时保留上一次成功的统计与任务列表，只更新 reachable / last_error 等状态字段，
+ * 聚合视图因此始终有数据可用，由调用方根据 updated_at 判断是否过期。
+ */
+struct EndpointSnapshot {
+    std::string endpoint;
+    bool reachable = false;                         ///< 最近一次抓取是否成功
+    bool has_data = false;                          ///< 是否至少成功抓取过一次
+    std::string last_error;                         ///< 最近一次失败的原因（成功时为空）
+    TaskPlatform::PlatformStatistics stats{};       ///< 最近一次成功抓取的统计
+    std::shared_ptr<const std::vector<TaskView>> tasks;   ///< 最近一次成功抓取的任务摘要（永不为空）
+    bool tasks_truncated = false;                   ///< 任务数超过上限或抓取超时，只取到一部分
+    Timestamp updated_at;                           ///< 最近一次成功抓取的时间
+    Timestamp attempted_at;                         ///< 最近一次抓取的时间
+    std::chrono::milliseconds scrape_duration{0};   ///< 最近一次抓取的耗时
+    std::uint64_t consecutive_failures = 0;
+};
+
+/**
+ * @brief 多平台聚合抓取器
+ *
+ * 每个端点一个后台线程，按刷新间隔并发抓取，每个请求受 timeout 限制，结果通过 shared_ptr 原子交换
+ * 发布到该端点的槽位。读取只做原子加载并合并，慢速或不可达的端点只会推迟自己的槽位，
+ * 聚合视图继续使用它上一次成功的结果。
+ *
+ * 每个端点在本地维护任务镜像：首次按游标翻页全量拉取 GET /api/tasks，之后以 ?since=<序号> 只拉取变化与墓碑
+ * （对端要求 reset 或不返回序号时退回全量）；GET /api/metrics 带 If-None-Match，未变化时只收到 304。
+ * 镜像没有变化时继续共享上一份任务列表，空闲端点每轮只有两个几乎为空的响应。
+ *
+ * 刷新间隔 <= 0 时不启动后台线程，读取时先同步并发抓取一轮（与 MetricsSnapshotter 的约定一致）。
+ */
+class PlatformAggregator {
+public:
+    struct Options {
+        std::chrono::milliseconds interval{1000};   ///< 每个端点的刷新间隔
+        std::chrono::milliseconds timeout{500};     ///< 每个端点的连接/读/写超时，也是单轮翻页的总时限
+        size_t max_tasks_per_endpoint = 1000;       ///< 每个端点最多抓取的任务数
+    };
+
+    /**
+     * @brief 端点形如 "http://host:port"、"host:port"，可带路径前缀（末尾的 /api/metrics 会被忽略）
+     */
+    explicit PlatformAggregator(const std::vector<std::string> &endpoints);
+    PlatformAggregator(const std::vector<std::string> &endpoints, const Options &options);
+    ~PlatformAggregator();
+
+    PlatformAggregator(const PlatformAggregator &) = delete;
+    PlatformAggregator &operator=(const PlatformAggregator &) = delete;
+
+    /**
+     * @brief 各端点的最近抓取结果（顺序与构造时一致）
+     */
+    std::vector<std::shared_ptr<const EndpointSnapshot>> endpoints();
+
+    /**
+     * @brief 所有有数据的端点的统计之和（包括暂时不可达、沿用上次结果的端点）
+     */
+    TaskPlatform::PlatformStatistics totals();
+
+    /**
+     * @brief 立即并发抓取所有端点并等待完成（每个端点最多耗时约 timeout）
+     */
+    void refresh();
+
+    /**
+     * @brief 修改刷新间隔；<= 0 停止后台线程，> 0 按需启动线程并从现在起按新间隔刷新
+     */
+    void set_interval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds interval() const;
+    const Options &options() const noexcept;
+
+    /**
+     * @brief 停止所有后台线程（幂等）；之后读取返回最后一次的结果
+     */
+    void stop();
+
+private:
+    struct Slot;
+
+    void _scrape(Slot &slot);
+    void _run(Slot &slot);
+    void _start_threads();
+    void _stop_threads(std::unique_lock<std::mutex> &lock);
+    void _update_live();
+
+    Options options_;
+    Timestamp created_at_;
+    std::vector<std::unique_ptr<Slot>> slots_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_{false};
+    bool stopped_{false};
+    std::uint64_t interval_epoch_{0};   // 每次修改间隔加一，唤醒等待中的线程
+    std::atomic<bool> live_{false};     // interval <= 0 且未停止：读取时先同步抓取
+};
+
+} // namespace youdidit
+} // namespace xswl
+
+#endif // XSWL_YOUDIDIT_WEB_PLATFORM_AGGREGATOR_HPP
@@ -3,12 +3,32 @@
 
 #include <xswl/youdidit/web/event_log.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
-#include <vector>
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace xswl {
 namespace youdidit {
 
+/**
+ * @brief 时间回放
+ *
+ * 调用 start_recording() 后，通过平台的批量生命周期订阅记录状态转换与删除的增量流，
+ * 并每 checkpoint_interval 条增量保存一次紧凑检查点（各状态任务数、各申领者负载）。
+ * 每个任务的当前状态单独跟踪：只有旧状态与跟踪状态一致的记录才会应用，
+ * 基线建立前后重叠到达的转换因此不会被重复计入；订阅丢弃过记录时从平台重建基线。
+ * snapshot_at() 二分定位到不晚于目标时刻的检查点再应用其后的增量，代价为 O(log n + checkpoint_interval)；
+ * timeline() 在一次定位后顺序推进，适合在 24 小时窗口内快速拖动。
+ *
+ * 未开始记录时 snapshot_at() 的任务统计退化为平台当前值。
+ * 记录期间平台必须比 TimeReplay 存活更久。
+ */
 class TimeReplay {
 public:
     struct Snapshot {
@@ -17,17 +37,118 @@ public:
         size_t completed_tasks{0};
         size_t failed_tasks{0};
         size_t events_count{0};
+        size_t published_tasks{0};
+        size_t claimed_tasks{0};
+        size_t processing_tasks{0};
+        size_t abandoned_tasks{0};
+        std::map<std::string, int> claimer_load;  ///< 各申领者持有（已申领/处理中/暂停）的任务数，仅记录期间有效
+    };
+
+    struct RecordingOptions {
+        size_t checkpoint_interval = 256;            ///< 每多少条状态转换保存一个检查点
+        std::chrono::hours history_window{24};       ///< 保留的历史时长（0 表示不限）
+        LifecycleBatchOptions batch;                 ///< 生命周期批量订阅参数
     };
 
     explicit TimeReplay(EventLog *event_log, TaskPlatform *platform);
+    ~TimeReplay();
+
+    TimeReplay(const TimeReplay &) = delete;
+    TimeReplay &operator=(const TimeReplay &) = delete;
+
+    /**
+     * @brief 以平台当前状态为基线开始记录状态转换（已在记录或没有平台时返回 false）
+     */
+    bool start_recording();
+    bool start_recording(const RecordingOptions &options);
+    void stop_recording();
+    bool is_recording() const;
 
+    /**
+     * @brief 将平台尚未投递的状态转换立即并入历史（便于在写入后立刻查询）
+     */
+    void sync();
+
+    /**
+     * @brief 指定时刻的平台状态
+     * @note 早于记录起点的时刻返回记录起点的状态
+     */
     Snapshot snapshot_at(const Timestamp &at) const;
 
+    /**
+     * @brief [start, end] 内等间隔的 points 个快照（含两端），一次定位后顺序应用增量
+     */
+    std::vector<Snapshot> timeline(const Timestamp &start, const Timestamp &end, size_t points) const;
+
+    /**
+     * @brief 当前保留的检查点数与增量数
+     */
+    size_t checkpoint_count() const;
+    size_t delta_count() const;
+
+    /**
+     * @brief 查询时间范围内的事件（按时间升序）
+     * @note 事件日志挂接了持久化存储时，超出内存保留范围的部分从存储读取
+     */
     std::vector<EventLog::Event> events_between(const Timestamp &start, const Timestamp &end) const;
 
 private:
+    static const size_t kStatusCount = static_cast<size_t>(TaskStatus::Abandoned) + 1;
+    static const std::uint32_t kNoClaimer = 0xFFFFFFFFu;
+
+    struct State {
+        std::array<std::int64_t, kStatusCount> by_status;
+        std::vector<int> claimer_load;  // 下标为 claimer_names_ 中的位置
+    };
+
+    struct Delta {
+        Timestamp at;
+        TaskStatus old_status;  // Draft 表示新任务
+        TaskStatus new_status;  // Draft 表示任务被删除
+        std::uint32_t claimer;  // 负载变化的申领者：claimer_names_ 下标或 kNoClaimer
+    };
+
+    struct TrackedTask {
+        TaskStatus status;
+        std::uint32_t claimer;  // 最近一次的申领者，释放负载时使用
+    };
+
+    struct Checkpoint {
+        Timestamp at;
+        std::uint64_t delta_index;  // 检查点之后第一条增量的绝对序号
+        State state;
+    };
+
+    // 以下辅助函数要求调用方持有 history_mutex_
+    void _record(const std::vector<TaskLifecycleRecord> &records);
+    void _rebuild_baseline(const Timestamp &at);
+    void _push_delta(const Delta &delta);
+    std::uint32_t _intern_claimer(const std::string &claimer_id);
+    static void _apply(State &state, const Delta &delta);
+    size_t _seek(const Timestamp &at, State &state) const;      // 返回下一条待应用增量在 deltas_ 中的下标
+    size_t _advance(State &state, size_t from, const Timestamp &at) const;
+    void _fill(Snapshot &snap, const State &state) const;
+    void _prune(const Timestamp &now);
+
     EventLog *event_log_;
     TaskPlatform *platform_;
+
+    RecordingOptions recording_options_;
+    std::uint64_t subscription_id_{0};
+    bool recording_{false};
+
+    mutable std::mutex history_mutex_;
+    std::deque<Checkpoint> checkpoints_;
+    std::deque<Delta> deltas_;
+    std::uint64_t first_delta_index_{0};
+    State current_;
+    Timestamp recording_started_;
+    Timestamp last_delta_at_;
+    size_t deltas_since_checkpoint_{0};
+    std::vector<std::string> claimer_names_;
+    std::map<std::string, std::uint32_t> claimer_ids_;
+    std::unordered_map<std::string, TrackedTask> tracked_;  // 平台中每个任务的跟踪状态
+    std::uint64_t seen_dropped_{0};                         // 已处理过的订阅丢弃数
 };
 
 } // namespace youdidit
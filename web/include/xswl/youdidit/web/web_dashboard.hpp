@@ -2,8 +2,11 @@
 #define XSWL_YOUDIDIT_WEB_WEB_DASHBOARD_HPP
 
 #include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/web/event_store.hpp>
 #include <xswl/youdidit/web/time_replay.hpp>
 #include <xswl/youdidit/web/metrics_exporter.hpp>
+#include <xswl/youdidit/web/metrics_snapshot.hpp>
+#include <xswl/youdidit/web/platform_aggregator.hpp>
 #include <xswl/youdidit/core/claimer.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
 #include <memory>
@@ -19,11 +22,26 @@ public:
     // 同进程模式
     explicit WebDashboard(TaskPlatform *platform);
 
-    // 远程模式（占位实现）
+    /**
+     * @brief 远程模式：以单个端点的聚合模式运行
+     *
+     * 后台线程在本地维护远程平台的镜像：/api/metrics 使用条件请求（未变化时只收到 304），
+     * 任务列表首次全量拉取，之后以 /api/tasks?since= 只拉取变化与墓碑。get_metrics()、get_tasks_summary()
+     * 与 analyze_performance() 只读取镜像，不发起网络请求。
+     */
     explicit WebDashboard(const std::string &metrics_endpoint);
-
-    // 多平台聚合模式（占位实现）
+    WebDashboard(const std::string &metrics_endpoint, const PlatformAggregator::Options &options);
+
+    /**
+     * @brief 多平台聚合模式
+     *
+     * 每个端点一个后台线程，按刷新间隔并发抓取各平台的 /api/metrics 与 /api/tasks（见 PlatformAggregator），
+     * get_metrics() 返回各平台统计之和，get_tasks_summary() 返回合并后的任务列表（TaskSummary::endpoint 标明来源）。
+     * 不可达的端点沿用上一次成功的结果，可通过 get_endpoint_status() 查看。
+     * options.interval 同时作为初始的指标快照刷新间隔，之后可用 set_update_interval() 一并修改。
+     */
     explicit WebDashboard(const std::vector<std::string> &endpoints);
+    WebDashboard(const std::vector<std::string> &endpoints, const PlatformAggregator::Options &options);
 
     ~WebDashboard();
 
@@ -31,13 +49,32 @@ public:
     void stop_server();
     bool is_running() const noexcept;
 
+    /**
+     * @brief 设置指标快照刷新间隔（默认 1000ms）
+     *
+     * 后台线程按此间隔采集平台统计并原子发布，get_metrics()、/api/metrics 与 get_dashboard_data()
+     * 均读取最近一份快照，不与申领者竞争平台锁；<= 0 表示不启动后台线程、每次读取时直接采集。
+     * 聚合模式下同时作为各端点的抓取间隔。
+     */
     WebDashboard &set_update_interval(int milliseconds);
+    /**
+     * @brief 设置事件持久化路径（段文件前缀，空字符串表示只保存在内存中）
+     *
+     * 打开（或恢复）<path>.<序号>.seg 段文件并挂接到事件日志，重启后历史事件仍可查询；
+     * 打开失败时事件日志保持纯内存模式，get_event_store() 返回空指针。
+     */
     WebDashboard &set_log_file_path(const std::string &path);
+    WebDashboard &set_log_file_path(const std::string &path, const EventStore::Options &options);
+    /**
+     * @brief 设置事件历史上限（即事件日志环形缓冲区容量，0 表示不限，默认 1000）
+     */
     WebDashboard &set_max_event_history(size_t max_events);
     WebDashboard &enable_https(const std::string &cert_path, const std::string &key_path);
 
     using DashboardMetrics = TaskPlatform::PlatformStatistics;
-    DashboardMetrics get_metrics() const;
+    DashboardMetrics get_metrics() const;   ///< 最近一份快照中的统计（最多落后一个刷新间隔）
+    std::shared_ptr<const MetricsSnapshot> get_metrics_snapshot() const;
+    std::shared_ptr<MetricsSnapshotter> get_metrics_snapshotter() const;
     std::string get_dashboard_data() const;
 
     struct TaskSummary {
@@ -48,6 +85,7 @@ public:
         TaskStatus status;
         Timestamp published_at;
         std::string claimer_id;
+        std::string endpoint;   ///< 来源端点（聚合模式），同进程模式为空
     };
 
     struct ClaimerSummary {
@@ -62,7 +100,16 @@ public:
     std::vector<TaskSummary> get_tasks_summary() const;
     std::vector<ClaimerSummary> get_claimers_summary() const;
 
+    /**
+     * @brief 聚合模式下各端点的最近抓取结果；其他模式返回空
+     */
+    std::vector<std::shared_ptr<const EndpointSnapshot>> get_endpoint_status() const;
+    std::shared_ptr<PlatformAggregator> get_aggregator() const;
+
+    TaskPlatform *get_platform() const noexcept;
     std::shared_ptr<TimeReplay> get_time_replay() const;
+    EventLog *get_event_log() const;
+    std::shared_ptr<EventStore> get_event_store() const;
     std::vector<std::string> get_event_logs(int limit = 100, int offset = 0) const;
 
     struct PerformanceAnalysis {
@@ -78,13 +125,15 @@ public:
     std::string export_as_csv(const Timestamp &start, const Timestamp &end) const;
 
 private:
-    DashboardMetrics _empty_metrics() const;
     std::string _serialize_metrics_json(const DashboardMetrics &metrics) const;
 
     TaskPlatform *platform_;
     EventLog *event_log_;
     std::unique_ptr<EventLog> owned_event_log_;
     std::shared_ptr<TimeReplay> time_replay_;
+    std::shared_ptr<EventStore> event_store_;
+    std::shared_ptr<PlatformAggregator> aggregator_;            // 仅聚合模式
+    std::shared_ptr<MetricsSnapshotter> metrics_snapshotter_;   // 在事件日志之后声明，先于其停止
 
     std::vector<std::string> endpoints_;
     int update_interval_ms_;
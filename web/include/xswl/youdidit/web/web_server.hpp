@@ -2,36 +2,101 @@
 #define XSWL_YOUDIDIT_WEB_WEB_SERVER_HPP
 
 #include <xswl/youdidit/web/web_dashboard.hpp>
+#include <xswl/youdidit/core/types.hpp>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 
 namespace xswl {
 namespace youdidit {
 
+class EventStreamHub;
+
 class WebServer {
 public:
+    /**
+     * @brief HTTP 服务参数（在 start() 时生效）
+     *
+     * 每个连接在其整个 keep-alive 生命周期内占用一个工作线程（SSE 连接亦然）。SSE 连接数受
+     * max_event_stream_clients 限制，始终为普通请求留出工作线程；超出上限的 SSE 请求以 503 应答。
+     * 所有工作线程忙且等待队列已满时，新连接交给单独的降载线程，直接以 503 + Retry-After 应答并关闭，
+     * 不进入路由、不触碰平台锁；降载线程自身也积压时直接关闭连接。
+     */
+    struct Options {
+        size_t worker_threads = 0;                        ///< 工作线程数，0 表示 max(8, 硬件线程数 - 1)
+        size_t max_queued_requests = 64;                  ///< 等待工作线程的连接上限，0 表示不限（不降载）
+        size_t keep_alive_max_count = 100;                ///< 单个连接最多处理的请求数（0 视为 1）
+        std::chrono::seconds keep_alive_timeout{5};       ///< keep-alive 连接的空闲超时
+        std::chrono::milliseconds read_timeout{5000};     ///< 读取请求的超时
+        std::chrono::milliseconds write_timeout{5000};    ///< 写出响应的超时
+        std::chrono::seconds retry_after{1};              ///< 503 响应的 Retry-After
+        size_t max_event_stream_clients = 0;              ///< SSE 连接上限，0 表示工作线程数的一半；至多为工作线程数 - 1（至少 1）
+        size_t max_batch_lines = 50000;                   ///< POST /api/tasks/batch 单个请求处理的非空行上限（0 视为 1）
+    };
+
     WebServer(WebDashboard *dashboard, int port = 8080);
+    WebServer(WebDashboard *dashboard, int port, const Options &options);
     ~WebServer() noexcept;
 
-    void start();
+    /**
+     * @brief 绑定端口并启动后台监听线程
+     *
+     * 返回时套接字已绑定并处于监听状态（不再依赖固定的等待时间）；端口为 0 时由系统分配，
+     * 实际端口通过 get_port() 获取。已在运行时直接返回成功。
+     * @return 无法绑定时返回 NETWORK_BIND_FAILED
+     */
+    tl::expected<void, Error> start();
     void stop();
     bool is_running() const noexcept;
 
     void set_port(int port);
+    /**
+     * @brief 运行中返回实际监听的端口（端口为 0 时即系统分配的端口），否则返回配置的端口
+     */
     int get_port() const noexcept;
-    
+
     void set_host(const std::string &host);
     const std::string &host() const noexcept;
 
+    /**
+     * @brief 修改服务参数，下次 start() 时生效
+     */
+    WebServer &set_options(const Options &options);
+    const Options &options() const noexcept;
+
+    /**
+     * @brief 因过载以 503 应答或直接关闭的连接数（累计）
+     */
+    std::uint64_t shed_count() const noexcept;
+
+    /**
+     * @brief 注册批量提交接口可引用的任务处理函数（POST /api/tasks/batch 中的 "handler" 字段）
+     *
+     * 可在运行中随时调用；同名覆盖，handler 为空时移除该名称。
+     */
+    WebServer &register_task_handler(const std::string &name, Task::TaskHandler handler);
+
 private:
+    using TaskHandlerMap = std::map<std::string, Task::TaskHandler>;
+
     WebDashboard *dashboard_;
     std::string host_;
     int port_;
+    Options options_;
     std::atomic<bool> running_;
+    std::atomic<int> bound_port_;
+    std::atomic<std::uint64_t> shed_count_;
     void *http_server_;  // Opaque pointer to httplib::Server
     std::thread server_thread_;
-    
+    std::shared_ptr<EventStreamHub> event_hub_;  // /api/events/stream 的推送中心
+    std::shared_ptr<const TaskHandlerMap> task_handlers_;  // 写时复制，只通过 std::atomic_load/atomic_store 访问
+    std::mutex task_handlers_mutex_;                       // 串行化注册
+
     // Private helper methods
     void _setup_routes();
     std::string _get_dashboard_html();
@@ -1,11 +1,19 @@
 #include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/web/event_store.hpp>
 #include <algorithm>
+#include <string>
+#include <utility>
 
 namespace xswl {
 namespace youdidit {
 
 EventLog::EventLog() = default;
 
+EventLog::EventLog(size_t capacity) : capacity_(capacity) {
+    // 一次预留全部槽位：填满前的追加不会因扩容而移动已有事件
+    events_.reserve(capacity_);
+}
+
 void EventLog::add_event(EventType type,
                          const std::string &source,
                          const std::string &message,
@@ -18,41 +26,329 @@ void EventLog::add_event_at(const Timestamp &ts,
                             const std::string &source,
                             const std::string &message,
                             const std::map<std::string, std::string> &metadata) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    events_.push_back(Event{ts, type, source, message, metadata});
+    // 在锁外构造事件并计算占用，临界区内只做一次移动赋值
+    Event event{ts, type, source, message, metadata, 0};
+    size_t bytes = _event_bytes(event);
+
+    std::shared_ptr<EventStore> store;
+    std::uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sequence = next_sequence_++;
+        event.sequence = sequence;
+        _insert(std::move(event), bytes);
+        store = store_;
+    }
+    // 编码与入队在日志锁外进行，落盘由存储的写线程异步完成
+    if (store) {
+        store->append(ts, type, source, message, metadata, sequence);
+    }
+}
+
+void EventLog::_insert(Event &&event, size_t bytes) {
+    const Timestamp ts = event.timestamp;
+    if (capacity_ > 0 && count_ >= capacity_) {
+        _drop_oldest();
+    }
+    if (count_ < events_.size()) {
+        // 复用空闲槽位
+        events_[(head_ + count_) % events_.size()] = std::move(event);
+    } else {
+        if (head_ != 0) {
+            _linearize();
+        }
+        events_.push_back(std::move(event));
+    }
+    ++count_;
+    events_bytes_ += bytes;
+
+    // 保持按时间有序：迟到的事件向前逐个交换到正确位置，代价为 O(比它新的事件数)，最坏 O(n)；
+    // 按时间顺序追加时循环不执行
+    size_t index = count_ - 1;
+    while (index > 0 && _at(index - 1).timestamp > ts) {
+        std::swap(_at(index - 1), _at(index));
+        --index;
+    }
 }
 
 std::vector<EventLog::Event> EventLog::get_events(const Filter &filter) const {
     std::vector<Event> result;
     std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &ev : events_) {
-        if (filter.type.has_value() && ev.type != filter.type.value()) {
-            continue;
+    size_t begin = 0;
+    size_t end = 0;
+    _range(filter, begin, end);
+    for (size_t i = begin; i < end; ++i) {
+        const Event &ev = _at(i);
+        if (_matches(ev, filter)) {
+            result.push_back(ev);
         }
-        if (filter.source.has_value() && ev.source != filter.source.value()) {
+    }
+    return result;
+}
+
+size_t EventLog::for_each_event(const Filter &filter, const std::function<bool(const Event &)> &visitor) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t begin = 0;
+    size_t end = 0;
+    _range(filter, begin, end);
+    size_t visited = 0;
+    for (size_t i = begin; i < end; ++i) {
+        const Event &ev = _at(i);
+        if (!_matches(ev, filter)) {
             continue;
         }
-        if (filter.start_time.has_value() && ev.timestamp < filter.start_time.value()) {
-            continue;
+        ++visited;
+        if (!visitor(ev)) {
+            break;
         }
-        if (filter.end_time.has_value() && ev.timestamp > filter.end_time.value()) {
-            continue;
+    }
+    return visited;
+}
+
+size_t EventLog::count_events(const Filter &filter) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t begin = 0;
+    size_t end = 0;
+    _range(filter, begin, end);
+    if (!filter.type.has_value() && !filter.source.has_value()) {
+        return end - begin;
+    }
+    size_t count = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (_matches(_at(i), filter)) {
+            ++count;
         }
-        result.push_back(ev);
     }
-    return result;
+    return count;
+}
+
+EventLog::Page EventLog::get_events_page(const Filter &filter, size_t limit, const std::string &cursor) const {
+    Page page;
+    if (limit == 0) {
+        return page;
+    }
+    // 游标格式：<timestamp 计数>:<sequence>，指向上一页最后一个事件
+    bool has_cursor = false;
+    Timestamp::rep cursor_ts = 0;
+    std::uint64_t cursor_seq = 0;
+    size_t colon = cursor.find(':');
+    if (colon != std::string::npos && colon > 0 && colon + 1 < cursor.size()) {
+        try {
+            cursor_ts = static_cast<Timestamp::rep>(std::stoll(cursor.substr(0, colon)));
+            cursor_seq = static_cast<std::uint64_t>(std::stoull(cursor.substr(colon + 1)));
+            has_cursor = true;
+        } catch (...) {
+            has_cursor = false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t begin = 0;
+    size_t end = 0;
+    _range(filter, begin, end);
+    if (has_cursor) {
+        // 事件按 (timestamp, sequence) 有序，二分定位到游标之后的第一个事件
+        size_t lo = begin;
+        size_t hi = end;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            const Event &ev = _at(mid);
+            Timestamp::rep rep = ev.timestamp.time_since_epoch().count();
+            if (rep < cursor_ts || (rep == cursor_ts && ev.sequence <= cursor_seq)) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        begin = lo;
+    }
+
+    page.events.reserve(std::min(limit, end - begin));
+    size_t i = begin;
+    for (; i < end && page.events.size() < limit; ++i) {
+        const Event &ev = _at(i);
+        if (_matches(ev, filter)) {
+            page.events.push_back(ev);
+        }
+    }
+    // 仅在后面仍有匹配事件时返回游标
+    for (; i < end; ++i) {
+        if (_matches(_at(i), filter)) {
+            const Event &last = page.events.back();
+            page.next_cursor = std::to_string(last.timestamp.time_since_epoch().count()) + ":" +
+                               std::to_string(last.sequence);
+            break;
+        }
+    }
+    return page;
 }
 
 void EventLog::cleanup_events_before(const Timestamp &before_time) {
     std::lock_guard<std::mutex> lock(mutex_);
-    events_.erase(std::remove_if(events_.begin(), events_.end(), [&](const Event &ev) {
-        return ev.timestamp < before_time;
-    }), events_.end());
+    size_t expired = _lower_bound(before_time);
+    for (size_t i = 0; i < expired; ++i) {
+        _pop_oldest();
+    }
 }
 
 size_t EventLog::size() const {
     std::lock_guard<std::mutex> lock(mutex_);
-    return events_.size();
+    return count_;
+}
+
+void EventLog::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    if (capacity_ == 0) {
+        return;
+    }
+    while (count_ > capacity_) {
+        _drop_oldest();
+    }
+    if (events_.size() > capacity_) {
+        _linearize();
+        events_.resize(capacity_);
+        events_.shrink_to_fit();
+    } else {
+        events_.reserve(capacity_);
+    }
+}
+
+size_t EventLog::capacity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return capacity_;
+}
+
+std::uint64_t EventLog::dropped_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+void EventLog::attach_store(std::shared_ptr<EventStore> store) {
+    // 预加载在锁外读取存储，避免持锁做文件 IO
+    size_t preload = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (store && count_ == 0) {
+            preload = capacity_;
+        }
+    }
+    std::vector<Event> recent;
+    if (preload > 0) {
+        recent = store->recent_events(preload);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    store_ = store;
+    if (!store_) {
+        return;
+    }
+    next_sequence_ = std::max(next_sequence_, store_->last_sequence() + 1);
+    if (count_ == 0) {
+        for (auto &event : recent) {
+            size_t bytes = _event_bytes(event);
+            _insert(std::move(event), bytes);
+        }
+    }
+}
+
+std::shared_ptr<EventStore> EventLog::store() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return store_;
+}
+
+MemoryUsage EventLog::memory_usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    MemoryUsage usage;
+    usage.components["events"] = events_bytes_;
+    usage.components["reserved"] = (events_.capacity() - count_) * sizeof(Event);
+    return usage;
+}
+
+const EventLog::Event &EventLog::_at(size_t index) const {
+    return events_[(head_ + index) % events_.size()];
+}
+
+EventLog::Event &EventLog::_at(size_t index) {
+    return events_[(head_ + index) % events_.size()];
+}
+
+size_t EventLog::_lower_bound(const Timestamp &ts) const {
+    size_t lo = 0;
+    size_t hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (_at(mid).timestamp < ts) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t EventLog::_upper_bound(const Timestamp &ts) const {
+    size_t lo = 0;
+    size_t hi = count_;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ts < _at(mid).timestamp) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+void EventLog::_range(const Filter &filter, size_t &begin, size_t &end) const {
+    begin = filter.start_time.has_value() ? _lower_bound(filter.start_time.value()) : 0;
+    end = filter.end_time.has_value() ? _upper_bound(filter.end_time.value()) : count_;
+    if (end < begin) {
+        end = begin;
+    }
+}
+
+bool EventLog::_matches(const Event &event, const Filter &filter) {
+    if (filter.type.has_value() && event.type != filter.type.value()) {
+        return false;
+    }
+    if (filter.source.has_value() && event.source != filter.source.value()) {
+        return false;
+    }
+    return true;
+}
+
+void EventLog::_linearize() {
+    if (head_ == 0) {
+        return;
+    }
+    std::rotate(events_.begin(), events_.begin() + static_cast<std::ptrdiff_t>(head_), events_.end());
+    head_ = 0;
+}
+
+void EventLog::_pop_oldest() {
+    Event &oldest = events_[head_];
+    events_bytes_ -= _event_bytes(oldest);
+    oldest = Event();
+    head_ = (head_ + 1) % events_.size();
+    --count_;
+}
+
+void EventLog::_drop_oldest() {
+    _pop_oldest();
+    ++dropped_;
+}
+
+size_t EventLog::_event_bytes(const Event &event) {
+    size_t bytes = sizeof(Event) +
+                   MemoryUsage::string_bytes(event.source) +
+                   MemoryUsage::string_bytes(event.message);
+    for (const auto &pair : event.metadata) {
+        bytes += MemoryUsage::tree_node_bytes(sizeof(std::pair<const std::string, std::string>)) +
+                 MemoryUsage::string_bytes(pair.first) + MemoryUsage::string_bytes(pair.second);
+    }
+    return bytes;
 }
 
 } // namespace youdidit
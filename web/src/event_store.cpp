@@ -0,0 +1,1069 @@
+#include <xswl/youdidit/web/event_store.hpp>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace xswl {
+namespace youdidit {
+
+// C++11 兼容的 make_unique 实现
+namespace {
+    template<typename T, typename... Args>
+    std::unique_ptr<T> make_unique_impl(Args&&... args) {
+        return std::unique_ptr<T>(new T(std::forward<Args>(args)...));
+    }
+
+    // 段文件头：8 字节魔数 + 4 字节版本 + 4 字节保留
+    const char kSegmentMagic[8] = {'Y', 'D', 'E', 'V', 'S', 'E', 'G', '1'};
+    const char kIndexMagic[8] = {'Y', 'D', 'E', 'V', 'I', 'D', 'X', '1'};
+    const std::uint32_t kFormatVersion = 1;
+    const std::size_t kSegmentHeaderBytes = 16;
+    // 记录帧：4 字节负载长度 + 4 字节 CRC32 + 负载
+    const std::size_t kFrameHeaderBytes = 8;
+    // 负载最小长度：时间戳 8 + 序号 8 + 类型 1 + 来源长度 2 + 消息长度 4 + 元数据个数 2
+    const std::uint32_t kMinPayloadBytes = 25;
+    const std::uint32_t kMaxPayloadBytes = 64u * 1024 * 1024;
+    // 缓冲区超过该大小时不再等待 flush_interval，立即唤醒写线程
+    const std::size_t kEagerFlushBytes = 1024 * 1024;
+
+    const std::int64_t kMinTs = std::numeric_limits<std::int64_t>::min();
+    const std::int64_t kMaxTs = std::numeric_limits<std::int64_t>::max();
+
+    std::uint32_t crc32(const unsigned char *data, std::size_t size) {
+        static std::uint32_t table[256];
+        static std::once_flag once;
+        std::call_once(once, []() {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+                }
+                table[i] = c;
+            }
+        });
+        std::uint32_t crc = 0xFFFFFFFFu;
+        for (std::size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // 小端序编码，文件格式与平台字节序无关
+    void put_u16(std::string &out, std::uint16_t v) {
+        out.push_back(static_cast<char>(v & 0xFF));
+        out.push_back(static_cast<char>((v >> 8) & 0xFF));
+    }
+
+    void put_u32(std::string &out, std::uint32_t v) {
+        for (int i = 0; i < 4; ++i) {
+            out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        }
+    }
+
+    void put_u64(std::string &out, std::uint64_t v) {
+        for (int i = 0; i < 8; ++i) {
+            out.push_back(static_cast<char>((v >> (8 * i)) & 0xFF));
+        }
+    }
+
+    std::uint32_t get_u32(const unsigned char *p) {
+        return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+               (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+    }
+
+    std::uint64_t get_u64(const unsigned char *p) {
+        return static_cast<std::uint64_t>(get_u32(p)) | (static_cast<std::uint64_t>(get_u32(p + 4)) << 32);
+    }
+
+    class ByteReader {
+    public:
+        ByteReader(const unsigned char *data, std::size_t size) : data_(data), size_(size), pos_(0), ok_(true) {}
+
+        std::uint64_t u64() { return take(8) ? get_u64(data_ + pos_ - 8) : 0; }
+        std::uint32_t u32() { return take(4) ? get_u32(data_ + pos_ - 4) : 0; }
+        std::uint16_t u16() {
+            return take(2) ? static_cast<std::uint16_t>(data_[pos_ - 2] | (data_[pos_ - 1] << 8)) : 0;
+        }
+        std::uint8_t u8() { return take(1) ? data_[pos_ - 1] : 0; }
+        void bytes(std::size_t n, std::string &out) {
+            if (take(n)) {
+                out.assign(reinterpret_cast<const char *>(data_ + pos_ - n), n);
+            }
+        }
+        bool ok() const { return ok_; }
+
+    private:
+        bool take(std::size_t n) {
+            if (!ok_ || size_ - pos_ < n) {
+                ok_ = false;
+                return false;
+            }
+            pos_ += n;
+            return true;
+        }
+
+        const unsigned char *data_;
+        std::size_t size_;
+        std::size_t pos_;
+        bool ok_;
+    };
+
+    std::int64_t to_nanos(const Timestamp &ts) {
+        return static_cast<std::int64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(ts.time_since_epoch()).count());
+    }
+
+    Timestamp from_nanos(std::int64_t ns) {
+        return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::nanoseconds(ns)));
+    }
+
+    void encode_frame(std::string &out,
+                      const Timestamp &ts,
+                      EventLog::EventType type,
+                      const std::string &source,
+                      const std::string &message,
+                      const std::map<std::string, std::string> &metadata,
+                      std::uint64_t sequence) {
+        std::string payload;
+        payload.reserve(kMinPayloadBytes + source.size() + message.size() + metadata.size() * 16);
+        put_u64(payload, static_cast<std::uint64_t>(to_nanos(ts)));
+        put_u64(payload, sequence);
+        payload.push_back(static_cast<char>(type));
+        // 超长字段截断到长度字段能表示的范围
+        std::size_t source_len = std::min<std::size_t>(source.size(), 0xFFFF);
+        put_u16(payload, static_cast<std::uint16_t>(source_len));
+        payload.append(source, 0, source_len);
+        std::size_t message_len = std::min<std::size_t>(message.size(), kMaxPayloadBytes / 2);
+        put_u32(payload, static_cast<std::uint32_t>(message_len));
+        payload.append(message, 0, message_len);
+        std::size_t meta_count = std::min<std::size_t>(metadata.size(), 0xFFFF);
+        put_u16(payload, static_cast<std::uint16_t>(meta_count));
+        std::size_t written = 0;
+        for (const auto &pair : metadata) {
+            if (written++ == meta_count) {
+                break;
+            }
+            std::size_t key_len = std::min<std::size_t>(pair.first.size(), 0xFFFF);
+            put_u16(payload, static_cast<std::uint16_t>(key_len));
+            payload.append(pair.first, 0, key_len);
+            std::size_t value_len = std::min<std::size_t>(pair.second.size(), kMaxPayloadBytes / 4);
+            put_u32(payload, static_cast<std::uint32_t>(value_len));
+            payload.append(pair.second, 0, value_len);
+        }
+
+        put_u32(out, static_cast<std::uint32_t>(payload.size()));
+        put_u32(out, crc32(reinterpret_cast<const unsigned char *>(payload.data()), payload.size()));
+        out += payload;
+    }
+
+    bool decode_payload(const unsigned char *data, std::size_t size, EventLog::Event &event) {
+        ByteReader reader(data, size);
+        event.timestamp = from_nanos(static_cast<std::int64_t>(reader.u64()));
+        event.sequence = reader.u64();
+        std::uint8_t type = reader.u8();
+        if (type > static_cast<std::uint8_t>(EventLog::EventType::Task)) {
+            return false;
+        }
+        event.type = static_cast<EventLog::EventType>(type);
+        reader.bytes(reader.u16(), event.source);
+        reader.bytes(reader.u32(), event.message);
+        event.metadata.clear();
+        std::uint16_t meta_count = reader.u16();
+        for (std::uint16_t i = 0; i < meta_count && reader.ok(); ++i) {
+            std::string key;
+            std::string value;
+            reader.bytes(reader.u16(), key);
+            reader.bytes(reader.u32(), value);
+            event.metadata[key] = value;
+        }
+        return reader.ok();
+    }
+
+    // 稀疏索引项：offset 处开始的块；max_before 为该块之前所有记录的最大时间戳（单调不减），
+    // block_min 为块内记录的最小时间戳。按追加顺序写入的时间戳可能轻微乱序，两者共同保证跳过是安全的。
+    struct IndexEntry {
+        std::uint64_t offset;
+        std::int64_t max_before;
+        std::int64_t block_min;
+    };
+
+    struct Segment {
+        std::uint64_t number{0};
+        std::string path;
+        std::uint64_t size{kSegmentHeaderBytes};  // 有效（已写入）字节数
+        std::uint64_t records{0};
+        std::int64_t min_ts{kMaxTs};
+        std::int64_t max_ts{kMinTs};
+        std::uint64_t first_seq{0};
+        std::uint64_t last_seq{0};
+        std::vector<IndexEntry> index;
+
+        void note_record(std::uint64_t offset, std::uint64_t frame_bytes, std::int64_t ts, std::uint64_t seq,
+                         std::size_t interval) {
+            if (index.empty() || offset - index.back().offset >= interval) {
+                IndexEntry entry;
+                entry.offset = offset;
+                entry.max_before = max_ts;
+                entry.block_min = ts;
+                index.push_back(entry);
+            } else {
+                index.back().block_min = std::min(index.back().block_min, ts);
+            }
+            min_ts = std::min(min_ts, ts);
+            max_ts = std::max(max_ts, ts);
+            if (records == 0) {
+                first_seq = seq;
+            }
+            last_seq = std::max(last_seq, seq);
+            ++records;
+            size = offset + frame_bytes;
+        }
+    };
+
+    std::string segment_path(const std::string &base, std::uint64_t number) {
+        char suffix[32];
+        std::snprintf(suffix, sizeof(suffix), ".%08llu.seg", static_cast<unsigned long long>(number));
+        return base + suffix;
+    }
+
+    std::string index_path(const Segment &segment) {
+        return segment.path.substr(0, segment.path.size() - 4) + ".idx";
+    }
+
+    bool file_size(const std::string &path, std::uint64_t &size) {
+#if defined(_WIN32)
+        struct _stat64 st;
+        if (_stat64(path.c_str(), &st) != 0) {
+            return false;
+        }
+#else
+        struct stat st;
+        if (::stat(path.c_str(), &st) != 0) {
+            return false;
+        }
+#endif
+        size = static_cast<std::uint64_t>(st.st_size);
+        return true;
+    }
+
+    bool truncate_file(const std::string &path, std::uint64_t size) {
+#if defined(_WIN32)
+        int fd = _open(path.c_str(), _O_RDWR | _O_BINARY);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = _chsize_s(fd, static_cast<__int64>(size)) == 0;
+        _close(fd);
+        return ok;
+#else
+        return ::truncate(path.c_str(), static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    bool sync_file(std::FILE *file) {
+        if (std::fflush(file) != 0) {
+            return false;
+        }
+#if defined(_WIN32)
+        return _commit(_fileno(file)) == 0;
+#else
+        return ::fsync(fileno(file)) == 0;
+#endif
+    }
+
+    // 列出 base 对应的段文件序号（升序）
+    std::vector<std::uint64_t> list_segments(const std::string &base) {
+        std::string dir = ".";
+        std::string prefix = base;
+        std::size_t slash = base.find_last_of("/\\");
+        if (slash != std::string::npos) {
+            dir = slash == 0 ? base.substr(0, 1) : base.substr(0, slash);
+            prefix = base.substr(slash + 1);
+        }
+        prefix += ".";
+
+        std::vector<std::string> names;
+#if defined(_WIN32)
+        struct _finddata_t info;
+        intptr_t handle = _findfirst((dir + "\\" + prefix + "*.seg").c_str(), &info);
+        if (handle != -1) {
+            do {
+                names.push_back(info.name);
+            } while (_findnext(handle, &info) == 0);
+            _findclose(handle);
+        }
+#else
+        DIR *handle = ::opendir(dir.c_str());
+        if (handle) {
+            while (struct dirent *entry = ::readdir(handle)) {
+                names.push_back(entry->d_name);
+            }
+            ::closedir(handle);
+        }
+#endif
+
+        std::vector<std::uint64_t> numbers;
+        const std::string suffix = ".seg";
+        for (const auto &name : names) {
+            if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+                name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+                continue;
+            }
+            std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+            if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) {
+                continue;
+            }
+            numbers.push_back(static_cast<std::uint64_t>(std::stoull(digits)));
+        }
+        std::sort(numbers.begin(), numbers.end());
+        return numbers;
+    }
+
+    // 只读映射段文件的前 size 字节；Windows 下回退为读入内存
+    class MappedFile {
+    public:
+        MappedFile() : data_(nullptr), size_(0) {}
+        ~MappedFile() { close(); }
+
+        MappedFile(const MappedFile &) = delete;
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        bool open(const std::string &path, std::size_t size) {
+            close();
+            if (size == 0) {
+                return false;
+            }
+#if defined(_WIN32)
+            std::ifstream in(path.c_str(), std::ios::binary);
+            buffer_.resize(size);
+            if (!in.read(reinterpret_cast<char *>(&buffer_[0]), static_cast<std::streamsize>(size))) {
+                buffer_.clear();
+                return false;
+            }
+            data_ = &buffer_[0];
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                return false;
+            }
+            void *addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (addr == MAP_FAILED) {
+                return false;
+            }
+            data_ = static_cast<const unsigned char *>(addr);
+#endif
+            size_ = size;
+            return true;
+        }
+
+        void close() {
+#if defined(_WIN32)
+            buffer_.clear();
+#else
+            if (data_) {
+                ::munmap(const_cast<unsigned char *>(data_), size_);
+            }
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        const unsigned char *data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+    private:
+        const unsigned char *data_;
+        std::size_t size_;
+#if defined(_WIN32)
+        std::vector<unsigned char> buffer_;
+#endif
+    };
+
+    std::string encode_index(const Segment &segment) {
+        std::string out(kIndexMagic, sizeof(kIndexMagic));
+        put_u64(out, segment.size);
+        put_u64(out, segment.records);
+        put_u64(out, static_cast<std::uint64_t>(segment.min_ts));
+        put_u64(out, static_cast<std::uint64_t>(segment.max_ts));
+        put_u64(out, segment.first_seq);
+        put_u64(out, segment.last_seq);
+        put_u32(out, static_cast<std::uint32_t>(segment.index.size()));
+        for (const auto &entry : segment.index) {
+            put_u64(out, entry.offset);
+            put_u64(out, static_cast<std::uint64_t>(entry.max_before));
+            put_u64(out, static_cast<std::uint64_t>(entry.block_min));
+        }
+        put_u32(out, crc32(reinterpret_cast<const unsigned char *>(out.data()), out.size()));
+        return out;
+    }
+
+    bool decode_index(const std::string &data, Segment &segment) {
+        if (data.size() < sizeof(kIndexMagic) + 4 || std::memcmp(data.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+            return false;
+        }
+        const unsigned char *bytes = reinterpret_cast<const unsigned char *>(data.data());
+        if (crc32(bytes, data.size() - 4) != get_u32(bytes + data.size() - 4)) {
+            return false;
+        }
+        ByteReader reader(bytes + sizeof(kIndexMagic), data.size() - sizeof(kIndexMagic) - 4);
+        segment.size = reader.u64();
+        segment.records = reader.u64();
+        segment.min_ts = static_cast<std::int64_t>(reader.u64());
+        segment.max_ts = static_cast<std::int64_t>(reader.u64());
+        segment.first_seq = reader.u64();
+        segment.last_seq = reader.u64();
+        std::uint32_t count = reader.u32();
+        segment.index.clear();
+        for (std::uint32_t i = 0; i < count && reader.ok(); ++i) {
+            IndexEntry entry;
+            entry.offset = reader.u64();
+            entry.max_before = static_cast<std::int64_t>(reader.u64());
+            entry.block_min = static_cast<std::int64_t>(reader.u64());
+            segment.index.push_back(entry);
+        }
+        return reader.ok();
+    }
+
+    bool write_index(const Segment &segment) {
+        const std::string path = index_path(segment);
+        const std::string tmp = path + ".tmp";
+        const std::string data = encode_index(segment);
+        std::FILE *file = std::fopen(tmp.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size() && sync_file(file);
+        ok = (std::fclose(file) == 0) && ok;
+        if (ok) {
+#if defined(_WIN32)
+            std::remove(path.c_str());
+#endif
+            ok = std::rename(tmp.c_str(), path.c_str()) == 0;
+        }
+        if (!ok) {
+            std::remove(tmp.c_str());
+        }
+        return ok;
+    }
+
+    bool read_index(Segment &segment) {
+        std::ifstream in(index_path(segment).c_str(), std::ios::binary);
+        if (!in) {
+            return false;
+        }
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::uint64_t actual = 0;
+        // 索引记录的有效长度须与段文件一致，否则说明封存后文件被改动，需要重新扫描
+        return decode_index(data, segment) && file_size(segment.path, actual) && actual == segment.size;
+    }
+}
+
+// ========== 内部实现类 ==========
+class EventStore::Impl {
+public:
+    Options options_;
+
+    // 已封存的段与活动段（最后一个）的只读快照；写线程每批写入后替换活动段快照
+    mutable std::mutex segments_mutex_;
+    std::vector<std::shared_ptr<const Segment>> segments_;
+
+    // 以下仅由写线程（及打开/关闭时）访问
+    Segment active_;
+    std::FILE *active_file_;
+
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;
+    std::condition_variable durable_cv_;
+    std::string pending_;              // 待写入的记录帧
+    std::uint64_t appended_;           // 已进入缓冲区的记录数
+    std::uint64_t completed_;          // 已由写线程处理完的记录数
+    std::uint64_t dropped_events_;     // 因缓冲区超限被丢弃的事件数
+    std::uint64_t discarded_records_;  // 因写入失败被丢弃的记录数
+    bool unreported_loss_;             // 自上一次 flush() 以来是否有事件丢失
+    bool flush_requested_;
+    bool stopping_;
+    std::thread writer_;
+
+    std::atomic<std::uint64_t> persisted_;
+    std::atomic<std::uint64_t> syncs_;
+    std::atomic<std::uint64_t> recovered_records_;
+    std::atomic<std::uint64_t> truncated_bytes_;
+    std::atomic<std::uint64_t> removed_segments_;
+    std::atomic<std::uint64_t> write_errors_;
+    std::atomic<std::uint64_t> last_sequence_;
+
+    explicit Impl(const Options &options)
+        : options_(options),
+          active_file_(nullptr),
+          appended_(0),
+          completed_(0),
+          dropped_events_(0),
+          discarded_records_(0),
+          unreported_loss_(false),
+          flush_requested_(false),
+          stopping_(false),
+          persisted_(0),
+          syncs_(0),
+          recovered_records_(0),
+          truncated_bytes_(0),
+          removed_segments_(0),
+          write_errors_(0),
+          last_sequence_(0) {
+        if (options_.index_interval_bytes == 0) {
+            options_.index_interval_bytes = 1;
+        }
+        if (options_.segment_bytes < kSegmentHeaderBytes + kFrameHeaderBytes + kMinPayloadBytes) {
+            options_.segment_bytes = kSegmentHeaderBytes + kFrameHeaderBytes + kMinPayloadBytes;
+        }
+    }
+
+    // ---------- 打开与恢复 ----------
+
+    tl::expected<void, Error> recover() {
+        std::vector<std::uint64_t> numbers = list_segments(options_.base_path);
+        for (std::size_t i = 0; i < numbers.size(); ++i) {
+            const bool is_last = (i + 1 == numbers.size());
+            Segment segment;
+            segment.number = numbers[i];
+            segment.path = segment_path(options_.base_path, numbers[i]);
+            // 活动段在上次运行时可能未正常关闭，总是重新扫描；封存段优先使用 .idx
+            if (is_last || !read_index(segment)) {
+                segment = Segment();
+                segment.number = numbers[i];
+                segment.path = segment_path(options_.base_path, numbers[i]);
+                if (!scan_segment(segment)) {
+                    continue;
+                }
+                if (!is_last) {
+                    write_index(segment);
+                }
+            }
+            last_sequence_.store(std::max(last_sequence_.load(), segment.last_seq));
+            segments_.push_back(std::make_shared<const Segment>(segment));
+        }
+
+        if (segments_.empty()) {
+            return open_new_segment(1);
+        }
+        active_ = *segments_.back();
+        active_file_ = std::fopen(active_.path.c_str(), "ab");
+        if (!active_file_) {
+            return tl::make_unexpected(Error("Cannot open event segment " + active_.path, ErrorCode::STORAGE_IO_FAILED));
+        }
+        apply_retention();
+        return {};
+    }
+
+    // 校验段内所有记录，截断末尾不完整或损坏的部分，并重建稀疏索引
+    bool scan_segment(Segment &segment) {
+        std::uint64_t size = 0;
+        if (!file_size(segment.path, size)) {
+            return false;
+        }
+        std::uint64_t valid_end = 0;
+        {
+            MappedFile file;
+            if (size >= kSegmentHeaderBytes && file.open(segment.path, static_cast<std::size_t>(size)) &&
+                std::memcmp(file.data(), kSegmentMagic, sizeof(kSegmentMagic)) == 0) {
+                const unsigned char *data = file.data();
+                std::uint64_t pos = kSegmentHeaderBytes;
+                while (size - pos >= kFrameHeaderBytes) {
+                    std::uint32_t len = get_u32(data + pos);
+                    if (len < kMinPayloadBytes || len > kMaxPayloadBytes || size - pos - kFrameHeaderBytes < len) {
+                        break;
+                    }
+                    const unsigned char *payload = data + pos + kFrameHeaderBytes;
+                    if (crc32(payload, len) != get_u32(data + pos + 4)) {
+                        break;
+                    }
+                    segment.note_record(pos, kFrameHeaderBytes + len, static_cast<std::int64_t>(get_u64(payload)),
+                                        get_u64(payload + 8), options_.index_interval_bytes);
+                    pos += kFrameHeaderBytes + len;
+                }
+                valid_end = pos;
+            }
+        }
+
+        if (valid_end == 0) {
+            // 文件头缺失或损坏：整段无法解析，重写为空段
+            truncated_bytes_.fetch_add(size);
+            std::FILE *file = std::fopen(segment.path.c_str(), "wb");
+            if (!file) {
+                return false;
+            }
+            bool ok = write_header(file) && sync_file(file);
+            std::fclose(file);
+            segment.size = kSegmentHeaderBytes;
+            return ok;
+        }
+        if (valid_end < size) {
+            truncated_bytes_.fetch_add(size - valid_end);
+            if (!truncate_file(segment.path, valid_end)) {
+                return false;
+            }
+        }
+        segment.size = valid_end;
+        recovered_records_.fetch_add(segment.records);
+        return true;
+    }
+
+    static bool write_header(std::FILE *file) {
+        std::string header(kSegmentMagic, sizeof(kSegmentMagic));
+        put_u32(header, kFormatVersion);
+        put_u32(header, 0);
+        return std::fwrite(header.data(), 1, header.size(), file) == header.size();
+    }
+
+    tl::expected<void, Error> open_new_segment(std::uint64_t number) {
+        Segment segment;
+        segment.number = number;
+        segment.path = segment_path(options_.base_path, number);
+        std::FILE *file = std::fopen(segment.path.c_str(), "wb");
+        if (!file) {
+            return tl::make_unexpected(Error("Cannot create event segment " + segment.path, ErrorCode::STORAGE_IO_FAILED));
+        }
+        if (!write_header(file) || std::fflush(file) != 0) {
+            std::fclose(file);
+            return tl::make_unexpected(Error("Cannot write event segment " + segment.path, ErrorCode::STORAGE_IO_FAILED));
+        }
+        active_ = segment;
+        active_file_ = file;
+        std::lock_guard<std::mutex> lock(segments_mutex_);
+        segments_.push_back(std::make_shared<const Segment>(active_));
+        return {};
+    }
+
+    // ---------- 写线程 ----------
+
+    void start_writer() {
+        writer_ = std::thread([this]() { run_writer(); });
+    }
+
+    void run_writer() {
+        for (;;) {
+            std::string batch;
+            std::uint64_t target = 0;
+            std::uint64_t records = 0;
+            {
+                std::unique_lock<std::mutex> lock(queue_mutex_);
+                queue_cv_.wait(lock, [this]() { return stopping_ || !pending_.empty(); });
+                // 第一条记录到达后最多再等 flush_interval，把期间到达的记录合并为一次写入与一次 fsync
+                queue_cv_.wait_for(lock, options_.flush_interval, [this]() {
+                    return stopping_ || flush_requested_ || pending_.size() >= kEagerFlushBytes;
+                });
+                if (pending_.empty() && stopping_) {
+                    break;
+                }
+                batch.swap(pending_);
+                target = appended_;
+                records = target - completed_;
+                flush_requested_ = false;
+            }
+            const std::uint64_t written = write_batch(batch);
+            {
+                std::lock_guard<std::mutex> lock(queue_mutex_);
+                completed_ = target;
+                if (written < records) {
+                    discarded_records_ += records - written;
+                    unreported_loss_ = true;
+                }
+            }
+            durable_cv_.notify_all();
+        }
+    }
+
+    // 返回成功写入的记录数；写失败时本批剩余记录被丢弃，由调用方计入 discarded_records_
+    std::uint64_t write_batch(const std::string &batch) {
+        const unsigned char *data = reinterpret_cast<const unsigned char *>(batch.data());
+        std::size_t pos = 0;
+        std::uint64_t written = 0;
+        bool dirty = false;
+        while (pos < batch.size()) {
+            if (active_.records > 0 &&
+                active_.size + kFrameHeaderBytes + get_u32(data + pos) > options_.segment_bytes) {
+                roll();
+                dirty = false;
+            }
+            if (!active_file_) {
+                write_errors_.fetch_add(1);
+                break;
+            }
+            // 当前段能容纳的连续记录帧一次写入（空段至少写入一条）
+            Segment next = active_;
+            std::size_t run_end = pos;
+            std::uint64_t run_records = 0;
+            while (run_end < batch.size()) {
+                const std::uint32_t len = get_u32(data + run_end);
+                const std::uint64_t frame = kFrameHeaderBytes + len;
+                if (next.records > 0 && next.size + frame > options_.segment_bytes) {
+                    break;
+                }
+                const unsigned char *payload = data + run_end + kFrameHeaderBytes;
+                next.note_record(next.size, frame, static_cast<std::int64_t>(get_u64(payload)), get_u64(payload + 8),
+                                 options_.index_interval_bytes);
+                run_end += static_cast<std::size_t>(frame);
+                ++run_records;
+            }
+            const std::size_t run_bytes = run_end - pos;
+            if (std::fwrite(data + pos, 1, run_bytes, active_file_) != run_bytes || std::fflush(active_file_) != 0) {
+                // 写失败：回退到上一次的有效长度，本批剩余记录丢弃
+                write_errors_.fetch_add(1);
+                truncate_file(active_.path, active_.size);
+                break;
+            }
+            active_ = std::move(next);
+            persisted_.fetch_add(run_records);
+            written += run_records;
+            pos = run_end;
+            dirty = true;
+        }
+        if (dirty) {
+            if (options_.sync_on_flush) {
+                if (sync_file(active_file_)) {
+                    syncs_.fetch_add(1);
+                } else {
+                    write_errors_.fetch_add(1);
+                }
+            }
+            last_sequence_.store(std::max(last_sequence_.load(), active_.last_seq));
+            publish_active();
+        }
+        return written;
+    }
+
+    void publish_active() {
+        std::shared_ptr<const Segment> snapshot = std::make_shared<const Segment>(active_);
+        std::lock_guard<std::mutex> lock(segments_mutex_);
+        if (!segments_.empty() && segments_.back()->number == active_.number) {
+            segments_.back() = snapshot;
+        } else {
+            segments_.push_back(snapshot);
+        }
+    }
+
+    // 封存当前段（落盘并写入索引），然后开启下一个段
+    void roll() {
+        if (active_file_) {
+            if (sync_file(active_file_)) {
+                syncs_.fetch_add(1);
+            }
+            std::fclose(active_file_);
+            active_file_ = nullptr;
+            last_sequence_.store(std::max(last_sequence_.load(), active_.last_seq));
+            publish_active();
+            write_index(active_);
+        }
+        if (!open_new_segment(active_.number + 1)) {
+            write_errors_.fetch_add(1);
+        }
+        apply_retention();
+    }
+
+    void close_writer() {
+        {
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            stopping_ = true;
+        }
+        queue_cv_.notify_all();
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        if (active_file_) {
+            sync_file(active_file_);
+            std::fclose(active_file_);
+            active_file_ = nullptr;
+        }
+        durable_cv_.notify_all();
+    }
+
+    // ---------- 保留策略 ----------
+
+    void apply_retention() {
+        std::vector<std::shared_ptr<const Segment>> removed;
+        {
+            std::lock_guard<std::mutex> lock(segments_mutex_);
+            std::uint64_t total = 0;
+            for (const auto &segment : segments_) {
+                total += segment->size;
+            }
+            const std::int64_t age_limit =
+                options_.retention_age.count() > 0
+                    ? to_nanos(std::chrono::system_clock::now() - options_.retention_age)
+                    : kMinTs;
+            // 活动段（最后一个）永不删除
+            std::size_t drop = 0;
+            while (drop + 1 < segments_.size()) {
+                const Segment &oldest = *segments_[drop];
+                const bool over_size = options_.retention_bytes > 0 && total > options_.retention_bytes;
+                const bool expired = oldest.records > 0 ? oldest.max_ts < age_limit : age_limit != kMinTs;
+                if (!over_size && !expired) {
+                    break;
+                }
+                total -= oldest.size;
+                ++drop;
+            }
+            removed.assign(segments_.begin(), segments_.begin() + static_cast<std::ptrdiff_t>(drop));
+            segments_.erase(segments_.begin(), segments_.begin() + static_cast<std::ptrdiff_t>(drop));
+        }
+        // 正在读取的映射在 POSIX 下不受删除影响
+        for (const auto &segment : removed) {
+            std::remove(segment->path.c_str());
+            std::remove(index_path(*segment).c_str());
+            removed_segments_.fetch_add(1);
+        }
+    }
+
+    // ---------- 读取 ----------
+
+    std::vector<std::shared_ptr<const Segment>> snapshot_segments() const {
+        std::lock_guard<std::mutex> lock(segments_mutex_);
+        return segments_;
+    }
+
+    /**
+     * 在单个段内按时间范围遍历记录：先用 max_before 二分定位起始块，
+     * 再用块最小时间戳的后缀最小值判断后续块是否还可能有范围内的记录。
+     */
+    static bool scan_range(const Segment &segment, std::int64_t start, std::int64_t end,
+                           const std::function<bool(const unsigned char *, std::uint32_t)> &on_record) {
+        if (segment.records == 0 || segment.index.empty() || segment.max_ts < start || segment.min_ts > end) {
+            return true;
+        }
+        const std::vector<IndexEntry> &index = segment.index;
+        std::vector<std::int64_t> suffix_min(index.size());
+        suffix_min.back() = index.back().block_min;
+        for (std::size_t i = index.size() - 1; i > 0; --i) {
+            suffix_min[i - 1] = std::min(suffix_min[i], index[i - 1].block_min);
+        }
+
+        std::size_t block = 0;
+        std::size_t lo = 0;
+        std::size_t hi = index.size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (index[mid].max_before < start) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        block = lo == 0 ? 0 : lo - 1;
+        if (suffix_min[block] > end) {
+            return true;
+        }
+
+        MappedFile file;
+        if (!file.open(segment.path, static_cast<std::size_t>(segment.size))) {
+            return true;
+        }
+        const unsigned char *data = file.data();
+        std::uint64_t pos = index[block].offset;
+        while (pos + kFrameHeaderBytes <= segment.size) {
+            while (block + 1 < index.size() && index[block + 1].offset <= pos) {
+                ++block;
+                if (suffix_min[block] > end) {
+                    return true;
+                }
+            }
+            const std::uint32_t len = get_u32(data + pos);
+            if (len < kMinPayloadBytes || pos + kFrameHeaderBytes + len > segment.size) {
+                break;
+            }
+            const unsigned char *payload = data + pos + kFrameHeaderBytes;
+            const std::int64_t ts = static_cast<std::int64_t>(get_u64(payload));
+            if (ts >= start && ts <= end && !on_record(payload, len)) {
+                return false;
+            }
+            pos += kFrameHeaderBytes + len;
+        }
+        return true;
+    }
+};
+
+// ========== EventStore ==========
+EventStore::EventStore(const Options &options) : d(make_unique_impl<Impl>(options)) {}
+
+tl::expected<std::shared_ptr<EventStore>, Error> EventStore::open(const Options &options) {
+    if (options.base_path.empty()) {
+        return tl::make_unexpected(Error("Event store path is empty", ErrorCode::STORAGE_IO_FAILED));
+    }
+    std::shared_ptr<EventStore> store(new EventStore(options));
+    auto recovered = store->d->recover();
+    if (!recovered) {
+        return tl::make_unexpected(recovered.error());
+    }
+    store->d->start_writer();
+    return store;
+}
+
+EventStore::~EventStore() noexcept {
+    d->close_writer();
+}
+
+void EventStore::append(const EventLog::Event &event) {
+    append(event.timestamp, event.type, event.source, event.message, event.metadata, event.sequence);
+}
+
+void EventStore::append(const Timestamp &ts,
+                        EventLog::EventType type,
+                        const std::string &source,
+                        const std::string &message,
+                        const std::map<std::string, std::string> &metadata,
+                        std::uint64_t sequence) {
+    // 在锁外完成编码，临界区内只做一次追加
+    std::string frame;
+    encode_frame(frame, ts, type, source, message, metadata, sequence);
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(d->queue_mutex_);
+        if (d->stopping_) {
+            return;
+        }
+        // 写线程跟不上（磁盘或 fsync 停滞）时丢弃新事件，而不是让缓冲区无限增长或阻塞调用方；
+        // 空缓冲区总是接受一条，避免单条超过上限的事件永远无法写入
+        if (d->options_.max_pending_bytes > 0 && !d->pending_.empty() &&
+            d->pending_.size() + frame.size() > d->options_.max_pending_bytes) {
+            ++d->dropped_events_;
+            d->unreported_loss_ = true;
+            return;
+        }
+        wake = d->pending_.empty() || d->pending_.size() + frame.size() >= kEagerFlushBytes;
+        d->pending_ += frame;
+        ++d->appended_;
+    }
+    if (wake) {
+        d->queue_cv_.notify_one();
+    }
+}
+
+bool EventStore::flush() {
+    std::unique_lock<std::mutex> lock(d->queue_mutex_);
+    const std::uint64_t target = d->appended_;
+    if (d->completed_ < target) {
+        d->flush_requested_ = true;
+        d->queue_cv_.notify_one();
+        // 写线程在停止前也会处理完缓冲区，因此总能等到 completed_ 追上 target
+        d->durable_cv_.wait(lock, [this, target]() { return d->completed_ >= target; });
+    }
+    const bool lossless = !d->unreported_loss_;
+    d->unreported_loss_ = false;
+    return lossless;
+}
+
+size_t EventStore::for_each_event(const EventLog::Filter &filter,
+                                  const std::function<bool(const EventLog::Event &)> &visitor) const {
+    const std::int64_t start = filter.start_time.has_value() ? to_nanos(filter.start_time.value()) : kMinTs;
+    const std::int64_t end = filter.end_time.has_value() ? to_nanos(filter.end_time.value()) : kMaxTs;
+    size_t visited = 0;
+    EventLog::Event event{};
+    for (const auto &segment : d->snapshot_segments()) {
+        bool more = Impl::scan_range(*segment, start, end, [&](const unsigned char *payload, std::uint32_t len) {
+            if (!decode_payload(payload, len, event)) {
+                return true;
+            }
+            if ((filter.type.has_value() && event.type != filter.type.value()) ||
+                (filter.source.has_value() && event.source != filter.source.value())) {
+                return true;
+            }
+            ++visited;
+            return visitor(event);
+        });
+        if (!more) {
+            break;
+        }
+    }
+    return visited;
+}
+
+std::vector<EventLog::Event> EventStore::get_events(const EventLog::Filter &filter) const {
+    std::vector<EventLog::Event> events;
+    for_each_event(filter, [&events](const EventLog::Event &event) {
+        events.push_back(event);
+        return true;
+    });
+    return events;
+}
+
+std::vector<EventLog::Event> EventStore::recent_events(size_t limit) const {
+    std::deque<EventLog::Event> tail;
+    if (limit == 0) {
+        return {};
+    }
+    // 从最新的段向前，每段顺序解码并只保留所需的末尾部分
+    auto segments = d->snapshot_segments();
+    for (auto it = segments.rbegin(); it != segments.rend() && tail.size() < limit; ++it) {
+        const size_t need = limit - tail.size();
+        std::deque<EventLog::Event> chunk;
+        Impl::scan_range(**it, kMinTs, kMaxTs, [&](const unsigned char *payload, std::uint32_t len) {
+            EventLog::Event event{};
+            if (decode_payload(payload, len, event)) {
+                chunk.push_back(std::move(event));
+                if (chunk.size() > need) {
+                    chunk.pop_front();
+                }
+            }
+            return true;
+        });
+        tail.insert(tail.begin(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+    }
+    return std::vector<EventLog::Event>(std::make_move_iterator(tail.begin()), std::make_move_iterator(tail.end()));
+}
+
+std::uint64_t EventStore::last_sequence() const {
+    return d->last_sequence_.load();
+}
+
+void EventStore::apply_retention() {
+    d->apply_retention();
+}
+
+EventStore::Statistics EventStore::statistics() const {
+    Statistics stats{};
+    for (const auto &segment : d->snapshot_segments()) {
+        ++stats.segments;
+        stats.total_bytes += segment->size;
+    }
+    {
+        std::lock_guard<std::mutex> lock(d->queue_mutex_);
+        stats.appended = d->appended_;
+        stats.dropped_events = d->dropped_events_;
+        stats.discarded_records = d->discarded_records_;
+    }
+    stats.persisted = d->persisted_.load();
+    stats.syncs = d->syncs_.load();
+    stats.recovered_records = d->recovered_records_.load();
+    stats.truncated_bytes = d->truncated_bytes_.load();
+    stats.removed_segments = d->removed_segments_.load();
+    stats.write_errors = d->write_errors_.load();
+    return stats;
+}
+
+const EventStore::Options &EventStore::options() const noexcept {
+    return d->options_;
+}
+
+} // namespace youdidit
+} // namespace xswl
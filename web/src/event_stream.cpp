@@ -0,0 +1,267 @@
+#include <xswl/youdidit/web/event_stream.hpp>
+#include <xswl/youdidit/web/json_writer.hpp>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace xswl {
+namespace youdidit {
+
+namespace {
+long long epoch_ms(const Timestamp &ts) {
+    return static_cast<long long>(std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count());
+}
+}
+
+// ========== EventStreamHub::Client ==========
+EventStreamHub::Client::Client(size_t capacity) : capacity_(capacity == 0 ? 1 : capacity) {}
+
+bool EventStreamHub::Client::pop_all(std::string &out, std::chrono::milliseconds timeout) {
+    out.clear();
+    std::deque<std::shared_ptr<const std::string>> pending;
+    bool resync = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, timeout, [this]() { return closed_ || !queue_.empty() || overflowed_; });
+        if (closed_) {
+            return false;
+        }
+        pending.swap(queue_);
+        resync = overflowed_;
+        overflowed_ = false;
+    }
+    // 在锁外拼接，投递线程只需与这里竞争一次交换
+    if (resync) {
+        out += "event: resync\ndata: {}\n\n";
+    }
+    for (const auto &message : pending) {
+        out += *message;
+    }
+    return true;
+}
+
+void EventStreamHub::Client::push(const std::vector<std::shared_ptr<const std::string>> &messages) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (closed_) {
+            return;
+        }
+        for (const auto &message : messages) {
+            if (queue_.size() >= capacity_) {
+                queue_.pop_front();
+                overflowed_ = true;
+                ++dropped_;
+            }
+            queue_.push_back(message);
+        }
+    }
+    cv_.notify_one();
+}
+
+void EventStreamHub::Client::close() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        queue_.clear();
+    }
+    cv_.notify_all();
+}
+
+bool EventStreamHub::Client::closed() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return closed_;
+}
+
+std::uint64_t EventStreamHub::Client::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dropped_;
+}
+
+// ========== EventStreamHub ==========
+EventStreamHub::EventStreamHub(TaskPlatform *platform) : EventStreamHub(platform, Options()) {}
+
+EventStreamHub::EventStreamHub(TaskPlatform *platform, const Options &options)
+    : platform_(platform), options_(options) {
+    if (platform_) {
+        const std::uint64_t id = platform_->subscribe_lifecycle_batches(
+            [this](const std::vector<TaskLifecycleRecord> &records) { _on_batch(records); }, options_.batch);
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        subscription_id_ = id;
+    }
+}
+
+EventStreamHub::~EventStreamHub() {
+    close();
+}
+
+std::shared_ptr<EventStreamHub::Client> EventStreamHub::connect() {
+    auto client = std::make_shared<Client>(options_.client_queue_capacity);
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    if (closed_) {
+        client->close();
+    } else if (options_.max_clients > 0 && clients_.size() >= options_.max_clients) {
+        return nullptr;
+    } else {
+        clients_.push_back(client);
+    }
+    return client;
+}
+
+void EventStreamHub::disconnect(const std::shared_ptr<Client> &client) {
+    if (!client) {
+        return;
+    }
+    client->close();
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    clients_.erase(std::remove(clients_.begin(), clients_.end(), client), clients_.end());
+}
+
+void EventStreamHub::broadcast(const std::string &event, const std::string &data) {
+    std::vector<std::shared_ptr<const std::string>> messages;
+    messages.push_back(_format(event, data));
+    _fan_out(messages);
+}
+
+void EventStreamHub::close() {
+    std::uint64_t id = 0;
+    std::vector<std::shared_ptr<Client>> clients;
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        if (closed_) {
+            return;
+        }
+        closed_ = true;
+        id = subscription_id_;
+        subscription_id_ = 0;
+        clients.swap(clients_);
+    }
+    // 先唤醒所有阻塞在 pop_all 上的连接，使 HTTP 线程尽快退出
+    for (const auto &client : clients) {
+        client->close();
+    }
+    if (platform_ && id != 0) {
+        platform_->unsubscribe_lifecycle_batches(id);
+    }
+}
+
+void EventStreamHub::sync() {
+    if (platform_) {
+        platform_->flush_lifecycle_batches();
+    }
+}
+
+size_t EventStreamHub::client_count() const {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    return clients_.size();
+}
+
+const EventStreamHub::Options &EventStreamHub::options() const noexcept {
+    return options_;
+}
+
+void EventStreamHub::_on_batch(const std::vector<TaskLifecycleRecord> &records) {
+    std::uint64_t subscription_id = 0;
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        if (clients_.empty()) {
+            return;  // 没有连接时不做格式化
+        }
+        subscription_id = subscription_id_;
+    }
+
+    std::vector<std::shared_ptr<const std::string>> messages;
+    messages.reserve(records.size() + 1);
+    // 订阅缓冲溢出丢弃过记录：增量不完整，要求客户端重新全量拉取
+    const std::uint64_t dropped = subscription_id != 0 ? platform_->lifecycle_batch_dropped(subscription_id) : 0;
+    if (dropped > reported_dropped_) {
+        reported_dropped_ = dropped;
+        messages.push_back(_format("resync", "{}"));
+    }
+    std::set<std::string> touched_claimers;
+    for (const auto &record : records) {
+        if (record.removed) {
+            JsonWriter data;
+            data.begin_object()
+                .field("id", record.task_id)
+                .field("status", to_string(record.old_status))
+                .field("claimer_id", record.claimer_id)
+                .field("timestamp", epoch_ms(record.timestamp))
+                .field("change_sequence", record.change_sequence)
+                .end_object();
+            messages.push_back(_format("task_removed", data.str()));
+            continue;
+        }
+        // 按 ID 查找任务取最新的展示字段；任务已被删除时只发送状态
+        std::string title;
+        std::string category;
+        int priority = 0;
+        long long published_at = 0;
+        if (auto task = platform_->get_task(record.task_id)) {
+            auto view = task->snapshot();
+            title = view->title;
+            category = view->category;
+            priority = view->priority;
+            published_at = epoch_ms(view->published_at);
+        }
+        JsonWriter data;
+        data.begin_object()
+            .field("id", record.task_id)
+            .field("title", title)
+            .field("category", category)
+            .field("priority", priority)
+            .field("status", to_string(record.new_status))
+            .field("old_status", to_string(record.old_status))
+            .field("published_at", published_at)
+            .field("claimer_id", record.claimer_id)
+            .field("timestamp", epoch_ms(record.timestamp))
+            .field("change_sequence", record.change_sequence)
+            .end_object();
+        messages.push_back(_format("task", data.str()));
+        if (!record.claimer_id.empty()) {
+            touched_claimers.insert(record.claimer_id);
+        }
+    }
+    // 每批每个申领者只发送一次最新摘要
+    for (const auto &claimer_id : touched_claimers) {
+        auto claimer = platform_->get_claimer(claimer_id);
+        if (!claimer) {
+            continue;
+        }
+        JsonWriter data;
+        data.begin_object()
+            .field("id", claimer->id())
+            .field("name", claimer->name())
+            .field("status", to_string(claimer->status()))
+            .field("claimed_task_count", claimer->claimed_task_count())
+            .field("total_completed", claimer->total_completed())
+            .field("total_failed", claimer->total_failed())
+            .end_object();
+        messages.push_back(_format("claimer", data.str()));
+    }
+    _fan_out(messages);
+}
+
+std::shared_ptr<const std::string> EventStreamHub::_format(const std::string &event, const std::string &data) {
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(format_mutex_);
+        id = next_event_id_++;
+    }
+    return std::make_shared<const std::string>("id: " + std::to_string(id) + "\nevent: " + event + "\ndata: " + data +
+                                               "\n\n");
+}
+
+void EventStreamHub::_fan_out(const std::vector<std::shared_ptr<const std::string>> &messages) {
+    std::vector<std::shared_ptr<Client>> clients;
+    {
+        std::lock_guard<std::mutex> lock(clients_mutex_);
+        clients = clients_;
+    }
+    // 每个客户端只追加共享消息的指针，一批只加一次锁
+    for (const auto &client : clients) {
+        client->push(messages);
+    }
+}
+
+} // namespace youdidit
+} // namespace xswl
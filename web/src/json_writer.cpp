@@ -0,0 +1,277 @@
+#include <xswl/youdidit/web/json_writer.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+namespace xswl {
+namespace youdidit {
+
+namespace {
+// 需要转义的字节：控制字符、双引号、反斜杠（查表，避免逐字节多次比较）
+struct EscapeTable {
+    bool entries[256];
+    EscapeTable() {
+        for (int i = 0; i < 256; ++i) {
+            entries[i] = i < 0x20 || i == '"' || i == '\\';
+        }
+    }
+};
+}
+
+JsonWriter::JsonWriter() : JsonWriter(Sink(), 0) {}
+
+JsonWriter::JsonWriter(Sink sink, size_t flush_threshold)
+    : after_key_(false), sink_(std::move(sink)), flush_threshold_(flush_threshold), ok_(true) {
+    buffer_.reserve(sink_ ? flush_threshold_ + 256 : 256);
+}
+
+JsonWriter &JsonWriter::begin_object() {
+    _separate();
+    buffer_ += '{';
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::end_object() {
+    buffer_ += '}';
+    if (!first_.empty()) {
+        first_.pop_back();
+    }
+    _maybe_flush();
+    return *this;
+}
+
+JsonWriter &JsonWriter::begin_array() {
+    _separate();
+    buffer_ += '[';
+    first_.push_back(true);
+    return *this;
+}
+
+JsonWriter &JsonWriter::end_array() {
+    buffer_ += ']';
+    if (!first_.empty()) {
+        first_.pop_back();
+    }
+    _maybe_flush();
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const char *name) {
+    _separate();
+    _write_string(name, std::strlen(name));
+    buffer_ += ':';
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::key(const std::string &name) {
+    _separate();
+    _write_string(name.data(), name.size());
+    buffer_ += ':';
+    after_key_ = true;
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const char *text) {
+    if (!text) {
+        return null();
+    }
+    _separate();
+    _write_string(text, std::strlen(text));
+    _maybe_flush();
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(const std::string &text) {
+    _separate();
+    _write_string(text.data(), text.size());
+    _maybe_flush();
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(bool flag) {
+    _separate();
+    buffer_ += flag ? "true" : "false";
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(int number) {
+    _separate();
+    _write_signed(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(unsigned number) {
+    _separate();
+    _write_unsigned(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(long number) {
+    _separate();
+    _write_signed(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(unsigned long number) {
+    _separate();
+    _write_unsigned(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(long long number) {
+    _separate();
+    _write_signed(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(unsigned long long number) {
+    _separate();
+    _write_unsigned(number);
+    return *this;
+}
+
+JsonWriter &JsonWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        return null();
+    }
+    _separate();
+    // 优先使用 15 位有效数字（更短），不能精确往返时再用 17 位
+    char buf[32];
+    int len = std::snprintf(buf, sizeof(buf), "%.15g", number);
+    if (std::strtod(buf, nullptr) != number) {
+        len = std::snprintf(buf, sizeof(buf), "%.17g", number);
+    }
+    for (int i = 0; i < len; ++i) {
+        if (buf[i] == ',') {
+            buf[i] = '.';  // 进程设置了使用逗号作小数点的 locale
+        }
+    }
+    buffer_.append(buf, static_cast<size_t>(len));
+    return *this;
+}
+
+JsonWriter &JsonWriter::null() {
+    _separate();
+    buffer_ += "null";
+    return *this;
+}
+
+JsonWriter &JsonWriter::raw_value(const char *json, size_t size) {
+    _separate();
+    buffer_.append(json, size);
+    _maybe_flush();
+    return *this;
+}
+
+const std::string &JsonWriter::str() const noexcept {
+    return buffer_;
+}
+
+size_t JsonWriter::size() const noexcept {
+    return buffer_.size();
+}
+
+void JsonWriter::clear() {
+    buffer_.clear();
+}
+
+bool JsonWriter::flush() {
+    if (sink_ && !buffer_.empty()) {
+        if (ok_ && !sink_(buffer_.data(), buffer_.size())) {
+            ok_ = false;
+        }
+        buffer_.clear();
+    }
+    return ok_;
+}
+
+bool JsonWriter::ok() const noexcept {
+    return ok_;
+}
+
+void JsonWriter::escape(std::string &out, const char *text, size_t size) {
+    static const char hex[] = "0123456789abcdef";
+    static const EscapeTable table;
+    size_t run = 0;  // 尚未追加的无需转义片段起点
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char ch = static_cast<unsigned char>(text[i]);
+        if (!table.entries[ch]) {
+            continue;
+        }
+        out.append(text + run, i - run);
+        run = i + 1;
+        switch (ch) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default: {
+            char buf[6] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0x0F]};
+            out.append(buf, sizeof(buf));
+        }
+        }
+    }
+    out.append(text + run, size - run);
+}
+
+void JsonWriter::escape(std::string &out, const std::string &text) {
+    escape(out, text.data(), text.size());
+}
+
+void JsonWriter::_separate() {
+    if (after_key_) {
+        after_key_ = false;
+        return;
+    }
+    if (first_.empty()) {
+        return;
+    }
+    if (first_.back()) {
+        first_.back() = false;
+    } else {
+        buffer_ += ',';
+    }
+}
+
+void JsonWriter::_write_string(const char *text, size_t size) {
+    buffer_ += '"';
+    escape(buffer_, text, size);
+    buffer_ += '"';
+}
+
+void JsonWriter::_write_signed(long long number) {
+    if (number < 0) {
+        buffer_ += '-';
+        // 先转为无符号再取负，避免 LLONG_MIN 溢出
+        _write_unsigned(0ULL - static_cast<unsigned long long>(number));
+    } else {
+        _write_unsigned(static_cast<unsigned long long>(number));
+    }
+}
+
+void JsonWriter::_write_unsigned(unsigned long long number) {
+    char buf[24];
+    char *end = buf + sizeof(buf);
+    char *p = end;
+    do {
+        *--p = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    buffer_.append(p, static_cast<size_t>(end - p));
+}
+
+void JsonWriter::_maybe_flush() {
+    if (sink_ && buffer_.size() >= flush_threshold_) {
+        flush();
+    }
+}
+
+} // namespace youdidit
+} // namespace xswl
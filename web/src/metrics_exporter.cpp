@@ -1,54 +1,255 @@
 #include <xswl/youdidit/web/metrics_exporter.hpp>
+#include <xswl/youdidit/web/json_writer.hpp>
 #include <sstream>
+#include <utility>
 
 namespace xswl {
 namespace youdidit {
 
+namespace {
+// 直方图的 le 边界：64us 起每 4 倍一档（均为 2 的幂，与直方图桶边界对齐，计数精确）
+const unsigned kFirstBoundaryBit = 6;
+const unsigned kLastBoundaryBit = 34;
+
+// Prometheus 标签值转义：反斜杠、双引号与换行
+std::string label_value(const std::string &value) {
+    std::string out;
+    out.reserve(value.size());
+    for (char ch : value) {
+        switch (ch) {
+        case '\\': out += "\\\\"; break;
+        case '"': out += "\\\""; break;
+        case '\n': out += "\\n"; break;
+        default: out += ch;
+        }
+    }
+    return out;
+}
+
+// 锁等待/持有时间的 le 边界：256ns 起每 4 倍一档，到约 4.3s
+const unsigned kFirstLockBoundaryBit = 8;
+const unsigned kLastLockBoundaryBit = 32;
+
+// value / 10^scale 的精确十进制表示（去掉末尾的 0）
+std::string decimal(std::uint64_t value, unsigned scale) {
+    std::uint64_t divisor = 1;
+    for (unsigned i = 0; i < scale; ++i) {
+        divisor *= 10;
+    }
+    std::string out = std::to_string(value / divisor);
+    std::uint64_t fraction = value % divisor;
+    if (fraction != 0) {
+        std::string digits = std::to_string(fraction);
+        digits.insert(0, scale - digits.size(), '0');
+        digits.erase(digits.find_last_not_of('0') + 1);
+        out += '.';
+        out += digits;
+    }
+    return out;
+}
+
+// 微秒 → 秒
+std::string seconds(std::uint64_t micros) {
+    return decimal(micros, 6);
+}
+
+// 纳秒 → 秒
+std::string nano_seconds(std::uint64_t nanos) {
+    return decimal(nanos, 9);
+}
+
+void write_gauge(std::ostream &oss, const char *name, const char *help, std::uint64_t value,
+                 const char *type = "gauge") {
+    oss << "# HELP " << name << " " << help << "\n";
+    oss << "# TYPE " << name << " " << type << "\n";
+    oss << name << " " << value << "\n";
+}
+
+struct StageMetric {
+    LatencyStage stage;
+    const char *name;
+    const char *help;
+};
+
+const StageMetric kStageMetrics[] = {
+    {LatencyStage::QueueWait, "youdidit_task_queue_wait_seconds", "Time from publish to claim"},
+    {LatencyStage::StartDelay, "youdidit_task_start_delay_seconds", "Time from claim to start of execution"},
+    {LatencyStage::Run, "youdidit_task_run_seconds", "Time from start of execution to completion"},
+    {LatencyStage::EndToEnd, "youdidit_task_end_to_end_seconds", "Time from publish to completion"},
+};
+
+const double kQuantiles[] = {0.5, 0.99, 0.999};
+const char *const kQuantileLabels[] = {"0.5", "0.99", "0.999"};
+}
+
 MetricsExporter::MetricsExporter(TaskPlatform *platform, EventLog *event_log)
     : platform_(platform), event_log_(event_log) {}
 
+MetricsExporter::MetricsExporter(std::shared_ptr<MetricsSnapshotter> snapshotter)
+    : platform_(nullptr), event_log_(nullptr), snapshotter_(std::move(snapshotter)) {}
+
 std::string MetricsExporter::export_json() const {
-    std::ostringstream oss;
-    oss << "{";
-    if (platform_) {
-        auto stats = platform_->get_statistics();
-        oss << "\"total_tasks\":" << stats.total_tasks << ",";
-        oss << "\"completed_tasks\":" << stats.completed_tasks << ",";
-        oss << "\"failed_tasks\":" << stats.failed_tasks << ",";
-        oss << "\"published_tasks\":" << stats.published_tasks << ",";
-        oss << "\"claimed_tasks\":" << stats.claimed_tasks << ",";
-        oss << "\"processing_tasks\":" << stats.processing_tasks << ",";
-        oss << "\"abandoned_tasks\":" << stats.abandoned_tasks << ",";
-        oss << "\"total_claimers\":" << stats.total_claimers;
-    }
-    if (event_log_) {
-        if (platform_) {
-            oss << ",";
-        }
-        oss << "\"events\":" << event_log_->size();
+    auto snapshot = _snapshot();
+    const auto &stats = snapshot->stats;
+    JsonWriter writer;
+    writer.begin_object();
+    if (snapshot->has_platform) {
+        writer.field("total_tasks", stats.total_tasks)
+            .field("completed_tasks", stats.completed_tasks)
+            .field("failed_tasks", stats.failed_tasks)
+            .field("published_tasks", stats.published_tasks)
+            .field("claimed_tasks", stats.claimed_tasks)
+            .field("processing_tasks", stats.processing_tasks)
+            .field("abandoned_tasks", stats.abandoned_tasks)
+            .field("total_claimers", stats.total_claimers);
     }
-    oss << "}";
-    return oss.str();
+    if (snapshot->has_event_log) {
+        writer.field("events", snapshot->event_count);
+    }
+    writer.end_object();
+    return writer.str();
 }
 
 std::string MetricsExporter::export_prometheus() const {
+    auto snapshot = _snapshot();
+    const auto &stats = snapshot->stats;
     std::ostringstream oss;
-    if (platform_) {
-        auto stats = platform_->get_statistics();
-        oss << "youdidit_tasks_total " << stats.total_tasks << "\n";
-        oss << "youdidit_tasks_completed " << stats.completed_tasks << "\n";
-        oss << "youdidit_tasks_failed " << stats.failed_tasks << "\n";
-        oss << "youdidit_tasks_published " << stats.published_tasks << "\n";
-        oss << "youdidit_tasks_claimed " << stats.claimed_tasks << "\n";
-        oss << "youdidit_tasks_processing " << stats.processing_tasks << "\n";
-        oss << "youdidit_tasks_abandoned " << stats.abandoned_tasks << "\n";
-        oss << "youdidit_claimers_total " << stats.total_claimers << "\n";
-    }
-    if (event_log_) {
-        oss << "youdidit_events_total " << event_log_->size() << "\n";
+    if (snapshot->has_platform) {
+        write_gauge(oss, "youdidit_tasks_total", "Number of tasks on the platform", stats.total_tasks);
+        write_gauge(oss, "youdidit_tasks_completed", "Number of completed tasks", stats.completed_tasks);
+        write_gauge(oss, "youdidit_tasks_failed", "Number of failed tasks", stats.failed_tasks);
+        write_gauge(oss, "youdidit_tasks_published", "Number of tasks waiting to be claimed", stats.published_tasks);
+        write_gauge(oss, "youdidit_tasks_claimed", "Number of claimed tasks not yet started", stats.claimed_tasks);
+        write_gauge(oss, "youdidit_tasks_processing", "Number of tasks being processed", stats.processing_tasks);
+        write_gauge(oss, "youdidit_tasks_abandoned", "Number of abandoned tasks", stats.abandoned_tasks);
+        write_gauge(oss, "youdidit_claimers_total", "Number of registered claimers", stats.total_claimers);
+    }
+    if (snapshot->has_event_log) {
+        write_gauge(oss, "youdidit_events_total", "Number of events held by the event log", snapshot->event_count);
+        write_gauge(oss, "youdidit_events_dropped_total", "Events evicted from the event log ring buffer",
+                    snapshot->events_dropped, "counter");
     }
+    _write_latency(oss, *snapshot);
+    _write_locks(oss, *snapshot);
+    _write_memory_usage(oss, *snapshot);
     return oss.str();
 }
 
+std::shared_ptr<const MetricsSnapshot> MetricsExporter::_snapshot() const {
+    if (snapshotter_) {
+        return snapshotter_->current();
+    }
+    return MetricsSnapshot::capture(platform_, event_log_);
+}
+
+void MetricsExporter::_write_latency(std::ostream &oss, const MetricsSnapshot &snapshot) const {
+    if (snapshot.latency.empty()) {
+        return;
+    }
+    for (const auto &metric : kStageMetrics) {
+        oss << "# HELP " << metric.name << " " << metric.help << "\n";
+        oss << "# TYPE " << metric.name << " histogram\n";
+        for (const auto &series : snapshot.latency) {
+            const auto &histogram = series.stage(metric.stage);
+            std::string labels = "category=\"" + label_value(series.category) + "\",claimer=\"" +
+                                 label_value(series.claimer_id) + "\"";
+            for (unsigned bit = kFirstBoundaryBit; bit <= kLastBoundaryBit; bit += 2) {
+                std::uint64_t limit = std::uint64_t(1) << bit;
+                oss << metric.name << "_bucket{" << labels << ",le=\"" << seconds(limit) << "\"} "
+                    << histogram.count_below(limit) << "\n";
+            }
+            oss << metric.name << "_bucket{" << labels << ",le=\"+Inf\"} " << histogram.count << "\n";
+            oss << metric.name << "_sum{" << labels << "} " << seconds(histogram.sum) << "\n";
+            oss << metric.name << "_count{" << labels << "} " << histogram.count << "\n";
+        }
+    }
+
+    // 由细粒度桶直接计算的分位数（相对误差 <= 1/16），无需在查询端插值
+    oss << "# HELP youdidit_task_latency_quantile_seconds Latency quantiles per stage computed from fine-grained buckets\n";
+    oss << "# TYPE youdidit_task_latency_quantile_seconds gauge\n";
+    for (const auto &metric : kStageMetrics) {
+        for (const auto &series : snapshot.latency) {
+            const auto &histogram = series.stage(metric.stage);
+            if (histogram.count == 0) {
+                continue;
+            }
+            for (size_t i = 0; i < sizeof(kQuantiles) / sizeof(kQuantiles[0]); ++i) {
+                oss << "youdidit_task_latency_quantile_seconds{stage=\"" << latency_stage_name(metric.stage)
+                    << "\",category=\"" << label_value(series.category) << "\",claimer=\""
+                    << label_value(series.claimer_id) << "\",quantile=\"" << kQuantileLabels[i] << "\"} "
+                    << seconds(histogram.percentile(kQuantiles[i])) << "\n";
+            }
+        }
+    }
+}
+
+void MetricsExporter::_write_locks(std::ostream &oss, const MetricsSnapshot &snapshot) const {
+    if (snapshot.locks.empty()) {
+        return;
+    }
+    oss << "# HELP youdidit_lock_acquisitions_total Lock acquisitions per lock site\n";
+    oss << "# TYPE youdidit_lock_acquisitions_total counter\n";
+    for (const auto &lock : snapshot.locks) {
+        oss << "youdidit_lock_acquisitions_total{lock=\"" << lock.name << "\"} " << lock.acquisitions << "\n";
+    }
+    oss << "# HELP youdidit_lock_contended_total Lock acquisitions that had to wait\n";
+    oss << "# TYPE youdidit_lock_contended_total counter\n";
+    for (const auto &lock : snapshot.locks) {
+        oss << "youdidit_lock_contended_total{lock=\"" << lock.name << "\"} " << lock.contended << "\n";
+    }
+
+    struct LockMetric {
+        const char *name;
+        const char *help;
+        const LatencyHistogram::Snapshot LockStatistics::*histogram;
+    };
+    const LockMetric metrics[] = {
+        {"youdidit_lock_wait_seconds", "Time spent waiting for a contended lock", &LockStatistics::wait},
+        {"youdidit_lock_hold_seconds", "Time a lock was held", &LockStatistics::hold},
+    };
+    for (const auto &metric : metrics) {
+        oss << "# HELP " << metric.name << " " << metric.help << "\n";
+        oss << "# TYPE " << metric.name << " histogram\n";
+        for (const auto &lock : snapshot.locks) {
+            const auto &histogram = lock.*metric.histogram;
+            std::string labels = "lock=\"" + lock.name + "\"";
+            for (unsigned bit = kFirstLockBoundaryBit; bit <= kLastLockBoundaryBit; bit += 2) {
+                std::uint64_t limit = std::uint64_t(1) << bit;
+                oss << metric.name << "_bucket{" << labels << ",le=\"" << nano_seconds(limit) << "\"} "
+                    << histogram.count_below(limit) << "\n";
+            }
+            oss << metric.name << "_bucket{" << labels << ",le=\"+Inf\"} " << histogram.count << "\n";
+            oss << metric.name << "_sum{" << labels << "} " << nano_seconds(histogram.sum) << "\n";
+            oss << metric.name << "_count{" << labels << "} " << histogram.count << "\n";
+        }
+    }
+}
+
+void MetricsExporter::_write_memory_usage(std::ostream &oss, const MetricsSnapshot &snapshot) const {
+    if (!snapshot.has_platform && !snapshot.has_event_log) {
+        return;
+    }
+    oss << "# HELP youdidit_memory_bytes Approximate memory usage by component\n";
+    oss << "# TYPE youdidit_memory_bytes gauge\n";
+    if (snapshot.has_platform) {
+        for (const auto &pair : snapshot.platform_memory.components) {
+            oss << "youdidit_memory_bytes{scope=\"platform\",component=\"" << pair.first << "\"} "
+                << pair.second << "\n";
+        }
+        for (const auto &claimer : snapshot.claimer_memory) {
+            for (const auto &pair : claimer.second.components) {
+                oss << "youdidit_memory_bytes{scope=\"claimer\",claimer=\"" << label_value(claimer.first)
+                    << "\",component=\"" << pair.first << "\"} " << pair.second << "\n";
+            }
+        }
+    }
+    if (snapshot.has_event_log) {
+        for (const auto &pair : snapshot.event_log_memory.components) {
+            oss << "youdidit_memory_bytes{scope=\"event_log\",component=\"" << pair.first << "\"} "
+                << pair.second << "\n";
+        }
+    }
+}
+
 } // namespace youdidit
 } // namespace xswl
@@ -0,0 +1,150 @@
+#include <xswl/youdidit/web/metrics_snapshot.hpp>
+
+namespace xswl {
+namespace youdidit {
+
+// ========== MetricsSnapshot ==========
+std::shared_ptr<const MetricsSnapshot> MetricsSnapshot::capture(TaskPlatform *platform, EventLog *event_log,
+                                                                std::uint64_t generation,
+                                                                const StatisticsSource &statistics) {
+    std::shared_ptr<MetricsSnapshot> snapshot = std::make_shared<MetricsSnapshot>();
+    snapshot->stats = TaskPlatform::PlatformStatistics{};
+    snapshot->has_platform = platform != nullptr;
+    snapshot->has_event_log = event_log != nullptr;
+    snapshot->event_count = 0;
+    snapshot->events_dropped = 0;
+    snapshot->taken_at = std::chrono::system_clock::now();
+    snapshot->generation = generation;
+    snapshot->change_sequence = 0;
+    snapshot->locks = lock_statistics();
+    if (platform) {
+        // 先取序号再统计：增量订阅方据此丢弃统计中已包含的变更
+        snapshot->change_sequence = platform->change_sequence();
+        snapshot->stats = platform->get_statistics();
+        snapshot->platform_memory = platform->memory_usage();
+        snapshot->latency = platform->latency_histograms();
+        auto claimers = platform->get_claimers();
+        snapshot->claimer_memory.reserve(claimers.size());
+        for (const auto &claimer : claimers) {
+            snapshot->claimer_memory.emplace_back(claimer->id(), claimer->memory_usage());
+        }
+    } else if (statistics) {
+        snapshot->stats = statistics();
+        snapshot->has_platform = true;
+    } else {
+        snapshot->stats.start_time = snapshot->taken_at;
+    }
+    if (event_log) {
+        snapshot->event_count = event_log->size();
+        snapshot->events_dropped = event_log->dropped_count();
+        snapshot->event_log_memory = event_log->memory_usage();
+    }
+    return snapshot;
+}
+
+// ========== MetricsSnapshotter ==========
+MetricsSnapshotter::MetricsSnapshotter(TaskPlatform *platform, EventLog *event_log,
+                                       std::chrono::milliseconds interval)
+    : platform_(platform), event_log_(event_log), interval_(interval) {
+    // 构造时同步采集第一份快照，current() 从一开始就有数据
+    refresh();
+    _update_live();
+    if (interval_.count() > 0) {
+        thread_ = std::thread([this]() { _run(); });
+    }
+}
+
+MetricsSnapshotter::~MetricsSnapshotter() {
+    stop();
+}
+
+std::shared_ptr<const MetricsSnapshot> MetricsSnapshotter::current() {
+    if (live_.load(std::memory_order_acquire)) {
+        return refresh();
+    }
+    return std::atomic_load(&snapshot_);
+}
+
+std::shared_ptr<const MetricsSnapshot> MetricsSnapshotter::refresh() {
+    std::lock_guard<std::mutex> lock(refresh_mutex_);
+    auto snapshot = MetricsSnapshot::capture(platform_, event_log_, next_generation_++, statistics_);
+    std::atomic_store(&snapshot_, snapshot);
+    return snapshot;
+}
+
+void MetricsSnapshotter::set_interval(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    interval_ = interval;
+    _update_live();
+    if (stopped_) {
+        return;
+    }
+    if (interval_.count() <= 0) {
+        _stop_thread(lock);
+        return;
+    }
+    if (thread_.joinable()) {
+        interval_changed_ = true;
+        cv_.notify_one();
+    } else {
+        thread_ = std::thread([this]() { _run(); });
+    }
+}
+
+void MetricsSnapshotter::set_statistics_source(MetricsSnapshot::StatisticsSource statistics) {
+    {
+        std::lock_guard<std::mutex> lock(refresh_mutex_);
+        statistics_ = std::move(statistics);
+    }
+    refresh();
+}
+
+std::chrono::milliseconds MetricsSnapshotter::interval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return interval_;
+}
+
+void MetricsSnapshotter::stop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_ = true;
+    _update_live();
+    _stop_thread(lock);
+}
+
+void MetricsSnapshotter::_update_live() {
+    live_.store(interval_.count() <= 0 && !stopped_, std::memory_order_release);
+}
+
+void MetricsSnapshotter::_stop_thread(std::unique_lock<std::mutex> &lock) {
+    if (!thread_.joinable()) {
+        return;
+    }
+    stopping_ = true;
+    std::thread thread = std::move(thread_);
+    lock.unlock();
+    cv_.notify_one();
+    thread.join();
+    lock.lock();
+    stopping_ = false;
+}
+
+void MetricsSnapshotter::_run() {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            bool woken = cv_.wait_for(lock, interval_, [this]() { return stopping_ || interval_changed_; });
+            if (stopping_) {
+                return;
+            }
+            if (woken) {
+                // 间隔已修改：按新间隔重新计时
+                interval_changed_ = false;
+                continue;
+            }
+        }
+        refresh();
+    }
+}
+
+} // namespace youdidit
+} // namespace xswl
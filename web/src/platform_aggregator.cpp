@@ -0,0 +1,470 @@
+#include <xswl/youdidit/web/platform_aggregator.hpp>
+#include <httplib.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <utility>
+
+namespace xswl {
+namespace youdidit {
+
+namespace {
+// 与 /api/tasks 的 limit 上限一致
+const size_t kMaxPageLimit = 5000;
+
+// 拆分端点为 "scheme://host:port" 与路径前缀；兼容直接给出 .../api/metrics 的写法
+void split_endpoint(const std::string &endpoint, std::string &origin, std::string &prefix) {
+    const std::string api_metrics = "/api/metrics";
+    std::string::size_type scheme = endpoint.find("://");
+    std::string::size_type path = endpoint.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+    origin = endpoint.substr(0, path);
+    prefix = path == std::string::npos ? std::string() : endpoint.substr(path);
+    if (prefix.size() >= api_metrics.size() &&
+        prefix.compare(prefix.size() - api_metrics.size(), api_metrics.size(), api_metrics) == 0) {
+        prefix.erase(prefix.size() - api_metrics.size());
+    }
+    while (!prefix.empty() && prefix.back() == '/') {
+        prefix.pop_back();
+    }
+}
+
+size_t size_field(const nlohmann::json &object, const char *name) {
+    auto it = object.find(name);
+    return it != object.end() && it->is_number_unsigned() ? it->get<size_t>() : 0;
+}
+
+bool bool_field(const nlohmann::json &object, const char *name) {
+    auto it = object.find(name);
+    return it != object.end() && it->is_boolean() && it->get<bool>();
+}
+
+std::string string_field(const nlohmann::json &object, const char *name) {
+    auto it = object.find(name);
+    return it != object.end() && it->is_string() ? it->get<std::string>() : std::string();
+}
+
+TaskView parse_task(const nlohmann::json &item) {
+    TaskView view;
+    view.id = string_field(item, "id");
+    view.title = string_field(item, "title");
+    view.category = string_field(item, "category");
+    view.claimer_id = string_field(item, "claimer_id");
+    auto priority = item.find("priority");
+    if (priority != item.end() && priority->is_number_integer()) {
+        view.priority = priority->get<int>();
+    }
+    auto status = task_status_from_string(string_field(item, "status"));
+    if (status) {
+        view.status = status.value();
+    }
+    auto published_at = item.find("published_at");
+    if (published_at != item.end() && published_at->is_number_integer()) {
+        view.published_at = Timestamp(std::chrono::duration_cast<Timestamp::duration>(
+            std::chrono::milliseconds(published_at->get<std::int64_t>())));
+    }
+    return view;
+}
+}
+
+// ========== Slot ==========
+struct PlatformAggregator::Slot {
+    Slot(const std::string &endpoint, const Options &options) : endpoint(endpoint) {
+        split_endpoint(endpoint, origin, prefix);
+        client.reset(new httplib::Client(origin));
+        client->set_keep_alive(true);
+        client->set_connection_timeout(options.timeout);
+        client->set_read_timeout(options.timeout);
+        client->set_write_timeout(options.timeout);
+
+        auto initial = std::make_shared<EndpointSnapshot>();
+        initial->endpoint = endpoint;
+        initial->last_error = "not scraped yet";
+        initial->tasks = std::make_shared<const std::vector<TaskView>>();
+        snapshot = initial;
+    }
+
+    // GET 并解析为 JSON 对象
+    bool fetch(const std::string &path, nlohmann::json &body, std::string &error) {
+        auto res = client->Get(prefix + path);
+        if (!res) {
+            error = path + ": " + httplib::to_string(res.error());
+            return false;
+        }
+        if (res->status != 200) {
+            error = path + ": HTTP " + std::to_string(res->status);
+            return false;
+        }
+        body = nlohmann::json::parse(res->body, nullptr, false);
+        if (!body.is_object()) {
+            error = path + ": invalid JSON";
+            return false;
+        }
+        return true;
+    }
+
+    // 条件请求 /api/metrics：未变化时对端返回 304，沿用 stats
+    bool fetch_metrics(std::string &error) {
+        httplib::Headers headers;
+        if (!metrics_etag.empty()) {
+            headers.emplace("If-None-Match", metrics_etag);
+        }
+        auto res = client->Get(prefix + "/api/metrics", headers);
+        if (!res) {
+            error = "/api/metrics: " + httplib::to_string(res.error());
+            return false;
+        }
+        if (res->status == 304) {
+            return true;
+        }
+        if (res->status != 200) {
+            error = "/api/metrics: HTTP " + std::to_string(res->status);
+            return false;
+        }
+        auto metrics = nlohmann::json::parse(res->body, nullptr, false);
+        if (!metrics.is_object()) {
+            error = "/api/metrics: invalid JSON";
+            return false;
+        }
+        stats.total_tasks = size_field(metrics, "total_tasks");
+        stats.published_tasks = size_field(metrics, "published_tasks");
+        stats.claimed_tasks = size_field(metrics, "claimed_tasks");
+        stats.processing_tasks = size_field(metrics, "processing_tasks");
+        stats.completed_tasks = size_field(metrics, "completed_tasks");
+        stats.failed_tasks = size_field(metrics, "failed_tasks");
+        stats.abandoned_tasks = size_field(metrics, "abandoned_tasks");
+        stats.total_claimers = size_field(metrics, "total_claimers");
+        metrics_etag = res->get_header_value("ETag");
+        return true;
+    }
+
+    // 按游标翻页全量拉取，成功后替换镜像；对端返回 sequence 时之后改为增量同步
+    bool sync_full(size_t max_tasks, std::chrono::steady_clock::time_point deadline, std::string &error) {
+        std::map<TaskId, TaskView> fresh;
+        std::string cursor;
+        std::uint64_t first_sequence = 0;
+        bool has_sequence = false;
+        bool capped = false;
+        bool timed_out = false;
+        for (;;) {
+            const size_t wanted = max_tasks - fresh.size();
+            if (wanted == 0) {
+                capped = true;
+                break;
+            }
+            std::string path = "/api/tasks?limit=" + std::to_string(std::min(wanted, kMaxPageLimit));
+            if (!cursor.empty()) {
+                path += "&cursor=" + httplib::encode_uri_component(cursor);
+            }
+            nlohmann::json page;
+            if (!fetch(path, page, error)) {
+                return false;
+            }
+            // 取第一页的序号：翻页期间的变化会在下一次增量同步中重新收到
+            auto sequence_field = page.find("sequence");
+            if (cursor.empty() && sequence_field != page.end() && sequence_field->is_number_unsigned()) {
+                first_sequence = sequence_field->get<std::uint64_t>();
+                has_sequence = true;
+            }
+            auto items = page.find("tasks");
+            if (items != page.end() && items->is_array()) {
+                for (const auto &item : *items) {
+                    if (item.is_object()) {
+                        TaskView view = parse_task(item);
+                        TaskId id = view.id;
+                        fresh[id] = std::move(view);
+                    }
+                }
+            }
+            cursor = string_field(page, "next_cursor");
+            if (cursor.empty()) {
+                break;
+            }
+            if (std::chrono::steady_clock::now() >= deadline) {
+                timed_out = true;
+                break;
+            }
+        }
+        mirror.swap(fresh);
+        sequence = first_sequence;
+        // 超时未取完时下一轮重新全量拉取；达到上限则保持截断并继续增量同步
+        synced = has_sequence && !timed_out;
+        truncated = capped || timed_out;
+        mirror_changed = true;
+        return true;
+    }
+
+    // 用 since 拉取变化与墓碑并应用到镜像；对端要求重置时清除 synced，由调用方全量拉取
+    bool sync_changes(size_t max_tasks, std::chrono::steady_clock::time_point deadline, std::string &error) {
+        for (;;) {
+            nlohmann::json page;
+            if (!fetch("/api/tasks?since=" + std::to_string(sequence) + "&limit=" + std::to_string(kMaxPageLimit),
+                       page, error)) {
+                return false;
+            }
+            if (bool_field(page, "reset")) {
+                synced = false;
+                return true;
+            }
+            auto items = page.find("tasks");
+            if (items != page.end() && items->is_array()) {
+                for (const auto &item : *items) {
+                    if (!item.is_object()) {
+                        continue;
+                    }
+                    TaskView view = parse_task(item);
+                    auto it = mirror.find(view.id);
+                    if (it != mirror.end()) {
+                        it->second = std::move(view);
+                    } else if (mirror.size() < max_tasks) {
+                        TaskId id = view.id;
+                        mirror.emplace(std::move(id), std::move(view));
+                    } else {
+                        truncated = true;
+                        continue;
+                    }
+                    mirror_changed = true;
+                }
+            }
+            auto removed = page.find("removed");
+            if (removed != page.end() && removed->is_array()) {
+                for (const auto &id : *removed) {
+                    if (id.is_string() && mirror.erase(id.get<std::string>()) > 0) {
+                        mirror_changed = true;
+                    }
+                }
+            }
+            auto sequence_field = page.find("sequence");
+            if (sequence_field != page.end() && sequence_field->is_number_unsigned()) {
+                sequence = sequence_field->get<std::uint64_t>();
+            }
+            // 本轮超时时剩余的变化留到下一轮
+            if (!bool_field(page, "has_more") || std::chrono::steady_clock::now() >= deadline) {
+                return true;
+            }
+        }
+    }
+
+    std::string endpoint;
+    std::string origin;
+    std::string prefix;
+    std::mutex scrape_mutex;                            // 同一端点的抓取串行执行，保证发布顺序
+    std::unique_ptr<httplib::Client> client;            // 只在持有 scrape_mutex 时使用（stop() 除外）
+    std::shared_ptr<const EndpointSnapshot> snapshot;   // 只通过 std::atomic_load/atomic_store 访问
+    std::thread thread;
+
+    // 以下只在持有 scrape_mutex 时访问
+    TaskPlatform::PlatformStatistics stats{};   // 最近一次 200 响应的统计
+    std::string metrics_etag;                   // 该响应的 ETag
+    std::map<TaskId, TaskView> mirror;          // 远程任务的本地镜像，按 ID 排序（与 /api/tasks 默认顺序一致）
+    std::uint64_t sequence = 0;                 // 镜像对应的远程变更序号
+    bool synced = false;                        // 镜像可按 since 增量同步
+    bool truncated = false;                     // 镜像只包含部分任务
+    bool mirror_changed = false;                // 镜像有尚未发布的修改
+};
+
+// ========== PlatformAggregator ==========
+PlatformAggregator::PlatformAggregator(const std::vector<std::string> &endpoints)
+    : PlatformAggregator(endpoints, Options()) {}
+
+PlatformAggregator::PlatformAggregator(const std::vector<std::string> &endpoints, const Options &options)
+    : options_(options), created_at_(std::chrono::system_clock::now()) {
+    slots_.reserve(endpoints.size());
+    for (const auto &endpoint : endpoints) {
+        slots_.emplace_back(new Slot(endpoint, options_));
+    }
+    _update_live();
+    if (options_.interval.count() > 0) {
+        _start_threads();
+    }
+}
+
+PlatformAggregator::~PlatformAggregator() {
+    stop();
+}
+
+std::vector<std::shared_ptr<const EndpointSnapshot>> PlatformAggregator::endpoints() {
+    if (live_.load(std::memory_order_acquire)) {
+        refresh();
+    }
+    std::vector<std::shared_ptr<const EndpointSnapshot>> result;
+    result.reserve(slots_.size());
+    for (const auto &slot : slots_) {
+        result.push_back(std::atomic_load(&slot->snapshot));
+    }
+    return result;
+}
+
+TaskPlatform::PlatformStatistics PlatformAggregator::totals() {
+    TaskPlatform::PlatformStatistics totals{};
+    totals.start_time = created_at_;
+    for (const auto &snapshot : endpoints()) {
+        if (!snapshot->has_data) {
+            continue;
+        }
+        const auto &stats = snapshot->stats;
+        totals.total_tasks += stats.total_tasks;
+        totals.published_tasks += stats.published_tasks;
+        totals.claimed_tasks += stats.claimed_tasks;
+        totals.processing_tasks += stats.processing_tasks;
+        totals.completed_tasks += stats.completed_tasks;
+        totals.failed_tasks += stats.failed_tasks;
+        totals.abandoned_tasks += stats.abandoned_tasks;
+        totals.total_claimers += stats.total_claimers;
+    }
+    return totals;
+}
+
+void PlatformAggregator::refresh() {
+    if (slots_.empty()) {
+        return;
+    }
+    // 第一个端点在当前线程抓取，其余各开一个线程，总耗时约等于最慢的那个端点
+    std::vector<std::thread> workers;
+    workers.reserve(slots_.size() - 1);
+    for (size_t i = 1; i < slots_.size(); ++i) {
+        Slot *slot = slots_[i].get();
+        workers.emplace_back([this, slot]() { _scrape(*slot); });
+    }
+    _scrape(*slots_[0]);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+void PlatformAggregator::set_interval(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    options_.interval = interval;
+    _update_live();
+    if (stopped_) {
+        return;
+    }
+    if (interval.count() <= 0) {
+        _stop_threads(lock);
+        return;
+    }
+    if (!slots_.empty() && slots_[0]->thread.joinable()) {
+        ++interval_epoch_;
+        cv_.notify_all();
+    } else {
+        _start_threads();
+    }
+}
+
+std::chrono::milliseconds PlatformAggregator::interval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return options_.interval;
+}
+
+const PlatformAggregator::Options &PlatformAggregator::options() const noexcept {
+    return options_;
+}
+
+void PlatformAggregator::stop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    stopped_ = true;
+    _update_live();
+    _stop_threads(lock);
+}
+
+void PlatformAggregator::_scrape(Slot &slot) {
+    std::lock_guard<std::mutex> lock(slot.scrape_mutex);
+    const auto started = std::chrono::steady_clock::now();
+    const auto deadline = started + options_.timeout;
+
+    // 在上一份结果的基础上修改：失败时沿用上次的统计与任务列表
+    auto next = std::make_shared<EndpointSnapshot>(*std::atomic_load(&slot.snapshot));
+    next->attempted_at = std::chrono::system_clock::now();
+
+    std::string error;
+    bool ok = false;
+    if (!slot.client->is_valid()) {
+        error = "invalid endpoint " + slot.endpoint;
+    } else {
+        ok = slot.fetch_metrics(error);
+    }
+    if (ok && slot.synced) {
+        ok = slot.sync_changes(options_.max_tasks_per_endpoint, deadline, error);
+    }
+    if (ok && !slot.synced) {
+        // 首次抓取、对端要求重置或对端不支持增量同步
+        ok = slot.sync_full(options_.max_tasks_per_endpoint, deadline, error);
+    }
+
+    if (ok) {
+        next->reachable = true;
+        next->has_data = true;
+        next->last_error.clear();
+        next->stats = slot.stats;
+        next->stats.start_time = created_at_;
+        if (slot.mirror_changed) {
+            // 只在镜像变化时重建列表，否则继续共享上一份
+            auto tasks = std::make_shared<std::vector<TaskView>>();
+            tasks->reserve(slot.mirror.size());
+            for (const auto &entry : slot.mirror) {
+                tasks->push_back(entry.second);
+            }
+            next->tasks = std::move(tasks);
+            slot.mirror_changed = false;
+        }
+        next->tasks_truncated = slot.truncated;
+        next->updated_at = std::chrono::system_clock::now();
+        next->consecutive_failures = 0;
+    } else {
+        next->reachable = false;
+        next->last_error = error;
+        ++next->consecutive_failures;
+    }
+    next->scrape_duration =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - started);
+    std::atomic_store(&slot.snapshot, std::shared_ptr<const EndpointSnapshot>(std::move(next)));
+}
+
+void PlatformAggregator::_run(Slot &slot) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        _scrape(slot);
+        lock.lock();
+        std::uint64_t epoch = interval_epoch_;
+        while (!stopping_) {
+            if (!cv_.wait_for(lock, options_.interval, [&]() { return stopping_ || interval_epoch_ != epoch; })) {
+                break;  // 到达刷新时间
+            }
+            epoch = interval_epoch_;  // 间隔已修改：按新间隔重新计时
+        }
+    }
+}
+
+void PlatformAggregator::_start_threads() {
+    for (auto &slot : slots_) {
+        Slot *target = slot.get();
+        slot->thread = std::thread([this, target]() { _run(*target); });
+    }
+}
+
+void PlatformAggregator::_stop_threads(std::unique_lock<std::mutex> &lock) {
+    if (slots_.empty() || !slots_[0]->thread.joinable()) {
+        return;
+    }
+    stopping_ = true;
+    std::vector<std::thread> threads;
+    for (auto &slot : slots_) {
+        threads.push_back(std::move(slot->thread));
+        slot->client->stop();  // 中断进行中的请求，不必等到超时
+    }
+    lock.unlock();
+    cv_.notify_all();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    lock.lock();
+    stopping_ = false;
+}
+
+void PlatformAggregator::_update_live() {
+    live_.store(options_.interval.count() <= 0 && !stopped_, std::memory_order_release);
+}
+
+} // namespace youdidit
+} // namespace xswl
@@ -1,28 +1,382 @@
 #include <xswl/youdidit/web/time_replay.hpp>
+#include <xswl/youdidit/web/event_store.hpp>
+#include <algorithm>
+#include <iterator>
+#include <set>
 
 namespace xswl {
 namespace youdidit {
 
+namespace {
+    // 持有任务的状态：计入申领者负载
+    bool holds_claim(TaskStatus status) {
+        return status == TaskStatus::Claimed || status == TaskStatus::Processing || status == TaskStatus::Paused;
+    }
+}
+
+const size_t TimeReplay::kStatusCount;
+const std::uint32_t TimeReplay::kNoClaimer;
+
 TimeReplay::TimeReplay(EventLog *event_log, TaskPlatform *platform)
-    : event_log_(event_log), platform_(platform) {}
+    : event_log_(event_log), platform_(platform) {
+    current_.by_status.fill(0);
+}
+
+TimeReplay::~TimeReplay() {
+    stop_recording();
+}
+
+bool TimeReplay::start_recording() {
+    return start_recording(RecordingOptions());
+}
+
+bool TimeReplay::start_recording(const RecordingOptions &options) {
+    if (!platform_) {
+        return false;
+    }
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        if (recording_) {
+            return false;
+        }
+        recording_ = true;
+        recording_options_ = options;
+        if (recording_options_.checkpoint_interval == 0) {
+            recording_options_.checkpoint_interval = 1;
+        }
+        recording_started_ = std::chrono::system_clock::now();
+        checkpoints_.clear();
+    }
+
+    // 先订阅再取基线：持有 history_mutex_ 建立基线，期间到达的批次在回调中等待；
+    // 与基线重叠的转换按跟踪状态过滤（见 _record）
+    std::uint64_t id = platform_->subscribe_lifecycle_batches(
+        [this](const std::vector<TaskLifecycleRecord> &records) {
+            std::lock_guard<std::mutex> lock(history_mutex_);
+            _record(records);
+        },
+        recording_options_.batch);
+
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    subscription_id_ = id;
+    seen_dropped_ = 0;
+    deltas_.clear();
+    first_delta_index_ = 0;
+    last_delta_at_ = recording_started_;
+    _rebuild_baseline(recording_started_);
+    return true;
+}
+
+void TimeReplay::stop_recording() {
+    std::uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        if (!recording_) {
+            return;
+        }
+        recording_ = false;
+        id = subscription_id_;
+        subscription_id_ = 0;
+        tracked_.clear();
+    }
+    // 取消订阅会投递剩余记录并等待回调结束，不能持有 history_mutex_
+    if (id != 0) {
+        platform_->unsubscribe_lifecycle_batches(id);
+    }
+}
+
+bool TimeReplay::is_recording() const {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return recording_;
+}
+
+void TimeReplay::sync() {
+    if (platform_ && is_recording()) {
+        platform_->flush_lifecycle_batches();
+    }
+}
 
 TimeReplay::Snapshot TimeReplay::snapshot_at(const Timestamp &at) const {
     Snapshot snap{};
     snap.at = at;
-    if (platform_) {
+    bool recorded = false;
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        if (!checkpoints_.empty()) {
+            State state;
+            size_t next = _seek(at, state);
+            _advance(state, next, at);
+            _fill(snap, state);
+            recorded = true;
+        }
+    }
+    if (!recorded && platform_) {
         auto stats = platform_->get_statistics();
         snap.total_tasks = stats.total_tasks;
         snap.completed_tasks = stats.completed_tasks;
         snap.failed_tasks = stats.failed_tasks;
+        snap.published_tasks = stats.published_tasks;
+        snap.claimed_tasks = stats.claimed_tasks;
+        snap.processing_tasks = stats.processing_tasks;
+        snap.abandoned_tasks = stats.abandoned_tasks;
     }
     if (event_log_) {
         EventLog::Filter f;
         f.end_time = at;
-        snap.events_count = event_log_->get_events(f).size();
+        snap.events_count = event_log_->count_events(f);
     }
     return snap;
 }
 
+std::vector<TimeReplay::Snapshot> TimeReplay::timeline(const Timestamp &start, const Timestamp &end,
+                                                       size_t points) const {
+    std::vector<Snapshot> result;
+    if (points == 0 || end < start) {
+        return result;
+    }
+    result.resize(points);
+    const Timestamp::duration span = end - start;
+    for (size_t i = 0; i < points; ++i) {
+        result[i].at = points == 1 ? end : start + span * static_cast<Timestamp::rep>(i) /
+                                                       static_cast<Timestamp::rep>(points - 1);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        if (!checkpoints_.empty()) {
+            // 只定位一次，之后每个采样点只应用与上一个采样点之间的增量
+            State state;
+            size_t next = _seek(result.front().at, state);
+            for (auto &snap : result) {
+                next = _advance(state, next, snap.at);
+                _fill(snap, state);
+            }
+        } else if (platform_) {
+            auto stats = platform_->get_statistics();
+            for (auto &snap : result) {
+                snap.total_tasks = stats.total_tasks;
+                snap.completed_tasks = stats.completed_tasks;
+                snap.failed_tasks = stats.failed_tasks;
+                snap.published_tasks = stats.published_tasks;
+                snap.claimed_tasks = stats.claimed_tasks;
+                snap.processing_tasks = stats.processing_tasks;
+                snap.abandoned_tasks = stats.abandoned_tasks;
+            }
+        }
+    }
+    if (event_log_) {
+        for (auto &snap : result) {
+            EventLog::Filter f;
+            f.end_time = snap.at;
+            snap.events_count = event_log_->count_events(f);
+        }
+    }
+    return result;
+}
+
+size_t TimeReplay::checkpoint_count() const {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return checkpoints_.size();
+}
+
+size_t TimeReplay::delta_count() const {
+    std::lock_guard<std::mutex> lock(history_mutex_);
+    return deltas_.size();
+}
+
+void TimeReplay::_record(const std::vector<TaskLifecycleRecord> &records) {
+    if (!recording_ || checkpoints_.empty()) {
+        return;
+    }
+    // 订阅缓冲溢出丢弃过记录：跟踪状态已不可信，以平台当前状态重建基线
+    const std::uint64_t dropped = platform_->lifecycle_batch_dropped(subscription_id_);
+    if (dropped > seen_dropped_) {
+        seen_dropped_ = dropped;
+        _rebuild_baseline(std::max<Timestamp>(std::chrono::system_clock::now(), last_delta_at_));
+    }
+    for (const auto &record : records) {
+        auto it = tracked_.find(record.task_id);
+        Delta delta;
+        delta.claimer = kNoClaimer;
+        if (record.removed) {
+            if (it == tracked_.end()) {
+                continue;
+            }
+            delta.old_status = it->second.status;
+            delta.new_status = TaskStatus::Draft;
+            delta.claimer = it->second.claimer;
+            tracked_.erase(it);
+        } else if (it == tracked_.end()) {
+            if (record.old_status != TaskStatus::Draft) {
+                continue;  // 已删除任务仍在途的转换
+            }
+            delta.old_status = TaskStatus::Draft;
+            delta.new_status = record.new_status;
+            if (!record.claimer_id.empty()) {
+                delta.claimer = _intern_claimer(record.claimer_id);
+            }
+            tracked_[record.task_id] = TrackedTask{record.new_status, delta.claimer};
+        } else {
+            // 旧状态与跟踪状态不一致：基线已包含的转换（或其后续），忽略
+            if (record.old_status != it->second.status) {
+                continue;
+            }
+            delta.old_status = record.old_status;
+            delta.new_status = record.new_status;
+            if (!record.claimer_id.empty()) {
+                const std::uint32_t claimer = _intern_claimer(record.claimer_id);
+                // 释放负载记在原申领者上（放弃时记录中的申领者可能已清空或变化）
+                delta.claimer = holds_claim(record.new_status) || it->second.claimer == kNoClaimer
+                                    ? claimer : it->second.claimer;
+                it->second.claimer = claimer;
+            } else {
+                delta.claimer = it->second.claimer;
+            }
+            it->second.status = record.new_status;
+        }
+        // 批次之间的时间戳可能有少量乱序；增量流按到达顺序追加并把时间钳制为单调不减，
+        // 保证检查点之后的增量都不早于检查点
+        delta.at = std::max(record.timestamp, last_delta_at_);
+        last_delta_at_ = delta.at;
+        _push_delta(delta);
+    }
+    _prune(std::chrono::system_clock::now());
+}
+
+void TimeReplay::_push_delta(const Delta &delta) {
+    _apply(current_, delta);
+    deltas_.push_back(delta);
+    if (++deltas_since_checkpoint_ >= recording_options_.checkpoint_interval) {
+        checkpoints_.push_back(Checkpoint{delta.at, first_delta_index_ + deltas_.size(), current_});
+        deltas_since_checkpoint_ = 0;
+    }
+}
+
+void TimeReplay::_rebuild_baseline(const Timestamp &at) {
+    auto tasks = platform_->get_tasks();
+    tracked_.clear();
+    tracked_.reserve(tasks.size());
+    current_.by_status.fill(0);
+    current_.claimer_load.clear();
+    for (const auto &task : tasks) {
+        auto view = task->snapshot();
+        ++current_.by_status[static_cast<size_t>(view->status)];
+        std::uint32_t claimer = kNoClaimer;
+        if (!view->claimer_id.empty()) {
+            claimer = _intern_claimer(view->claimer_id);
+            if (holds_claim(view->status)) {
+                if (current_.claimer_load.size() <= claimer) {
+                    current_.claimer_load.resize(claimer + 1, 0);
+                }
+                ++current_.claimer_load[claimer];
+            }
+        }
+        tracked_[view->id] = TrackedTask{view->status, claimer};
+    }
+    current_.by_status[static_cast<size_t>(TaskStatus::Draft)] = 0;
+    deltas_since_checkpoint_ = 0;
+    last_delta_at_ = at;
+    checkpoints_.push_back(Checkpoint{at, first_delta_index_ + deltas_.size(), current_});
+}
+
+std::uint32_t TimeReplay::_intern_claimer(const std::string &claimer_id) {
+    auto it = claimer_ids_.find(claimer_id);
+    if (it != claimer_ids_.end()) {
+        return it->second;
+    }
+    std::uint32_t id = static_cast<std::uint32_t>(claimer_names_.size());
+    claimer_names_.push_back(claimer_id);
+    claimer_ids_[claimer_id] = id;
+    return id;
+}
+
+void TimeReplay::_apply(State &state, const Delta &delta) {
+    // Draft 任务不在平台中，从 Draft 转出即为新任务
+    if (delta.old_status != TaskStatus::Draft) {
+        --state.by_status[static_cast<size_t>(delta.old_status)];
+    }
+    if (delta.new_status != TaskStatus::Draft) {
+        ++state.by_status[static_cast<size_t>(delta.new_status)];
+    }
+    if (delta.claimer == kNoClaimer) {
+        return;
+    }
+    const bool held_before = holds_claim(delta.old_status);
+    const bool held_after = holds_claim(delta.new_status);
+    if (held_before == held_after) {
+        return;
+    }
+    if (state.claimer_load.size() <= delta.claimer) {
+        state.claimer_load.resize(delta.claimer + 1, 0);
+    }
+    int &load = state.claimer_load[delta.claimer];
+    load = held_after ? load + 1 : std::max(0, load - 1);
+}
+
+size_t TimeReplay::_seek(const Timestamp &at, State &state) const {
+    // 最后一个不晚于 at 的检查点；早于所有检查点时使用最早的检查点
+    size_t lo = 0;
+    size_t hi = checkpoints_.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (at < checkpoints_[mid].at) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+    const Checkpoint &checkpoint = checkpoints_[lo == 0 ? 0 : lo - 1];
+    state = checkpoint.state;
+    return static_cast<size_t>(checkpoint.delta_index - first_delta_index_);
+}
+
+size_t TimeReplay::_advance(State &state, size_t from, const Timestamp &at) const {
+    size_t index = from;
+    while (index < deltas_.size() && !(at < deltas_[index].at)) {
+        _apply(state, deltas_[index]);
+        ++index;
+    }
+    return index;
+}
+
+void TimeReplay::_fill(Snapshot &snap, const State &state) const {
+    auto count = [&state](TaskStatus status) {
+        return static_cast<size_t>(std::max<std::int64_t>(0, state.by_status[static_cast<size_t>(status)]));
+    };
+    snap.total_tasks = 0;
+    for (size_t i = 0; i < kStatusCount; ++i) {
+        snap.total_tasks += static_cast<size_t>(std::max<std::int64_t>(0, state.by_status[i]));
+    }
+    snap.published_tasks = count(TaskStatus::Published);
+    snap.claimed_tasks = count(TaskStatus::Claimed);
+    snap.processing_tasks = count(TaskStatus::Processing);
+    snap.completed_tasks = count(TaskStatus::Completed);
+    snap.failed_tasks = count(TaskStatus::Failed);
+    snap.abandoned_tasks = count(TaskStatus::Abandoned);
+    snap.claimer_load.clear();
+    for (size_t i = 0; i < state.claimer_load.size(); ++i) {
+        if (state.claimer_load[i] > 0) {
+            snap.claimer_load[claimer_names_[i]] = state.claimer_load[i];
+        }
+    }
+}
+
+void TimeReplay::_prune(const Timestamp &now) {
+    if (recording_options_.history_window.count() <= 0) {
+        return;
+    }
+    // 只在检查点处截断：第二个检查点仍早于窗口起点时，第一个检查点及其增量都不再需要
+    const Timestamp horizon = now - recording_options_.history_window;
+    while (checkpoints_.size() > 1 && checkpoints_[1].at < horizon) {
+        checkpoints_.pop_front();
+        const std::uint64_t keep_from = checkpoints_.front().delta_index;
+        while (first_delta_index_ < keep_from && !deltas_.empty()) {
+            deltas_.pop_front();
+            ++first_delta_index_;
+        }
+    }
+}
+
 std::vector<EventLog::Event> TimeReplay::events_between(const Timestamp &start, const Timestamp &end) const {
     if (!event_log_) {
         return {};
@@ -30,7 +384,43 @@ std::vector<EventLog::Event> TimeReplay::events_between(const Timestamp &start,
     EventLog::Filter f;
     f.start_time = start;
     f.end_time = end;
-    return event_log_->get_events(f);
+    std::vector<EventLog::Event> recent = event_log_->get_events(f);
+    std::shared_ptr<EventStore> store = event_log_->store();
+    if (!store) {
+        return recent;
+    }
+
+    // 内存中只保留最近的事件，更早的部分从持久化存储按时间索引读取
+    EventLog::Page oldest = event_log_->get_events_page(EventLog::Filter{}, 1);
+    if (!oldest.events.empty() && oldest.events.front().timestamp < start) {
+        return recent;
+    }
+    EventLog::Filter history_filter = f;
+    std::set<std::uint64_t> boundary_sequences;
+    if (!oldest.events.empty()) {
+        const Timestamp boundary = oldest.events.front().timestamp;
+        history_filter.end_time = std::min(end, boundary);
+        // 与内存中最早事件同一时刻的事件可能两边都有，按序号去重
+        for (const auto &ev : recent) {
+            if (ev.timestamp != boundary) {
+                break;
+            }
+            boundary_sequences.insert(ev.sequence);
+        }
+    }
+    std::vector<EventLog::Event> events;
+    store->for_each_event(history_filter, [&](const EventLog::Event &ev) {
+        if (boundary_sequences.count(ev.sequence) == 0) {
+            events.push_back(ev);
+        }
+        return true;
+    });
+    // 段内按追加顺序保存，合并前统一为 (timestamp, sequence) 顺序
+    std::sort(events.begin(), events.end(), [](const EventLog::Event &a, const EventLog::Event &b) {
+        return a.timestamp < b.timestamp || (a.timestamp == b.timestamp && a.sequence < b.sequence);
+    });
+    events.insert(events.end(), std::make_move_iterator(recent.begin()), std::make_move_iterator(recent.end()));
+    return events;
 }
 
 } // namespace youdidit
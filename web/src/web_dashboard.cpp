@@ -6,22 +6,6 @@
 namespace xswl {
 namespace youdidit {
 
-namespace {
-TaskPlatform::PlatformStatistics make_zero_stats() {
-    TaskPlatform::PlatformStatistics stats{};
-    stats.start_time = std::chrono::system_clock::now();
-    stats.total_tasks = 0;
-    stats.published_tasks = 0;
-    stats.claimed_tasks = 0;
-    stats.processing_tasks = 0;
-    stats.completed_tasks = 0;
-    stats.failed_tasks = 0;
-    stats.abandoned_tasks = 0;
-    stats.total_claimers = 0;
-    return stats;
-}
-}
-
 WebDashboard::WebDashboard(TaskPlatform *platform)
     : platform_(platform),
       event_log_(nullptr),
@@ -31,19 +15,33 @@ WebDashboard::WebDashboard(TaskPlatform *platform)
       running_(false),
       port_(0),
       https_enabled_(false) {
-    owned_event_log_.reset(new EventLog());
+    owned_event_log_.reset(new EventLog(max_event_history_));
     event_log_ = owned_event_log_.get();
     time_replay_ = std::make_shared<TimeReplay>(event_log_, platform_);
+    // 记录状态转换检查点与增量，供时间回放与 24 小时拖动使用
+    time_replay_->start_recording();
+    metrics_snapshotter_ = std::make_shared<MetricsSnapshotter>(platform_, event_log_,
+                                                                std::chrono::milliseconds(update_interval_ms_));
 }
 
 WebDashboard::WebDashboard(const std::string &metrics_endpoint)
-    : WebDashboard(static_cast<TaskPlatform *>(nullptr)) {
-    endpoints_.push_back(metrics_endpoint);
-}
+    : WebDashboard(metrics_endpoint, PlatformAggregator::Options()) {}
+
+WebDashboard::WebDashboard(const std::string &metrics_endpoint, const PlatformAggregator::Options &options)
+    : WebDashboard(std::vector<std::string>(1, metrics_endpoint), options) {}
 
 WebDashboard::WebDashboard(const std::vector<std::string> &endpoints)
+    : WebDashboard(endpoints, PlatformAggregator::Options()) {}
+
+WebDashboard::WebDashboard(const std::vector<std::string> &endpoints, const PlatformAggregator::Options &options)
     : WebDashboard(static_cast<TaskPlatform *>(nullptr)) {
     endpoints_ = endpoints;
+    // 以调用方给出的抓取间隔为准，指标快照沿用同一间隔
+    update_interval_ms_ = static_cast<int>(options.interval.count());
+    metrics_snapshotter_->set_interval(options.interval);
+    aggregator_ = std::make_shared<PlatformAggregator>(endpoints_, options);
+    std::shared_ptr<PlatformAggregator> aggregator = aggregator_;
+    metrics_snapshotter_->set_statistics_source([aggregator]() { return aggregator->totals(); });
 }
 
 WebDashboard::~WebDashboard() = default;
@@ -63,16 +61,45 @@ bool WebDashboard::is_running() const noexcept {
 
 WebDashboard &WebDashboard::set_update_interval(int milliseconds) {
     update_interval_ms_ = milliseconds;
+    if (aggregator_) {
+        aggregator_->set_interval(std::chrono::milliseconds(milliseconds));
+    }
+    metrics_snapshotter_->set_interval(std::chrono::milliseconds(milliseconds));
     return *this;
 }
 
 WebDashboard &WebDashboard::set_log_file_path(const std::string &path) {
+    return set_log_file_path(path, EventStore::Options());
+}
+
+WebDashboard &WebDashboard::set_log_file_path(const std::string &path, const EventStore::Options &options) {
     log_file_path_ = path;
+    // 先释放旧存储（写完缓冲区），避免新旧存储同时写同一组段文件
+    if (event_log_) {
+        event_log_->attach_store(nullptr);
+    }
+    event_store_.reset();
+    if (path.empty()) {
+        return *this;
+    }
+
+    EventStore::Options store_options = options;
+    store_options.base_path = path;
+    auto opened = EventStore::open(store_options);
+    if (opened) {
+        event_store_ = opened.value();
+        if (event_log_) {
+            event_log_->attach_store(event_store_);
+        }
+    }
     return *this;
 }
 
 WebDashboard &WebDashboard::set_max_event_history(size_t max_events) {
     max_event_history_ = max_events;
+    if (event_log_) {
+        event_log_->set_capacity(max_events);
+    }
     return *this;
 }
 
@@ -84,34 +111,65 @@ WebDashboard &WebDashboard::enable_https(const std::string &cert_path, const std
 }
 
 WebDashboard::DashboardMetrics WebDashboard::get_metrics() const {
-    if (platform_) {
-        return platform_->get_statistics();
-    }
-    return _empty_metrics();
+    return metrics_snapshotter_->current()->stats;
+}
+
+std::shared_ptr<const MetricsSnapshot> WebDashboard::get_metrics_snapshot() const {
+    return metrics_snapshotter_->current();
+}
+
+std::shared_ptr<MetricsSnapshotter> WebDashboard::get_metrics_snapshotter() const {
+    return metrics_snapshotter_;
 }
 
 std::string WebDashboard::get_dashboard_data() const {
-    MetricsExporter exporter(platform_, event_log_);
+    MetricsExporter exporter(metrics_snapshotter_);
     return exporter.export_json();
 }
 
 std::vector<WebDashboard::TaskSummary> WebDashboard::get_tasks_summary() const {
     std::vector<TaskSummary> summaries;
+    if (aggregator_) {
+        // 合并各端点缓存的任务列表，不发起网络请求（刷新间隔 <= 0 时除外）
+        auto endpoints = aggregator_->endpoints();
+        size_t total = 0;
+        for (const auto &endpoint : endpoints) {
+            total += endpoint->tasks->size();
+        }
+        summaries.reserve(total);
+        for (const auto &endpoint : endpoints) {
+            for (const auto &view : *endpoint->tasks) {
+                TaskSummary summary;
+                summary.id = view.id;
+                summary.title = view.title;
+                summary.category = view.category;
+                summary.priority = view.priority;
+                summary.status = view.status;
+                summary.published_at = view.published_at;
+                summary.claimer_id = view.claimer_id;
+                summary.endpoint = endpoint->endpoint;
+                summaries.push_back(std::move(summary));
+            }
+        }
+        return summaries;
+    }
     if (!platform_) {
         return summaries;
     }
     auto tasks = platform_->get_tasks();
     summaries.reserve(tasks.size());
     for (const auto &task : tasks) {
+        // 一次快照读取全部字段，避免逐字段加锁且保证字段间一致
+        auto view = task->snapshot();
         TaskSummary summary;
-        summary.id = task->id();
-        summary.title = task->title();
-        summary.category = task->category();
-        summary.priority = task->priority();
-        summary.status = task->status();
-        summary.published_at = task->published_at();
-        summary.claimer_id = task->claimer_id();
-        summaries.push_back(summary);
+        summary.id = view->id;
+        summary.title = view->title;
+        summary.category = view->category;
+        summary.priority = view->priority;
+        summary.status = view->status;
+        summary.published_at = view->published_at;
+        summary.claimer_id = view->claimer_id;
+        summaries.push_back(std::move(summary));
     }
     return summaries;
 }
@@ -136,31 +194,55 @@ std::vector<WebDashboard::ClaimerSummary> WebDashboard::get_claimers_summary() c
     return summaries;
 }
 
+std::vector<std::shared_ptr<const EndpointSnapshot>> WebDashboard::get_endpoint_status() const {
+    if (!aggregator_) {
+        return std::vector<std::shared_ptr<const EndpointSnapshot>>();
+    }
+    return aggregator_->endpoints();
+}
+
+std::shared_ptr<PlatformAggregator> WebDashboard::get_aggregator() const {
+    return aggregator_;
+}
+
+TaskPlatform *WebDashboard::get_platform() const noexcept {
+    return platform_;
+}
+
 std::shared_ptr<TimeReplay> WebDashboard::get_time_replay() const {
     return time_replay_;
 }
 
+EventLog *WebDashboard::get_event_log() const {
+    return event_log_;
+}
+
+std::shared_ptr<EventStore> WebDashboard::get_event_store() const {
+    return event_store_;
+}
+
 std::vector<std::string> WebDashboard::get_event_logs(int limit, int offset) const {
     std::vector<std::string> logs;
-    if (!event_log_) {
+    if (!event_log_ || limit <= 0) {
         return logs;
     }
-    auto events = event_log_->get_events();
     if (offset < 0) {
         offset = 0;
     }
-    size_t begin = static_cast<size_t>(offset);
-    if (begin >= events.size()) {
-        return logs;
-    }
-    size_t end = std::min(begin + static_cast<size_t>(limit), events.size());
-    logs.reserve(end - begin);
-    for (size_t i = begin; i < end; ++i) {
-        const auto &ev = events[i];
+    // 直接在日志内遍历，跳过 offset 条后格式化 limit 条，不复制整个日志
+    size_t skip = static_cast<size_t>(offset);
+    size_t wanted = static_cast<size_t>(limit);
+    logs.reserve(std::min(wanted, event_log_->size()));
+    event_log_->for_each_event(EventLog::Filter{}, [&](const EventLog::Event &ev) {
+        if (skip > 0) {
+            --skip;
+            return true;
+        }
         std::ostringstream oss;
         oss << ev.timestamp.time_since_epoch().count() << "|" << ev.source << "|" << ev.message;
         logs.push_back(oss.str());
-    }
+        return logs.size() < wanted;
+    });
     return logs;
 }
 
@@ -198,8 +280,7 @@ std::string WebDashboard::export_as_json(const Timestamp &start, const Timestamp
         EventLog::Filter f;
         f.start_time = start;
         f.end_time = end;
-        auto events = event_log_->get_events(f);
-        oss << ",\"events_in_range\":" << events.size();
+        oss << ",\"events_in_range\":" << event_log_->count_events(f);
     }
     oss << "}";
     return oss.str();
@@ -225,10 +306,6 @@ std::string WebDashboard::export_as_csv(const Timestamp &start, const Timestamp
     return oss.str();
 }
 
-WebDashboard::DashboardMetrics WebDashboard::_empty_metrics() const {
-    return make_zero_stats();
-}
-
 std::string WebDashboard::_serialize_metrics_json(const DashboardMetrics &metrics) const {
     std::ostringstream oss;
     oss << "\"total_tasks\":" << metrics.total_tasks << ",";
@@ -1,50 +1,598 @@
 #include <xswl/youdidit/web/web_server.hpp>
+#include <xswl/youdidit/web/event_stream.hpp>
+#include <xswl/youdidit/web/json_writer.hpp>
 #include <httplib.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 namespace xswl {
 namespace youdidit {
 
-WebServer::WebServer(WebDashboard *dashboard, int port)
-    : dashboard_(dashboard), host_("0.0.0.0"), port_(port), running_(false), http_server_(nullptr) {}
+namespace {
+// 分块输出时每次回调序列化的元素数
+const size_t kStreamChunkItems = 256;
+
+// 等待降载线程应答 503 的连接上限，超过后直接关闭连接
+const size_t kMaxPendingShed = 128;
+
+// 当前线程正在处理被降载的连接：预路由处理器直接应答 503
+thread_local bool tl_shedding = false;
+
+// 有界工作线程池：等待队列已满时把连接转交降载线程，而不是像 httplib::ThreadPool 那样直接关闭
+class SheddingTaskQueue : public httplib::TaskQueue {
+public:
+    SheddingTaskQueue(size_t worker_threads, size_t max_queued, std::atomic<std::uint64_t> *shed_count)
+        : max_queued_(max_queued), shed_count_(shed_count) {
+        workers_.reserve(worker_threads);
+        for (size_t i = 0; i < worker_threads; ++i) {
+            workers_.emplace_back([this]() { _run(jobs_, jobs_cv_); });
+        }
+        if (max_queued_ > 0) {
+            shedder_ = std::thread([this]() {
+                tl_shedding = true;
+                _run(shed_jobs_, shed_cv_);
+            });
+        }
+    }
+
+    bool enqueue(std::function<void()> fn) override {
+        bool shed = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (max_queued_ == 0 || jobs_.size() < max_queued_) {
+                jobs_.push_back(std::move(fn));
+            } else {
+                shed_count_->fetch_add(1, std::memory_order_relaxed);
+                if (shed_jobs_.size() >= kMaxPendingShed) {
+                    return false;  // httplib 直接关闭连接
+                }
+                shed_jobs_.push_back(std::move(fn));
+                shed = true;
+            }
+        }
+        (shed ? shed_cv_ : jobs_cv_).notify_one();
+        return true;
+    }
+
+    void shutdown() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        jobs_cv_.notify_all();
+        shed_cv_.notify_all();
+        for (auto &worker : workers_) {
+            worker.join();
+        }
+        if (shedder_.joinable()) {
+            shedder_.join();
+        }
+    }
+
+private:
+    // 处理队列中的连接直到关闭；关闭时先处理完已入队的连接
+    void _run(std::deque<std::function<void()>> &queue, std::condition_variable &cv) {
+        for (;;) {
+            std::function<void()> fn;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv.wait(lock, [&]() { return shutdown_ || !queue.empty(); });
+                if (queue.empty()) {
+                    return;
+                }
+                fn = std::move(queue.front());
+                queue.pop_front();
+            }
+            fn();
+        }
+    }
+
+    const size_t max_queued_;
+    std::atomic<std::uint64_t> *shed_count_;
+    std::mutex mutex_;
+    std::condition_variable jobs_cv_;
+    std::condition_variable shed_cv_;
+    std::deque<std::function<void()>> jobs_;
+    std::deque<std::function<void()>> shed_jobs_;
+    bool shutdown_{false};
+    std::vector<std::thread> workers_;
+    std::thread shedder_;
+};
+
+std::int64_t to_epoch_ms(const Timestamp &ts) {
+    return static_cast<std::int64_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(ts.time_since_epoch()).count());
+}
+
+Timestamp from_epoch_ms(std::int64_t ms) {
+    return Timestamp(std::chrono::duration_cast<Timestamp::duration>(std::chrono::milliseconds(ms)));
+}
+
+// 读取整数查询参数；缺失或无法解析时返回 fallback
+std::int64_t int_param(const httplib::Request &req, const char *name, std::int64_t fallback) {
+    if (!req.has_param(name)) {
+        return fallback;
+    }
+    try {
+        return static_cast<std::int64_t>(std::stoll(req.get_param_value(name)));
+    } catch (...) {
+        return fallback;
+    }
+}
+
+// 严格读取整数查询参数：整个值必须是十进制整数且不溢出；缺失时保留 *value，格式错误时返回 false
+bool strict_int_param(const httplib::Request &req, const char *name, std::int64_t *value) {
+    if (!req.has_param(name)) {
+        return true;
+    }
+    const std::string text = req.get_param_value(name);
+    if (text.empty() || std::isspace(static_cast<unsigned char>(text[0]))) {
+        return false;
+    }
+    try {
+        size_t consumed = 0;
+        const long long parsed = std::stoll(text, &consumed);
+        if (consumed != text.size()) {
+            return false;
+        }
+        *value = static_cast<std::int64_t>(parsed);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
+// 列表接口的 limit 参数：默认 1000，限制在 [1, 5000]；格式错误时返回 false
+bool page_limit(const httplib::Request &req, size_t *limit) {
+    std::int64_t value = 1000;
+    if (!strict_int_param(req, "limit", &value)) {
+        return false;
+    }
+    *limit = static_cast<size_t>(std::max<std::int64_t>(1, std::min<std::int64_t>(value, 5000)));
+    return true;
+}
+
+// 响应体的强 ETag（FNV-1a 64 位）
+std::string entity_tag(const std::string &body) {
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : body) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    static const char kHex[] = "0123456789abcdef";
+    std::string tag(18, '"');
+    for (int i = 16; i >= 1; --i, hash >>= 4) {
+        tag[static_cast<size_t>(i)] = kHex[hash & 0xf];
+    }
+    return tag;
+}
+
+void send_json(httplib::Response &res, const JsonWriter &writer) {
+    res.set_content(writer.str(), "application/json");
+}
+
+void send_error(httplib::Response &res, int status, const std::string &message) {
+    JsonWriter writer;
+    writer.begin_object().field("error", message).end_object();
+    res.status = status;
+    send_json(res, writer);
+}
+
+// 以 chunked 方式发送 JSON：produce 每次向 writer 追加一段（返回 false 表示文档已写完），
+// 写出后清空缓冲区，内存占用只与单段大小有关
+void send_json_stream(httplib::Response &res, const std::function<bool(JsonWriter &)> &produce) {
+    auto writer = std::make_shared<JsonWriter>();
+    res.set_chunked_content_provider("application/json", [writer, produce](size_t, httplib::DataSink &sink) {
+        const bool more = produce(*writer);
+        if (writer->size() > 0) {
+            if (!sink.write(writer->str().data(), writer->size())) {
+                return false;
+            }
+            writer->clear();
+        }
+        if (!more) {
+            sink.done();
+        }
+        return true;
+    });
+}
+
+const size_t kBatchPublishChunk = 1024;       // 批量提交时每次 publish_tasks 的行数
+const size_t kMaxBatchLineBytes = 1 << 20;    // 批量提交的单行上限，超出的行整行拒绝
+
+// POST /api/tasks/batch：逐块接收请求体，按行解析任务描述，每 kBatchPublishChunk 行发布一次，逐行结果写入 results。
+// 请求体不整体缓存，内存占用只有一个未完整的行、一批待发布的任务和结果（每行几十字节）；
+// 结果至多 max_lines 项，之后的请求体只读取不处理，由调用方以 413 应答
+class TaskBatchIngest {
+public:
+    using HandlerMap = std::map<std::string, Task::TaskHandler>;
+
+    TaskBatchIngest(TaskPlatform *platform, std::shared_ptr<const HandlerMap> handlers, JsonWriter &results,
+                    size_t max_lines)
+        : platform_(platform), handlers_(std::move(handlers)), results_(results), builder_(platform),
+          max_lines_(std::max<size_t>(1, max_lines)) {
+        pending_.reserve(kBatchPublishChunk);
+        tasks_.reserve(kBatchPublishChunk);
+    }
+
+    // 接收一段请求体；完整的行直接在块内解析，跨块的行先拼接
+    bool feed(const char *data, size_t size) {
+        if (next_line_ > 0) {
+            return true;  // 已达行数上限：读完请求体以便正常应答，但不再解析
+        }
+        const char *end = data + size;
+        while (data < end) {
+            const char *newline = static_cast<const char *>(std::memchr(data, '\n', static_cast<size_t>(end - data)));
+            const char *stop = newline ? newline : end;
+            const size_t length = static_cast<size_t>(stop - data);
+            if (!oversized_) {
+                if (partial_.size() + length > kMaxBatchLineBytes) {
+                    oversized_ = true;
+                    std::string().swap(partial_);
+                } else if (!newline || !partial_.empty()) {
+                    partial_.append(data, length);
+                }
+            }
+            if (!newline) {
+                break;
+            }
+            _end_line(data, stop);
+            if (next_line_ > 0) {
+                break;
+            }
+            data = newline + 1;
+        }
+        return true;
+    }
+
+    // 请求体结束：处理没有换行结尾的最后一行并发布剩余任务
+    void finish() {
+        if (next_line_ == 0 && (oversized_ || !partial_.empty())) {
+            _end_line(nullptr, nullptr);
+        }
+        _flush();
+    }
+
+    size_t accepted() const noexcept { return accepted_; }
+    size_t rejected() const noexcept { return rejected_; }
+    // 因行数上限未处理的第一行的行号；0 表示整个请求体都已处理
+    size_t next_line() const noexcept { return next_line_; }
+
+private:
+    struct Entry {
+        size_t line;
+        std::shared_ptr<Task> task;   // 为空表示该行被拒绝
+        std::string error;
+    };
+
+    void _end_line(const char *begin, const char *end) {
+        ++line_no_;
+        if (accepted_ + rejected_ + pending_.size() >= max_lines_ && (oversized_ || !_blank(begin, end))) {
+            next_line_ = line_no_;
+            std::string().swap(partial_);
+            oversized_ = false;
+            return;
+        }
+        if (oversized_) {
+            oversized_ = false;
+            _reject("line too long");
+        } else if (!partial_.empty()) {
+            _line(partial_.data(), partial_.data() + partial_.size());
+            partial_.clear();
+        } else if (begin) {
+            _line(begin, end);
+        }
+        if (pending_.size() >= kBatchPublishChunk) {
+            _flush();
+        }
+    }
+
+    // 当前行（跨块的行在 partial_ 中）是否只含空白
+    bool _blank(const char *begin, const char *end) const {
+        if (!partial_.empty()) {
+            begin = partial_.data();
+            end = partial_.data() + partial_.size();
+        }
+        for (; begin < end; ++begin) {
+            if (!std::isspace(static_cast<unsigned char>(*begin))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void _line(const char *begin, const char *end) {
+        while (begin < end && std::isspace(static_cast<unsigned char>(end[-1]))) {
+            --end;
+        }
+        while (begin < end && std::isspace(static_cast<unsigned char>(*begin))) {
+            ++begin;
+        }
+        if (begin == end) {
+            return;  // 空行不产生结果
+        }
+        auto spec = nlohmann::json::parse(begin, end, nullptr, false);
+        if (spec.is_discarded() || !spec.is_object()) {
+            _reject("invalid JSON object");
+            return;
+        }
+        std::string error;
+        auto task = _build(spec, error);
+        if (!task) {
+            _reject(error);
+            return;
+        }
+        pending_.push_back(Entry{line_no_, std::move(task), std::string()});
+    }
+
+    void _reject(const std::string &error) {
+        pending_.push_back(Entry{line_no_, nullptr, error});
+    }
+
+    std::shared_ptr<Task> _build(const nlohmann::json &spec, std::string &error) {
+        builder_.reset();
+        for (auto it = spec.begin(); it != spec.end(); ++it) {
+            const std::string &key = it.key();
+            const nlohmann::json &value = it.value();
+            if (key == "title" || key == "description" || key == "category" || key == "handler") {
+                if (!value.is_string()) {
+                    error = "field '" + key + "' must be a string";
+                    return nullptr;
+                }
+                const std::string &text = value.get_ref<const std::string &>();
+                if (key == "title") {
+                    builder_.title(text);
+                } else if (key == "description") {
+                    builder_.description(text);
+                } else if (key == "category") {
+                    builder_.category(text);
+                } else {
+                    auto handler = handlers_ ? handlers_->find(text) : HandlerMap::const_iterator();
+                    if (!handlers_ || handler == handlers_->end()) {
+                        error = "unknown handler: " + text;
+                        return nullptr;
+                    }
+                    builder_.handler(handler->second);
+                }
+            } else if (key == "priority") {
+                if (!value.is_number_integer()) {
+                    error = "field 'priority' must be an integer";
+                    return nullptr;
+                }
+                builder_.priority(value.get<int>());
+            } else if (key == "tags") {
+                if (!value.is_array()) {
+                    error = "field 'tags' must be an array of strings";
+                    return nullptr;
+                }
+                for (const auto &tag : value) {
+                    if (!tag.is_string()) {
+                        error = "field 'tags' must be an array of strings";
+                        return nullptr;
+                    }
+                    builder_.add_tag(tag.get_ref<const std::string &>());
+                }
+            } else if (key == "metadata") {
+                if (!value.is_object()) {
+                    error = "field 'metadata' must be an object";
+                    return nullptr;
+                }
+                for (auto entry = value.begin(); entry != value.end(); ++entry) {
+                    // 非字符串的值按 JSON 文本保存
+                    builder_.metadata(entry.key(), entry.value().is_string()
+                                                       ? entry.value().get_ref<const std::string &>()
+                                                       : entry.value().dump());
+                }
+            }
+            // 其他字段忽略，便于客户端携带自己的附加信息
+        }
+
+        auto task = builder_.build();
+        if (!task) {
+            for (const auto &message : builder_.validation_errors()) {
+                error += error.empty() ? message : "; " + message;
+            }
+        }
+        return task;
+    }
+
+    void _flush() {
+        tasks_.clear();
+        for (const auto &entry : pending_) {
+            if (entry.task) {
+                tasks_.push_back(entry.task);
+            }
+        }
+        auto published = tasks_.empty() ? std::vector<tl::expected<TaskId, Error>>()
+                                        : platform_->publish_tasks(tasks_);
+        size_t next = 0;
+        for (const auto &entry : pending_) {
+            results_.begin_object().field("line", entry.line);
+            if (!entry.task) {
+                results_.field("error", entry.error);
+                ++rejected_;
+            } else if (published[next].has_value()) {
+                results_.field("id", published[next].value());
+                ++accepted_;
+                ++next;
+            } else {
+                results_.field("error", published[next].error().message);
+                ++rejected_;
+                ++next;
+            }
+            results_.end_object();
+        }
+        pending_.clear();
+        tasks_.clear();
+    }
+
+    TaskPlatform *platform_;
+    std::shared_ptr<const HandlerMap> handlers_;
+    JsonWriter &results_;
+    TaskBuilder builder_;
+    const size_t max_lines_;
+    size_t next_line_ = 0;
+    std::string partial_;
+    bool oversized_ = false;
+    size_t line_no_ = 0;
+    std::vector<Entry> pending_;
+    std::vector<std::shared_ptr<Task>> tasks_;
+    size_t accepted_ = 0;
+    size_t rejected_ = 0;
+};
+
+// 写入任务摘要的公共字段（不结束对象，调用方可继续追加字段）
+void write_task_fields(JsonWriter &w, const TaskView &task) {
+    w.begin_object()
+        .field("id", task.id)
+        .field("title", task.title)
+        .field("category", task.category)
+        .field("priority", task.priority)
+        .field("status", to_string(task.status))
+        .field("published_at", to_epoch_ms(task.published_at))
+        .field("claimer_id", task.claimer_id);
+}
+
+void write_metrics_json(JsonWriter &w, const WebDashboard::DashboardMetrics &metrics, std::uint64_t sequence) {
+    w.begin_object()
+        .field("total_tasks", metrics.total_tasks)
+        .field("published_tasks", metrics.published_tasks)
+        .field("claimed_tasks", metrics.claimed_tasks)
+        .field("processing_tasks", metrics.processing_tasks)
+        .field("completed_tasks", metrics.completed_tasks)
+        .field("failed_tasks", metrics.failed_tasks)
+        .field("abandoned_tasks", metrics.abandoned_tasks)
+        .field("total_claimers", metrics.total_claimers)
+        .field("sequence", sequence)
+        .end_object();
+}
+
+void write_snapshot_json(JsonWriter &w, const TimeReplay::Snapshot &snap) {
+    w.begin_object().field("timestamp", to_epoch_ms(snap.at));
+    w.key("metrics").begin_object()
+        .field("total_tasks", snap.total_tasks)
+        .field("published_tasks", snap.published_tasks)
+        .field("claimed_tasks", snap.claimed_tasks)
+        .field("processing_tasks", snap.processing_tasks)
+        .field("completed_tasks", snap.completed_tasks)
+        .field("failed_tasks", snap.failed_tasks)
+        .field("abandoned_tasks", snap.abandoned_tasks)
+        .field("events_count", snap.events_count)
+        .end_object();
+    w.key("claimer_load").begin_object();
+    for (const auto &pair : snap.claimer_load) {
+        w.field(pair.first.c_str(), pair.second);
+    }
+    w.end_object().end_object();
+}
+}
+
+WebServer::WebServer(WebDashboard *dashboard, int port) : WebServer(dashboard, port, Options()) {}
+
+WebServer::WebServer(WebDashboard *dashboard, int port, const Options &options)
+    : dashboard_(dashboard), host_("0.0.0.0"), port_(port), options_(options), running_(false), bound_port_(0),
+      shed_count_(0), http_server_(nullptr) {}
 
 WebServer::~WebServer() noexcept {
     stop();
 }
 
-void WebServer::start() {
-    if (running_) return;
-    
+tl::expected<void, Error> WebServer::start() {
+    if (running_) return {};
+
+    httplib::Server *server = nullptr;
     try {
-        // Cast void* to httplib::Server*
-        httplib::Server *server = new httplib::Server();
+        server = new httplib::Server();
         http_server_ = static_cast<void*>(server);
-        
-        // Setup routes BEFORE starting server
+
+        const size_t workers = options_.worker_threads > 0 ? options_.worker_threads
+                                                           : static_cast<size_t>(CPPHTTPLIB_THREAD_POOL_COUNT);
+        const size_t max_queued = options_.max_queued_requests;
+        std::atomic<std::uint64_t> *shed_count = &shed_count_;
+        server->new_task_queue = [workers, max_queued, shed_count]() {
+            return new SheddingTaskQueue(workers, max_queued, shed_count);
+        };
+        // httplib 默认启用 SO_REUSEPORT，第二个实例会与已有服务共享端口并分走连接；只保留 SO_REUSEADDR，端口占用时绑定失败
+        server->set_socket_options([](socket_t sock) {
+            httplib::detail::set_socket_opt(sock, SOL_SOCKET, SO_REUSEADDR, 1);
+        });
+        server->set_keep_alive_max_count(std::max<size_t>(1, options_.keep_alive_max_count));
+        server->set_keep_alive_timeout(static_cast<time_t>(options_.keep_alive_timeout.count()));
+        server->set_read_timeout(options_.read_timeout);
+        server->set_write_timeout(options_.write_timeout);
+
+        // 降载线程上的请求不进入路由
+        const std::string retry_after = std::to_string(options_.retry_after.count());
+        server->set_pre_routing_handler([retry_after](const httplib::Request&, httplib::Response& res) {
+            if (!tl_shedding) {
+                return httplib::Server::HandlerResponse::Unhandled;
+            }
+            // 降载线程只有一个：应答后要求客户端关闭连接，不在 keep-alive 上等待下一个请求
+            res.set_header("Retry-After", retry_after);
+            res.set_header("Connection", "close");
+            send_error(res, 503, "server overloaded");
+            return httplib::Server::HandlerResponse::Handled;
+        });
+
+        if (dashboard_) {
+            // SSE 连接一直占用工作线程，上限须低于工作线程数，否则仪表板会占满线程池
+            EventStreamHub::Options hub_options;
+            hub_options.max_clients = options_.max_event_stream_clients > 0
+                                          ? std::min(options_.max_event_stream_clients, std::max<size_t>(1, workers - 1))
+                                          : std::max<size_t>(1, workers / 2);
+            event_hub_ = std::make_shared<EventStreamHub>(dashboard_->get_platform(), hub_options);
+        }
         _setup_routes();
 
-        // Start listening in background thread
-        // Official cpp-httplib: listen() is blocking, so run in thread
+        // 先在当前线程绑定并开始监听，返回后连接即可进入 backlog；端口为 0 时由系统分配
+        const int port = port_ == 0 ? server->bind_to_any_port(host_) : (server->bind_to_port(host_, port_) ? port_ : -1);
+        if (port < 0) {
+            delete server;
+            http_server_ = nullptr;
+            event_hub_.reset();
+            return tl::make_unexpected(
+                Error("Cannot bind " + host_ + ":" + std::to_string(port_), ErrorCode::NETWORK_BIND_FAILED));
+        }
+        bound_port_ = port;
+
         running_ = true;
-        server_thread_ = std::thread([this, server]() {
-            server->listen(host_.c_str(), port_);
+        server_thread_ = std::thread([server]() {
+            server->listen_after_bind();
         });
-        
-        // Give the server a moment to bind
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    } catch (...) {
+        // 接受循环开始前 httplib::Server::stop() 不生效，等它就绪后再返回，保证随后的 stop() 能结束线程
+        server->wait_until_ready();
+    } catch (const std::exception &e) {
         running_ = false;
-        if (http_server_) {
-            httplib::Server *server = static_cast<httplib::Server*>(http_server_);
-            delete server;
-            http_server_ = nullptr;
+        if (server_thread_.joinable()) {
+            server->stop();
+            server_thread_.join();
         }
+        delete server;
+        http_server_ = nullptr;
+        event_hub_.reset();
+        return tl::make_unexpected(Error(std::string("Cannot start web server: ") + e.what(),
+                                         ErrorCode::NETWORK_BIND_FAILED));
     }
+    return {};
 }
 
 void WebServer::stop() {
+    // 先关闭事件流，唤醒阻塞在 SSE 连接上的工作线程，否则 server->stop() 会等待它们
+    if (event_hub_) {
+        event_hub_->close();
+    }
     if (http_server_) {
         httplib::Server *server = static_cast<httplib::Server*>(http_server_);
         server->stop();
@@ -59,6 +607,7 @@ void WebServer::stop() {
         delete server;
         http_server_ = nullptr;
     }
+    event_hub_.reset();
 
     running_ = false;
 }
@@ -72,7 +621,7 @@ void WebServer::set_port(int port) {
 }
 
 int WebServer::get_port() const noexcept {
-    return port_;
+    return running_ ? bound_port_.load() : port_;
 }
 
 void WebServer::set_host(const std::string &host) {
@@ -83,6 +632,32 @@ const std::string &WebServer::host() const noexcept {
     return host_;
 }
 
+WebServer &WebServer::set_options(const Options &options) {
+    options_ = options;
+    return *this;
+}
+
+const WebServer::Options &WebServer::options() const noexcept {
+    return options_;
+}
+
+std::uint64_t WebServer::shed_count() const noexcept {
+    return shed_count_.load(std::memory_order_relaxed);
+}
+
+WebServer &WebServer::register_task_handler(const std::string &name, Task::TaskHandler handler) {
+    std::lock_guard<std::mutex> lock(task_handlers_mutex_);
+    auto current = std::atomic_load(&task_handlers_);
+    auto updated = current ? std::make_shared<TaskHandlerMap>(*current) : std::make_shared<TaskHandlerMap>();
+    if (handler) {
+        (*updated)[name] = std::move(handler);
+    } else {
+        updated->erase(name);
+    }
+    std::atomic_store(&task_handlers_, std::shared_ptr<const TaskHandlerMap>(std::move(updated)));
+    return *this;
+}
+
 void WebServer::_setup_routes() {
     if (!http_server_ || !dashboard_) return;
     
@@ -93,88 +668,400 @@ void WebServer::_setup_routes() {
         res.set_content(_get_dashboard_html(), "text/html; charset=utf-8");
     });
     
-    // REST API - 获取指标
-    server->Get("/api/metrics", [this](const httplib::Request&, httplib::Response& res) {
-        auto metrics = dashboard_->get_metrics();
-        
-        std::ostringstream oss;
-        oss << "{"
-            << "\"total_tasks\":" << metrics.total_tasks << ","
-            << "\"published_tasks\":" << metrics.published_tasks << ","
-            << "\"claimed_tasks\":" << metrics.claimed_tasks << ","
-            << "\"processing_tasks\":" << metrics.processing_tasks << ","
-            << "\"completed_tasks\":" << metrics.completed_tasks << ","
-            << "\"failed_tasks\":" << metrics.failed_tasks << ","
-            << "\"abandoned_tasks\":" << metrics.abandoned_tasks << ","
-            << "\"total_claimers\":" << metrics.total_claimers
-            << "}";
-        
-        res.set_content(oss.str(), "application/json");
+    // REST API - 获取指标（读取后台快照，不与申领者竞争平台锁）
+    server->Get("/api/metrics", [this](const httplib::Request& req, httplib::Response& res) {
+        // sequence：统计已包含的变更序号，事件流订阅方据此丢弃重复的增量
+        auto snapshot = dashboard_->get_metrics_snapshot();
+        JsonWriter writer;
+        write_metrics_json(writer, snapshot->stats, snapshot->change_sequence);
+        // 支持条件请求：指标未变化时轮询方只收到 304
+        const std::string etag = entity_tag(writer.str());
+        res.set_header("ETag", etag);
+        if (req.get_header_value("If-None-Match") == etag) {
+            res.status = 304;
+            return;
+        }
+        send_json(res, writer);
     });
     
-    // REST API - 获取任务摘要
-    server->Get("/api/tasks", [this](const httplib::Request&, httplib::Response& res) {
-        auto tasks = dashboard_->get_tasks_summary();
-        
-        std::ostringstream oss;
-        oss << "{\"tasks\":[";
-        for (size_t i = 0; i < tasks.size(); ++i) {
-            if (i > 0) oss << ",";
-            
-            auto published_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-                tasks[i].published_at.time_since_epoch()).count();
-            
-            oss << "{";
-            oss << "\"id\":\"" << tasks[i].id << "\",";
-            oss << "\"title\":\"" << tasks[i].title << "\",";
-            oss << "\"category\":\"" << tasks[i].category << "\",";
-            oss << "\"priority\":" << tasks[i].priority << ",";
-            oss << "\"status\":\"" << to_string(tasks[i].status) << "\",";
-            oss << "\"published_at\":" << published_ms << ",";
-            oss << "\"claimer_id\":\"" << tasks[i].claimer_id << "\"";
-            oss << "}";
-        }
-        oss << "],\"count\":" << tasks.size() << "}";
-        
-        res.set_content(oss.str(), "application/json");
+    // Prometheus 抓取端点（从后台快照渲染）
+    server->Get("/metrics", [this](const httplib::Request&, httplib::Response& res) {
+        MetricsExporter exporter(dashboard_->get_metrics_snapshotter());
+        res.set_content(exporter.export_prometheus(), "text/plain; version=0.0.4");
+    });
+
+    // REST API - 获取任务摘要（过滤、排序与游标分页在平台内完成，不复制完整任务列表；响应分块输出）
+    server->Get("/api/tasks", [this](const httplib::Request& req, httplib::Response& res) {
+        TaskPlatform *platform = dashboard_->get_platform();
+        if (!platform) {
+            // 聚合模式：返回各端点缓存的任务合并结果（不支持过滤与分页）
+            auto summaries = std::make_shared<std::vector<WebDashboard::TaskSummary>>(dashboard_->get_tasks_summary());
+            auto next = std::make_shared<size_t>(0);
+            send_json_stream(res, [summaries, next](JsonWriter &w) {
+                if (*next == 0) {
+                    w.begin_object().key("tasks").begin_array();
+                }
+                const size_t end = std::min(summaries->size(), *next + kStreamChunkItems);
+                for (; *next < end; ++*next) {
+                    const auto &task = (*summaries)[*next];
+                    w.begin_object()
+                        .field("id", task.id)
+                        .field("title", task.title)
+                        .field("category", task.category)
+                        .field("priority", task.priority)
+                        .field("status", to_string(task.status))
+                        .field("published_at", to_epoch_ms(task.published_at))
+                        .field("claimer_id", task.claimer_id)
+                        .field("endpoint", task.endpoint)
+                        .end_object();
+                }
+                if (*next < summaries->size()) {
+                    return true;
+                }
+                w.end_array().field("count", summaries->size()).key("next_cursor").null().end_object();
+                return false;
+            });
+            return;
+        }
+
+        // 增量同步：只返回自 since 以来变化的任务与墓碑
+        if (req.has_param("since")) {
+            std::int64_t since = -1;
+            if (!strict_int_param(req, "since", &since) || since < 0) {
+                send_error(res, 400, "invalid since");
+                return;
+            }
+            size_t limit = 0;
+            if (!page_limit(req, &limit)) {
+                send_error(res, 400, "invalid limit");
+                return;
+            }
+            auto changes = std::make_shared<TaskPlatform::ChangeSet>(
+                platform->get_changes_since(static_cast<std::uint64_t>(since), limit));
+            auto next = std::make_shared<size_t>(0);
+            send_json_stream(res, [changes, next](JsonWriter &w) {
+                if (*next == 0) {
+                    w.begin_object()
+                        .field("sequence", changes->sequence)
+                        .field("has_more", changes->has_more)
+                        .field("reset", changes->reset)
+                        .key("tasks").begin_array();
+                }
+                const size_t end = std::min(changes->tasks.size(), *next + kStreamChunkItems);
+                for (; *next < end; ++*next) {
+                    const auto &task = changes->tasks[*next];
+                    write_task_fields(w, *task->snapshot());
+                    w.field("change_sequence", task->change_sequence()).end_object();
+                }
+                if (*next < changes->tasks.size()) {
+                    return true;
+                }
+                w.end_array().key("removed").begin_array();
+                for (const auto &id : changes->removed_task_ids) {
+                    w.value(id);
+                }
+                w.end_array().end_object();
+                return false;
+            });
+            return;
+        }
+
+        TaskPlatform::TaskQuery query;
+        std::string error;
+        if (req.has_param("status")) {
+            auto status = task_status_from_string(req.get_param_value("status"));
+            if (status) {
+                query.filter.status = status.value();
+            } else {
+                error = "invalid status";
+            }
+        }
+        if (req.has_param("category")) {
+            query.filter.category = req.get_param_value("category");
+        }
+        if (req.has_param("claimer")) {
+            query.filter.claimer_id = req.get_param_value("claimer");
+        }
+        if (req.has_param("min_priority")) {
+            std::int64_t priority = 0;
+            if (strict_int_param(req, "min_priority", &priority) && priority >= INT_MIN && priority <= INT_MAX) {
+                query.filter.min_priority = static_cast<int>(priority);
+            } else {
+                error = "invalid min_priority";
+            }
+        }
+        if (req.has_param("max_priority")) {
+            std::int64_t priority = 0;
+            if (strict_int_param(req, "max_priority", &priority) && priority >= INT_MIN && priority <= INT_MAX) {
+                query.filter.max_priority = static_cast<int>(priority);
+            } else {
+                error = "invalid max_priority";
+            }
+        }
+        if (req.has_param("tags")) {
+            // 逗号分隔，要求同时包含全部标签
+            std::istringstream tags(req.get_param_value("tags"));
+            std::string tag;
+            while (std::getline(tags, tag, ',')) {
+                if (!tag.empty()) {
+                    query.filter.tags.push_back(tag);
+                }
+            }
+        }
+        if (req.has_param("sort")) {
+            const std::string sort = req.get_param_value("sort");
+            if (sort == "id") {
+                query.sort_by = TaskPlatform::TaskSortKey::Id;
+            } else if (sort == "published_at") {
+                query.sort_by = TaskPlatform::TaskSortKey::PublishedAt;
+            } else if (sort == "priority") {
+                query.sort_by = TaskPlatform::TaskSortKey::Priority;
+            } else {
+                error = "invalid sort";
+            }
+        }
+        if (req.has_param("order")) {
+            const std::string order = req.get_param_value("order");
+            if (order == "desc") {
+                query.descending = true;
+            } else if (order != "asc") {
+                error = "invalid order";
+            }
+        }
+        if (!page_limit(req, &query.limit)) {
+            error = "invalid limit";
+        }
+        query.cursor = req.get_param_value("cursor");
+
+        if (!error.empty()) {
+            send_error(res, 400, error);
+            return;
+        }
+        // 先取序号再查询：调用方之后以该序号增量同步，不会漏掉查询期间的变化
+        const std::uint64_t sequence = platform->change_sequence();
+        auto result = platform->query_tasks(query);
+        if (!result) {
+            send_error(res, 400, result.error().message);
+            return;
+        }
+
+        auto page = std::make_shared<TaskPlatform::TaskPage>(std::move(result.value()));
+        auto next = std::make_shared<size_t>(0);
+        send_json_stream(res, [page, next, sequence](JsonWriter &w) {
+            if (*next == 0) {
+                w.begin_object().key("tasks").begin_array();
+            }
+            const size_t end = std::min(page->tasks.size(), *next + kStreamChunkItems);
+            for (; *next < end; ++*next) {
+                write_task_fields(w, *page->tasks[*next]);
+                w.end_object();
+            }
+            if (*next < page->tasks.size()) {
+                return true;
+            }
+            w.end_array().field("count", page->tasks.size()).key("next_cursor");
+            if (page->next_cursor.empty()) {
+                w.null();
+            } else {
+                w.value(page->next_cursor);
+            }
+            w.field("sequence", sequence).end_object();
+            return false;
+        });
     });
     
+    // 事件流 - 任务与申领者的增量变化（Server-Sent Events）
+    server->Get("/api/events/stream", [this](const httplib::Request&, httplib::Response& res) {
+        auto hub = event_hub_;
+        if (!hub) {
+            res.status = 503;
+            return;
+        }
+        auto client = hub->connect();
+        if (!client) {
+            res.set_header("Retry-After", std::to_string(options_.retry_after.count()));
+            res.set_header("Connection", "close");
+            send_error(res, 503, "too many event stream clients");
+            return;
+        }
+        res.set_header("Cache-Control", "no-cache");
+        res.set_header("X-Accel-Buffering", "no");
+        res.set_chunked_content_provider(
+            "text/event-stream",
+            [client, hub](size_t, httplib::DataSink &sink) {
+                std::string chunk;
+                if (!client->pop_all(chunk, hub->options().heartbeat_interval)) {
+                    sink.done();
+                    return false;
+                }
+                if (chunk.empty()) {
+                    chunk = ": keep-alive\n\n";  // 空闲心跳，也用于及时发现断开的连接
+                }
+                return sink.write(chunk.data(), chunk.size());
+            },
+            [client, hub](bool) { hub->disconnect(client); });
+    });
+    
+    // REST API - 聚合模式下各端点的抓取状态
+    server->Get("/api/endpoints", [this](const httplib::Request&, httplib::Response& res) {
+        JsonWriter writer;
+        writer.begin_object().key("endpoints").begin_array();
+        for (const auto &endpoint : dashboard_->get_endpoint_status()) {
+            writer.begin_object()
+                .field("endpoint", endpoint->endpoint)
+                .field("reachable", endpoint->reachable)
+                .field("last_error", endpoint->last_error)
+                .field("updated_at", endpoint->has_data ? to_epoch_ms(endpoint->updated_at) : 0)
+                .field("scrape_ms", static_cast<std::int64_t>(endpoint->scrape_duration.count()))
+                .field("consecutive_failures", endpoint->consecutive_failures)
+                .field("total_tasks", endpoint->stats.total_tasks)
+                .field("tasks_truncated", endpoint->tasks_truncated)
+                .end_object();
+        }
+        writer.end_array().end_object();
+        send_json(res, writer);
+    });
+
+    // REST API - 批量提交任务（请求体为 NDJSON，每行一个任务描述；逐块读取、分批发布，返回逐行结果）
+    server->Post("/api/tasks/batch", [this](const httplib::Request&, httplib::Response& res,
+                                            const httplib::ContentReader& content_reader) {
+        TaskPlatform *platform = dashboard_->get_platform();
+        if (!platform) {
+            send_error(res, 404, "no local platform");
+            return;
+        }
+        JsonWriter writer;
+        writer.begin_object().key("results").begin_array();
+        TaskBatchIngest ingest(platform, std::atomic_load(&task_handlers_), writer, options_.max_batch_lines);
+        content_reader([&ingest](const char *data, size_t size) {
+            return ingest.feed(data, size);
+        });
+        ingest.finish();
+        writer.end_array().field("accepted", ingest.accepted()).field("rejected", ingest.rejected());
+        if (ingest.next_line() > 0) {
+            // 超出行数上限：已处理的行照常发布，客户端从 next_line 起重新提交剩余部分
+            writer.field("error", "too many lines").field("next_line", ingest.next_line());
+            res.status = 413;
+        }
+        writer.end_object();
+        send_json(res, writer);
+    });
+
     // REST API - 获取申领者摘要
     server->Get("/api/claimers", [this](const httplib::Request&, httplib::Response& res) {
         auto claimers = dashboard_->get_claimers_summary();
         
-        std::ostringstream oss;
-        oss << "[";
-        for (size_t i = 0; i < claimers.size(); ++i) {
-            if (i > 0) oss << ",";
-            oss << "{"
-                << "\"id\":\"" << claimers[i].id << "\","
-                << "\"name\":\"" << claimers[i].name << "\","
-                << "\"status\":\"" << to_string(claimers[i].status) << "\","
-                << "\"claimed_task_count\":" << claimers[i].claimed_task_count << ","
-                << "\"total_completed\":" << claimers[i].total_completed << ","
-                << "\"total_failed\":" << claimers[i].total_failed
-                << "}";
-        }
-        oss << "]";
-        
-        res.set_content(oss.str(), "application/json");
+        JsonWriter writer;
+        writer.begin_array();
+        for (const auto &claimer : claimers) {
+            writer.begin_object()
+                .field("id", claimer.id)
+                .field("name", claimer.name)
+                .field("status", to_string(claimer.status))
+                .field("claimed_task_count", claimer.claimed_task_count)
+                .field("total_completed", claimer.total_completed)
+                .field("total_failed", claimer.total_failed)
+                .end_object();
+        }
+        writer.end_array();
+        send_json(res, writer);
     });
     
-    // REST API - 获取事件日志
-    // REST API - 获取事件日志
-    server->Get("/api/logs", [this](const httplib::Request&, httplib::Response& res) {
-        auto logs = dashboard_->get_event_logs();
-        
-        std::ostringstream oss;
-        oss << "[";
-        for (size_t i = 0; i < logs.size(); ++i) {
-            if (i > 0) oss << ",";
-            oss << "\"" << logs[i] << "\"";
+    // REST API - 指定时刻的快照（timestamp 为毫秒时间戳，缺省为当前时刻）
+    server->Get("/api/replay/snapshot", [this](const httplib::Request& req, httplib::Response& res) {
+        auto replay = dashboard_->get_time_replay();
+        if (!replay) {
+            res.status = 404;
+            return;
         }
-        oss << "]";
-        
-        res.set_content(oss.str(), "application/json");
+        replay->sync();
+        auto at = from_epoch_ms(int_param(req, "timestamp", to_epoch_ms(std::chrono::system_clock::now())));
+        JsonWriter writer;
+        write_snapshot_json(writer, replay->snapshot_at(at));
+        send_json(res, writer);
+    });
+
+    // REST API - 状态演化轨迹（默认最近 24 小时、288 个采样点），仪表板一次取回后在本地拖动回放
+    server->Get("/api/replay/trace", [this](const httplib::Request& req, httplib::Response& res) {
+        auto replay = dashboard_->get_time_replay();
+        if (!replay) {
+            res.status = 404;
+            return;
+        }
+        replay->sync();
+        const std::int64_t now_ms = to_epoch_ms(std::chrono::system_clock::now());
+        const std::int64_t end_ms = int_param(req, "end_time", now_ms);
+        const std::int64_t start_ms = int_param(req, "start_time", end_ms - 24LL * 3600 * 1000);
+        std::int64_t points = int_param(req, "points", 288);
+        const std::int64_t interval_ms = int_param(req, "interval_ms", 0);
+        if (interval_ms > 0) {
+            points = (end_ms - start_ms) / interval_ms + 1;
+        }
+        points = std::max<std::int64_t>(1, std::min<std::int64_t>(points, 5000));
+        if (end_ms < start_ms) {
+            res.status = 400;
+            return;
+        }
+
+        auto snapshots = replay->timeline(from_epoch_ms(start_ms), from_epoch_ms(end_ms), static_cast<size_t>(points));
+        JsonWriter writer;
+        writer.begin_object().field("start_time", start_ms).field("end_time", end_ms).key("snapshots").begin_array();
+        for (const auto &snap : snapshots) {
+            write_snapshot_json(writer, snap);
+        }
+        writer.end_array().end_object();
+        send_json(res, writer);
+    });
+
+    // REST API - 获取事件日志（limit 默认 100，offset 跳过最早的若干条；按页读取日志并分块输出）
+    server->Get("/api/logs", [this](const httplib::Request& req, httplib::Response& res) {
+        EventLog *log = dashboard_->get_event_log();
+        struct LogCursor {
+            std::string cursor;
+            size_t skip;
+            size_t remaining;
+            bool started;
+        };
+        auto state = std::make_shared<LogCursor>();
+        state->skip = static_cast<size_t>(std::max<std::int64_t>(0, int_param(req, "offset", 0)));
+        state->remaining = static_cast<size_t>(std::max<std::int64_t>(0, int_param(req, "limit", 100)));
+        state->started = false;
+
+        send_json_stream(res, [log, state](JsonWriter &w) {
+            if (!state->started) {
+                w.begin_array();
+                state->started = true;
+            }
+            if (!log || state->remaining == 0) {
+                w.end_array();
+                return false;
+            }
+            auto page = log->get_events_page(EventLog::Filter{}, std::min(kStreamChunkItems, state->skip + state->remaining),
+                                             state->cursor);
+            std::string line;
+            for (const auto &ev : page.events) {
+                if (state->skip > 0) {
+                    --state->skip;
+                    continue;
+                }
+                if (state->remaining == 0) {
+                    break;
+                }
+                --state->remaining;
+                line.assign(std::to_string(ev.timestamp.time_since_epoch().count()));
+                line += '|';
+                line += ev.source;
+                line += '|';
+                line += ev.message;
+                w.value(line);
+            }
+            state->cursor = page.next_cursor;
+            if (state->remaining == 0 || state->cursor.empty()) {
+                w.end_array();
+                return false;
+            }
+            return true;
+        });
     });
 }
 
@@ -367,6 +1254,17 @@ std::string WebServer::_get_dashboard_html() {
         .p-med  { background: #f59e0b; }
         .p-low  { background: #10b981; }
 
+        /* 24 小时回放滑块 */
+        .scrubber {
+            display: flex;
+            align-items: center;
+            gap: 6px;
+            margin-right: 16px;
+            font-size: 11px;
+            color: var(--text-secondary);
+        }
+        .scrubber input { width: 200px; accent-color: #60a5fa; }
+        .scrubber span { font-family: var(--font-mono); min-width: 56px; }
     </style>
 </head>
 <body>
@@ -385,6 +1283,9 @@ std::string WebServer::_get_dashboard_html() {
                     <div class="mini-metric">失败 <strong style="color:#f87171" id="m-fail">0</strong></div>
                     <div class="mini-metric">总计 <strong id="m-tot">0</strong></div>
                 </div>
+                <div class="scrubber" title="拖动回放最近 24 小时">
+                    24h <input type="range" id="scrub" min="0" max="287" value="287"> <span id="scrub-label">LIVE</span>
+                </div>
                 <div style="font-size:11px; color:#64748b; font-family:var(--font-mono)" id="sys-time">00:00:00</div>
             </div>
         </div>
@@ -440,67 +1341,149 @@ const renderPr = p => {
     return `<span class="prio-dot ${cls}"></span>`;
 };
 const fmtT = ts => new Date(ts).toLocaleTimeString('zh-CN',{hour12:false});
+const showMetrics = m => {
+    $('m-pro').innerText = m.processing_tasks;
+    $('m-back').innerText = (m.published_tasks||0) + (m.claimed_tasks||0);
+    $('m-ok').innerText = m.completed_tasks;
+    $('m-fail').innerText = (m.failed_tasks||0) + (m.abandoned_tasks||0);
+    $('m-tot').innerText = m.total_tasks;
+};
+// 24 小时回放：一次取回 288 个采样点（5 分钟间隔），拖动时只在本地切换，过期（>60s）才重新获取
+let trace = null, traceAt = 0;
+const scrubbing = () => +$('scrub').value < +$('scrub').max;
+$('scrub').addEventListener('input', async e => {
+    if (!scrubbing()) { $('scrub-label').innerText = 'LIVE'; showMetrics(metrics); return; }
+    if (!trace || Date.now() - traceAt > 60000) {
+        try { trace = await (await fetch('/api/replay/trace?points=288')).json(); traceAt = Date.now(); }
+        catch(err) { return; }
+    }
+    const snap = trace.snapshots[+e.target.value];
+    if (!snap) return;
+    $('scrub-label').innerText = fmtT(snap.timestamp);
+    showMetrics(snap.metrics);
+});
 
-async function tick() {
-    $('sys-time').innerText = new Date().toLocaleTimeString();
+// 本地镜像：首次（以及 resync 时）全量拉取一次，之后只应用 /api/events/stream 推送的增量。
+// 全量结果带有变更序号（指标快照可能落后一个刷新间隔）：拉取期间的增量先缓存，拉取完成后
+// 重放最近收到的、序号大于该序号的增量，不大于它的已包含在结果中
+let metrics = {}, dirty = false, metricsSeq = 0, loading = 0, reloaded = false, recent = [];
+const tasks = new Map(), claimers = new Map();
+const statusField = {'Published':'published_tasks','Claimed':'claimed_tasks','Processing':'processing_tasks',
+                     'Completed':'completed_tasks','Failed':'failed_tasks','Abandoned':'abandoned_tasks'};
 
-    // 1. Metrics & Claimers
+async function loadAll() {
+    ++loading;
+    let loaded = false;
     try {
-        const [mRes, cRes] = await Promise.all([fetch('/api/metrics'), fetch('/api/claimers')]);
-        const m = await mRes.json();
+        const [mRes, cRes, tRes] = await Promise.all([fetch('/api/metrics'), fetch('/api/claimers'), fetch('/api/tasks?sort=published_at&order=desc&limit=500')]);
+        metrics = await mRes.json();
+        metricsSeq = metrics.sequence || 0;
         const c = await cRes.json();
-        
-        // Metrics
-        $('m-pro').innerText = m.processing_tasks;
-        $('m-back').innerText = (m.published_tasks||0) + (m.claimed_tasks||0);
-        $('m-ok').innerText = m.completed_tasks;
-        $('m-fail').innerText = (m.failed_tasks||0) + (m.abandoned_tasks||0);
-        $('m-tot').innerText = m.total_tasks;
-
-        // Claimers
-        $('claimer-list').innerHTML = c.map(x => {
-            const active = x.claimed_task_count > 0;
-            const stColor = active ? '#4ade80' : '#475569';
-            return `
-            <div class="claimer-item">
-                <div>
-                    <div class="c-name">${esc(x.name||x.id)}</div>
-                    <div class="c-info">完成: ${x.total_completed} | 失败: ${x.total_failed}</div>
-                </div>
-                <div style="text-align:right">
-                    <div style="font-size:10px; color:${stColor}; font-weight:600">${active ? 'BUSY' : 'IDLE'}</div>
-                    <div style="font-size:10px; color:#64748b">Load: ${x.claimed_task_count}</div>
-                </div>
-            </div>`;
-        }).join('');
+        const data = await tRes.json();
+        claimers.clear(); c.forEach(x => claimers.set(x.id, x));
+        tasks.clear(); (data.tasks||[]).forEach(t => { t.change_sequence = data.sequence || 0; tasks.set(t.id, t); });
+        dirty = loaded = reloaded = true;
     } catch(e) { console.error('Data fail', e); }
+    if (loaded) recent = recent.filter(d => d.t.change_sequence > metricsSeq);
+    if (--loading === 0) {
+        // 拉取成功时在新结果上重放全部较新的增量；失败时只补上拉取期间缓存的增量
+        recent.forEach(d => { if (reloaded || !d.done) { d.apply(d.t); d.done = true; } });
+        reloaded = false;
+    }
+}
 
-    // 2. Tasks
-    try {
-        const res = await fetch('/api/tasks');
-        const data = await res.json();
-        const tasks = (data.tasks||[]).sort((a,b)=> (b.published_at||0)-(a.published_at||0));
-        $('task-count').innerText = tasks.length;
-        
-        $('task-list').innerHTML = tasks.slice(0, 100).map(t => {
-            const claimer = t.claimer_id ? `<span style="font-size:11px; color:#94a3b8;">${esc(t.claimer_id)}</span>` 
-                                         : '<span style="font-size:11px; color:#334155">-</span>';
-            return `
-            <tr>
-                <td style="font-size:11px; color:#64748b;">${fmtT(t.published_at)}</td>
-                <td style="text-align:center">${renderPr(t.priority)}</td>
-                <td class="id-mono" title="${esc(t.id)}">${esc(t.id)}</td>
-                <td style="font-size:11px; max-width:100px" title="${esc(t.title)}">${esc(t.title)}</td>
-                <td><span style="font-size:11px; padding:1px 4px; background:#1e293b; border-radius:3px">${esc(t.category)}</span></td>
-                <td>${claimer}</td>
-                <td>${renderSt(t.status)}</td>
-            </tr>`;
-        }).join('');
-    } catch(e) {}
-}
-
-tick();
-setInterval(tick, 1500); // Faster updates
+function onDelta(apply, t) {
+    recent.push({apply, t, done: loading === 0});
+    if (recent.length > 20000) recent.splice(0, 10000);
+    if (loading === 0) apply(t);
+}
+
+// 任务镜像只接受比已有状态更新的增量
+function isNewer(t) {
+    const prev = tasks.get(t.id);
+    return !prev || !(prev.change_sequence >= t.change_sequence);
+}
+
+function applyTask(t) {
+    if (t.change_sequence > metricsSeq) {
+        const from = statusField[t.old_status], to = statusField[t.status];
+        if (t.old_status === 'Draft') metrics.total_tasks = (metrics.total_tasks||0) + 1;
+        if (from && metrics[from] > 0) metrics[from]--;
+        if (to) metrics[to] = (metrics[to]||0) + 1;
+    }
+    if (isNewer(t)) tasks.set(t.id, Object.assign(tasks.get(t.id) || {}, t));
+    dirty = true;
+}
+
+function removeTask(t) {
+    if (t.change_sequence > metricsSeq) {
+        const from = statusField[t.status];
+        if (from && metrics[from] > 0) metrics[from]--;
+        if (metrics.total_tasks > 0) metrics.total_tasks--;
+    }
+    if (isNewer(t)) tasks.delete(t.id);
+    dirty = true;
+}
+
+function render() {
+    if (!dirty) return;
+    dirty = false;
+    // Metrics（回放时保持显示回放时刻的数据）
+    if (!scrubbing()) showMetrics(metrics);
+
+    // Claimers
+    $('claimer-list').innerHTML = Array.from(claimers.values()).map(x => {
+        const active = x.claimed_task_count > 0;
+        const stColor = active ? '#4ade80' : '#475569';
+        return `
+        <div class="claimer-item">
+            <div>
+                <div class="c-name">${esc(x.name||x.id)}</div>
+                <div class="c-info">完成: ${x.total_completed} | 失败: ${x.total_failed}</div>
+            </div>
+            <div style="text-align:right">
+                <div style="font-size:10px; color:${stColor}; font-weight:600">${active ? 'BUSY' : 'IDLE'}</div>
+                <div style="font-size:10px; color:#64748b">Load: ${x.claimed_task_count}</div>
+            </div>
+        </div>`;
+    }).join('');
+
+    // Tasks
+    const list = Array.from(tasks.values()).sort((a,b)=> (b.published_at||0)-(a.published_at||0));
+    $('task-count').innerText = metrics.total_tasks || list.length;
+    $('task-list').innerHTML = list.slice(0, 100).map(t => {
+        const claimer = t.claimer_id ? `<span style="font-size:11px; color:#94a3b8;">${esc(t.claimer_id)}</span>` 
+                                     : '<span style="font-size:11px; color:#334155">-</span>';
+        return `
+        <tr>
+            <td style="font-size:11px; color:#64748b;">${fmtT(t.published_at)}</td>
+            <td style="text-align:center">${renderPr(t.priority)}</td>
+            <td class="id-mono" title="${esc(t.id)}">${esc(t.id)}</td>
+            <td style="font-size:11px; max-width:100px" title="${esc(t.title)}">${esc(t.title)}</td>
+            <td><span style="font-size:11px; padding:1px 4px; background:#1e293b; border-radius:3px">${esc(t.category)}</span></td>
+            <td>${claimer}</td>
+            <td>${renderSt(t.status)}</td>
+        </tr>`;
+    }).join('');
+}
+
+function poll() {
+    loadAll();
+    setInterval(loadAll, 1500);
+}
+if (window.EventSource) {
+    const es = new EventSource('/api/events/stream');
+    es.onopen = loadAll;  // 首次连接与断线重连后都重新拉取全量
+    es.onerror = () => { if (es.readyState === EventSource.CLOSED) poll(); };  // SSE 连接数已满（503）时退回轮询
+    es.addEventListener('task', e => onDelta(applyTask, JSON.parse(e.data)));
+    es.addEventListener('task_removed', e => onDelta(removeTask, JSON.parse(e.data)));
+    es.addEventListener('claimer', e => { const x = JSON.parse(e.data); claimers.set(x.id, x); dirty = true; });
+    es.addEventListener('resync', loadAll);
+} else {
+    poll();
+}
+setInterval(render, 250);  // 合并高频变化，最多每 250ms 重绘一次
+setInterval(() => { $('sys-time').innerText = new Date().toLocaleTimeString(); }, 1000);
 </script>
 </body>
 </html>)HTML";
@@ -1,14 +1,24 @@
 #include <xswl/youdidit/web/event_log.hpp>
+#include <xswl/youdidit/web/event_store.hpp>
+#include <xswl/youdidit/web/event_stream.hpp>
+#include <xswl/youdidit/web/json_writer.hpp>
 #include <xswl/youdidit/web/time_replay.hpp>
 #include <xswl/youdidit/web/metrics_exporter.hpp>
+#include <xswl/youdidit/web/metrics_snapshot.hpp>
 #include <xswl/youdidit/web/web_dashboard.hpp>
 #include <xswl/youdidit/web/web_server.hpp>
 #include <xswl/youdidit/core/task_platform.hpp>
 #include <xswl/youdidit/core/task_builder.hpp>
+#include <httplib.h>
+#include <atomic>
 #include <cassert>
+#include <cstdio>
 #include <iostream>
 #include <thread>
+#include <vector>
 #include <chrono>
+#include <limits>
+#include <nlohmann/json.hpp>
 
 using namespace xswl::youdidit;
 
@@ -81,6 +91,223 @@ bool test_event_log_basic() {
     return true;
 }
 
+bool test_event_log_ring_buffer() {
+    EventLog log(3);
+    for (int i = 0; i < 5; ++i) {
+        log.add_event(EventLog::EventType::Info, "ring", "event" + std::to_string(i));
+    }
+    TEST_ASSERT(log.size() == 3, "Ring should keep only capacity events");
+    TEST_ASSERT(log.dropped_count() == 2, "Overwritten events should be counted");
+    auto events = log.get_events();
+    TEST_ASSERT(events.front().message == "event2" && events.back().message == "event4",
+                "Ring should keep the newest events in order");
+
+    log.set_capacity(2);
+    TEST_ASSERT(log.size() == 2 && log.dropped_count() == 3, "Shrinking should drop the oldest");
+    TEST_ASSERT(log.get_events().front().message == "event3", "Oldest surviving event after shrink");
+
+    WebDashboard dashboard(static_cast<TaskPlatform *>(nullptr));
+    dashboard.set_max_event_history(4);
+    TEST_ASSERT(dashboard.get_event_log()->capacity() == 4, "Dashboard history limit should bound its log");
+
+    return true;
+}
+
+bool test_event_log_ordered_queries() {
+    EventLog log;
+    log.add_event_at(make_time_shift_ms(-30), EventLog::EventType::Info, "src", "a");
+    log.add_event_at(make_time_shift_ms(-10), EventLog::EventType::Info, "src", "c");
+    log.add_event_at(make_time_shift_ms(-20), EventLog::EventType::Warning, "src", "b");  // 迟到事件
+    auto ordered = log.get_events();
+    TEST_ASSERT(ordered.size() == 3 && ordered[0].message == "a" && ordered[1].message == "b" &&
+                    ordered[2].message == "c",
+                "Late events should be inserted in timestamp order");
+
+    EventLog::Filter range;
+    range.start_time = make_time_shift_ms(-25);
+    TEST_ASSERT(log.count_events(range) == 2, "Count should use time bounds");
+    range.type = EventLog::EventType::Warning;
+    TEST_ASSERT(log.count_events(range) == 1, "Count should honour type filter");
+
+    size_t seen = log.for_each_event(EventLog::Filter{}, [](const EventLog::Event &) { return false; });
+    TEST_ASSERT(seen == 1, "Visitor returning false should stop iteration");
+
+    EventLog paged;
+    auto base = make_time_shift_ms(-1000);
+    for (int i = 0; i < 250; ++i) {
+        paged.add_event_at(base + std::chrono::milliseconds(i / 2), EventLog::EventType::Info, "p",
+                           std::to_string(i));
+    }
+    std::vector<std::string> collected;
+    std::string cursor;
+    int pages = 0;
+    do {
+        auto page = paged.get_events_page(EventLog::Filter{}, 100, cursor);
+        for (const auto &ev : page.events) {
+            collected.push_back(ev.message);
+        }
+        cursor = page.next_cursor;
+        ++pages;
+    } while (!cursor.empty() && pages < 10);
+    TEST_ASSERT(pages == 3, "250 events should take three pages of 100");
+    TEST_ASSERT(collected.size() == 250, "Pagination should return every event exactly once");
+    for (int i = 0; i < 250; ++i) {
+        if (collected[static_cast<size_t>(i)] != std::to_string(i)) {
+            TEST_ASSERT(false, "Pagination should keep insertion order for equal timestamps");
+        }
+    }
+
+    WebDashboard dashboard(static_cast<TaskPlatform *>(nullptr));
+    for (int i = 0; i < 5; ++i) {
+        dashboard.get_event_log()->add_event(EventLog::EventType::Info, "dash", "m" + std::to_string(i));
+    }
+    auto logs = dashboard.get_event_logs(2, 1);
+    TEST_ASSERT(logs.size() == 2 && logs[0].find("m1") != std::string::npos && logs[1].find("m2") != std::string::npos,
+                "Dashboard log pages should honour limit and offset");
+
+    return true;
+}
+
+std::string store_segment_path(const std::string &base, int number) {
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%08d", number);
+    return base + suffix + ".seg";
+}
+
+void remove_store_files(const std::string &base) {
+    for (int i = 1; i <= 256; ++i) {
+        std::string seg = store_segment_path(base, i);
+        std::remove(seg.c_str());
+        std::remove((seg.substr(0, seg.size() - 4) + ".idx").c_str());
+    }
+}
+
+bool test_event_store_persistence() {
+    const std::string base = "youdidit_test_event_store";
+    remove_store_files(base);
+
+    EventStore::Options options;
+    options.base_path = base;
+    options.segment_bytes = 4096;
+    options.index_interval_bytes = 256;
+    options.flush_interval = std::chrono::milliseconds(5);
+
+    auto t0 = make_time_shift_ms(-60000);
+    {
+        auto opened = EventStore::open(options);
+        TEST_ASSERT(opened.has_value(), "Store should open");
+        std::shared_ptr<EventStore> store = opened.value();
+        EventLog log(50);
+        log.attach_store(store);
+        for (int i = 0; i < 200; ++i) {
+            log.add_event_at(t0 + std::chrono::milliseconds(i), EventLog::EventType::Info, "store",
+                             "e" + std::to_string(i), {{"i", std::to_string(i)}});
+        }
+        TEST_ASSERT(store->flush(), "Flush should report no lost events");
+        auto stats = store->statistics();
+        TEST_ASSERT(stats.persisted == 200, "Every appended event should be written");
+        TEST_ASSERT(stats.segments > 2, "Small segments should roll");
+        TEST_ASSERT(stats.syncs < 200, "Writes should be group committed");
+
+        EventLog::Filter range;
+        range.start_time = t0 + std::chrono::milliseconds(50);
+        range.end_time = t0 + std::chrono::milliseconds(99);
+        auto history = store->get_events(range);
+        TEST_ASSERT(history.size() == 50 && history.front().message == "e50" && history.back().message == "e99",
+                    "Range query should use the time index");
+        TEST_ASSERT(history[10].metadata["i"] == "60", "Metadata should round-trip");
+
+        TimeReplay replay(&log, nullptr);
+        auto all = replay.events_between(t0, t0 + std::chrono::milliseconds(1000));
+        TEST_ASSERT(all.size() == 200 && all.front().message == "e0" && all.back().message == "e199",
+                    "Replay should merge persisted history with in-memory events");
+        log.attach_store(nullptr);
+    }
+
+    // 模拟崩溃：活动段末尾残留半条记录
+    int last = 0;
+    for (int i = 1; i <= 256; ++i) {
+        std::FILE *probe = std::fopen(store_segment_path(base, i).c_str(), "rb");
+        if (probe) {
+            std::fclose(probe);
+            last = i;
+        }
+    }
+    TEST_ASSERT(last > 0, "Segment files should exist");
+    std::FILE *torn = std::fopen(store_segment_path(base, last).c_str(), "ab");
+    TEST_ASSERT(torn != nullptr, "Active segment should be writable");
+    std::fwrite("\x30\0\0\0\1", 1, 5, torn);
+    std::fclose(torn);
+
+    {
+        WebDashboard dashboard(static_cast<TaskPlatform *>(nullptr));
+        dashboard.set_max_event_history(50);
+        dashboard.set_log_file_path(base, options);
+        auto store = dashboard.get_event_store();
+        TEST_ASSERT(store != nullptr, "Dashboard should open the store");
+        auto stats = store->statistics();
+        TEST_ASSERT(stats.truncated_bytes == 5, "Recovery should truncate the torn record");
+        TEST_ASSERT(stats.recovered_records > 0, "Recovery should rescan the active segment");
+        TEST_ASSERT(dashboard.get_event_log()->size() == 50, "Recent history should be preloaded");
+        auto recent = dashboard.get_event_log()->get_events();
+        TEST_ASSERT(recent.back().message == "e199", "Preloaded history should end with the last event");
+
+        dashboard.get_event_log()->add_event(EventLog::EventType::Info, "store", "after-restart");
+        auto after = dashboard.get_event_log()->get_events();
+        TEST_ASSERT(after.back().sequence > 200, "Sequences should continue after restart");
+    }
+
+    options.retention_bytes = 8192;
+    {
+        auto opened = EventStore::open(options);
+        TEST_ASSERT(opened.has_value(), "Store should reopen");
+        auto stats = opened.value()->statistics();
+        TEST_ASSERT(stats.removed_segments > 0, "Retention should drop old segments");
+        TEST_ASSERT(stats.total_bytes <= 8192 + options.segment_bytes, "Retention should bound total size");
+        auto events = opened.value()->get_events();
+        TEST_ASSERT(!events.empty() && events.front().message != "e0", "Oldest events should be gone");
+        TEST_ASSERT(events.back().message == "after-restart", "Newest events should be kept");
+    }
+
+    remove_store_files(base);
+    return true;
+}
+
+bool test_event_store_pending_cap() {
+    const std::string base = "youdidit_test_event_store_cap";
+    remove_store_files(base);
+
+    EventStore::Options options;
+    options.base_path = base;
+    options.max_pending_bytes = 512;
+    // 写线程在首条记录后最多等待 flush_interval，期间缓冲区只能容纳少量记录
+    options.flush_interval = std::chrono::milliseconds(2000);
+    {
+        auto opened = EventStore::open(options);
+        TEST_ASSERT(opened.has_value(), "Store should open");
+        std::shared_ptr<EventStore> store = opened.value();
+        const std::string message(100, 'x');
+        for (int i = 0; i < 100; ++i) {
+            store->append(std::chrono::system_clock::now(), EventLog::EventType::Info, "cap", message, {},
+                          static_cast<std::uint64_t>(i + 1));
+        }
+        TEST_ASSERT(!store->flush(), "Flush should report dropped events");
+        auto stats = store->statistics();
+        TEST_ASSERT(stats.dropped_events > 0, "Events beyond the pending cap should be dropped");
+        TEST_ASSERT(stats.appended + stats.dropped_events == 100, "Every event should be appended or dropped");
+        TEST_ASSERT(stats.persisted == stats.appended, "Accepted events should be written");
+        TEST_ASSERT(stats.discarded_records == 0 && stats.write_errors == 0, "No write should fail");
+        TEST_ASSERT(store->flush(), "A loss should be reported only once");
+
+        store->append(std::chrono::system_clock::now(), EventLog::EventType::Info, "cap", message, {}, 101);
+        TEST_ASSERT(store->flush(), "A drained buffer should accept events again");
+        TEST_ASSERT(store->statistics().persisted == stats.persisted + 1, "The new event should be written");
+    }
+
+    remove_store_files(base);
+    return true;
+}
+
 bool test_time_replay_snapshot() {
     TaskPlatform platform;
     EventLog log;
@@ -106,6 +333,254 @@ bool test_time_replay_snapshot() {
     return true;
 }
 
+bool test_time_replay_overlap_and_removal() {
+    TaskPlatform platform;
+    auto claimer = std::make_shared<Claimer>("c1", "C");
+    claimer->set_max_concurrent(1000);
+    platform.register_claimer(claimer);
+
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (int i = 0; i < 400; ++i) {
+        auto task = platform.task_builder()
+                        .title("o" + std::to_string(i))
+                        .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                        .build();
+        platform.publish_task(task);
+        tasks.push_back(task);
+    }
+
+    // 建立基线的同时持续发生转换：重叠的记录不能被重复计入
+    EventLog log;
+    TimeReplay replay(&log, &platform);
+    TimeReplay::RecordingOptions options;
+    options.checkpoint_interval = 16;
+    options.batch.flush_interval = std::chrono::milliseconds(1);
+    std::atomic<bool> started(false);
+    std::thread worker([&]() {
+        started.store(true);
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (platform.claim_task(claimer, tasks[i]->id()).has_value() && i % 2 == 0) {
+                claimer->run_task(tasks[i], std::string());
+            }
+        }
+    });
+    while (!started.load()) {
+        std::this_thread::yield();
+    }
+    TEST_ASSERT(replay.start_recording(options), "Recording should start");
+    worker.join();
+    replay.sync();
+
+    auto stats = platform.get_statistics();
+    auto latest = replay.snapshot_at(std::chrono::system_clock::now());
+    TEST_ASSERT(latest.total_tasks == stats.total_tasks, "Overlapping transitions should not be double counted");
+    TEST_ASSERT(latest.completed_tasks == 200 && latest.claimed_tasks == 200 && latest.published_tasks == 0,
+                "Status counts should match the platform");
+    TEST_ASSERT(latest.claimer_load["c1"] == 200, "Claimer load should match the held tasks");
+
+    // 删除：强制删除持有中的任务释放申领者负载，清理已完成任务减少总数
+    TEST_ASSERT(platform.remove_task(tasks[1]->id(), true), "Forced removal should succeed");
+    platform.clear_completed_tasks(false);
+    replay.sync();
+    stats = platform.get_statistics();
+    latest = replay.snapshot_at(std::chrono::system_clock::now());
+    TEST_ASSERT(latest.total_tasks == stats.total_tasks && latest.total_tasks == 199,
+                "Removed tasks should leave the replay totals");
+    TEST_ASSERT(latest.completed_tasks == 0 && latest.claimed_tasks == 199, "Removals should update status counts");
+    TEST_ASSERT(latest.claimer_load["c1"] == 199, "Removing a held task should release its claimer load");
+    return true;
+}
+
+bool test_time_replay_checkpoints() {
+    TaskPlatform platform;
+    auto claimer = std::make_shared<Claimer>("c1", "C");
+    claimer->set_max_concurrent(10);
+    platform.register_claimer(claimer);
+
+    EventLog log;
+    TimeReplay replay(&log, &platform);
+    TimeReplay::RecordingOptions options;
+    options.checkpoint_interval = 4;
+    options.batch.flush_interval = std::chrono::milliseconds(5);
+    TEST_ASSERT(replay.start_recording(options), "Recording should start");
+    TEST_ASSERT(!replay.start_recording(options), "Recording should not start twice");
+    auto t_start = std::chrono::system_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    std::vector<std::shared_ptr<Task>> tasks;
+    for (int i = 0; i < 10; ++i) {
+        auto task = platform.task_builder()
+                        .title("r" + std::to_string(i))
+                        .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                        .build();
+        platform.publish_task(task);
+        tasks.push_back(task);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    auto t_published = std::chrono::system_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+    for (int i = 0; i < 3; ++i) {
+        TEST_ASSERT(platform.claim_task(claimer, tasks[static_cast<size_t>(i)]->id()).has_value(),
+                    "Claim should succeed");
+    }
+    claimer->run_task(tasks[0], std::string());
+    claimer->run_task(tasks[1], std::string());
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    auto t_end = std::chrono::system_clock::now();
+    replay.sync();
+
+    auto before = replay.snapshot_at(t_start - std::chrono::seconds(1));
+    TEST_ASSERT(before.total_tasks == 0, "History before recording should start from the baseline");
+
+    auto published = replay.snapshot_at(t_published);
+    TEST_ASSERT(published.total_tasks == 10 && published.published_tasks == 10 && published.completed_tasks == 0,
+                "Snapshot should reflect the state at the requested time");
+    TEST_ASSERT(published.claimer_load.empty(), "No claimer should hold tasks before claiming");
+
+    auto latest = replay.snapshot_at(t_end);
+    TEST_ASSERT(latest.completed_tasks == 2 && latest.claimed_tasks == 1 && latest.published_tasks == 7,
+                "Latest snapshot should apply all deltas");
+    TEST_ASSERT(latest.claimer_load.size() == 1 && latest.claimer_load["c1"] == 1,
+                "Claimer load should track held tasks");
+    TEST_ASSERT(replay.checkpoint_count() > 2, "Checkpoints should be taken periodically");
+
+    auto timeline = replay.timeline(t_start, t_end, 5);
+    TEST_ASSERT(timeline.size() == 5, "Timeline should return the requested points");
+    TEST_ASSERT(timeline.front().total_tasks == 0 && timeline.back().completed_tasks == 2,
+                "Timeline should scrub from the first to the last state");
+    for (size_t i = 1; i < timeline.size(); ++i) {
+        TEST_ASSERT(timeline[i].total_tasks >= timeline[i - 1].total_tasks, "Timeline should move forward");
+    }
+
+    replay.stop_recording();
+    TEST_ASSERT(!replay.is_recording(), "Recording should stop");
+    return true;
+}
+
+bool test_event_stream_hub() {
+    TaskPlatform platform;
+    EventStreamHub::Options options;
+    options.batch.flush_interval = std::chrono::milliseconds(5);
+    EventStreamHub hub(&platform, options);
+
+    auto client = hub.connect();
+    TEST_ASSERT(hub.client_count() == 1, "Client should be registered");
+
+    auto task = platform.task_builder()
+                    .title("stream")
+                    .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                    .build();
+    platform.publish_task(task);
+    hub.sync();
+
+    std::string chunk;
+    TEST_ASSERT(client->pop_all(chunk, std::chrono::milliseconds(100)), "Open client should return data");
+    TEST_ASSERT(chunk.find("event: task") != std::string::npos, "Task transition should be streamed");
+    TEST_ASSERT(chunk.find(task->id()) != std::string::npos, "Event should carry the task id");
+    TEST_ASSERT(chunk.find("\"old_status\":\"Draft\"") != std::string::npos, "Event should carry the old status");
+    const size_t sequence_at = chunk.find("\"change_sequence\":");
+    TEST_ASSERT(sequence_at != std::string::npos, "Event should carry the change sequence of the transition");
+    const std::uint64_t published_sequence = std::stoull(chunk.substr(sequence_at + 18));
+    TEST_ASSERT(published_sequence > 0 && published_sequence <= platform.change_sequence(),
+                "Transition sequence should come from the platform change log");
+
+    // 删除：推送 task_removed，序号大于此前的转换
+    TEST_ASSERT(platform.remove_task(task->id(), true), "Removal should succeed");
+    hub.sync();
+    TEST_ASSERT(client->pop_all(chunk, std::chrono::milliseconds(100)), "Removal should be streamed");
+    TEST_ASSERT(chunk.find("event: task_removed") != std::string::npos, "Removal should use task_removed");
+    TEST_ASSERT(chunk.find("\"change_sequence\":" + std::to_string(platform.change_sequence())) != std::string::npos &&
+                    platform.change_sequence() > published_sequence,
+                "Removal should carry its own change sequence");
+
+    // 慢客户端：队列满时丢弃最旧消息并要求 resync，不阻塞投递
+    EventStreamHub::Options small = options;
+    small.client_queue_capacity = 2;
+    EventStreamHub small_hub(&platform, small);
+    auto slow = small_hub.connect();
+    for (int i = 0; i < 5; ++i) {
+        small_hub.broadcast("ping", "{}");
+    }
+    TEST_ASSERT(slow->dropped() == 3, "Overflowing messages should be dropped");
+    TEST_ASSERT(slow->pop_all(chunk, std::chrono::milliseconds(0)), "Slow client should still be open");
+    TEST_ASSERT(chunk.find("event: resync") == 0, "Overflow should be signalled with resync first");
+
+    hub.disconnect(client);
+    TEST_ASSERT(hub.client_count() == 0, "Client should be removed");
+    TEST_ASSERT(!client->pop_all(chunk, std::chrono::milliseconds(0)), "Disconnected client should be closed");
+
+    // 客户端数上限：满时拒绝接入，断开后空出名额
+    EventStreamHub::Options capped = options;
+    capped.max_clients = 1;
+    EventStreamHub capped_hub(&platform, capped);
+    auto only = capped_hub.connect();
+    TEST_ASSERT(only && !capped_hub.connect(), "Hub at max_clients should refuse new clients");
+    capped_hub.disconnect(only);
+    TEST_ASSERT(capped_hub.connect() != nullptr, "Disconnecting should free a slot");
+
+    small_hub.close();
+    TEST_ASSERT(!slow->pop_all(chunk, std::chrono::milliseconds(0)), "Closing the hub should close its clients");
+    TEST_ASSERT(small_hub.connect()->closed(), "Closed hub should refuse new clients");
+    return true;
+}
+
+bool test_json_writer() {
+    // 转义：引号、反斜杠、常见控制字符与其余控制字符
+    std::string tricky = std::string("say \"hi\"\\ \n\t\r\b\f") + '\x01' + "\xe4\xbd\xa0";
+    JsonWriter w;
+    w.begin_object()
+        .field("title", tricky)
+        .field("n", -42)
+        .field("big", std::numeric_limits<unsigned long long>::max())
+        .field("min", std::numeric_limits<long long>::min())
+        .field("ratio", 0.1)
+        .field("nan", std::numeric_limits<double>::quiet_NaN())
+        .field("flag", true)
+        .key("empty").begin_array().end_array()
+        .key("nested").begin_array().begin_object().field("a", 1).end_object().value("x").null().end_array()
+        .end_object();
+    const std::string &out = w.str();
+    TEST_ASSERT(out.find("\\u0001") != std::string::npos, "Control characters should be escaped as \\u00XX");
+    TEST_ASSERT(out.find("\\\"hi\\\"") != std::string::npos, "Quotes should be escaped");
+    TEST_ASSERT(out.find("\"nan\":null") != std::string::npos, "NaN should be written as null");
+
+    auto parsed = nlohmann::json::parse(out);
+    TEST_ASSERT(parsed["title"].get<std::string>() == tricky, "Escaped string should round-trip");
+    TEST_ASSERT(parsed["n"].get<int>() == -42, "Negative integers should round-trip");
+    TEST_ASSERT(parsed["big"].get<unsigned long long>() == std::numeric_limits<unsigned long long>::max(),
+                "Unsigned 64-bit values should round-trip");
+    TEST_ASSERT(parsed["min"].get<long long>() == std::numeric_limits<long long>::min(),
+                "Signed 64-bit minimum should round-trip");
+    TEST_ASSERT(parsed["ratio"].get<double>() == 0.1, "Doubles should round-trip");
+    TEST_ASSERT(parsed["empty"].empty() && parsed["nested"].size() == 3, "Nested containers should be separated");
+
+    // 带 sink：超过阈值时分段输出，拼接后与一次性输出相同
+    std::string streamed;
+    size_t flushes = 0;
+    JsonWriter sw([&](const char *data, size_t size) {
+        streamed.append(data, size);
+        ++flushes;
+        return true;
+    }, 64);
+    sw.begin_array();
+    for (int i = 0; i < 100; ++i) {
+        sw.begin_object().field("id", i).field("title", tricky).end_object();
+        TEST_ASSERT(sw.size() < 64 + 64, "Buffer should stay near the flush threshold");
+    }
+    sw.end_array();
+    TEST_ASSERT(sw.flush(), "Flushing to an accepting sink should succeed");
+    TEST_ASSERT(flushes > 1, "Output should be delivered in several pieces");
+    auto array = nlohmann::json::parse(streamed);
+    TEST_ASSERT(array.size() == 100 && array[99]["id"].get<int>() == 99, "Streamed output should be complete");
+
+    // sink 拒绝后写入器报告失败
+    JsonWriter failing([](const char *, size_t) { return false; }, 1);
+    failing.begin_array().value(1).end_array();
+    TEST_ASSERT(!failing.ok(), "Rejected writes should be reported");
+    return true;
+}
+
 bool test_metrics_exporter_formats() {
     TaskPlatform platform;
     EventLog log;
@@ -119,7 +594,117 @@ bool test_metrics_exporter_formats() {
     TEST_ASSERT(json.find("total_tasks") != std::string::npos, "JSON should contain total_tasks");
     TEST_ASSERT(prom.find("youdidit_tasks_total") != std::string::npos, "Prometheus should contain tasks metric");
     TEST_ASSERT(prom.find("youdidit_events_total") != std::string::npos, "Prometheus should contain events metric");
+    TEST_ASSERT(prom.find("youdidit_memory_bytes{scope=\"platform\",component=\"tasks\"}") != std::string::npos,
+                "Prometheus should contain platform memory breakdown");
+    TEST_ASSERT(prom.find("youdidit_memory_bytes{scope=\"event_log\",component=\"events\"}") != std::string::npos,
+                "Prometheus should contain event log memory breakdown");
+    TEST_ASSERT(log.memory_usage().components["events"] > 0, "Event log should account its events");
+    TEST_ASSERT(prom.find("# TYPE youdidit_tasks_total gauge") != std::string::npos, "Gauges should declare their type");
+
+    // 执行一个任务后导出各阶段延迟直方图
+    auto claimer = std::make_shared<Claimer>("w\"1", "worker");
+    platform.register_claimer(claimer);
+    auto task = platform.task_builder()
+                    .title("latency")
+                    .category("ingest")
+                    .handler([](Task &, const std::string &) { return TaskResult("ok"); })
+                    .build();
+    platform.publish_task(task);
+    auto claimed = claimer->claim_next_task();
+    TEST_ASSERT(claimed.has_value() && claimer->run_task(claimed.value(), std::string()).ok(), "Task should run");
+    prom = exporter.export_prometheus();
+    TEST_ASSERT(prom.find("# TYPE youdidit_task_queue_wait_seconds histogram") != std::string::npos,
+                "Queue wait should be exported as a histogram");
+    TEST_ASSERT(prom.find("youdidit_task_run_seconds_count{category=\"ingest\",claimer=\"w\\\"1\"} 1") !=
+                    std::string::npos,
+                "Run histogram should be labelled by category and escaped claimer id");
+    TEST_ASSERT(prom.find("youdidit_task_end_to_end_seconds_bucket{category=\"ingest\",claimer=\"w\\\"1\",le=\"+Inf\"} 1") !=
+                    std::string::npos,
+                "Histogram should end with a +Inf bucket");
+    TEST_ASSERT(prom.find("le=\"0.001024\"") != std::string::npos, "Bucket boundaries should be in seconds");
+    TEST_ASSERT(prom.find("youdidit_task_latency_quantile_seconds{stage=\"queue_wait\",category=\"ingest\"") !=
+                    std::string::npos,
+                "Queue wait quantiles should be exported");
 
+    // 锁争用统计只在 XSWL_YOUDIDIT_ENABLE_LOCK_PROFILING=ON 的构建中导出
+    if (lock_profiling_compiled_in()) {
+        TEST_ASSERT(prom.find("# TYPE youdidit_lock_contended_total counter") != std::string::npos,
+                    "Contended acquisitions should be exported as a counter");
+        TEST_ASSERT(prom.find("youdidit_lock_acquisitions_total{lock=\"platform.tasks\"}") != std::string::npos,
+                    "Acquisitions should be labelled by lock site");
+        TEST_ASSERT(prom.find("youdidit_lock_hold_seconds_bucket{lock=\"task.data\",le=\"0.000000256\"}") !=
+                        std::string::npos,
+                    "Hold time buckets should be in seconds");
+        TEST_ASSERT(prom.find("youdidit_lock_wait_seconds_count{lock=\"claimer.data\"}") != std::string::npos,
+                    "Wait time histogram should be exported per lock site");
+    } else {
+        TEST_ASSERT(prom.find("youdidit_lock_") == std::string::npos, "No lock metrics when compiled out");
+    }
+
+    return true;
+}
+
+bool test_metrics_snapshotter() {
+    TaskPlatform platform;
+    EventLog log;
+    make_task_with_status(platform, "t1", TaskStatus::Completed);
+
+    MetricsSnapshotter snapshotter(&platform, &log, std::chrono::milliseconds(20));
+    auto first = snapshotter.current();
+    TEST_ASSERT(first && first->generation >= 1, "First snapshot should be taken on construction");
+    TEST_ASSERT(first->stats.total_tasks == 1 && first->stats.completed_tasks == 1, "Snapshot should hold stats");
+
+    // 发布后的快照不可变，新数据由后台线程在下一个间隔发布
+    make_task_with_status(platform, "t2", TaskStatus::Published);
+    TEST_ASSERT(first->stats.total_tasks == 1, "Published snapshot should never change");
+    bool refreshed = false;
+    for (int i = 0; i < 200 && !refreshed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        auto snap = snapshotter.current();
+        refreshed = snap->stats.total_tasks == 2 && snap->generation > first->generation;
+    }
+    TEST_ASSERT(refreshed, "Background thread should publish a fresh snapshot");
+
+    // 并发读取者只做原子加载
+    std::atomic<bool> readers_ok{true};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back([&]() {
+            std::uint64_t last = 0;
+            for (int i = 0; i < 2000; ++i) {
+                auto snap = snapshotter.current();
+                if (!snap || snap->generation < last) {
+                    readers_ok = false;
+                }
+                last = snap->generation;
+            }
+        });
+    }
+    for (auto &t : readers) {
+        t.join();
+    }
+    TEST_ASSERT(readers_ok.load(), "Readers should see monotonically newer snapshots");
+
+    // 间隔 <= 0：停止后台线程，每次读取直接采集
+    snapshotter.set_interval(std::chrono::milliseconds(0));
+    make_task_with_status(platform, "t3", TaskStatus::Published);
+    TEST_ASSERT(snapshotter.current()->stats.total_tasks == 3, "Live mode should capture on every read");
+
+    // 导出器从快照渲染
+    snapshotter.set_interval(std::chrono::milliseconds(1000));
+    snapshotter.refresh();
+    MetricsExporter exporter(std::shared_ptr<MetricsSnapshotter>(&snapshotter, [](MetricsSnapshotter *) {}));
+    TEST_ASSERT(exporter.export_prometheus().find("youdidit_tasks_total 3") != std::string::npos,
+                "Exporter should render the snapshot");
+    snapshotter.stop();
+    auto last = snapshotter.current();
+    TEST_ASSERT(snapshotter.current() == last, "Stopped snapshotter should keep its last snapshot");
+
+    WebDashboard dashboard(&platform);
+    dashboard.set_update_interval(10);
+    TEST_ASSERT(dashboard.get_metrics_snapshotter()->interval().count() == 10,
+                "Dashboard should forward its update interval");
+    TEST_ASSERT(dashboard.get_metrics().total_tasks == 3, "Dashboard metrics should come from the snapshot");
     return true;
 }
 
@@ -163,13 +748,394 @@ bool test_web_server_start_stop() {
     TaskPlatform platform;
     WebDashboard dashboard(&platform);
     WebServer server(&dashboard, 8081);
-    server.start();
+    TEST_ASSERT(server.start().has_value(), "Server should start");
     TEST_ASSERT(server.is_running(), "Server should be running after start");
     server.stop();
     TEST_ASSERT(!server.is_running(), "Server should stop");
     return true;
 }
 
+bool test_web_server_ephemeral_port() {
+    TaskPlatform platform;
+    WebDashboard dashboard(&platform);
+    WebServer server(&dashboard, 0);
+    server.set_host("127.0.0.1");
+    TEST_ASSERT(server.start().has_value(), "Server should bind an ephemeral port");
+    const int port = server.get_port();
+    TEST_ASSERT(port > 0, "Chosen port should be reported");
+
+    // start() 返回时已在监听，无需等待
+    httplib::Client client("127.0.0.1", port);
+    auto res = client.Get("/api/metrics");
+    TEST_ASSERT(res && res->status == 200, "Server should answer right after start");
+    TEST_ASSERT(res->body.find("\"sequence\":") != std::string::npos, "Metrics should carry the change sequence");
+
+    WebServer clash(&dashboard, port);
+    clash.set_host("127.0.0.1");
+    auto result = clash.start();
+    TEST_ASSERT(!result.has_value() && result.error().code == ErrorCode::NETWORK_BIND_FAILED,
+                "Binding a used port should fail");
+    TEST_ASSERT(!clash.is_running(), "Failed server should not be running");
+
+    server.stop();
+    TEST_ASSERT(server.get_port() == 0, "Stopped server reports the configured port");
+    return true;
+}
+
+bool test_web_server_load_shedding() {
+    TaskPlatform platform;
+    WebDashboard dashboard(&platform);
+    WebServer::Options options;
+    options.worker_threads = 1;
+    options.max_queued_requests = 1;
+    options.retry_after = std::chrono::seconds(3);
+    WebServer server(&dashboard, 0, options);
+    server.set_host("127.0.0.1");
+    TEST_ASSERT(server.start().has_value(), "Server should start");
+    const int port = server.get_port();
+
+    // 第一个 SSE 连接占住唯一的工作线程，第二个占满等待队列
+    auto hold = [port]() {
+        httplib::Client client("127.0.0.1", port);
+        client.set_read_timeout(std::chrono::seconds(30));
+        client.Get("/api/events/stream", [](const char *, size_t) { return true; });
+    };
+    std::thread first(hold);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    std::thread second(hold);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    httplib::Client client("127.0.0.1", port);
+    client.set_read_timeout(std::chrono::seconds(5));
+    auto res = client.Get("/api/metrics");
+    TEST_ASSERT(res && res->status == 503, "Saturated server should shed with 503");
+    TEST_ASSERT(res->get_header_value("Retry-After") == "3", "503 should carry Retry-After");
+    TEST_ASSERT(res->get_header_value("Connection") == "close", "Shed response should close the connection");
+    TEST_ASSERT(server.shed_count() == 1, "Shed request should be counted");
+
+    // 降载线程不被上一个连接占住，紧接着的请求同样立即得到 503
+    const auto begin = std::chrono::steady_clock::now();
+    res = client.Get("/api/metrics");
+    TEST_ASSERT(res && res->status == 503, "Next shed request should be answered");
+    TEST_ASSERT(std::chrono::steady_clock::now() - begin < std::chrono::seconds(2),
+                "Shed thread should not wait on the previous connection");
+    TEST_ASSERT(server.shed_count() == 2, "Both shed requests should be counted");
+
+    server.stop();
+    first.join();
+    second.join();
+    return true;
+}
+
+bool test_web_server_event_stream_limit() {
+    TaskPlatform platform;
+    WebDashboard dashboard(&platform);
+    WebServer::Options options;
+    options.worker_threads = 4;   // 默认上限为 2，另外两个工作线程留给普通请求
+    WebServer server(&dashboard, 0, options);
+    server.set_host("127.0.0.1");
+    TEST_ASSERT(server.start().has_value(), "Server should start");
+    const int port = server.get_port();
+
+    // 两个 SSE 连接占满上限
+    auto hold = [port]() {
+        httplib::Client client("127.0.0.1", port);
+        client.set_read_timeout(std::chrono::seconds(30));
+        client.Get("/api/events/stream", [](const char *, size_t) { return true; });
+    };
+    std::thread first(hold);
+    std::thread second(hold);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    httplib::Client client("127.0.0.1", port);
+    client.set_read_timeout(std::chrono::seconds(5));
+    auto res = client.Get("/api/events/stream");
+    TEST_ASSERT(res && res->status == 503, "Streams beyond the cap should get 503");
+    TEST_ASSERT(res->get_header_value("Connection") == "close", "Rejected stream should close the connection");
+    res = client.Get("/api/metrics");
+    TEST_ASSERT(res && res->status == 200, "Regular requests should still find a worker");
+
+    server.stop();
+    first.join();
+    second.join();
+    return true;
+}
+
+bool test_web_dashboard_aggregation() {
+    // 两个同进程的平台各自挂一个 WebServer，作为被聚合的端点
+    TaskPlatform platform_a;
+    TaskPlatform platform_b;
+    for (int i = 0; i < 3; ++i) {
+        auto task = std::make_shared<Task>("a" + std::to_string(i));
+        task->set_status(TaskStatus::Published);
+        platform_a.publish_task(task);
+    }
+    auto task_b = std::make_shared<Task>("b0");
+    task_b->set_title("quoted \"title\"");
+    task_b->set_status(TaskStatus::Published);
+    platform_b.publish_task(task_b);
+
+    WebDashboard dashboard_a(&platform_a);
+    WebDashboard dashboard_b(&platform_b);
+    dashboard_a.set_update_interval(0);
+    dashboard_b.set_update_interval(0);
+    WebServer server_a(&dashboard_a, 0);
+    WebServer server_b(&dashboard_b, 0);
+    server_a.set_host("127.0.0.1");
+    server_b.set_host("127.0.0.1");
+    TEST_ASSERT(server_a.start().has_value() && server_b.start().has_value(), "Stand-in servers should start");
+
+    // 慢速端点：指标接口 2 秒后才返回
+    httplib::Server slow;
+    slow.Get("/api/metrics", [](const httplib::Request &, httplib::Response &res) {
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+        res.set_content("{}", "application/json");
+    });
+    const int slow_port = slow.bind_to_any_port("127.0.0.1");
+    std::thread slow_thread([&slow]() { slow.listen_after_bind(); });
+    slow.wait_until_ready();
+
+    const std::string endpoint_a = "http://127.0.0.1:" + std::to_string(server_a.get_port());
+    const std::string endpoint_b = "127.0.0.1:" + std::to_string(server_b.get_port()) + "/api/metrics";
+    const std::string endpoint_slow = "http://127.0.0.1:" + std::to_string(slow_port);
+
+    PlatformAggregator::Options options;
+    options.timeout = std::chrono::milliseconds(300);
+    WebDashboard aggregate(std::vector<std::string>{endpoint_a, endpoint_b, endpoint_slow}, options);
+    aggregate.set_update_interval(0);  // 读取时同步抓取一轮，便于断言
+
+    auto started = std::chrono::steady_clock::now();
+    auto metrics = aggregate.get_metrics();
+    auto elapsed = std::chrono::steady_clock::now() - started;
+    TEST_ASSERT(metrics.total_tasks == 4, "Aggregated metrics should sum all endpoints");
+    TEST_ASSERT(elapsed < std::chrono::milliseconds(1500), "Slow endpoint should not stall the aggregate");
+
+    auto tasks = aggregate.get_tasks_summary();
+    TEST_ASSERT(tasks.size() == 4, "Aggregated task list should merge all endpoints");
+    size_t from_b = 0;
+    for (const auto &task : tasks) {
+        if (task.endpoint == endpoint_b) {
+            ++from_b;
+            TEST_ASSERT(task.id == "b0" && task.title == "quoted \"title\"", "Task fields should survive scraping");
+            TEST_ASSERT(task.status == TaskStatus::Published, "Task status should be parsed");
+        }
+    }
+    TEST_ASSERT(from_b == 1, "Tasks should carry their endpoint");
+
+    auto status = aggregate.get_endpoint_status();
+    TEST_ASSERT(status.size() == 3, "Every endpoint should report a status");
+    TEST_ASSERT(status[0]->reachable && status[1]->reachable, "Stand-ins should be reachable");
+    TEST_ASSERT(!status[2]->reachable && !status[2]->last_error.empty(), "Slow endpoint should time out");
+
+    // 端点下线后沿用上一次的结果
+    server_b.stop();
+    metrics = aggregate.get_metrics();
+    status = aggregate.get_endpoint_status();
+    TEST_ASSERT(!status[1]->reachable && status[1]->has_data, "Offline endpoint should keep its last result");
+    TEST_ASSERT(status[1]->consecutive_failures >= 1, "Failures should be counted");
+    TEST_ASSERT(metrics.total_tasks == 4, "Cached results should stay in the aggregate");
+
+    aggregate.get_aggregator()->stop();
+
+    // 构造时的刷新间隔以调用方的 Options 为准（单端点远程模式同样如此）
+    PlatformAggregator::Options custom;
+    custom.interval = std::chrono::milliseconds(250);
+    WebDashboard remote(endpoint_a, custom);
+    TEST_ASSERT(remote.get_aggregator()->interval() == std::chrono::milliseconds(250),
+                "Aggregator should keep the caller's interval");
+    TEST_ASSERT(remote.get_metrics_snapshotter()->interval() == std::chrono::milliseconds(250),
+                "Snapshot interval should follow the aggregator interval");
+    remote.get_aggregator()->stop();
+
+    server_a.stop();
+    slow.stop();
+    slow_thread.join();
+    return true;
+}
+
+bool test_web_dashboard_remote_mirror() {
+    TaskPlatform platform;
+    for (int i = 0; i < 3; ++i) {
+        auto task = std::make_shared<Task>("r" + std::to_string(i));
+        task->set_status(TaskStatus::Published);
+        platform.publish_task(task);
+    }
+    auto claimer = std::make_shared<Claimer>("c1", "claimer");
+    platform.register_claimer(claimer);
+
+    WebDashboard local(&platform);
+    local.set_update_interval(0);
+    WebServer server(&local, 0);
+    server.set_host("127.0.0.1");
+    TEST_ASSERT(server.start().has_value(), "Remote stand-in should start");
+    const std::string endpoint = "http://127.0.0.1:" + std::to_string(server.get_port()) + "/api/metrics";
+
+    // 指标接口支持条件请求
+    httplib::Client client("127.0.0.1", server.get_port());
+    auto first = client.Get("/api/metrics");
+    TEST_ASSERT(first && first->status == 200 && first->has_header("ETag"), "Metrics should carry an ETag");
+    auto again = client.Get("/api/metrics", httplib::Headers{{"If-None-Match", first->get_header_value("ETag")}});
+    TEST_ASSERT(again && again->status == 304, "Unchanged metrics should answer 304");
+
+    WebDashboard remote(endpoint);
+    remote.set_update_interval(0);  // 每次读取前同步一轮
+    auto tasks = remote.get_tasks_summary();
+    TEST_ASSERT(tasks.size() == 3, "Mirror should hold the remote tasks");
+    TEST_ASSERT(remote.get_metrics().total_tasks == 3, "Mirror should hold the remote metrics");
+
+    // 没有变化时镜像不重建，任务列表继续共享
+    auto before = remote.get_endpoint_status()[0]->tasks;
+    auto after = remote.get_endpoint_status()[0]->tasks;
+    TEST_ASSERT(before == after, "Unchanged mirror should be shared between rounds");
+
+    // 增量同步：申领、删除与新发布都会反映到镜像
+    TEST_ASSERT(claimer->claim_task("r0").has_value(), "Claim should succeed");
+    TEST_ASSERT(platform.remove_task("r1", true), "Remove should succeed");
+    auto added = std::make_shared<Task>("r3");
+    added->set_status(TaskStatus::Published);
+    platform.publish_task(added);
+
+    tasks = remote.get_tasks_summary();
+    TEST_ASSERT(tasks.size() == 3, "Mirror should apply additions and removals");
+    bool claimed = false;
+    for (const auto &task : tasks) {
+        TEST_ASSERT(task.id != "r1", "Removed task should leave the mirror");
+        if (task.id == "r0") {
+            claimed = task.status == TaskStatus::Claimed && task.claimer_id == "c1";
+        }
+    }
+    TEST_ASSERT(claimed, "Status changes should reach the mirror");
+
+    // 远端下线后，读取只访问本地镜像
+    remote.get_aggregator()->stop();
+    server.stop();
+    tasks = remote.get_tasks_summary();
+    TEST_ASSERT(tasks.size() == 3, "Mirror should survive the remote going away");
+    auto analysis = remote.analyze_performance(make_time_shift_ms(-60000), make_time_shift_ms(0));
+    TEST_ASSERT(analysis.total_tasks == 3, "Performance analysis should read the mirror");
+    return true;
+}
+
+bool test_web_server_query_validation() {
+    TaskPlatform platform;
+    make_task_with_status(platform, "t1", TaskStatus::Published);
+    WebDashboard dashboard(&platform);
+    WebServer server(&dashboard, 0);
+    server.set_host("127.0.0.1");
+    TEST_ASSERT(server.start().has_value(), "Server should start");
+    httplib::Client client("127.0.0.1", server.get_port());
+
+    const char *invalid[] = {"/api/tasks?min_priority=5x", "/api/tasks?max_priority=abc", "/api/tasks?limit=",
+                             "/api/tasks?limit=10.5", "/api/tasks?min_priority=99999999999",
+                             "/api/tasks?limit=%2010", "/api/tasks?since=0&limit=1x", "/api/tasks?since=3z"};
+    for (const char *path : invalid) {
+        auto res = client.Get(path);
+        TEST_ASSERT(res && res->status == 400, "Malformed integer parameters should be rejected");
+    }
+    auto res = client.Get("/api/tasks?min_priority=-3&max_priority=10&limit=1");
+    TEST_ASSERT(res && res->status == 200, "Well-formed integers should be accepted");
+    TEST_ASSERT(nlohmann::json::parse(res->body)["count"] == 1, "Filters should apply");
+    res = client.Get("/api/tasks?min_priority=1");
+    TEST_ASSERT(res && res->status == 200 && nlohmann::json::parse(res->body)["count"] == 0,
+                "min_priority should filter out lower priorities");
+
+    server.stop();
+    return true;
+}
+
+bool test_web_server_batch_submit() {
+    TaskPlatform platform;
+    platform.set_max_task_queue_size(2500);
+    WebDashboard dashboard(&platform);
+    WebServer server(&dashboard, 0);
+    server.set_host("127.0.0.1");
+    server.register_task_handler("echo", [](Task &, const std::string &input) { return TaskResult(input); });
+    TEST_ASSERT(server.start().has_value(), "Server should start");
+    httplib::Client client("127.0.0.1", server.get_port());
+
+    const std::string body =
+        "{\"title\":\"a\",\"handler\":\"echo\",\"priority\":7,\"category\":\"c\",\"tags\":[\"x\"],\"metadata\":{\"k\":\"v\",\"n\":1}}\n"
+        "\n"
+        "not json\n"
+        "{\"title\":\"b\",\"handler\":\"missing\"}\n"
+        "{\"handler\":\"echo\"}\r\n"
+        "{\"title\":\"c\",\"handler\":\"echo\",\"priority\":\"high\"}\n"
+        "{\"title\":\"d\",\"handler\":\"echo\"}";
+    auto res = client.Post("/api/tasks/batch", body, "application/x-ndjson");
+    TEST_ASSERT(res && res->status == 200, "Batch should be accepted");
+    auto json = nlohmann::json::parse(res->body);
+    TEST_ASSERT(json["accepted"] == 2 && json["rejected"] == 4, "Counts should cover every non-blank line");
+    const auto &results = json["results"];
+    TEST_ASSERT(results.size() == 6, "Blank lines produce no result");
+    TEST_ASSERT(results[0]["line"] == 1 && results[0].contains("id"), "Valid line should be published");
+    TEST_ASSERT(results[1]["line"] == 3 && results[1]["error"] == "invalid JSON object", "Bad JSON should be reported");
+    TEST_ASSERT(results[2]["error"] == "unknown handler: missing", "Unknown handler should be reported");
+    TEST_ASSERT(results[3]["error"].get<std::string>().find("title") != std::string::npos,
+                "Validation errors should be reported");
+    TEST_ASSERT(results[4]["error"] == "field 'priority' must be an integer", "Type errors should be reported");
+    TEST_ASSERT(results[5]["line"] == 7 && results[5].contains("id"), "Last line without newline should count");
+
+    auto task = platform.get_task(results[0]["id"].get<std::string>());
+    TEST_ASSERT(task && task->status() == TaskStatus::Published && task->priority() == 7, "Task fields should apply");
+    TEST_ASSERT(task->category() == "c" && task->tags().count("x") == 1, "Category and tags should apply");
+    TEST_ASSERT(task->metadata()["k"] == "v" && task->metadata()["n"] == "1", "Metadata should apply");
+
+    // 多个发布批次、跨块的行、超长行与队列上限
+    std::string big;
+    for (int i = 0; i < 3000; ++i) {
+        big += "{\"title\":\"bulk-" + std::to_string(i) + "\",\"handler\":\"echo\"}\n";
+        if (i == 10) {
+            big += "{\"title\":\"" + std::string(2u << 20, 'x') + "\",\"handler\":\"echo\"}\n";
+        }
+    }
+    res = client.Post("/api/tasks/batch", big, "application/x-ndjson");
+    TEST_ASSERT(res && res->status == 200, "Large batch should be accepted");
+    json = nlohmann::json::parse(res->body);
+    TEST_ASSERT(json["results"].size() == 3001, "Every line should have a result");
+    TEST_ASSERT(json["results"][11]["error"] == "line too long", "Oversized line should be rejected");
+    TEST_ASSERT(json["results"][12]["line"] == 13 && json["results"][12].contains("id"),
+                "Line after an oversized one should be parsed");
+    TEST_ASSERT(json["accepted"] == 2498 && platform.task_count() == 2500, "Queue limit should cap the batch");
+    TEST_ASSERT(json["results"][3000]["error"] == "Platform task queue is full", "Overflow should be reported");
+
+    server.stop();
+
+    // 行数上限：上限内的行照常发布，其余行不处理，以 413 应答并给出续传行号
+    WebServer::Options capped;
+    capped.max_batch_lines = 3;
+    WebServer capped_server(&dashboard, 0, capped);
+    capped_server.set_host("127.0.0.1");
+    capped_server.register_task_handler("echo", [](Task &, const std::string &input) { return TaskResult(input); });
+    TEST_ASSERT(capped_server.start().has_value(), "Capped server should start");
+    platform.set_max_task_queue_size(0);
+    const size_t before = platform.task_count();
+    httplib::Client capped_client("127.0.0.1", capped_server.get_port());
+    res = capped_client.Post("/api/tasks/batch",
+                             "{\"title\":\"e\",\"handler\":\"echo\"}\n\n{\"title\":\"f\",\"handler\":\"echo\"}\n"
+                             "oops\n  \n{\"title\":\"g\",\"handler\":\"echo\"}\n{\"title\":\"h\",\"handler\":\"echo\"}",
+                             "application/x-ndjson");
+    TEST_ASSERT(res && res->status == 413, "Lines beyond the cap should yield 413");
+    json = nlohmann::json::parse(res->body);
+    TEST_ASSERT(json["results"].size() == 3 && json["accepted"] == 2 && json["rejected"] == 1,
+                "Only lines within the cap should be processed");
+    TEST_ASSERT(json["next_line"] == 6 && json["error"] == "too many lines", "Response should say where to resume");
+    TEST_ASSERT(platform.task_count() == before + 2, "Lines beyond the cap should not be published");
+    res = capped_client.Post("/api/tasks/batch", "{\"title\":\"i\",\"handler\":\"echo\"}\n\n\n",
+                             "application/x-ndjson");
+    TEST_ASSERT(res && res->status == 200 && !nlohmann::json::parse(res->body).contains("next_line"),
+                "Batches within the cap should succeed");
+    capped_server.stop();
+
+    WebDashboard remote(std::vector<std::string>{});
+    WebServer remote_server(&remote, 0);
+    remote_server.set_host("127.0.0.1");
+    TEST_ASSERT(remote_server.start().has_value(), "Server without platform should start");
+    httplib::Client remote_client("127.0.0.1", remote_server.get_port());
+    res = remote_client.Post("/api/tasks/batch", "{}\n", "application/x-ndjson");
+    TEST_ASSERT(res && res->status == 404, "Batch needs a local platform");
+    return true;
+}
+
 } // namespace
 
 int main() {
@@ -180,10 +1146,26 @@ int main() {
     bool all_passed = true;
 
     RUN_TEST(test_event_log_basic);
+    RUN_TEST(test_event_log_ring_buffer);
+    RUN_TEST(test_event_log_ordered_queries);
+    RUN_TEST(test_event_store_persistence);
+    RUN_TEST(test_event_store_pending_cap);
     RUN_TEST(test_time_replay_snapshot);
+    RUN_TEST(test_time_replay_checkpoints);
+    RUN_TEST(test_time_replay_overlap_and_removal);
+    RUN_TEST(test_event_stream_hub);
+    RUN_TEST(test_json_writer);
     RUN_TEST(test_metrics_exporter_formats);
+    RUN_TEST(test_metrics_snapshotter);
     RUN_TEST(test_web_dashboard_summaries);
     RUN_TEST(test_web_server_start_stop);
+    RUN_TEST(test_web_server_ephemeral_port);
+    RUN_TEST(test_web_server_load_shedding);
+    RUN_TEST(test_web_server_event_stream_limit);
+    RUN_TEST(test_web_dashboard_aggregation);
+    RUN_TEST(test_web_dashboard_remote_mirror);
+    RUN_TEST(test_web_server_query_validation);
+    RUN_TEST(test_web_server_batch_submit);
 
     std::cout << "========================================" << std::endl;
     if (all_passed) {